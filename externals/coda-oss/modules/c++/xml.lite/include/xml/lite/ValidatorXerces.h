@@ -95,7 +95,10 @@ private:
  * \class ValidatorXerces
  * \brief Schema validation is done here.
  *
- * This class is the Xercesc schema validator
+ * This class is the Xercesc schema validator. Schemas are compiled once
+ * per process and shared, so constructing a validator for a set of
+ * schemas that has been seen before is cheap. Each validator still has
+ * its own parser and must only be used by one thread at a time.
  */
 class ValidatorXerces : public ValidatorInterface
 {
@@ -118,6 +121,15 @@ public:
                     logging::Logger* log,
                     bool recursive = true);
 
+    /*!
+     *  Grammars compiled from a set of schemas are cached for the life of
+     *  the process and shared by every validator built from the same
+     *  schema files. A set where any schema failed to load is not
+     *  cached. This releases the cache; existing validators keep the
+     *  grammars they already use.
+     */
+    static void clearGrammarCache();
+
     ValidatorXerces(const ValidatorXerces&) = delete;
     ValidatorXerces& operator=(const ValidatorXerces&) = delete;
     ValidatorXerces(ValidatorXerces&&) = delete;
@@ -142,7 +154,7 @@ private:
                    const std::string& xmlID,
                    std::vector<ValidationInfo>& errors) const;
 
-    std::unique_ptr<xercesc::XMLGrammarPool> mSchemaPool;
+    std::shared_ptr<xercesc::XMLGrammarPool> mSchemaPool;
     std::unique_ptr<xml::lite::ValidationErrorHandler> mErrorHandler;
     std::unique_ptr<xercesc::DOMLSParser> mValidator;
 
@@ -22,6 +22,8 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
+#include <mutex>
 #include <std/filesystem>
 #include <std/memory>
 #include <std/string>
@@ -96,33 +98,25 @@ ValidatorXerces::ValidatorXerces(
     ValidatorXerces(convert(schemaPaths), log, recursive)
 {
 }
-ValidatorXerces::ValidatorXerces(
-    const std::vector<std::string>& schemaPaths, 
-    logging::Logger* log,
-    bool recursive) :
-    ValidatorInterface(schemaPaths, log, recursive)
+// set the configuration settings shared by validators and grammar loaders
+static xercesc::DOMLSParser* createParser(xercesc::XMLGrammarPool& schemaPool,
+                                          ValidationErrorHandler& errorHandler)
 {
-    // add each schema into a grammar pool --
-    // this allows reuse
-    mSchemaPool.reset(
-        new xercesc::XMLGrammarPoolImpl(
-            xercesc::XMLPlatformUtils::fgMemoryManager));
-
     const XMLCh ls_id [] = {xercesc::chLatin_L, 
                             xercesc::chLatin_S, 
                             xercesc::chNull};
 
     // create the validator
-    mValidator.reset(
+    xercesc::DOMLSParser* parser =
         xercesc::DOMImplementationRegistry::
             getDOMImplementation (ls_id)->createLSParser(
                 xercesc::DOMImplementationLS::MODE_SYNCHRONOUS,
                 0, 
                 xercesc::XMLPlatformUtils::fgMemoryManager,
-                mSchemaPool.get()));
+                &schemaPool);
 
     // set the configuration settings
-    xercesc::DOMConfiguration* config = mValidator->getDomConfig();
+    xercesc::DOMConfiguration* config = parser->getDomConfig();
     config->setParameter(xercesc::XMLUni::fgDOMComments, false);
     config->setParameter(xercesc::XMLUni::fgDOMDatatypeNormalization, true);
     config->setParameter(xercesc::XMLUni::fgDOMEntities, false);
@@ -147,32 +141,121 @@ ValidatorXerces::ValidatorXerces(
     config->setParameter(xercesc::XMLUni::fgXercesUserAdoptsDOMDocument, true);
 
     // add a error handler we still have control over
-    mErrorHandler.reset(
-            new ValidationErrorHandler());
     config->setParameter(xercesc::XMLUni::fgDOMErrorHandler, 
-                         mErrorHandler.get());
+                         &errorHandler);
+    return parser;
+}
 
-    // load our schemas --
-    // search each directory for schemas
-    sys::OS os;
-    std::vector<std::string> schemas = 
-        os.search(schemaPaths, "", ".xsd", recursive);
+// Compiled grammars for each set of schema files. A locked pool is
+// read-only, so any number of parsers on any number of threads can
+// validate against it at once.
+struct GrammarPoolCache final
+{
+    // Compiling is done under the entry's own mutex, so validators for
+    // other schema sets aren't held up, and validators for the same set
+    // wait for one compile rather than each doing their own
+    struct Entry final
+    {
+        std::mutex mMutex;
+        std::shared_ptr<xercesc::XMLGrammarPool> mPool;
+    };
+
+    XercesContext mCtxt;    //! keeps Xerces alive as long as the pools
+    std::mutex mMutex;
+    std::map<std::vector<std::string>, std::shared_ptr<Entry> > mEntries;
+};
+static GrammarPoolCache& getGrammarPoolCache()
+{
+    static GrammarPoolCache cache;
+    return cache;
+}
+
+static std::shared_ptr<xercesc::XMLGrammarPool> getGrammarPool(
+        const std::vector<std::string>& schemas,
+        logging::Logger* log)
+{
+    std::vector<std::string> key(schemas);
+    std::sort(key.begin(), key.end());
+
+    GrammarPoolCache& cache = getGrammarPoolCache();
+    std::shared_ptr<GrammarPoolCache::Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(cache.mMutex);
+        auto& cached = cache.mEntries[key];
+        if (cached.get() == nullptr)
+        {
+            cached = std::make_shared<GrammarPoolCache::Entry>();
+        }
+        entry = cached;
+    }
+
+    std::lock_guard<std::mutex> lock(entry->mMutex);
+    if (entry->mPool.get() != nullptr)
+    {
+        return entry->mPool;
+    }
 
-    //  add the schema to the validator
-    for (size_t i = 0; i < schemas.size(); ++i)
+    auto newPool = std::make_shared<xercesc::XMLGrammarPoolImpl>(
+            xercesc::XMLPlatformUtils::fgMemoryManager);
+    bool loadedAll = true;
     {
-        if (!mValidator->loadGrammar(schemas[i].c_str(), 
+        ValidationErrorHandler errorHandler;
+        std::unique_ptr<xercesc::DOMLSParser> loader(
+                createParser(*newPool, errorHandler));
+
+        //  add the schema to the pool
+        for (size_t i = 0; i < schemas.size(); ++i)
+        {
+            if (!loader->loadGrammar(schemas[i].c_str(), 
                                      xercesc::Grammar::SchemaGrammarType,
                                      true))
-        {
-            std::ostringstream oss;
-            oss << "Error: Failure to load schema " << schemas[i];
-            log->warn(Ctxt(oss.str()));
+            {
+                std::ostringstream oss;
+                oss << "Error: Failure to load schema " << schemas[i];
+                log->warn(Ctxt(oss.str()));
+                loadedAll = false;
+            }
         }
     }
 
     //! no additional schemas will be loaded after this point!
-    mSchemaPool->lockPool();
+    newPool->lockPool();
+
+    // An incomplete pool still serves this validator, but isn't kept, so
+    // the next one tries the schemas again
+    if (loadedAll)
+    {
+        entry->mPool = newPool;
+    }
+    return newPool;
+}
+
+void ValidatorXerces::clearGrammarCache()
+{
+    GrammarPoolCache& cache = getGrammarPoolCache();
+    std::lock_guard<std::mutex> lock(cache.mMutex);
+    cache.mEntries.clear();
+}
+
+ValidatorXerces::ValidatorXerces(
+    const std::vector<std::string>& schemaPaths, 
+    logging::Logger* log,
+    bool recursive) :
+    ValidatorInterface(schemaPaths, log, recursive)
+{
+    // load our schemas --
+    // search each directory for schemas
+    sys::OS os;
+    std::vector<std::string> schemas = 
+        os.search(schemaPaths, "", ".xsd", recursive);
+
+    // every validator for the same schemas shares one grammar pool --
+    // the schemas are only read and compiled the first time
+    mSchemaPool = getGrammarPool(schemas, log);
+
+    mErrorHandler.reset(
+            new ValidationErrorHandler());
+    mValidator.reset(createParser(*mSchemaPool, *mErrorHandler));
 }
 
 // From config.h.in: Define to the 16 bit type used to represent Xerces UTF-16 characters
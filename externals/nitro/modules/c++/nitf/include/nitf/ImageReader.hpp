@@ -37,6 +37,7 @@
 #include "nitf/ImageReader.h"
 #include "nitf/Object.hpp"
 #include "nitf/BlockingInfo.hpp"
+#include "nitf/IOInterface.hpp"
 #include "nitf/System.hpp"
 
 /*!
@@ -154,6 +155,27 @@ public:
     //!  Set read caching
     void setReadCaching();
 
+    /*!
+     *  Set how many bytes of whole blocks are cached between reads;
+     *  least recently used blocks are freed first. The most recent block
+     *  is always kept, so the default of 0 caches a single block.
+     *  A non-zero limit also enables read caching.
+     *  \param maxBytes  Cache size limit in bytes
+     */
+    void setBlockCacheSize(uint64_t maxBytes);
+
+    //! Number of block lookups satisfied from the cache, and that missed
+    void getBlockCacheStats(uint64_t& hits, uint64_t& misses) const;
+
+    /*!
+     *  Read pixels through 'input', another handle to the same file, so
+     *  readers of different segments can read concurrently without parsing
+     *  the headers again.  Call before the first read; 'input' must outlive
+     *  this reader.
+     *  \param input  Interface to read pixels from
+     */
+    void setInput(nitf::IOInterface& input);
+
     // for unit-tests
     bool getMaskInfo(uint32_t& imageDataOffset, uint32_t& blockRecordLength,
         uint32_t& padRecordLength, uint32_t& padPixelValueLength,
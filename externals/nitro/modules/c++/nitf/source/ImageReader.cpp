@@ -81,6 +81,21 @@ void ImageReader::setReadCaching()
     nitf_ImageReader_setReadCaching(getNativeOrThrow());
 }
 
+void ImageReader::setBlockCacheSize(uint64_t maxBytes)
+{
+    nitf_ImageReader_setBlockCacheSize(getNativeOrThrow(), maxBytes);
+}
+
+void ImageReader::getBlockCacheStats(uint64_t& hits, uint64_t& misses) const
+{
+    nitf_ImageReader_getBlockCacheStats(getNativeOrThrow(), &hits, &misses);
+}
+
+void ImageReader::setInput(nitf::IOInterface& input)
+{
+    nitf_ImageReader_setInput(getNativeOrThrow(), input.getNativeOrThrow());
+}
+
 BufferList<std::byte> ImageReader::read(const nitf::SubWindow& window, size_t /*nbpp*/)
 {
     // see py_ImageReader_read() and doRead() in test_buffered_read.cpp
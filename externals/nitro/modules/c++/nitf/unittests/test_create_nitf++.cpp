@@ -36,6 +36,7 @@
 #include <thread>
 #include <array>
 #include <memory>
+#include <vector>
 
 #include <config/compiler_extensions.h>
 
@@ -419,6 +420,130 @@ TEST_CASE(test_create_nitf_test)
 }
 
 
+static std::vector<uint8_t> test_block_cache__writeNITF(const std::string& filename,
+    uint32_t numRowsPerBlock, uint32_t numColsPerBlock)
+{
+    const auto numRows = NITRO_IMAGE.height;
+    const auto numCols = NITRO_IMAGE.width;
+    std::vector<uint8_t> image(static_cast<size_t>(numRows) * numCols);
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<uint8_t>(ii % 251);
+    }
+
+    nitf::Record record;
+    populateFileHeader(record, filename);
+
+    nitf::ImageSegment segment = record.newImageSegment();
+    nitf::ImageSubheader header = segment.getSubheader();
+    header.getImageId().set("NITRO-TEST");
+    header.getImageDateAndTime().set("20080812000000");
+    setCornersFromDMSBox(header);
+
+    std::vector<nitf::BandInfo> bands(1, nitf::BandInfo());
+    bands[0].init(nitf::Representation::M, nitf::Subcategory::None, "N", "   ");
+    header.setPixelInformation(nitf::PixelValueType::Integer, 8, 8, "R",
+        nitf::ImageRepresentation::MONO, "VIS", bands);
+    header.setBlocking(numRows, numCols, numRowsPerBlock, numColsPerBlock,
+        nitf::BlockingMode::Block);
+
+    nitf::IOHandle out(filename, NITF_ACCESS_WRITEONLY, NITF_CREATE);
+    nitf::Writer writer;
+    writer.prepare(out, record);
+
+    nitf::ImageWriter imageWriter = writer.newImageWriter(0);
+    nitf::ImageSource imageSource;
+    nitf::BandSource bandSource = nitf::MemorySource(image.data(), image.size(), 0, 1, 0);
+    imageSource.addBand(bandSource);
+    imageWriter.attachSource(imageSource);
+    writer.write();
+
+    return image;
+}
+
+TEST_CASE(test_block_cache)
+{
+    const std::string outname("test_block_cache.nitf");
+    constexpr uint32_t numRowsPerBlock = 12; // 3 x 4 blocks
+    constexpr uint32_t numColsPerBlock = 47;
+    constexpr uint64_t blockBytes = numRowsPerBlock * numColsPerBlock;
+    constexpr uint32_t numBlocksPerRow = 4;
+    const auto numCols = NITRO_IMAGE.width;
+    const auto image = test_block_cache__writeNITF(outname, numRowsPerBlock, numColsPerBlock);
+
+    nitf::IOHandle handle(outname, NITF_ACCESS_READONLY, NITF_OPEN_EXISTING);
+    nitf::Reader reader;
+    nitf::Record record = reader.read(handle);
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    // Room for two blocks: 0 is used again before 2 is read, so 1 goes
+    {
+        nitf::ImageReader imageReader = reader.newImageReader(0);
+        imageReader.setBlockCacheSize(2 * blockBytes);
+
+        for (const uint32_t blockNumber : { 0, 1, 0, 2, 0, 1 })
+        {
+            uint64_t blockSize;
+            const auto block = imageReader.readBlock(blockNumber, &blockSize);
+            TEST_ASSERT_EQ(blockSize, blockBytes);
+
+            const auto blockRow = blockNumber / numBlocksPerRow;
+            const auto blockCol = blockNumber % numBlocksPerRow;
+            for (uint32_t row = 0; row < numRowsPerBlock; ++row)
+            {
+                for (uint32_t col = 0; col < numColsPerBlock; ++col)
+                {
+                    const auto pixel = (blockRow * numRowsPerBlock + row) * numCols +
+                        blockCol * numColsPerBlock + col;
+                    TEST_ASSERT_EQ(block[row * numColsPerBlock + col], image[pixel]);
+                }
+            }
+        }
+        imageReader.getBlockCacheStats(hits, misses);
+        TEST_ASSERT_EQ(hits, static_cast<uint64_t>(2));
+        TEST_ASSERT_EQ(misses, static_cast<uint64_t>(4));
+    }
+
+    // Room for a row of blocks: a full read decodes each block only once
+    {
+        nitf::ImageReader imageReader = reader.newImageReader(0);
+        imageReader.setBlockCacheSize(numBlocksPerRow * blockBytes);
+
+        std::vector<uint8_t> buffer(image.size());
+        uint8_t* bands[] = { buffer.data() };
+        uint32_t bandList[] = { 0 };
+        const nitf::SubWindow subWindow(NITRO_IMAGE.height, numCols, bandList, 1);
+        int padded;
+        imageReader.read(subWindow, bands, &padded);
+        TEST_ASSERT(buffer == image);
+
+        imageReader.getBlockCacheStats(hits, misses);
+        TEST_ASSERT_EQ(misses, static_cast<uint64_t>(12));
+        TEST_ASSERT(hits > 0);
+    }
+
+    // Back to zero: uncompressed images go back to reading around the cache
+    {
+        nitf::ImageReader imageReader = reader.newImageReader(0);
+        imageReader.setBlockCacheSize(numBlocksPerRow * blockBytes);
+        imageReader.setBlockCacheSize(0);
+
+        std::vector<uint8_t> buffer(image.size());
+        uint8_t* bands[] = { buffer.data() };
+        uint32_t bandList[] = { 0 };
+        const nitf::SubWindow subWindow(NITRO_IMAGE.height, numCols, bandList, 1);
+        int padded;
+        imageReader.read(subWindow, bands, &padded);
+        TEST_ASSERT(buffer == image);
+
+        imageReader.getBlockCacheStats(hits, misses);
+        TEST_ASSERT_EQ(hits, static_cast<uint64_t>(0));
+        TEST_ASSERT_EQ(misses, static_cast<uint64_t>(0));
+    }
+}
+
+
 static void RecordThread_run()
     {
         nitf::Record record(NITF_VER_21);
@@ -488,4 +613,5 @@ TEST_MAIN(
     TEST_CHECK(test_create_nitf_with_byte_provider_test);
     TEST_CHECK(test_create_nitf_test);
     TEST_CHECK(test_mt_record);
+    TEST_CHECK(test_block_cache);
 )
\ No newline at end of file
@@ -865,6 +865,35 @@ NITFPROT(void) nitf_ImageIO_setReadCaching
     nitf_ImageIO * nitf      /*!< Object to modify */
 );
 
+/*!
+  \brief nitf_ImageIO_setBlockCacheSize - Set the read block cache limit
+
+  See the documentation for nitf_ImageReader_setBlockCacheSize
+
+  \return None
+*/
+
+NITFPROT(void) nitf_ImageIO_setBlockCacheSize
+(
+    nitf_ImageIO * nitf,     /*!< Object to modify */
+    uint64_t maxBytes        /*!< Cache size limit in bytes */
+);
+
+/*!
+  \brief nitf_ImageIO_getBlockCacheStats - Get read block cache counters
+
+  See the documentation for nitf_ImageReader_getBlockCacheStats
+
+  \return None
+*/
+
+NITFPROT(void) nitf_ImageIO_getBlockCacheStats
+(
+    nitf_ImageIO * nitf,     /*!< Object to query */
+    uint64_t * hits,         /*!< Returns reads satisfied from the cache */
+    uint64_t * misses        /*!< Returns reads that had to read a block */
+);
+
 /*!
   \brief nitf_BlockingInfo_print - Print blocking information
 
@@ -91,6 +91,70 @@ NITFAPI(void) nitf_ImageReader_setReadCaching
     nitf_ImageReader * iReader  /*!< Object to modify */
 );
 
+/*!
+  \brief nitf_ImageReader_setBlockCacheSize - Set the read block cache limit
+
+  nitf_ImageReader_setBlockCacheSize sets how many bytes of whole blocks
+  (decompressed, for compressed images) the reader keeps between reads.
+  Blocks are freed least recently used first, but the block most recently
+  read is always kept, so the default limit of zero caches one block.
+  The cache belongs to the reader and is shared by all of its reads and
+  direct block reads; use one reader for overlapping windows, such as the
+  tiles of a viewer, to avoid reading and decompressing blocks again.
+
+  A non-zero limit also enables cached reads (see
+  nitf_ImageReader_setReadCaching); setting it back to zero restores the
+  previous reader, unless cached reads were enabled explicitly. Lowering
+  the limit frees blocks immediately.
+
+  \return None
+*/
+
+NITFAPI(void) nitf_ImageReader_setBlockCacheSize
+(
+    nitf_ImageReader * iReader, /*!< Object to modify */
+    uint64_t maxBytes           /*!< Cache size limit in bytes */
+);
+
+/*!
+  \brief nitf_ImageReader_getBlockCacheStats - Get read block cache counters
+
+  nitf_ImageReader_getBlockCacheStats returns the number of block lookups
+  satisfied from the cache and the number that read the block from the
+  file, counted over the life of the reader. Either pointer may be NULL.
+
+  \return None
+*/
+
+NITFAPI(void) nitf_ImageReader_getBlockCacheStats
+(
+    nitf_ImageReader * iReader, /*!< Object to query */
+    uint64_t * hits,            /*!< Returns reads satisfied from the cache */
+    uint64_t * misses           /*!< Returns reads that had to read a block */
+);
+
+/*!
+  \brief nitf_ImageReader_setInput - Read pixels through another interface
+
+  nitf_ImageReader_setInput makes later reads go through 'input' instead of
+  the nitf_Reader's input. 'input' must be the same file (or a copy of it),
+  since the segment's offsets were taken from the nitf_Reader's record.
+  This lets readers for different segments read concurrently, each with
+  its own file position, without parsing the headers again.
+
+  Call this before the first read; compressed images hold on to the
+  interface their decompressor was started with. The reader does not take
+  ownership of 'input', which must outlive it.
+
+  \return None
+*/
+
+NITFAPI(void) nitf_ImageReader_setInput
+(
+    nitf_ImageReader * iReader, /*!< Object to modify */
+    nitf_IOInterface * input    /*!< Interface to read pixels from */
+);
+
 NITF_CXX_ENDGUARD
 
 #endif
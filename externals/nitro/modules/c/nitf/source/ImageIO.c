@@ -428,8 +428,8 @@ _nitf_ImageIOParameters;
 /*!
   \brief _nitf_ImageIOBlockCacheControl - Block cache control
 
-  The _nitf_ImageIOBlockCacheControl structure manages the block cache used by
-  the cached reader.
+  The _nitf_ImageIOBlockCacheControl structure manages the block buffer used
+  by the cached writer. Reads are cached by _nitf_ImageIOReadCache.
 
   If there is no block in a block buffer, the corresponding block number
   will be set to NITF_IMAGE_IO_NO_BLOCK.
@@ -451,6 +451,51 @@ typedef struct
 }
 _nitf_ImageIOBlockCacheControl;
 
+/*!
+  \brief _nitf_ImageIOCachedBlock - One block in the read block cache
+
+  Blocks are kept in a doubly linked list ordered by last use. The buffer
+  is either allocated by the system memory allocation facility or returned
+  by the decompression plugin's readBlock, in which case it must be freed
+  by the plugin's freeBlock.
+*/
+
+typedef struct _nitf_ImageIOCachedBlock
+{
+    uint32_t number;         /*!< Block number */
+    uint8_t *block;          /*!< Block buffer */
+    uint64_t size;           /*!< Block buffer size in bytes */
+    NITF_BOOL decompressed;     /*!< Buffer belongs to the decompressor if TRUE */
+    struct _nitf_ImageIOCachedBlock *newer; /*!< Next more recently used */
+    struct _nitf_ImageIOCachedBlock *older; /*!< Next less recently used */
+}
+_nitf_ImageIOCachedBlock;
+
+/*!
+  \brief _nitf_ImageIOReadCache - Read block cache
+
+  The _nitf_ImageIOReadCache structure manages the block cache used by the
+  cached reader and by direct block reads. Whole blocks (decompressed, for
+  compressed images) are kept until the total size would exceed maxBytes,
+  then the least recently used blocks are freed. The block just read is
+  always kept, so a maxBytes of zero is a cache of one block.
+
+  The byNumber table has one entry per block and is allocated on first use.
+*/
+
+typedef struct
+{
+    uint64_t maxBytes;       /*!< Cache size limit in bytes */
+    uint64_t bytes;          /*!< Bytes currently cached */
+    _nitf_ImageIOCachedBlock *newest;  /*!< Most recently used block */
+    _nitf_ImageIOCachedBlock *oldest;  /*!< Least recently used block */
+    _nitf_ImageIOCachedBlock **byNumber; /*!< Cached blocks by block number */
+    uint32_t numBlocks;      /*!< Length of byNumber */
+    uint64_t hits;           /*!< Reads satisfied from the cache */
+    uint64_t misses;         /*!< Reads that had to read a block */
+}
+_nitf_ImageIOReadCache;
+
 /*!
   \brief _nitf_ImageIO - Object private data structure
 
@@ -501,8 +546,11 @@ typedef struct
     uint64_t dataLength;     /*!< Length of the data including masks */
     /*!< Configuration parameters */
     _nitf_ImageIOParameters parameters;
-    /*!< Block control */
-    _nitf_ImageIOBlockCacheControl blockControl;
+    /*!< Read block cache */
+    _nitf_ImageIOReadCache readCache;
+    /*!< Reader to restore when the cache size goes back to zero, NULL if
+      the cache size did not switch to cached reads */
+    _NITF_IMAGE_IO_IO_FUNC readerBeforeCache;
     /*!< Compression handler function */
     nitf_CompressionInterface *compressor;
     /*!< Decompression handler function */
@@ -2087,6 +2135,67 @@ I/O errors
 int nitf_ImageIO_cachedReader(_nitf_ImageIOBlock * blockIO, nitf_IOInterface* io, nitf_Error * error      /*!< Error object */
                              );
 
+/*!
+  \brief nitf_ImageIO_getCachedBlock - Get a block through the read cache
+
+  nitf_ImageIO_getCachedBlock returns the requested block from the read
+  block cache, reading (and if necessary decompressing) it on a miss. Least
+  recently used blocks are freed to keep the cache within its size limit.
+  The returned buffer remains valid until the next miss.
+
+  \b Note:
+
+  This is an internal function and is not intended to be called directly by
+the user.
+
+\return Returns NULL on error
+
+On error, the error object is set. Possible errors include:
+
+Memory allocation error
+I/O errors
+Decompression errors
+*/
+
+NITFPRIV(uint8_t *) nitf_ImageIO_getCachedBlock(_nitf_ImageIO * nitf,
+                                                nitf_IOInterface* io,
+                                                uint32_t blockNumber,
+                                                uint64_t imageDataOffset,
+                                                uint64_t * blockSize,
+                                                nitf_Error * error);
+
+/*!
+  \brief nitf_ImageIO_freeOldestBlock - Free the least recently used block
+
+  nitf_ImageIO_freeOldestBlock removes the least recently used block from
+  the read block cache, if there is one, and frees it.
+
+  \b Note:
+
+  This is an internal function and is not intended to be called directly by
+the user.
+
+  \return None
+*/
+
+NITFPRIV(void) nitf_ImageIO_freeOldestBlock(_nitf_ImageIO * nitf);
+
+/*!
+  \brief nitf_ImageIO_clearReadCache - Free all cached blocks
+
+  nitf_ImageIO_clearReadCache frees every block in the read block cache and
+  the block table. The size limit and the counters are not changed.
+
+  \b Note:
+
+  This is an internal function and is not intended to be called directly by
+the user.
+
+  \return None
+*/
+
+NITFPRIV(void) nitf_ImageIO_clearReadCache(_nitf_ImageIO * nitf);
+
 /*!
   \brief nitf_ImageIO_uncachedWriter - Write pixel data to a file without
    block caching
@@ -3175,9 +3284,7 @@ NITFPROT(nitf_ImageIO *) nitf_ImageIO_construct(
     nitf->decompressor = decompressor;
     nitf->compressionControl = NULL;
     nitf->decompressionControl = NULL;
-    nitf->blockControl.number = NITF_IMAGE_IO_NO_BLOCK;
-    nitf->blockControl.freeFlag = 1;
-    nitf->blockControl.block = NULL;
+    memset(&(nitf->readCache), 0, sizeof(_nitf_ImageIOReadCache));
     nitf->cachedWriteFlag = 0;
 
     nitf_ImageIO_setDefaultParameters(nitf);
@@ -3299,8 +3406,8 @@ NITFPROT(nitf_ImageIO *) nitf_ImageIO_clone(nitf_ImageIO * image,
 
     clone->blockInfoFlag = 0;
 
-    memset(&(clone->blockControl), 0,
-           sizeof(_nitf_ImageIOBlockCacheControl));
+    memset(&(clone->readCache), 0, sizeof(_nitf_ImageIOReadCache));
+    clone->readCache.maxBytes = ((_nitf_ImageIO *) image)->readCache.maxBytes;
 
     clone->decompressionControl = NULL;
 
@@ -3314,7 +3421,6 @@ NITFPROT(nitf_ImageIO *) nitf_ImageIO_clone(nitf_ImageIO * image,
 NITFPROT(void) nitf_ImageIO_destruct(nitf_ImageIO ** nitf)
 {
     _nitf_ImageIO *nitfp;       /* Pointer to internal type */
-    nitf_Error error;           /* For decompressor free block call */
 
     if (*nitf == NULL)
         return;
@@ -3327,16 +3433,7 @@ NITFPROT(void) nitf_ImageIO_destruct(nitf_ImageIO ** nitf)
     if (nitfp->padMask != NULL)
         NITF_FREE(nitfp->padMask);
 
-    if (nitfp->blockControl.block != NULL)
-    {
-        /* No plugin */
-        if (nitfp->decompressor == NULL)
-            NITF_FREE(nitfp->blockControl.block);
-        else
-            (*(nitfp->decompressor->freeBlock)) (nitfp->decompressionControl,
-                                                 nitfp->blockControl.block,
-                                                 &error);
-    }
+    nitf_ImageIO_clearReadCache(nitfp);
 
     /* Have a plugin with "destructor" */
     if ((nitfp->decompressor != NULL) && (nitfp->decompressor->destroyControl != NULL))
@@ -3971,6 +4068,49 @@ NITFPROT(void) nitf_ImageIO_setReadCaching(nitf_ImageIO * nitf)
 
     initf = (_nitf_ImageIO *) nitf;
     initf->vtbl.reader = nitf_ImageIO_cachedReader;
+    initf->readerBeforeCache = NULL;  /* Explicit, so keep it */
+
+    return;
+}
+
+NITFPROT(void) nitf_ImageIO_setBlockCacheSize(nitf_ImageIO * nitf,
+                                              uint64_t maxBytes)
+{
+    _nitf_ImageIO *initf;   /* Internal representation of object */
+
+    initf = (_nitf_ImageIO *) nitf;
+    initf->readCache.maxBytes = maxBytes;
+
+    /* Always keep the most recently used block */
+    while ((initf->readCache.oldest != initf->readCache.newest)
+            && (initf->readCache.bytes > maxBytes))
+        nitf_ImageIO_freeOldestBlock(initf);
+
+    if ((maxBytes > 0) && (initf->vtbl.reader != nitf_ImageIO_cachedReader))
+    {
+        initf->readerBeforeCache = initf->vtbl.reader;
+        initf->vtbl.reader = nitf_ImageIO_cachedReader;
+    }
+    else if ((maxBytes == 0) && (initf->readerBeforeCache != NULL))
+    {
+        initf->vtbl.reader = initf->readerBeforeCache;
+        initf->readerBeforeCache = NULL;
+    }
+
+    return;
+}
+
+NITFPROT(void) nitf_ImageIO_getBlockCacheStats(nitf_ImageIO * nitf,
+                                               uint64_t * hits,
+                                               uint64_t * misses)
+{
+    _nitf_ImageIO *initf;   /* Internal representation of object */
+
+    initf = (_nitf_ImageIO *) nitf;
+    if (hits != NULL)
+        *hits = initf->readCache.hits;
+    if (misses != NULL)
+        *misses = initf->readCache.misses;
 
     return;
 }
@@ -7425,68 +7565,17 @@ int nitf_ImageIO_cachedReader(_nitf_ImageIOBlock * blockIO,
     }
     else
     {
-        if (nitf->blockControl.number != blockIO->number)
-        {
-            if ((nitf->pixel.type != NITF_IMAGE_IO_PIXEL_TYPE_B)
-                  && (nitf->pixel.type != NITF_IMAGE_IO_PIXEL_TYPE_12)
-                     && (nitf->compression & NITF_IMAGE_IO_NO_COMPRESSION))
-            {
-                /* Allocate block buffer if required */
-                if (nitf->blockControl.block == NULL)
-                {
-                    nitf->blockControl.block =
-                        (uint8_t *) NITF_MALLOC(nitf->blockSize);
-                    if (nitf->blockControl.block == NULL)
-                    {
-                        nitf_Error_initf(error, NITF_CTXT, NITF_ERR_MEMORY,
-                                         "Error allocating block buffer: %s",
-                                         NITF_STRERROR(NITF_ERRNO));
-                        return NITF_FAILURE;
-                    }
-                }
-                /* Read the block */
-
-                if (!nitf_ImageIO_readFromFile(io,
-                                               blockIO->cntl->nitf->
-                                               pixelBase +
-                                               blockIO->imageDataOffset,
-                                               nitf->blockControl.block,
-                                               nitf->blockSize, error))
-                    return NITF_FAILURE;
-            }
-            else
-            {
-                /* Decompression interface structure */
-                nitf_DecompressionInterface* decompInterface;
+        uint8_t *block;          /* Cached block */
 
-                /* No plugin */
-                if (nitf->decompressor == NULL)
-                {
-                    nitf_Error_initf(error, NITF_CTXT,
-                                     NITF_ERR_DECOMPRESSION,
-                                     "No decompression plugin for compressed type");
-                    return NITF_FAILURE;
-                }
-
-                decompInterface = nitf->decompressor;
-                if (nitf->blockControl.block != NULL)
-                    (*(decompInterface->freeBlock)) (nitf->decompressionControl,
-                                                     nitf->blockControl.block,
-                                                     error);
-                nitf->blockControl.block =
-                    (*(decompInterface->readBlock)) (nitf->decompressionControl,
-                                                     blockIO->number,
-                                                     &blockSize,
-                                                     error);
-                if (nitf->blockControl.block == NULL)
-                    return NITF_FAILURE;
-            }
-            nitf->blockControl.number = blockIO->number;
-        }
+        block = nitf_ImageIO_getCachedBlock(nitf, io, blockIO->number,
+                                            blockIO->imageDataOffset,
+                                            &blockSize, error);
+        if (block == NULL)
+            return NITF_FAILURE;
 
         /* Get data from block */
         memcpy(blockIO->rwBuffer.buffer + blockIO->rwBuffer.offset.mark,
-               nitf->blockControl.block + blockIO->blockOffset.mark,
+               block + blockIO->blockOffset.mark,
                blockIO->readCount);
 
         if (blockIO->padMask[blockIO->number] != NITF_IMAGE_IO_NO_OFFSET)
@@ -7496,6 +7585,204 @@ int nitf_ImageIO_cachedReader(_nitf_ImageIOBlock * blockIO,
     }
 }
 
+NITFPRIV(uint8_t *) nitf_ImageIO_getCachedBlock(_nitf_ImageIO * nitf,
+                                                nitf_IOInterface* io,
+                                                uint32_t blockNumber,
+                                                uint64_t imageDataOffset,
+                                                uint64_t * blockSize,
+                                                nitf_Error * error)
+{
+    _nitf_ImageIOReadCache *cache;     /* The read block cache */
+    _nitf_ImageIOCachedBlock *entry;   /* Cache entry for the block */
+
+    cache = &(nitf->readCache);
+
+    /* Allocate the block table if required */
+    if (cache->byNumber == NULL)
+    {
+        cache->byNumber = (_nitf_ImageIOCachedBlock **)
+            NITF_MALLOC(nitf->nBlocksTotal * sizeof(_nitf_ImageIOCachedBlock *));
+        if (cache->byNumber == NULL)
+        {
+            nitf_Error_initf(error, NITF_CTXT, NITF_ERR_MEMORY,
+                             "Error allocating block cache: %s",
+                             NITF_STRERROR(NITF_ERRNO));
+            return NULL;
+        }
+        memset(cache->byNumber, 0,
+               nitf->nBlocksTotal * sizeof(_nitf_ImageIOCachedBlock *));
+        cache->numBlocks = nitf->nBlocksTotal;
+    }
+
+    if (blockNumber >= cache->numBlocks)
+    {
+        nitf_Error_initf(error, NITF_CTXT, NITF_ERR_INVALID_PARAMETER,
+                         "Block number %u out of range (%u blocks)",
+                         blockNumber, cache->numBlocks);
+        return NULL;
+    }
+
+    entry = cache->byNumber[blockNumber];
+    if (entry != NULL)
+    {
+        cache->hits += 1;
+
+        /* Move to the front of the list */
+        if (entry != cache->newest)
+        {
+            entry->newer->older = entry->older;
+            if (entry->older != NULL)
+                entry->older->newer = entry->newer;
+            else
+                cache->oldest = entry->newer;
+
+            entry->older = cache->newest;
+            entry->newer = NULL;
+            cache->newest->newer = entry;
+            cache->newest = entry;
+        }
+
+        *blockSize = entry->size;
+        return entry->block;
+    }
+
+    cache->misses += 1;
+
+    entry = (_nitf_ImageIOCachedBlock *)
+        NITF_MALLOC(sizeof(_nitf_ImageIOCachedBlock));
+    if (entry == NULL)
+    {
+        nitf_Error_initf(error, NITF_CTXT, NITF_ERR_MEMORY,
+                         "Error allocating block cache entry: %s",
+                         NITF_STRERROR(NITF_ERRNO));
+        return NULL;
+    }
+    entry->number = blockNumber;
+
+    if ((nitf->pixel.type != NITF_IMAGE_IO_PIXEL_TYPE_B)
+        && (nitf->pixel.type != NITF_IMAGE_IO_PIXEL_TYPE_12)
+        && (nitf->compression & NITF_IMAGE_IO_NO_COMPRESSION))
+    {
+        /* Make room before allocating, the size is known */
+        while ((cache->oldest != NULL)
+                && (cache->bytes + nitf->blockSize > cache->maxBytes))
+            nitf_ImageIO_freeOldestBlock(nitf);
+
+        entry->block = (uint8_t *) NITF_MALLOC(nitf->blockSize);
+        if (entry->block == NULL)
+        {
+            nitf_Error_initf(error, NITF_CTXT, NITF_ERR_MEMORY,
+                             "Error allocating block buffer: %s",
+                             NITF_STRERROR(NITF_ERRNO));
+            NITF_FREE(entry);
+            return NULL;
+        }
+
+        /* Read the block */
+
+        if (!nitf_ImageIO_readFromFile(io,
+                                       nitf->pixelBase + imageDataOffset,
+                                       entry->block,
+                                       nitf->blockSize, error))
+        {
+            NITF_FREE(entry->block);
+            NITF_FREE(entry);
+            return NULL;
+        }
+        entry->size = nitf->blockSize;
+        entry->decompressed = 0;
+    }
+    else
+    {
+        /* Decompression interface structure */
+        nitf_DecompressionInterface* decompInterface;
+
+        /* No plugin */
+        if (nitf->decompressor == NULL)
+        {
+            nitf_Error_initf(error, NITF_CTXT,
+                             NITF_ERR_DECOMPRESSION,
+                             "No decompression plugin for compressed type");
+            NITF_FREE(entry);
+            return NULL;
+        }
+
+        decompInterface = nitf->decompressor;
+        entry->block =
+            (*(decompInterface->readBlock)) (nitf->decompressionControl,
+                                             blockNumber,
+                                             &(entry->size),
+                                             error);
+        if (entry->block == NULL)
+        {
+            NITF_FREE(entry);
+            return NULL;
+        }
+        entry->decompressed = 1;
+
+        while ((cache->oldest != NULL)
+                && (cache->bytes + entry->size > cache->maxBytes))
+            nitf_ImageIO_freeOldestBlock(nitf);
+    }
+
+    /* Add to the front of the list */
+    entry->newer = NULL;
+    entry->older = cache->newest;
+    if (cache->newest != NULL)
+        cache->newest->newer = entry;
+    else
+        cache->oldest = entry;
+    cache->newest = entry;
+    cache->byNumber[blockNumber] = entry;
+    cache->bytes += entry->size;
+
+    *blockSize = entry->size;
+    return entry->block;
+}
+
+NITFPRIV(void) nitf_ImageIO_freeOldestBlock(_nitf_ImageIO * nitf)
+{
+    _nitf_ImageIOReadCache *cache;     /* The read block cache */
+    _nitf_ImageIOCachedBlock *entry;   /* Block to free */
+    nitf_Error error;           /* For decompressor free block call */
+
+    cache = &(nitf->readCache);
+    entry = cache->oldest;
+    if (entry == NULL)
+        return;
+
+    cache->oldest = entry->newer;
+    if (cache->oldest != NULL)
+        cache->oldest->older = NULL;
+    else
+        cache->newest = NULL;
+
+    cache->byNumber[entry->number] = NULL;
+    cache->bytes -= entry->size;
+
+    if (entry->decompressed)
+        (*(nitf->decompressor->freeBlock)) (nitf->decompressionControl,
+                                            entry->block, &error);
+    else
+        NITF_FREE(entry->block);
+    NITF_FREE(entry);
+    return;
+}
+
+NITFPRIV(void) nitf_ImageIO_clearReadCache(_nitf_ImageIO * nitf)
+{
+    while (nitf->readCache.oldest != NULL)
+        nitf_ImageIO_freeOldestBlock(nitf);
+
+    if (nitf->readCache.byNumber != NULL)
+    {
+        NITF_FREE(nitf->readCache.byNumber);
+        nitf->readCache.byNumber = NULL;
+    }
+    nitf->readCache.numBlocks = 0;
+    return;
+}
+
 /*========================= Start Direct Block Reading  ================================*/
 NITFPROT(NRT_BOOL) nitf_ImageIO_setupDirectBlockRead(nitf_ImageIO *nitf,
                                                      nitf_IOInterface *io,
@@ -7545,69 +7832,8 @@ NITFPROT(uint8_t*) nitf_ImageIO_readBlockDirect(nitf_ImageIO* nitf,
     nitfI = (_nitf_ImageIO*) nitf;
     imageDataOffset = nitfI->blockMask[blockNumber];
 
-    if (nitfI->blockControl.number != blockNumber)
-    {
-        if ((nitfI->pixel.type != NITF_IMAGE_IO_PIXEL_TYPE_B)
-            && (nitfI->pixel.type != NITF_IMAGE_IO_PIXEL_TYPE_12)
-            && (nitfI->compression & NITF_IMAGE_IO_NO_COMPRESSION))
-        {
-            /* Allocate block buffer if required */
-            if (nitfI->blockControl.block == NULL)
-            {
-                nitfI->blockControl.block =
-                    (uint8_t *) NITF_MALLOC(nitfI->blockSize);
-                if (nitfI->blockControl.block == NULL)
-                {
-                    nitf_Error_initf(error, NITF_CTXT, NITF_ERR_MEMORY,
-                                     "Error allocating block buffer: %s",
-                                     NITF_STRERROR(NITF_ERRNO));
-                    return NULL;
-                }
-            }
-            /* Read the block */
-
-            if (!nitf_ImageIO_readFromFile(io,
-                                           nitfI->pixelBase + imageDataOffset,
-                                           nitfI->blockControl.block,
-                                           nitfI->blockSize, error))
-            {
-                return NULL;
-            }
-
-            *blockSize = nitfI->blockSize;
-        }
-        else
-        {
-            /* Decompression interface structure */
-            nitf_DecompressionInterface* decompInterface;
-
-            /* No plugin */
-            if (nitfI->decompressor == NULL)
-            {
-                nitf_Error_initf(error, NITF_CTXT,
-                                 NITF_ERR_DECOMPRESSION,
-                                 "No decompression plugin for compressed type");
-                return NULL;
-            }
-
-            decompInterface = nitfI->decompressor;
-            if (nitfI->blockControl.block != NULL)
-                (*(decompInterface->freeBlock)) (nitfI->decompressionControl,
-                                                 nitfI->blockControl.block,
-                                                 error);
-            nitfI->blockControl.block =
-                (*(decompInterface->readBlock)) (nitfI->decompressionControl,
-                                                 blockNumber, blockSize,
-                                                 error);
-            if (nitfI->blockControl.block == NULL)
-            {
-                return NULL;
-            }
-        }
-        nitfI->blockControl.number = blockNumber;
-    }
-
-    return nitfI->blockControl.block;
+    return nitf_ImageIO_getCachedBlock(nitfI, io, blockNumber,
+                                       imageDataOffset, blockSize, error);
 }
 
 /*========================= End Direct Block Reading  ================================*/
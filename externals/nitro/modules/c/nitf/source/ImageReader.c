@@ -99,3 +99,25 @@ NITFPROT(void) nitf_ImageReader_setReadCaching(nitf_ImageReader * iReader)
     nitf_ImageIO_setReadCaching(iReader->imageDeblocker);
     return;
 }
+
+NITFAPI(void) nitf_ImageReader_setBlockCacheSize(nitf_ImageReader * iReader,
+                                                 uint64_t maxBytes)
+{
+    nitf_ImageIO_setBlockCacheSize(iReader->imageDeblocker, maxBytes);
+    return;
+}
+
+NITFAPI(void) nitf_ImageReader_getBlockCacheStats(nitf_ImageReader * iReader,
+                                                  uint64_t * hits,
+                                                  uint64_t * misses)
+{
+    nitf_ImageIO_getBlockCacheStats(iReader->imageDeblocker, hits, misses);
+    return;
+}
+
+NITFAPI(void) nitf_ImageReader_setInput(nitf_ImageReader * iReader,
+                                        nitf_IOInterface * input)
+{
+    iReader->input = input;
+    return;
+}
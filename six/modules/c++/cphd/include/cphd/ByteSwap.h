@@ -93,6 +93,54 @@ void byteSwapAndScale(const void* input,
                       const double* scaleFactors,
                       size_t numThreads,
                       std::complex<float>* output);
+/*
+ *  \func promote
+ *  \brief Threaded promotion of native byte order input to complex<floats>
+ *
+ *  Valid input types:
+ *     int8_t
+ *     int16_t
+ *     sys::float
+ *
+ *  \param input Input to promote
+ *  \param elementSize Size of each element in 'input'
+ *  \param dims Number of rows and cols of elements in 'input'
+ *  \param numThreads Number of threads to use for promotion
+ *  \param output Pointer to output array of complex<float>
+ *
+ *  \throws If elementSize is not one of (2,4 or 8)
+ */
+void promote(const void* input,
+             size_t elementSize,
+             const types::RowCol<size_t>& dims,
+             size_t numThreads,
+             std::complex<float>* output);
+
+/*
+ *  \func scale
+ *  \brief Threaded promotion and scaling of native byte order input
+ *
+ *  Valid input types:
+ *     int8_t
+ *     int16_t
+ *     sys::float
+ *
+ *  \param input Input to promote and scale
+ *  \param elementSize Size of each element in 'input'
+ *  \param dims Number of rows and cols of elements in 'input'
+ *  \param scaleFactors pointer to num rows size array of doubles
+ *         to scale the input
+ *  \param numThreads Number of threads to use for scaling
+ *  \param output Pointer to output array of scaled complex<float>
+ *
+ *  \throws If elementSize is not one of (2,4 or 8)
+ */
+void scale(const void* input,
+           size_t elementSize,
+           const types::RowCol<size_t>& dims,
+           const double* scaleFactors,
+           size_t numThreads,
+           std::complex<float>* output);
 }
 
 #endif
@@ -64,6 +64,10 @@ struct CPHDReader final
      *  \func CPHDReader constructor
      *  \brief Construct CPHDReader from a file pathname
      *
+     *  Metadata is taken from MetadataCache::getInstance() when it is
+     *  enabled and already holds this version of the file, parsed
+     *  against the same 'schemaPaths'.
+     *
      *  \param fromFile File path of CPHD file
      *  \param numThreads Number of threads for parallelization
      *  \param schemaPaths (Optional) XML schemas for validation
@@ -154,8 +158,10 @@ private:
 
     /*
      *  Read in header, metadata, supportblock, pvpblock and wideband
+     *  Metadata is cached by 'pathname' unless it is empty.
      */
     void initialize(std::shared_ptr<io::SeekableInputStream> inStream,
+                    const std::string& pathname,
                     size_t numThreads,
                     std::shared_ptr<logging::Logger> logger,
                     const std::vector<std::string>& schemaPaths);
@@ -24,7 +24,12 @@
 #define __CPHD_CPHD_WRITER_H__
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <scene/sys_Conf.h>
@@ -91,7 +96,11 @@ protected:
  *
  *  \brief Class to handle writing to output stream and byte swapping
  *
- *  For little endian to big endian storage
+ *  For little endian to big endian storage. The scratch space is split
+ *  into several buffers, and a background thread writes each one to the
+ *  stream while the next is being filled and swapped. Every call returns
+ *  only after its data has been written, so the stream can be used
+ *  directly between calls.
  */
 struct DataWriterLittleEndian final : public DataWriter
 {
@@ -101,11 +110,17 @@ struct DataWriterLittleEndian final : public DataWriter
      *
      *  \param stream The seekable output stream to be written
      *  \param numThreads Number of threads for parallel processing
-     *  \param scratchSize Size of buffer to be used for scratch space
+     *  \param scratchSize Total size of the scratch buffers
+     *  \param numBuffers (Optional) Number of buffers 'scratchSize' is split
+     *  into; this is how many chunks can be queued for writing at once
      */
     DataWriterLittleEndian(std::shared_ptr<io::SeekableOutputStream> stream,
                            size_t numThreads,
-                           size_t scratchSize);
+                           size_t scratchSize,
+                           size_t numBuffers = 2);
+
+    //! Stops the writer thread
+    ~DataWriterLittleEndian();
 
     /*
      *  \func operator()
@@ -126,9 +141,28 @@ struct DataWriterLittleEndian final : public DataWriter
     }
 
 
+    DataWriterLittleEndian(const DataWriterLittleEndian&) = delete;
+    DataWriterLittleEndian& operator=(const DataWriterLittleEndian&) = delete;
+
 private:
-    // Scratch space buffer
-    std::vector<std::byte> mScratch;
+    // Writes queued buffers to the stream, in order
+    void writeQueued();
+    // Waits until every queued buffer is written, then rethrows any
+    // error from the writer thread
+    void waitForWrites();
+
+    // Scratch space buffers, used round robin
+    std::vector<std::vector<std::byte> > mScratch;
+    // Bytes of each buffer waiting to be written, 0 if the buffer is free
+    std::vector<size_t> mPending;
+
+    // Indices of filled buffers, in write order
+    std::deque<size_t> mQueue;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::exception_ptr mError;
+    bool mStop = false;
+    std::thread mWriter;
 };
 
 /*
@@ -197,15 +231,20 @@ struct CPHDWriter
      *  \param schemaPaths (Optional) A vector of XML schema paths for validation
      *  \param numThreads (Optional) The number of threads to use for processing.
      *  \param scratchSpaceSize (Optional) The maximum size of internal scratch space
-     *         that may be used if byte swapping is necessary.
+     *         that may be used if byte swapping is necessary. It is split
+     *         into numScratchBuffers buffers so swapping overlaps writing.
      *         Default is 4 MB
+     *  \param numScratchBuffers (Optional) Number of buffers the scratch
+     *         space is split into; this is how many chunks can be queued
+     *         for writing at once. Default is 2
      */
     CPHDWriter(
             const Metadata& metadata,
             std::shared_ptr<io::SeekableOutputStream> stream,
             const std::vector<std::string>& schemaPaths = std::vector<std::string>(),
             size_t numThreads = 0,
-            size_t scratchSpaceSize = 4 * 1024 * 1024);
+            size_t scratchSpaceSize = 4 * 1024 * 1024,
+            size_t numScratchBuffers = 2);
 
     /*
      *  \func Constructor
@@ -223,15 +262,20 @@ struct CPHDWriter
      *  \param schemaPaths (Optional) A vector of XML schema paths for validation
      *  \param numThreads (Optional) The number of threads to use for processing.
      *  \param scratchSpaceSize (Optional) The maximum size of internal scratch space
-     *         that may be used if byte swapping is necessary.
+     *         that may be used if byte swapping is necessary. It is split
+     *         into numScratchBuffers buffers so swapping overlaps writing.
      *         Default is 4 MB
+     *  \param numScratchBuffers (Optional) Number of buffers the scratch
+     *         space is split into; this is how many chunks can be queued
+     *         for writing at once. Default is 2
      */
     CPHDWriter(
             const Metadata& metadata,
             const std::string& pathname,
             const std::vector<std::string>& schemaPaths = std::vector<std::string>(),
             size_t numThreads = 0,
-            size_t scratchSpaceSize = 4 * 1024 * 1024);
+            size_t scratchSpaceSize = 4 * 1024 * 1024,
+            size_t numScratchBuffers = 2);
 
     /*
      *  \func write
@@ -398,6 +442,8 @@ private:
     const size_t mElementSize;
     //! size of scratch space for byte swapping
     const size_t mScratchSpaceSize;
+    //! number of buffers the scratch space is split into
+    const size_t mNumScratchBuffers;
     //! number of threads for parallelism
     const size_t mNumThreads;
     //! schemas for XML validation
@@ -0,0 +1,36 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CPHD_METADATA_CACHE_H__
+#define __CPHD_METADATA_CACHE_H__
+#pragma once
+
+#include <six/MetadataCache.h>
+#include <cphd/Metadata.h>
+
+namespace cphd
+{
+//! Parsed metadata shared by every CPHDReader opened from a pathname; see
+//! six::MetadataCache
+using MetadataCache = six::MetadataCache<Metadata>;
+}
+
+#endif
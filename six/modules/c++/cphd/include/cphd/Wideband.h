@@ -52,6 +52,9 @@ struct Wideband final
 {
     static const size_t ALL;
 
+    //! Default for setMaxReadGap(), in bytes
+    static const size_t DEFAULT_MAX_READ_GAP;
+
     /*!
      *  \func Wideband
      *
@@ -408,6 +411,30 @@ struct Wideband final
         return mElementSize;
     }
 
+    /*!
+     *  \func setMaxReadGap
+     *
+     *  \brief Largest gap between vectors that a sub-window read reads
+     *  through rather than skipping
+     *
+     *  Reading only some samples of each vector leaves a gap between the
+     *  vectors of the window. Gaps up to this size are read and dropped,
+     *  so several vectors come back from one read; larger gaps get a seek
+     *  and read per vector. 0 always reads vector by vector.
+     *
+     *  \param bytes Gap threshold in bytes
+     */
+    void setMaxReadGap(size_t bytes)
+    {
+        mMaxReadGap = bytes;
+    }
+
+    //! Threshold set by setMaxReadGap()
+    size_t getMaxReadGap() const
+    {
+        return mMaxReadGap;
+    }
+
 private:
     /*
      *  Initialize mOffsets for each array
@@ -469,6 +496,7 @@ private:
     const size_t mElementSize;  // element size (bytes / complex sample)
 
     std::vector<int64_t> mOffsets;  // Offset to start of each channel
+    size_t mMaxReadGap = DEFAULT_MAX_READ_GAP;  // see setMaxReadGap()
 
     friend std::ostream& operator<<(std::ostream& os, const Wideband& d);
 };
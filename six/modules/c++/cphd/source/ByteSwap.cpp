@@ -2,7 +2,7 @@
  * This file is part of cphd-c++
  * =========================================================================
  *
- * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
  *
  * cphd-c++ is free software; you can redistribute it and/or modify
  * it under the terms of the GNU Lesser General Public License as published by
@@ -21,6 +21,7 @@
  */
 #include <cphd/ByteSwap.h>
 
+#include <string.h>
 #include <string>
 #include <std/memory>
 
@@ -29,28 +30,10 @@
 #include <mt/ThreadGroup.h>
 #include <nitf/coda-oss.hpp>
 
+#include <six/ByteSwapKernels.h>
+
 namespace
 {
-// TODO: Maybe this should go in sys/Conf.h
-//       It's more flexible in that it properly handles float's - you can't
-//       just call sys::byteSwap(floatVal) because the compiler may change the
-//       byte-swapped float value into a valid IEEE value beforehand.
-// TODO: If we're really looking to optimize this, could specialize it for
-//       sizes of 2, 4, and 8 to eliminate the for loop
-template <typename T>
-inline
-void byteSwap(const void* in, T& out)
-{
-    const std::byte* const inPtr = static_cast<const std::byte*>(in);
-    std::byte* const outPtr = reinterpret_cast<std::byte*>(&out);
-
-    for (size_t ii = 0, jj = sizeof(T) - 1; ii < jj; ++ii, --jj)
-    {
-        outPtr[ii] = inPtr[jj];
-        outPtr[jj] = inPtr[ii];
-    }
-}
-
 class ByteSwapRunnable : public sys::Runnable
 {
 public:
@@ -59,19 +42,19 @@ public:
                      size_t startElement,
                      size_t numElements) :
         mBuffer(static_cast<std::byte*>(buffer) + startElement * elemSize),
-        mElemSize(static_cast<unsigned short>(elemSize)),
+        mElemSize(elemSize),
         mNumElements(numElements)
     {
     }
 
     virtual void run()
     {
-        sys::byteSwap(mBuffer, mElemSize, mNumElements);
+        six::byteSwapElements(mBuffer, mElemSize, mNumElements);
     }
 
 private:
     std::byte* const mBuffer;
-    const unsigned short mElemSize;
+    const size_t mElemSize;
     const size_t mNumElements;
 };
 
@@ -81,149 +64,62 @@ inline const std::byte* calc_offset(const void* input_, size_t offset)
     return input + offset;
 }
 
-template <typename InT>
-class ByteSwapAndPromoteRunnable : public sys::Runnable
+class ConvertRunnable : public sys::Runnable
 {
 public:
-    ByteSwapAndPromoteRunnable(const void* input,
-                             size_t startRow,
-                             size_t numRows,
-                             size_t numCols,
-                             std::complex<float>* output) :
-        mInput(calc_offset(input, startRow * numCols * sizeof(std::complex<InT>))),
+    ConvertRunnable(six::ConvertKernel kernel,
+                    const void* input,
+                    size_t elementSize,
+                    size_t startRow,
+                    size_t numRows,
+                    size_t numCols,
+                    const double* scaleFactors,
+                    std::complex<float>* output) :
+        mKernel(kernel),
+        mInput(calc_offset(input, startRow * numCols * elementSize)),
+        mElementSize(elementSize),
         mDims(numRows, numCols),
+        mScaleFactors(scaleFactors ? scaleFactors + startRow : nullptr),
         mOutput(output + startRow * numCols)
     {
     }
 
     virtual void run()
     {
-        InT real(0);
-        InT imag(0);
-
-        for (size_t row = 0, inIdx = 0, outIdx = 0; row < mDims.row; ++row)
+        const size_t bytesPerRow = mDims.col * mElementSize;
+        for (size_t row = 0; row < mDims.row; ++row)
         {
-            for (size_t col = 0;
-                 col < mDims.col;
-                 ++col, inIdx += sizeof(std::complex<InT>), ++outIdx)
-            {
-                // Have to be careful here - can't treat mInput as a
-                // std::complex<InT> directly in case InT is a float (see
-                // explanation in byteSwap() comments)
-                const auto input = calc_offset(mInput, inIdx);
-                byteSwap(input, real);
-                byteSwap(calc_offset(input, sizeof(InT)), imag);
-
-                mOutput[outIdx] = std::complex<float>(real,
-                                                      imag);
-            }
-        }
-    }
-
-private:
-    const std::byte* const mInput;
-    const types::RowCol<size_t> mDims;
-    std::complex<float>* const mOutput;
-};
-
-
-template <typename InT>
-class ByteSwapAndScaleRunnable : public sys::Runnable
-{
-public:
-    ByteSwapAndScaleRunnable(const void* input,
-                             size_t startRow,
-                             size_t numRows,
-                             size_t numCols,
-                             const double* scaleFactors,
-                             std::complex<float>* output) :
-        mInput(calc_offset(input, startRow * numCols * sizeof(std::complex<InT>))),
-        mDims(numRows, numCols),
-        mScaleFactors(scaleFactors + startRow),
-        mOutput(output + startRow * numCols)
-    {
-    }
-
-    virtual void run()
-    {
-        InT real(0);
-        InT imag(0);
-
-        for (size_t row = 0, inIdx = 0, outIdx = 0; row < mDims.row; ++row)
-        {
-            const double scaleFactor(mScaleFactors[row]);
-
-            for (size_t col = 0;
-                 col < mDims.col;
-                 ++col, inIdx += sizeof(std::complex<InT>), ++outIdx)
-            {
-                // Have to be careful here - can't treat mInput as a
-                // std::complex<InT> directly in case InT is a float (see
-                // explanation in byteSwap() comments)
-                const auto input = calc_offset(mInput, inIdx);
-                byteSwap(input, real);
-                byteSwap(calc_offset(input, sizeof(InT)), imag);
-
-                mOutput[outIdx] = std::complex<float>(
-                        static_cast<float>(real * scaleFactor),
-                        static_cast<float>(imag * scaleFactor));
-            }
+            mKernel(mInput + row * bytesPerRow,
+                    mDims.col,
+                    mScaleFactors ? mScaleFactors[row] : 1.0,
+                    mOutput + row * mDims.col);
         }
     }
 
 private:
+    const six::ConvertKernel mKernel;
     const std::byte* const mInput;
+    const size_t mElementSize;
     const types::RowCol<size_t> mDims;
     const double* const mScaleFactors;
     std::complex<float>* const mOutput;
 };
 
-template <typename InT>
-void byteSwapAndPromote(const void* input,
-                      const types::RowCol<size_t>& dims,
-                      size_t numThreads,
-                      std::complex<float>* output)
+void convert(const void* input,
+             size_t elementSize,
+             const types::RowCol<size_t>& dims,
+             const double* scaleFactors,
+             bool swap,
+             size_t numThreads,
+             std::complex<float>* output)
 {
-    if (numThreads <= 1)
-    {
-        ByteSwapAndPromoteRunnable<InT>(input, 0, dims.row, dims.col,output).run();
-    }
-    else
-    {
-        mt::ThreadGroup threads;
-        const mt::ThreadPlanner planner(dims.row, numThreads);
-
-        size_t threadNum(0);
-        size_t startRow(0);
-        size_t numRowsThisThread(0);
-        while (planner.getThreadInfo(threadNum++,
-                                     startRow,
-                                     numRowsThisThread))
-        {
-            auto scaler = std::make_unique<ByteSwapAndPromoteRunnable<InT>>(
-                    input,
-                    startRow,
-                    numRowsThisThread,
-                    dims.col,
-                    output);
-            threads.createThread(std::move(scaler));
-        }
-
-        threads.joinAll();
-    }
-}
+    const six::ConvertKernel kernel =
+            six::getConvertKernel(elementSize, swap, scaleFactors != nullptr);
 
-template <typename InT>
-void byteSwapAndScale(const void* input,
-                      const types::RowCol<size_t>& dims,
-                      const double* scaleFactors,
-                      size_t numThreads,
-                      std::complex<float>* output)
-{
     if (numThreads <= 1)
     {
-        ByteSwapAndScaleRunnable<InT>(input, 0, dims.row, dims.col,
-                                      scaleFactors, output).run();
+        ConvertRunnable(kernel, input, elementSize, 0, dims.row, dims.col,
+                        scaleFactors, output).run();
     }
     else
     {
@@ -237,14 +133,16 @@ void byteSwapAndScale(const void* input,
                                      startRow,
                                      numRowsThisThread))
         {
-            auto scaler = std::make_unique<ByteSwapAndScaleRunnable<InT>>(
+            auto converter = std::make_unique<ConvertRunnable>(
+                    kernel,
                     input,
+                    elementSize,
                     startRow,
                     numRowsThisThread,
                     dims.col,
                     scaleFactors,
                     output);
-            threads.createThread(std::move(scaler));
+            threads.createThread(std::move(converter));
         }
 
         threads.joinAll();
@@ -261,9 +159,7 @@ void byteSwap(void* buffer,
 {
     if (numThreads <= 1)
     {
-        sys::byteSwap(buffer,
-                      static_cast<unsigned short>(elemSize),
-                      numElements);
+        six::byteSwapElements(buffer, elemSize, numElements);
     }
     else
     {
@@ -294,21 +190,7 @@ void byteSwapAndPromote(const void* input,
                       size_t numThreads,
                       std::complex<float>* output)
 {
-    switch (elementSize)
-    {
-    case 2:
-        ::byteSwapAndPromote<int8_t>(input, dims, numThreads, output);
-        break;
-    case 4:
-        ::byteSwapAndPromote<int16_t>(input, dims, numThreads, output);
-        break;
-    case 8:
-        ::byteSwapAndPromote<float>(input, dims, numThreads, output);
-        break;
-    default:
-        throw except::Exception(Ctxt(
-                "Unexpected element size " + std::to_string(elementSize)));
-    }
+    convert(input, elementSize, dims, nullptr, true, numThreads, output);
 }
 
 void byteSwapAndScale(const void* input,
@@ -318,23 +200,27 @@ void byteSwapAndScale(const void* input,
                       size_t numThreads,
                       std::complex<float>* output)
 {
-    switch (elementSize)
-    {
-    case 2:
-        ::byteSwapAndScale<int8_t>(input, dims, scaleFactors, numThreads,
-                                        output);
-        break;
-    case 4:
-        ::byteSwapAndScale<int16_t>(input, dims, scaleFactors, numThreads,
-                                         output);
-        break;
-    case 8:
-        ::byteSwapAndScale<float>(input, dims, scaleFactors, numThreads,
-                                  output);
-        break;
-    default:
-        throw except::Exception(Ctxt(
-                "Unexpected element size " + std::to_string(elementSize)));
-    }
+    convert(input, elementSize, dims, scaleFactors, true, numThreads,
+            output);
+}
+
+void promote(const void* input,
+             size_t elementSize,
+             const types::RowCol<size_t>& dims,
+             size_t numThreads,
+             std::complex<float>* output)
+{
+    convert(input, elementSize, dims, nullptr, false, numThreads, output);
+}
+
+void scale(const void* input,
+           size_t elementSize,
+           const types::RowCol<size_t>& dims,
+           const double* scaleFactors,
+           size_t numThreads,
+           std::complex<float>* output)
+{
+    convert(input, elementSize, dims, scaleFactors, false, numThreads,
+            output);
 }
 }
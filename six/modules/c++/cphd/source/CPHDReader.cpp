@@ -26,6 +26,7 @@
 
 #include <except/Exception.h>
 #include <io/StringStream.h>
+#include <io/BufferViewStream.h>
 #include <io/FileInputStream.h>
 #include <logging/NullLogger.h>
 #include <mem/ScopedArray.h>
@@ -34,6 +35,7 @@
 
 #include <six/XmlLite.h>
 #include <cphd/CPHDXMLControl.h>
+#include <cphd/MetadataCache.h>
 
 namespace cphd
 {
@@ -42,7 +44,7 @@ CPHDReader::CPHDReader(std::shared_ptr<io::SeekableInputStream> inStream,
                        const std::vector<std::string>& schemaPaths,
                        std::shared_ptr<logging::Logger> logger)
 {
-    initialize(inStream, numThreads, logger, schemaPaths);
+    initialize(inStream, "", numThreads, logger, schemaPaths);
 }
 
 CPHDReader::CPHDReader(const std::string& fromFile,
@@ -50,11 +52,12 @@ CPHDReader::CPHDReader(const std::string& fromFile,
                        const std::vector<std::string>& schemaPaths,
                        std::shared_ptr<logging::Logger> logger)
 {
-    initialize(std::make_shared<io::FileInputStream>(fromFile),
+    initialize(std::make_shared<io::FileInputStream>(fromFile), fromFile,
         numThreads, logger, schemaPaths);
 }
 
 void CPHDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
+                            const std::string& pathname,
                             size_t numThreads,
                             std::shared_ptr<logging::Logger> logger,
                             const std::vector<std::string>& schemaPaths_)
@@ -64,10 +67,6 @@ void CPHDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
     // Read in the XML string
     inStream->seek(mFileHeader.getXMLBlockByteOffset(), io::Seekable::START);
 
-    six::MinidomParser xmlParser;
-    xmlParser.preserveCharacterData(true);
-    xmlParser.parse(*inStream, gsl::narrow<int>(mFileHeader.getXMLBlockSize()));
-
     if (logger.get() == nullptr)
     {
         logger = std::make_shared<logging::NullLogger>();
@@ -76,7 +75,39 @@ void CPHDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
     std::vector<std::filesystem::path> schemaPaths;
     std::transform(schemaPaths_.begin(), schemaPaths_.end(), std::back_inserter(schemaPaths),
         [](const std::string& s) { return s; });
-    mMetadata = CPHDXMLControl(logger.get()).fromXML(xmlParser.getDocument(), schemaPaths);
+
+    const auto parseXML = [&](io::InputStream& xmlStream)
+    {
+        six::MinidomParser xmlParser;
+        xmlParser.preserveCharacterData(true);
+        xmlParser.parse(xmlStream, gsl::narrow<int>(mFileHeader.getXMLBlockSize()));
+        mMetadata = CPHDXMLControl(logger.get()).fromXML(xmlParser.getDocument(), schemaPaths);
+    };
+
+    MetadataCache& cache = MetadataCache::getInstance();
+    if (pathname.empty() || cache.getCapacity() == 0)
+    {
+        parseXML(*inStream);
+    }
+    else
+    {
+        // Only a changed XML block has to be parsed again
+        std::vector<std::byte> xmlBlock(mFileHeader.getXMLBlockSize());
+        inStream->read(xmlBlock.data(), xmlBlock.size(), true);
+        const auto key = MetadataCache::makeKey(pathname, xmlBlock.data(),
+                                                xmlBlock.size(), schemaPaths_);
+        if (auto cached = cache.find(key))
+        {
+            mMetadata = *cached;
+        }
+        else
+        {
+            io::BufferViewStream<std::byte> xmlStream(
+                    mem::BufferView<std::byte>(xmlBlock.data(), xmlBlock.size()));
+            parseXML(xmlStream);
+            cache.insert(key, std::make_shared<const Metadata>(mMetadata));
+        }
+    }
 
     mSupportBlock = std::make_unique<SupportBlock>(inStream, mMetadata.data, mFileHeader);
 
@@ -21,6 +21,7 @@
  */
 #include <cphd/CPHDWriter.h>
 
+#include <algorithm>
 #include <thread>
 #include <std/bit>
 #include <std/memory>
@@ -53,33 +54,155 @@ DataWriter::~DataWriter()
 DataWriterLittleEndian::DataWriterLittleEndian(
         std::shared_ptr<io::SeekableOutputStream> stream,
         size_t numThreads,
-        size_t scratchSize) :
+        size_t scratchSize,
+        size_t numBuffers) :
     DataWriter(stream, numThreads),
-    mScratch(scratchSize)
+    mScratch(std::max<size_t>(numBuffers, 1),
+             std::vector<std::byte>(std::max<size_t>(
+                     scratchSize / std::max<size_t>(numBuffers, 1),
+                     sizeof(double)))),
+    mPending(mScratch.size(), 0)
 {
+    mWriter = std::thread(&DataWriterLittleEndian::writeQueued, this);
+}
+
+DataWriterLittleEndian::~DataWriterLittleEndian()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+    mWriter.join();
 }
 
 void DataWriterLittleEndian::operator()(const sys::ubyte* data,
                                         size_t numElements,
                                         size_t elementSize)
 {
-    size_t dataProcessed = 0;
-    const size_t dataSize = numElements * elementSize;
-    while (dataProcessed < dataSize)
+    // Only whole elements go in each buffer so they can be swapped
+    const size_t chunkSize =
+            mScratch[0].size() - mScratch[0].size() % elementSize;
+    if (chunkSize == 0)
     {
-        const size_t dataToProcess =
-                std::min(mScratch.size(), dataSize - dataProcessed);
+        throw except::Exception(Ctxt(
+                "Scratch space is smaller than one element"));
+    }
 
-        memcpy(mScratch.data(), data + dataProcessed, dataToProcess);
+    try
+    {
+        size_t dataProcessed = 0;
+        size_t index = 0;
+        const size_t dataSize = numElements * elementSize;
+        while (dataProcessed < dataSize)
+        {
+            // Wait for the writer thread to finish with this buffer
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                while (mPending[index] != 0 && !mError)
+                {
+                    mCondition.wait(lock);
+                }
+                if (mError)
+                {
+                    break;
+                }
+            }
+
+            const size_t dataToProcess =
+                    std::min(chunkSize, dataSize - dataProcessed);
+            std::byte* const buffer = mScratch[index].data();
+
+            memcpy(buffer, data + dataProcessed, dataToProcess);
+
+            cphd::byteSwap(buffer,
+                           elementSize,
+                           dataToProcess / elementSize,
+                           mNumThreads);
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mPending[index] = dataToProcess;
+                mQueue.push_back(index);
+            }
+            mCondition.notify_all();
+
+            dataProcessed += dataToProcess;
+            index = (index + 1) % mScratch.size();
+        }
+    }
+    catch (...)
+    {
+        // Don't leave writes in flight behind the caller's back
+        try
+        {
+            waitForWrites();
+        }
+        catch (...)
+        {
+        }
+        throw;
+    }
 
-        cphd::byteSwap(mScratch.data(),
-                       elementSize,
-                       dataToProcess / elementSize,
-                       mNumThreads);
+    waitForWrites();
+}
 
-        mStream->write(mScratch.data(), dataToProcess);
+void DataWriterLittleEndian::writeQueued()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        while (!mStop && mQueue.empty())
+        {
+            mCondition.wait(lock);
+        }
+        if (mQueue.empty())
+        {
+            return;
+        }
+
+        // Once a write fails, drop the rest of the queue
+        const size_t index = mQueue.front();
+        const bool write = !mError;
+        lock.unlock();
+
+        std::exception_ptr error;
+        if (write)
+        {
+            try
+            {
+                mStream->write(mScratch[index].data(), mPending[index]);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        lock.lock();
+        if (error)
+        {
+            mError = error;
+        }
+        mQueue.pop_front();
+        mPending[index] = 0;
+        mCondition.notify_all();
+    }
+}
 
-        dataProcessed += dataToProcess;
+void DataWriterLittleEndian::waitForWrites()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mQueue.empty())
+    {
+        mCondition.wait(lock);
+    }
+
+    if (mError)
+    {
+        std::exception_ptr error = mError;
+        mError = nullptr;
+        std::rethrow_exception(error);
     }
 }
 
@@ -110,7 +233,8 @@ void CPHDWriter::initializeDataWriter()
     {
         mDataWriter = std::make_unique<DataWriterLittleEndian>(mStream,
             mNumThreads,
-            mScratchSpaceSize);
+            mScratchSpaceSize,
+            mNumScratchBuffers);
     }
 }
 
@@ -119,10 +243,12 @@ CPHDWriter::CPHDWriter(const Metadata& metadata,
                        std::shared_ptr<io::SeekableOutputStream> outStream,
                        const std::vector<std::string>& schemaPaths,
                        size_t numThreads,
-                       size_t scratchSpaceSize) :
+                       size_t scratchSpaceSize,
+                       size_t numScratchBuffers) :
     mMetadata(metadata),
     mElementSize(metadata.data.getNumBytesPerSample()),
     mScratchSpaceSize(scratchSpaceSize),
+    mNumScratchBuffers(numScratchBuffers),
     mNumThreads(numThreads),
     mSchemaPaths(schemaPaths),
     mStream(outStream)
@@ -134,10 +260,12 @@ CPHDWriter::CPHDWriter(const Metadata& metadata,
                        const std::string& pathname,
                        const std::vector<std::string>& schemaPaths,
                        size_t numThreads,
-                       size_t scratchSpaceSize) :
+                       size_t scratchSpaceSize,
+                       size_t numScratchBuffers) :
     mMetadata(metadata),
     mElementSize(metadata.data.getNumBytesPerSample()),
     mScratchSpaceSize(scratchSpaceSize),
+    mNumScratchBuffers(numScratchBuffers),
     mNumThreads(numThreads),
     mSchemaPaths(schemaPaths)
 {
@@ -323,10 +451,11 @@ void CPHDWriter::writeMetadata(const PVPBlock& pvpBlock)
 void CPHDWriter::writePVPData(const PVPBlock& pvpBlock)
 {
     // Add padding
-    char zero = 0;
-    for (int64_t ii = 0; ii < mHeader.getPvpPadBytes(); ++ii)
+    if (mHeader.getPvpPadBytes() > 0)
     {
-        mStream->write(&zero, 1);
+        const std::vector<std::byte> zeros(
+                static_cast<size_t>(mHeader.getPvpPadBytes()));
+        mStream->write(zeros.data(), zeros.size());
     }
 
     // Write each PVP array
@@ -20,6 +20,9 @@
  *
  */
 
+#include <string.h>
+
+#include <algorithm>
 #include <limits>
 #include <sstream>
 #include <thread>
@@ -29,8 +32,6 @@
 #include <nitf/coda-oss.hpp>
 #include <except/Exception.h>
 #include <io/FileInputStream.h>
-#include <mt/ThreadGroup.h>
-#include <mt/ThreadPlanner.h>
 
 #include <six/Init.h>
 #include <cphd/ByteSwap.h>
@@ -40,209 +41,18 @@
 #undef min
 #undef max
 
-namespace
-{
-template <typename InT>
-class PromoteRunnable : public sys::Runnable
-{
-public:
-    PromoteRunnable(const std::complex<InT>* input,
-                    size_t startRow,
-                    size_t numRows,
-                    size_t numCols,
-                    std::complex<float>* output) :
-        mInput(input + startRow * numCols),
-        mDims(numRows, numCols),
-        mOutput(output + startRow * numCols)
-    {
-    }
-
-    virtual void run()
-    {
-        for (size_t row = 0, idx = 0; row < mDims.row; ++row)
-        {
-            for (size_t col = 0; col < mDims.col; ++col, ++idx)
-            {
-                const std::complex<InT>& input(mInput[idx]);
-                mOutput[idx] = std::complex<float>(input.real(), input.imag());
-            }
-        }
-    }
-
-private:
-    const std::complex<InT>* const mInput;
-    const types::RowCol<size_t> mDims;
-    std::complex<float>* const mOutput;
-};
-
-template <typename InT>
-class ScaleRunnable : public sys::Runnable
-{
-public:
-    ScaleRunnable(const std::complex<InT>* input,
-                  size_t startRow,
-                  size_t numRows,
-                  size_t numCols,
-                  const double* scaleFactors,
-                  std::complex<float>* output) :
-        mInput(input + startRow * numCols),
-        mDims(numRows, numCols),
-        mScaleFactors(scaleFactors + startRow),
-        mOutput(output + startRow * numCols)
-    {
-    }
-
-    virtual void run()
-    {
-        for (size_t row = 0, idx = 0; row < mDims.row; ++row)
-        {
-            const double scaleFactor(mScaleFactors[row]);
-            for (size_t col = 0; col < mDims.col; ++col, ++idx)
-            {
-                const std::complex<InT>& input(mInput[idx]);
-                mOutput[idx] = std::complex<float>(static_cast<float>(input.real() * scaleFactor),
-                                                   static_cast<float>(input.imag() * scaleFactor));
-            }
-        }
-    }
-
-private:
-    const std::complex<InT>* const mInput;
-    const types::RowCol<size_t> mDims;
-    const double* const mScaleFactors;
-    std::complex<float>* const mOutput;
-};
-
-template <typename InT>
-void promote(const void* input,
-             const types::RowCol<size_t>& dims,
-             size_t numThreads,
-             std::complex<float>* output)
-{
-    if (numThreads <= 1)
-    {
-        PromoteRunnable<InT>(static_cast<const std::complex<InT>*>(input),
-                             0,
-                             dims.row,
-                             dims.col,
-                             output)
-                .run();
-    }
-    else
-    {
-        mt::ThreadGroup threads;
-        const mt::ThreadPlanner planner(dims.row, numThreads);
-
-        size_t threadNum(0);
-        size_t startRow(0);
-        size_t numRowsThisThread(0);
-        while (planner.getThreadInfo(threadNum++, startRow, numRowsThisThread))
-        {
-           auto scaler = std::make_unique<PromoteRunnable<InT>>(
-                    static_cast<const std::complex<InT>*>(input),
-                    startRow,
-                    numRowsThisThread,
-                    dims.col,
-                    output);
-            threads.createThread(std::move(scaler));
-        }
-
-        threads.joinAll();
-    }
-}
-
-void promote(const void* input,
-             size_t elementSize,
-             const types::RowCol<size_t>& dims,
-             size_t numThreads,
-             std::complex<float>* output)
-{
-    switch (elementSize)
-    {
-    case 2:
-        promote<int8_t>(input, dims, numThreads, output);
-        break;
-    case 4:
-        promote<int16_t>(input, dims, numThreads, output);
-        break;
-    case 8:
-        promote<float>(input, dims, numThreads, output);
-        break;
-    default:
-        throw except::Exception(
-                Ctxt("Unexpected element size " + std::to_string(elementSize)));
-    }
-}
-template <typename InT>
-void scale(const void* input,
-           const types::RowCol<size_t>& dims,
-           const double* scaleFactors,
-           size_t numThreads,
-           std::complex<float>* output)
+namespace cphd
 {
-    if (numThreads <= 1)
-    {
-        ScaleRunnable<InT>(static_cast<const std::complex<InT>*>(input),
-                           0,
-                           dims.row,
-                           dims.col,
-                           scaleFactors,
-                           output)
-                .run();
-    }
-    else
-    {
-        mt::ThreadGroup threads;
-        const mt::ThreadPlanner planner(dims.row, numThreads);
-
-        size_t threadNum(0);
-        size_t startRow(0);
-        size_t numRowsThisThread(0);
-        while (planner.getThreadInfo(threadNum++, startRow, numRowsThisThread))
-        {
-           auto scaler = std::make_unique<ScaleRunnable<InT>>(
-                    static_cast<const std::complex<InT>*>(input),
-                    startRow,
-                    numRowsThisThread,
-                    dims.col,
-                    scaleFactors,
-                    output);
-            threads.createThread(std::move(scaler));
-        }
-
-        threads.joinAll();
-    }
-}
+const size_t Wideband::ALL = std::numeric_limits<size_t>::max();
+const size_t Wideband::DEFAULT_MAX_READ_GAP = 16 * 1024;
 
-void scale(const void* input,
-           size_t elementSize,
-           const types::RowCol<size_t>& dims,
-           const double* scaleFactors,
-           size_t numThreads,
-           std::complex<float>* output)
+namespace
 {
-    switch (elementSize)
-    {
-    case 2:
-        scale<int8_t>(input, dims, scaleFactors, numThreads, output);
-        break;
-    case 4:
-        scale<int16_t>(input, dims, scaleFactors, numThreads, output);
-        break;
-    case 8:
-        scale<float>(input, dims, scaleFactors, numThreads, output);
-        break;
-    default:
-        throw except::Exception(
-                Ctxt("Unexpected element size " + std::to_string(elementSize)));
-    }
-}
+// Largest span of rows (with the gaps between them) read at once when
+// reading through gaps
+const size_t MAX_SPAN_BYTES = 4 * 1024 * 1024;
 }
 
-namespace cphd
-{
-const size_t Wideband::ALL = std::numeric_limits<size_t>::max();
-
 Wideband::Wideband(const std::string& pathname,
                    const cphd::MetadataBase& metadata,
                    int64_t startWB,
@@ -423,12 +233,40 @@ void Wideband::readImpl(size_t channel,
     }
     else
     {
-        // We're stuck reading a row at a time since we're only reading some
-        // of the columns
+        // We're only reading some of the columns
         const size_t bytesPerVectorAOI = dims.col * mElementSize;
         const size_t bytesPerVectorFile =
                 mMetadata.getNumSamples(channel) * mElementSize;
 
+        // When the rows are close together, read spans of rows into a
+        // bounce buffer and drop the gaps instead of a seek and read per row
+        const size_t rowsPerSpan = bytesPerVectorAOI >= MAX_SPAN_BYTES ? 1 :
+                (MAX_SPAN_BYTES - bytesPerVectorAOI) / bytesPerVectorFile + 1;
+        if (bytesPerVectorFile - bytesPerVectorAOI <= mMaxReadGap &&
+            rowsPerSpan > 1 && dims.row > 1)
+        {
+            const size_t maxRows = std::min(rowsPerSpan, dims.row);
+            std::vector<std::byte> span(
+                    (maxRows - 1) * bytesPerVectorFile + bytesPerVectorAOI);
+            for (size_t row = 0; row < dims.row; row += maxRows)
+            {
+                const size_t numRows = std::min(maxRows, dims.row - row);
+                mInStream->seek(inOffset, io::FileInputStream::START);
+                mInStream->read(span.data(),
+                                (numRows - 1) * bytesPerVectorFile +
+                                        bytesPerVectorAOI);
+                for (size_t ii = 0; ii < numRows; ++ii)
+                {
+                    memcpy(dataPtr,
+                           span.data() + ii * bytesPerVectorFile,
+                           bytesPerVectorAOI);
+                    dataPtr += bytesPerVectorAOI;
+                }
+                inOffset += numRows * bytesPerVectorFile;
+            }
+            return;
+        }
+
         for (size_t row = 0; row < dims.row; ++row)
         {
             mInStream->seek(inOffset, io::FileInputStream::START);
@@ -669,12 +507,12 @@ void Wideband::read(size_t channel,
         else
         {
             // Just need to scale
-            scale(scratch.data,
-                  mElementSize,
-                  dims,
-                  vectorScaleFactors.data(),
-                  numThreads,
-                  data.data);
+            cphd::scale(scratch.data,
+                        mElementSize,
+                        dims,
+                        vectorScaleFactors.data(),
+                        numThreads,
+                        data.data);
         }
     }
     // We need to convert the output to floating-point data
@@ -695,7 +533,8 @@ void Wideband::read(size_t channel,
         }
         else
         {
-            promote(scratch.data, mElementSize, dims, numThreads, data.data);
+            cphd::promote(
+                    scratch.data, mElementSize, dims, numThreads, data.data);
         }
     }
     else
@@ -0,0 +1,101 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include <io/ByteStream.h>
+#include <cphd/CPHDWriter.h>
+
+#include "TestCase.h"
+
+namespace
+{
+std::vector<uint32_t> makeData(size_t size)
+{
+    std::vector<uint32_t> data(size);
+    for (size_t ii = 0; ii < data.size(); ++ii)
+    {
+        data[ii] = static_cast<uint32_t>(ii * 0x01020304);
+    }
+    return data;
+}
+
+bool isSwapped(const std::vector<uint32_t>& data, io::ByteStream& stream)
+{
+    if (stream.getSize() != data.size() * sizeof(uint32_t))
+    {
+        return false;
+    }
+    const auto written = reinterpret_cast<const unsigned char*>(stream.get());
+    for (size_t ii = 0; ii < data.size(); ++ii)
+    {
+        const auto bytes = reinterpret_cast<const unsigned char*>(&data[ii]);
+        for (size_t jj = 0; jj < sizeof(uint32_t); ++jj)
+        {
+            if (written[ii * sizeof(uint32_t) + jj] !=
+                bytes[sizeof(uint32_t) - 1 - jj])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+}
+
+TEST_CASE(testPipelinedWrites)
+{
+    const std::vector<uint32_t> data = makeData(1001);
+
+    for (size_t numBuffers = 1; numBuffers <= 4; ++numBuffers)
+    {
+        auto stream = std::make_shared<io::ByteStream>();
+
+        // Scratch space that isn't a whole number of elements per buffer
+        cphd::DataWriterLittleEndian writer(stream, 2, 150, numBuffers);
+        writer(reinterpret_cast<const std::byte*>(data.data()), 500,
+               sizeof(uint32_t));
+
+        // The stream is free to use directly between calls
+        TEST_ASSERT_EQ(stream->tell(),
+                       static_cast<sys::Off_T>(500 * sizeof(uint32_t)));
+        writer(reinterpret_cast<const std::byte*>(data.data() + 500), 501,
+               sizeof(uint32_t));
+
+        TEST_ASSERT_TRUE(isSwapped(data, *stream));
+    }
+}
+
+TEST_CASE(testScratchSmallerThanElementThrows)
+{
+    const std::vector<uint32_t> data = makeData(4);
+    auto stream = std::make_shared<io::ByteStream>();
+    cphd::DataWriterLittleEndian writer(stream, 1, 8, 2);
+    TEST_EXCEPTION(writer(reinterpret_cast<const std::byte*>(data.data()),
+                          1, 16));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testPipelinedWrites);
+    TEST_CHECK(testScratchSmallerThanElementThrows);
+    )
@@ -0,0 +1,158 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CRSD_BISTATIC_GEOMETRY_H__
+#define __CRSD_BISTATIC_GEOMETRY_H__
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+#include <std/span>
+
+#include <crsd/PPPBlock.h>
+#include <crsd/PVPBlock.h>
+#include <crsd/ThreadPool.h>
+#include <crsd/Types.h>
+
+namespace crsd
+{
+/*!
+ *  \struct BistaticGeometry
+ *
+ *  \brief Bistatic collection geometry, one row per sample
+ *
+ *  The per-vector (or per-point) counterpart of the SARImage
+ *  reference geometry parameters. Each parameter is its own column so
+ *  the rows can be handed straight to vectorized code. Angles are in
+ *  degrees, rates in degrees per second and distances in meters.
+ *
+ *  The geometry is that of the bistatic pointing vector, the average of
+ *  the unit vectors from the scene point to the transmit and receive
+ *  APCs. The slant plane contains it and its time derivative, with its
+ *  normal taken on the side of the local up direction. Up is the WGS-84
+ *  ellipsoid normal at the scene point.
+ */
+struct BistaticGeometry final
+{
+    //! Number of rows
+    size_t size() const
+    {
+        return bistaticAngle.size();
+    }
+
+    //! Resize every column to 'numRows'
+    void resize(size_t numRows);
+
+    //! Angle between the point-to-tx and point-to-rcv lines [0 - 180]
+    std::vector<double> bistaticAngle;
+
+    //! Rate at which the bistatic angle changes
+    std::vector<double> bistaticAngleRate;
+
+    //! Grazing angle of the bistatic pointing vector to the Earth
+    //! Tangent Plane (ETP)
+    std::vector<double> grazeAngle;
+
+    //! Twist angle between cross range in the ETP and in the slant plane
+    std::vector<double> twistAngle;
+
+    //! Angle between the ETP normal and the slant plane normal
+    std::vector<double> slopeAngle;
+
+    //! Angle from north to the layover direction in the ETP, clockwise
+    //! toward east [0 - 360)
+    std::vector<double> layoverAngle;
+
+    //! Distance from the scene point to the tx and rcv APCs
+    std::vector<double> txSlantRange;
+    std::vector<double> rcvSlantRange;
+
+    //! Distance from the scene point to the tx and rcv APC nadirs, along
+    //! a spherical Earth through the scene point
+    std::vector<double> txGroundRange;
+    std::vector<double> rcvGroundRange;
+};
+
+/*
+ *  \func computeBistaticGeometry
+ *
+ *  \brief Compute the bistatic geometry for a batch of samples
+ *
+ *  Every input is a column with either one entry per sample or a single
+ *  entry that is used for every sample. One tx/rcv state with many
+ *  scene points gives the geometry over a scene grid. One scene point
+ *  with many states gives the geometry of each vector.
+ *
+ *  \param txPos Transmit APC positions, ECF (m)
+ *  \param txVel Transmit APC velocities, ECF (m/s)
+ *  \param rcvPos Receive APC positions, ECF (m)
+ *  \param rcvVel Receive APC velocities, ECF (m/s)
+ *  \param points Scene points, ECF (m)
+ *  \param numThreads Number of threads to split the samples over
+ *  \param threadPool (Optional) Pool to run on; ThreadPool::getDefault()
+ *  if null
+ *
+ *  \return One row per sample
+ *
+ *  \throw except::Exception If a column is empty or its length is
+ *  neither 1 nor the number of samples
+ */
+BistaticGeometry computeBistaticGeometry(std::span<const Vector3> txPos,
+                                         std::span<const Vector3> txVel,
+                                         std::span<const Vector3> rcvPos,
+                                         std::span<const Vector3> rcvVel,
+                                         std::span<const Vector3> points,
+                                         size_t numThreads,
+                                         ThreadPool* threadPool = nullptr);
+
+/*
+ *  \func computeBistaticGeometry
+ *
+ *  \brief Compute the bistatic geometry of every vector of a channel
+ *
+ *  Each vector's receive APC state comes from the PVPs and its transmit
+ *  APC state from the pulse named by its TxPulseIndex PVP.
+ *
+ *  \param pvpBlock PVPs containing RcvPos, RcvVel and TxPulseIndex
+ *  \param pppBlock PPPs of the channel's tx sequence
+ *  \param channel 0-based channel number
+ *  \param txSequence 0-based tx sequence number of the channel's
+ *  transmitter
+ *  \param point Scene point, ECF (m), e.g. the reference point
+ *  \param numThreads Number of threads to split the vectors over
+ *  \param threadPool (Optional) Pool to run on; ThreadPool::getDefault()
+ *  if null
+ *
+ *  \return One row per vector
+ *
+ *  \throw except::Exception If a pulse index is out of range
+ */
+BistaticGeometry computeBistaticGeometry(const PVPBlock& pvpBlock,
+                                         const PPPBlock& pppBlock,
+                                         size_t channel,
+                                         size_t txSequence,
+                                         const Vector3& point,
+                                         size_t numThreads,
+                                         ThreadPool* threadPool = nullptr);
+}
+
+#endif
@@ -29,6 +29,8 @@
 #include <scene/sys_Conf.h>
 #include <types/RowCol.h>
 
+#include <crsd/ThreadPool.h>
+
 namespace crsd
 {
 /*
@@ -39,11 +41,13 @@ namespace crsd
  *  \param elemSize Size of each element in 'buffer'
  *  \param numElements Number of elements in 'buffer'
  *  \param numThreads Number of threads to use for byte-swapping
+ *  \param threadPool (Optional) Pool to run on; the default pool if null
  */
 void byteSwap(void* buffer,
               size_t elemSize,
               size_t numElements,
-              size_t numThreads);
+              size_t numThreads,
+              ThreadPool* threadPool = nullptr);
 
 /*
  *  \func byteSwapAndPromote
@@ -59,6 +63,7 @@ void byteSwap(void* buffer,
  *  \param dims Number of rows and cols of elements in 'input'
  *  \param numThreads Number of threads to use for byte-swapping
  *  \param output Pointer to output array of complex<float>
+ *  \param threadPool (Optional) Pool to run on; the default pool if null
  *
  *  \throws If elementSize is not one of (2,4 or 8)
  */
@@ -66,7 +71,8 @@ void byteSwapAndPromote(const void* input,
                         size_t elementSize,
                         const types::RowCol<size_t>& dims,
                         size_t numThreads,
-                        std::complex<float>* output);
+                        std::complex<float>* output,
+                        ThreadPool* threadPool = nullptr);
 
 /*
  *  \func byteSwapAndScale
@@ -84,6 +90,7 @@ void byteSwapAndPromote(const void* input,
  *         to scale the input
  *  \param numThreads Number of threads to use for byte-swapping
  *  \param output Pointer to output array of scaled complex<float>
+ *  \param threadPool (Optional) Pool to run on; the default pool if null
  *
  *  \throws If elementSize is not one of (2,4 or 8)
  */
@@ -92,7 +99,61 @@ void byteSwapAndScale(const void* input,
                       const types::RowCol<size_t>& dims,
                       const double* scaleFactors,
                       size_t numThreads,
-                      std::complex<float>* output);
+                      std::complex<float>* output,
+                      ThreadPool* threadPool = nullptr);
+
+/*
+ *  \func promote
+ *  \brief Threaded promotion of native byte order input to complex<floats>
+ *
+ *  Valid input types:
+ *     int8_t
+ *     int16_t
+ *     sys::float
+ *
+ *  \param input Input to promote
+ *  \param elementSize Size of each element in 'input'
+ *  \param dims Number of rows and cols of elements in 'input'
+ *  \param numThreads Number of threads to use for promotion
+ *  \param output Pointer to output array of complex<float>
+ *  \param threadPool (Optional) Pool to run on; the default pool if null
+ *
+ *  \throws If elementSize is not one of (2,4 or 8)
+ */
+void promote(const void* input,
+             size_t elementSize,
+             const types::RowCol<size_t>& dims,
+             size_t numThreads,
+             std::complex<float>* output,
+             ThreadPool* threadPool = nullptr);
+
+/*
+ *  \func scale
+ *  \brief Threaded promotion and scaling of native byte order input
+ *
+ *  Valid input types:
+ *     int8_t
+ *     int16_t
+ *     sys::float
+ *
+ *  \param input Input to promote and scale
+ *  \param elementSize Size of each element in 'input'
+ *  \param dims Number of rows and cols of elements in 'input'
+ *  \param scaleFactors pointer to num rows size array of doubles
+ *         to scale the input
+ *  \param numThreads Number of threads to use for scaling
+ *  \param output Pointer to output array of scaled complex<float>
+ *  \param threadPool (Optional) Pool to run on; the default pool if null
+ *
+ *  \throws If elementSize is not one of (2,4 or 8)
+ */
+void scale(const void* input,
+           size_t elementSize,
+           const types::RowCol<size_t>& dims,
+           const double* scaleFactors,
+           size_t numThreads,
+           std::complex<float>* output,
+           ThreadPool* threadPool = nullptr);
 }
 
 #endif
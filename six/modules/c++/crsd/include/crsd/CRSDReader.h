@@ -22,7 +22,12 @@
 #ifndef __CRSD_CRSD_READER_H__
 #define __CRSD_CRSD_READER_H__
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <scene/sys_Conf.h>
 
@@ -48,10 +53,18 @@ struct CRSDReader final
      *  \func CRSDReader constructor
      *  \brief Construct CRSDReader from an input stream
      *
+     *  Once constructed, the reader only moves the stream's position
+     *  under its own lock; nothing else may read from 'inStream' while
+     *  the reader is in use.
+     *
      *  \param inStream Input stream containing CRSD file
      *  \param numThreads Number of threads for parallelization
      *  \param schemaPaths (Optional) XML schemas for validation
      *  \param logger (Optional) Provide custom log
+     *  \param threadPool (Optional) Pool for endian swapping while loading
+     *  and reading; ThreadPool::getDefault() if null
+     *  \param loadLazily (Optional) Don't read the PVP and PPP arrays until
+     *  they are first accessed or prefetched
      */
     // Provides access to wideband but doesn't read it
     CRSDReader(std::shared_ptr<io::SeekableInputStream> inStream,
@@ -59,16 +72,28 @@ struct CRSDReader final
                const std::vector<std::string>& schemaPaths =
                        std::vector<std::string>(),
                std::shared_ptr<logging::Logger> logger =
-                       std::shared_ptr<logging::Logger>());
+                       std::shared_ptr<logging::Logger>(),
+               std::shared_ptr<ThreadPool> threadPool = nullptr,
+               bool loadLazily = false);
 
     /*
      *  \func CRSDReader constructor
      *  \brief Construct CRSDReader from a file pathname
      *
+     *  Wideband reads use positional I/O on their own file handle, so
+     *  multiple threads can read signal data from one reader concurrently.
+     *  Metadata is taken from MetadataCache::getInstance() when it is
+     *  enabled and already holds this version of the file, parsed
+     *  against the same 'schemaPaths'.
+     *
      *  \param fromFile File path of CRSD file
      *  \param numThreads Number of threads for parallelization
      *  \param schemaPaths (Optional) XML schemas for validation
      *  \param logger (Optional) Provide custom log
+     *  \param threadPool (Optional) Pool for endian swapping while loading
+     *  and reading; ThreadPool::getDefault() if null
+     *  \param loadLazily (Optional) Don't read the PVP and PPP arrays until
+     *  they are first accessed or prefetched
      */
     // Provides access to wideband but doesn't read it
     CRSDReader(const std::string& fromFile,
@@ -76,7 +101,9 @@ struct CRSDReader final
                const std::vector<std::string>& schemaPaths =
                        std::vector<std::string>(),
                std::shared_ptr<logging::Logger> logger =
-                       std::shared_ptr<logging::Logger>());
+                       std::shared_ptr<logging::Logger>(),
+               std::shared_ptr<ThreadPool> threadPool = nullptr,
+               bool loadLazily = false);
 
     //! Get parameter functions
     size_t getNumChannels() const
@@ -134,21 +161,83 @@ struct CRSDReader final
     {
         return mMetadata;
     }
-    //! Get per vector parameters
-    const PVPBlock& getPVPBlock() const
-    {
-        return mPVPBlock;
-    }
-    //! Get per vector parameters
-    const PPPBlock& getPPPBlock() const
-    {
-        return mPPPBlock;
-    }
+    /*
+     *  \func getPVPBlock
+     *  \brief Get per vector parameters, reading any channels not yet loaded
+     *
+     *  Waits for every channel, including ones other threads are
+     *  prefetching, so the whole returned block is safe to read. Once
+     *  everything is loaded this no longer takes a lock.
+     */
+    const PVPBlock& getPVPBlock() const;
+
+    /*
+     *  \func getPPPBlock
+     *  \brief Get per pulse parameters, reading any tx sequences not yet
+     *  loaded
+     *
+     *  Waits for every tx sequence, including ones other threads are
+     *  prefetching, so the whole returned block is safe to read. Once
+     *  everything is loaded this no longer takes a lock.
+     */
+    const PPPBlock& getPPPBlock() const;
+
+    /*
+     *  \func getPVPBlock
+     *  \brief Get per vector parameters, reading only 'channel' if needed
+     *
+     *  Other channels of the returned block are undefined until they are
+     *  loaded.
+     *
+     *  \param channel 0-based channel number
+     */
+    const PVPBlock& getPVPBlock(size_t channel) const;
+
+    /*
+     *  \func getPPPBlock
+     *  \brief Get per pulse parameters, reading only 'txSequence' if needed
+     *
+     *  Other tx sequences of the returned block are undefined until they
+     *  are loaded.
+     *
+     *  \param txSequence 0-based tx sequence number
+     */
+    const PPPBlock& getPPPBlock(size_t txSequence) const;
+
+    /*
+     *  \func prefetch
+     *  \brief Read the PVP array of a channel if it isn't loaded yet
+     *
+     *  Safe to call from multiple threads.
+     *
+     *  \param channel 0-based channel number
+     *
+     *  \throw except::Exception If the channel doesn't exist
+     */
+    void prefetch(size_t channel) const;
+
+    /*
+     *  \func prefetchTxSequence
+     *  \brief Read the PPP array of a tx sequence if it isn't loaded yet
+     *
+     *  Safe to call from multiple threads.
+     *
+     *  \param txSequence 0-based tx sequence number
+     *
+     *  \throw except::Exception If the tx sequence doesn't exist
+     */
+    void prefetchTxSequence(size_t txSequence) const;
     //! Get signal data
     const Wideband& getWideband() const
     {
         return *mWideband;
     }
+
+    //! See Wideband::setMaxReadGap()
+    void setMaxReadGap(size_t bytes)
+    {
+        mWideband->setMaxReadGap(bytes);
+    }
     //! Get support data
     const SupportBlock& getSupportBlock() const
     {
@@ -164,19 +253,58 @@ private:
     //! Support Block book-keeping info read in from CRSD file
     std::unique_ptr<SupportBlock> mSupportBlock;
     //! Per Vector Parameter info read in from CRSD file
-    PVPBlock mPVPBlock;
+    mutable PVPBlock mPVPBlock;
     //! Per Pulse Parameter info read in from CRSD file
-    PPPBlock mPPPBlock;
+    mutable PPPBlock mPPPBlock;
     //! Signal block book-keeping info read in from CRSD file
     std::unique_ptr<Wideband> mWideband;
 
+    enum class LoadState
+    {
+        NOT_LOADED,
+        LOADING,
+        LOADED
+    };
+
+    //! Which channels of mPVPBlock and tx sequences of mPPPBlock are read.
+    //! mLoadMutex only guards these; the reads themselves run unlocked,
+    //! and mLoadDone wakes threads waiting on another thread's read.
+    mutable std::vector<LoadState> mPVPState;
+    mutable std::vector<LoadState> mPPPState;
+    mutable std::mutex mLoadMutex;
+    mutable std::condition_variable mLoadDone;
+    //! Set once every channel/tx sequence is read; skips mLoadMutex after
+    mutable std::atomic<bool> mAllPVPLoaded{false};
+    mutable std::atomic<bool> mAllPPPLoaded{false};
+    //! Source of PVP and PPP arrays that are read on demand
+    std::shared_ptr<PositionalInputStream> mStream;
+    size_t mNumThreads = 0;
+    std::shared_ptr<ThreadPool> mThreadPool;
+
+    /*
+     *  Run 'load' for entry 'index' of 'states' unless it has already
+     *  run. Concurrent calls for the same entry wait for the first one;
+     *  if it throws, the entry can be loaded again.
+     */
+    void loadOnce(std::vector<LoadState>& states,
+                  size_t index,
+                  const std::function<void()>& load) const;
+
     /*
      *  Read in header, metadata, supportblock, pvpblock and wideband
+     *  Wideband reads go through 'signalStream' if it is set,
+     *  otherwise through 'inStream'. PVP and PPP blocks are left
+     *  unallocated, not read, if 'loadLazily' is set. Metadata is cached by 'pathname'
+     *  unless it is empty.
      */
     void initialize(std::shared_ptr<io::SeekableInputStream> inStream,
+                    std::shared_ptr<PositionalInputStream> signalStream,
+                    const std::string& pathname,
                     size_t numThreads,
                     std::shared_ptr<logging::Logger> logger,
-                    const std::vector<std::string>& schemaPaths);
+                    const std::vector<std::string>& schemaPaths,
+                    std::shared_ptr<ThreadPool> threadPool,
+                    bool loadLazily);
 };
 }
 
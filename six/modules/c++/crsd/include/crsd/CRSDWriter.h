@@ -24,8 +24,15 @@
 #define __CRSD_CRSD_WRITER_H__
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
+#include <std/span>
 
 #include <scene/sys_Conf.h>
 #include <types/RowCol.h>
@@ -37,6 +44,7 @@
 #include <crsd/PVPBlock.h>
 #include <crsd/PPP.h>
 #include <crsd/PPPBlock.h>
+#include <crsd/ThreadPool.h>
 
 namespace crsd
 {
@@ -54,9 +62,12 @@ struct DataWriter
      *
      *  \param stream The seekable output stream to be written
      *  \param numThreads Number of threads for parallel processing
+     *  \param threadPool (Optional) Pool for byte swapping; the default
+     *  pool if null
      */
     DataWriter(std::shared_ptr<io::SeekableOutputStream> stream,
-               size_t numThreads);
+               size_t numThreads,
+               std::shared_ptr<ThreadPool> threadPool = nullptr);
 
     /*
      *  Destructor
@@ -81,11 +92,53 @@ struct DataWriter
         (*this)(reinterpret_cast<const sys::ubyte*>(data), numElements, elementSize);
     }
 
+    /*
+     *  Fills 'buffer' with records [firstRecord, firstRecord + numRecords)
+     *  in native byte order. Called from several threads at once, for
+     *  disjoint ranges.
+     */
+    using RecordEncoder = std::function<void(size_t firstRecord,
+                                             size_t numRecords,
+                                             std::byte* buffer)>;
+
+    /*
+     *  \func writeRecords
+     *  \brief Encode fixed size records straight into the output staging
+     *  buffers, byte swap them there if necessary, and write them
+     *
+     *  Nothing is serialized ahead of time, and encoding runs in parallel
+     *  across records.
+     *
+     *  \param encode Produces the records
+     *  \param numRecords Total number of records
+     *  \param recordSize Bytes per record, a multiple of elementSize
+     *  \param elementSize Size of each element to byte swap
+     */
+    virtual void writeRecords(const RecordEncoder& encode,
+                              size_t numRecords,
+                              size_t recordSize,
+                              size_t elementSize) = 0;
+
 protected:
+    /*
+     *  Run 'encode' for records [firstRecord, firstRecord + numRecords)
+     *  into 'buffer' on up to mNumThreads threads, byte swapping each
+     *  piece right after it is encoded if 'swap' is set
+     */
+    void encodeRecords(const RecordEncoder& encode,
+                       size_t firstRecord,
+                       size_t numRecords,
+                       size_t recordSize,
+                       size_t elementSize,
+                       bool swap,
+                       std::byte* buffer) const;
+
     //! Output stream of CRSD
     std::shared_ptr<io::SeekableOutputStream> mStream;
     //! Number of threads for parallelism
     const size_t mNumThreads;
+    //! Pool the threads run on, nullptr for the default
+    const std::shared_ptr<ThreadPool> mThreadPool;
 };
 
 /*
@@ -93,7 +146,11 @@ protected:
  *
  *  \brief Class to handle writing to output stream and byte swapping
  *
- *  For little endian to big endian storage
+ *  For little endian to big endian storage. The scratch space is split
+ *  into several buffers, and a background thread writes each one to the
+ *  stream while the next is being filled and swapped. Every call returns
+ *  only after its data has been written, so the stream can be used
+ *  directly between calls.
  */
 struct DataWriterLittleEndian final : public DataWriter
 {
@@ -103,11 +160,20 @@ struct DataWriterLittleEndian final : public DataWriter
      *
      *  \param stream The seekable output stream to be written
      *  \param numThreads Number of threads for parallel processing
-     *  \param scratchSize Size of buffer to be used for scratch space
+     *  \param scratchSize Total size of the scratch buffers
+     *  \param threadPool (Optional) Pool for byte swapping; the default
+     *  pool if null
+     *  \param numBuffers (Optional) Number of buffers 'scratchSize' is split
+     *  into; this is how many chunks can be queued for writing at once
      */
     DataWriterLittleEndian(std::shared_ptr<io::SeekableOutputStream> stream,
                            size_t numThreads,
-                           size_t scratchSize);
+                           size_t scratchSize,
+                           std::shared_ptr<ThreadPool> threadPool = nullptr,
+                           size_t numBuffers = 2);
+
+    //! Stops the writer thread
+    ~DataWriterLittleEndian();
 
     /*
      *  \func operator()
@@ -127,10 +193,45 @@ struct DataWriterLittleEndian final : public DataWriter
         (*this)(reinterpret_cast<const sys::ubyte*>(data), numElements, elementSize);
     }
 
+    /*
+     *  \func writeRecords
+     *  \brief Encodes and swaps each scratch buffer's worth of records in
+     *  place, then queues it for writing
+     */
+    void writeRecords(const RecordEncoder& encode,
+                      size_t numRecords,
+                      size_t recordSize,
+                      size_t elementSize) override;
+
+    DataWriterLittleEndian(const DataWriterLittleEndian&) = delete;
+    DataWriterLittleEndian& operator=(const DataWriterLittleEndian&) = delete;
 
 private:
-    // Scratch space buffer
-    std::vector<std::byte> mScratch;
+    // Fills scratch buffers of up to 'chunkSize' bytes with 'fill' (given
+    // the byte offset into the data, the size and the buffer) and queues
+    // them until 'dataSize' bytes are written
+    void writeChunks(size_t dataSize,
+                     size_t chunkSize,
+                     const std::function<void(size_t, size_t, std::byte*)>& fill);
+
+    // Writes queued buffers to the stream, in order
+    void writeQueued();
+    // Waits until every queued buffer is written, then rethrows any
+    // error from the writer thread
+    void waitForWrites();
+
+    // Scratch space buffers, used round robin
+    std::vector<std::vector<std::byte> > mScratch;
+    // Bytes of each buffer waiting to be written, 0 if the buffer is free
+    std::vector<size_t> mPending;
+
+    // Indices of filled buffers, in write order
+    std::deque<size_t> mQueue;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::exception_ptr mError;
+    bool mStop = false;
+    std::thread mWriter;
 };
 
 /*
@@ -171,6 +272,16 @@ struct DataWriterBigEndian final : public DataWriter
     {
         (*this)(reinterpret_cast<const sys::ubyte*>(data), numElements, elementSize);
     }
+
+    /*
+     *  \func writeRecords
+     *  \brief Encodes records into a staging buffer and writes it; no
+     *  swapping is needed
+     */
+    void writeRecords(const RecordEncoder& encode,
+                      size_t numRecords,
+                      size_t recordSize,
+                      size_t elementSize) override;
 };
 
 
@@ -199,15 +310,23 @@ struct CRSDWriter
      *  \param schemaPaths (Optional) A vector of XML schema paths for validation
      *  \param numThreads (Optional) The number of threads to use for processing.
      *  \param scratchSpaceSize (Optional) The maximum size of internal scratch space
-     *         that may be used if byte swapping is necessary.
+     *         that may be used if byte swapping is necessary. It is split
+     *         into numScratchBuffers buffers so swapping overlaps writing.
      *         Default is 4 MB
+     *  \param threadPool (Optional) Pool the processing threads run on.
+     *         Default is ThreadPool::getDefault()
+     *  \param numScratchBuffers (Optional) Number of buffers the scratch
+     *         space is split into; this is how many chunks can be queued
+     *         for writing at once. Default is 2
      */
     CRSDWriter(
             const Metadata& metadata,
             std::shared_ptr<io::SeekableOutputStream> stream,
             const std::vector<std::string>& schemaPaths = std::vector<std::string>(),
             size_t numThreads = 0,
-            size_t scratchSpaceSize = 4 * 1024 * 1024);
+            size_t scratchSpaceSize = 4 * 1024 * 1024,
+            std::shared_ptr<ThreadPool> threadPool = nullptr,
+            size_t numScratchBuffers = 2);
 
     /*
      *  \func Constructor
@@ -225,15 +344,23 @@ struct CRSDWriter
      *  \param schemaPaths (Optional) A vector of XML schema paths for validation
      *  \param numThreads (Optional) The number of threads to use for processing.
      *  \param scratchSpaceSize (Optional) The maximum size of internal scratch space
-     *         that may be used if byte swapping is necessary.
+     *         that may be used if byte swapping is necessary. It is split
+     *         into numScratchBuffers buffers so swapping overlaps writing.
      *         Default is 4 MB
+     *  \param threadPool (Optional) Pool the processing threads run on.
+     *         Default is ThreadPool::getDefault()
+     *  \param numScratchBuffers (Optional) Number of buffers the scratch
+     *         space is split into; this is how many chunks can be queued
+     *         for writing at once. Default is 2
      */
     CRSDWriter(
             const Metadata& metadata,
             const std::string& pathname,
             const std::vector<std::string>& schemaPaths = std::vector<std::string>(),
             size_t numThreads = 0,
-            size_t scratchSpaceSize = 4 * 1024 * 1024);
+            size_t scratchSpaceSize = 4 * 1024 * 1024,
+            std::shared_ptr<ThreadPool> threadPool = nullptr,
+            size_t numScratchBuffers = 2);
 
     /*
      *  \func write
@@ -298,11 +425,87 @@ struct CRSDWriter
      */
     void writeMetadata(const PPPBlock& pppBlock);
 
+    /*
+     *  \func writeMetadata
+     *  \brief Writes the header and metadata and lays out the file for
+     *  streaming writes
+     *
+     *  Block sizes are computed from the metadata alone, so no PVP, PPP or
+     *  signal data needs to be in memory. Afterwards, writeVectors(),
+     *  writePVPs(), writePPPs() and writeSupportData() may be called in any
+     *  order, with any chunk size, until every block has been filled in.
+     *  The support, PPP and PVP blocks are zero filled here so any pads
+     *  between them are defined.
+     *
+     *  \throw except::Exception If the signal data is compressed
+     */
+    void writeMetadata();
+
+    /*
+     *  \func writeVectors
+     *  \brief Writes a range of signal vectors of one channel
+     *
+     *  Requires writeMetadata() to have been called first. This only works
+     *  with valid CRSDWriter data types:
+     *      std::complex<float>
+     *      std::complex<int16_t>
+     *      std::complex<int8_t>
+     *
+     *  \param channel 0-based channel to write to
+     *  \param firstVector First 0-based vector of the channel to write
+     *  \param data Whole vectors of samples, starting at 'firstVector'
+     *
+     *  \throw except::Exception If the data type doesn't match the metadata,
+     *  'data' isn't a whole number of vectors, or the vectors are out of range
+     */
+    template <typename T>
+    void writeVectors(size_t channel,
+                      size_t firstVector,
+                      std::span<const T> data);
+
+    /*
+     *  \func writePVPs
+     *  \brief Writes a range of PVP sets of one channel
+     *
+     *  Requires writeMetadata() to have been called first.
+     *
+     *  \param channel 0-based channel to write to
+     *  \param firstVector First 0-based vector of the channel to write
+     *  \param pvpBlock Consecutive PVP sets starting at 'firstVector', held in
+     *  channel 0 of the block (e.g. PVPBlock(1, {numVectors}, pvp))
+     *
+     *  \throw except::Exception If the PVP set size doesn't match the
+     *  metadata or the vectors are out of range
+     */
+    void writePVPs(size_t channel,
+                   size_t firstVector,
+                   const PVPBlock& pvpBlock);
+
+    /*
+     *  \func writePPPs
+     *  \brief Writes a range of PPP sets of one transmit sequence
+     *
+     *  Requires writeMetadata() to have been called first.
+     *
+     *  \param txSequence 0-based transmit sequence to write to
+     *  \param firstPulse First 0-based pulse of the sequence to write
+     *  \param pppBlock Consecutive PPP sets starting at 'firstPulse', held in
+     *  sequence 0 of the block (e.g. PPPBlock(1, {numPulses}, ppp))
+     *
+     *  \throw except::Exception If the PPP set size doesn't match the
+     *  metadata or the pulses are out of range
+     */
+    void writePPPs(size_t txSequence,
+                   size_t firstPulse,
+                   const PPPBlock& pppBlock);
+
     /*
      *  \func writeSupportData
      *  \brief Writes the specified support Array to the file
      *
-     *  Does not include padding.
+     *  Does not include padding. Seeks to the array's place in the support
+     *  block first, so arrays can be written in any order, before or after
+     *  the other blocks.
      *
      *  \param data A pointer to the start of the support array that
      *        will be written to file
@@ -312,6 +515,9 @@ struct CRSDWriter
     void writeSupportData(const T* data,
                           const std::string& id)
     {
+        mStream->seek(mHeader.getSupportBlockByteOffset() +
+                              mMetadata.data.getSupportArrayById(id).arrayByteOffset,
+                      io::SeekableOutputStream::START);
         writeSupportDataImpl(reinterpret_cast<const std::byte*>(data),
                              mMetadata.data.getSupportArrayById(id).numRows * mMetadata.data.getSupportArrayById(id).numCols,
                              mMetadata.data.getSupportArrayById(id).bytesPerElement);
@@ -375,7 +581,9 @@ struct CRSDWriter
      *  \param numElements The number of elements in data. Treat the data
      *  as complex when computing the size (do not multiply by 2
      *  for correct byte swapping this is done internally).
-     *  \param channel For selecting channel of compressed signal block
+     *  \param channel For selecting channel of compressed signal block.
+     *  A block from SignalChunkCompressor::getSignalBlock() holds every
+     *  channel and is written with a single call.
      */
     template <typename T>
     void writeCRSDData(const T* data,
@@ -399,15 +607,22 @@ private:
 
     /*
      *  Write pvp helper
+     *  Encodes every PVP set of one channel of the block into the output
      */
-    void writePVPData(const std::byte* pvpBlock,
-                      size_t index);
+    void writePVPData(const PVPBlock& pvpBlock,
+                      size_t channel);
 
     /*
      *  Write ppp helper
-     */                  
-    void writePPPData(const std::byte* pppBlock,
-                      size_t index);
+     *  Encodes every PPP set of one tx sequence of the block into the output
+     */
+    void writePPPData(const PPPBlock& pppBlock,
+                      size_t txSequence);
+
+    /*
+     *  Write zeros between blocks
+     */
+    void writePadding(int64_t numBytes);
 
     /*
      *  Implementation of write wideband
@@ -442,10 +657,16 @@ private:
     const size_t mScratchSpaceSize;
     //! number of threads for parallelism
     const size_t mNumThreads;
+    //! pool for the parallel work, nullptr for the default
+    const std::shared_ptr<ThreadPool> mThreadPool;
+    //! number of buffers the scratch space is split into
+    const size_t mNumScratchBuffers;
     //! schemas for XML validation
     const std::vector<std::string> mSchemaPaths;
     //! Output stream contains CRSD file
     std::shared_ptr<io::SeekableOutputStream> mStream;
+    //! Whether the header and metadata have been written
+    bool mMetadataWritten = false;
 };
 }
 
@@ -0,0 +1,257 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CRSD_MAPPED_SIGNAL_VIEW_H__
+#define __CRSD_MAPPED_SIGNAL_VIEW_H__
+#pragma once
+
+#include <string.h>
+#include <stddef.h>
+#include <complex>
+#include <iterator>
+#include <memory>
+
+#include <scene/sys_Conf.h>
+#include <std/cstddef>
+#include <crsd/PositionalInputStream.h>
+
+namespace crsd
+{
+/*
+ * \class MappedSignalView
+ * \brief Read-only view of memory-mapped signal samples
+ *
+ * Samples are decoded (and byte swapped if needed) one at a time as they
+ * are accessed, so touching a few vectors of a large channel only pages
+ * in those vectors. The view keeps its mapping alive.
+ *
+ * T is the component type of the signal array format:
+ *     int8_t  for CI2
+ *     int16_t for CI4
+ *     float   for CF8
+ */
+template <typename T>
+class MappedSignalView final
+{
+public:
+    typedef std::complex<T> value_type;
+
+    /*
+     * \class const_iterator
+     * \brief Random access iterator that decodes samples on dereference
+     */
+    class const_iterator final
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::complex<T> value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const std::complex<T>* pointer;
+        typedef std::complex<T> reference;
+
+        const_iterator() = default;
+        const_iterator(const MappedSignalView* view, size_t index) :
+            mView(view), mIndex(index)
+        {
+        }
+
+        std::complex<T> operator*() const
+        {
+            return (*mView)[mIndex];
+        }
+        std::complex<T> operator[](difference_type n) const
+        {
+            return (*mView)[mIndex + n];
+        }
+
+        const_iterator& operator++()
+        {
+            ++mIndex;
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator ret(*this);
+            ++mIndex;
+            return ret;
+        }
+        const_iterator& operator--()
+        {
+            --mIndex;
+            return *this;
+        }
+        const_iterator operator--(int)
+        {
+            const_iterator ret(*this);
+            --mIndex;
+            return ret;
+        }
+        const_iterator& operator+=(difference_type n)
+        {
+            mIndex += n;
+            return *this;
+        }
+        const_iterator& operator-=(difference_type n)
+        {
+            mIndex -= n;
+            return *this;
+        }
+        const_iterator operator+(difference_type n) const
+        {
+            return const_iterator(mView, mIndex + n);
+        }
+        const_iterator operator-(difference_type n) const
+        {
+            return const_iterator(mView, mIndex - n);
+        }
+        difference_type operator-(const const_iterator& rhs) const
+        {
+            return static_cast<difference_type>(mIndex) -
+                    static_cast<difference_type>(rhs.mIndex);
+        }
+
+        bool operator==(const const_iterator& rhs) const
+        {
+            return mIndex == rhs.mIndex;
+        }
+        bool operator!=(const const_iterator& rhs) const
+        {
+            return mIndex != rhs.mIndex;
+        }
+        bool operator<(const const_iterator& rhs) const
+        {
+            return mIndex < rhs.mIndex;
+        }
+        bool operator>(const const_iterator& rhs) const
+        {
+            return mIndex > rhs.mIndex;
+        }
+        bool operator<=(const const_iterator& rhs) const
+        {
+            return mIndex <= rhs.mIndex;
+        }
+        bool operator>=(const const_iterator& rhs) const
+        {
+            return mIndex >= rhs.mIndex;
+        }
+
+    private:
+        const MappedSignalView* mView = nullptr;
+        size_t mIndex = 0;
+    };
+
+    /*
+     *  \func MappedSignalView
+     *  \brief Wrap mapped big-endian samples
+     *
+     *  \param map Mapping that owns 'data'
+     *  \param data First sample of the view inside 'map'
+     *  \param numVectors Number of vectors in the view
+     *  \param numSamples Number of samples per vector
+     *  \param swap Whether samples need byte swapping on access
+     */
+    MappedSignalView(std::shared_ptr<const MemoryMap> map,
+                     const std::byte* data,
+                     size_t numVectors,
+                     size_t numSamples,
+                     bool swap) :
+        mMap(map),
+        mData(data),
+        mNumVectors(numVectors),
+        mNumSamples(numSamples),
+        mSwap(swap)
+    {
+    }
+
+    //! Number of vectors in the view
+    size_t getNumVectors() const
+    {
+        return mNumVectors;
+    }
+    //! Number of samples per vector
+    size_t getNumSamples() const
+    {
+        return mNumSamples;
+    }
+    //! Total number of samples in the view
+    size_t size() const
+    {
+        return mNumVectors * mNumSamples;
+    }
+    //! Undecoded samples, big-endian as in the file
+    const std::byte* data() const
+    {
+        return mData;
+    }
+
+    //! Decode the 'index'th sample, in vector-major order
+    std::complex<T> operator[](size_t index) const
+    {
+        const std::byte* const sample =
+                mData + index * sizeof(std::complex<T>);
+        return std::complex<T>(decode(sample), decode(sample + sizeof(T)));
+    }
+    //! Decode one sample of one vector (both 0-based, relative to the view)
+    std::complex<T> operator()(size_t vector, size_t sample) const
+    {
+        return (*this)[vector * mNumSamples + sample];
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const
+    {
+        return const_iterator(this, size());
+    }
+
+private:
+    // Go through bytes rather than casting so a byte swapped float is
+    // never loaded into a floating-point register before it's valid
+    T decode(const std::byte* in) const
+    {
+        T value;
+        if (mSwap)
+        {
+            std::byte swapped[sizeof(T)];
+            for (size_t ii = 0; ii < sizeof(T); ++ii)
+            {
+                swapped[ii] = in[sizeof(T) - 1 - ii];
+            }
+            memcpy(&value, swapped, sizeof(T));
+        }
+        else
+        {
+            memcpy(&value, in, sizeof(T));
+        }
+        return value;
+    }
+
+    std::shared_ptr<const MemoryMap> mMap;
+    const std::byte* mData;
+    size_t mNumVectors;
+    size_t mNumSamples;
+    bool mSwap;
+};
+}
+
+#endif
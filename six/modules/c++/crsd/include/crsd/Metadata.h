@@ -74,6 +74,7 @@ struct Metadata final : MetadataBase
     size_t getNumBytesPerSample() const override;   // 2, 4, or 8 bytes/complex sample
     size_t getCompressedSignalSize(size_t channel) const override;
     bool isCompressed() const override;
+    std::shared_ptr<const SignalChunkIndex> getSignalChunkIndex() const override;
 
     //! Get CRSD version
     std::string getVersion() const;
@@ -23,12 +23,15 @@
 #ifndef __CRSD_METADATA_BASE_H__
 #define __CRSD_METADATA_BASE_H__
 
+#include <memory>
 #include <ostream>
 #include <six/Init.h>
 #include <crsd/Enums.h>
 
 namespace crsd
 {
+struct SignalChunkIndex;
+
 /*!
  *  \class MetadataBase
  *  \brief Abstract base class for the CRSD and CRSD03 Metdata objects.
@@ -86,6 +89,18 @@ struct MetadataBase
     {
         return false;
     }
+
+    /*
+     * \func getSignalChunkIndex
+     * \brief Gets the chunk index of a signal block compressed in
+     *  independently decodable chunks
+     *
+     * \return nullptr by default, or if the signal block isn't chunked
+     */
+    virtual std::shared_ptr<const SignalChunkIndex> getSignalChunkIndex() const
+    {
+        return nullptr;
+    }
 };
 }
 
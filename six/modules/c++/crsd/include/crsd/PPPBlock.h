@@ -38,6 +38,8 @@
 #include <crsd/PPP.h>
 #include <crsd/Metadata.h>
 #include <crsd/ByteSwap.h>
+#include <crsd/ParameterCodec.h>
+#include <crsd/PositionalInputStream.h>
 #include <six/Parameter.h>
 
 namespace crsd
@@ -82,6 +84,9 @@ struct AddedPPP<std::string>
  *  \brief The PPP Block contains the actual PPP data
  *
  *  PPPBlock handles reading PPPBlock from CRSD file, and loading the data structure
+ *
+ *  Each tx sequence is stored by column: every parameter has one
+ *  contiguous array holding its value for all pulses of the sequence.
  */
 struct PPPBlock
 {
@@ -98,9 +103,12 @@ struct PPPBlock
      *  extract the number of txSequences and vectors of the VBM.
      *  The data metadata will also be updated with the number of ppp bytes required
      *  if provided number of bytes is not sufficient
+     *  \param allocate (Optional) If false, a tx sequence's arrays aren't
+     *  allocated until loadTxSequence() or load() reads it; until then the
+     *  tx sequence can't be accessed
     */
-    PPPBlock(const Ppp& ppp, const Data& data);
-    PPPBlock(const Metadata&);
+    PPPBlock(const Ppp& ppp, const Data& data, bool allocate = true);
+    PPPBlock(const Metadata&, bool allocate = true);
 
     /*!
      *  \func PPPBlock
@@ -169,15 +177,8 @@ struct PPPBlock
     template<typename T>
     T getAddedPPP(size_t txSequence, size_t set, const std::string& name) const
     {
-        verifyTxSequencePulse(txSequence, set);
-        if(mData[txSequence][set].addedPPP.count(name) == 1)
-        {
-            AddedPPP<T> aP;
-            return aP.getAddedPPP(mData[txSequence][set].addedPPP.find(name)->second);
-            // return AddPPPNamespace::getAddedPPP<T>(mData[txSequence][set].addedPPP.find(name)->second);
-        }
-        throw except::Exception(Ctxt(
-                "Parameter was not set"));
+        AddedPPP<T> aP;
+        return aP.getAddedPPP(getAddedParameter(txSequence, set, name));
     }
 
     //! Setter functions
@@ -200,20 +201,9 @@ struct PPPBlock
     template<typename T>
     void setAddedPPP(T value, size_t txSequence, size_t set, const std::string& name)
     {
-        verifyTxSequencePulse(txSequence, set);
-        if(mPpp.addedPPP.count(name) != 0)
-        {
-            if(mData[txSequence][set].addedPPP.count(name) == 0)
-            {
-                mData[txSequence][set].addedPPP[name] = six::Parameter();
-                mData[txSequence][set].addedPPP.find(name)->second.setValue(value);
-                return;
-            }
-            throw except::Exception(Ctxt(
-                                "Additional parameter requested already exists"));
-        }
-        throw except::Exception(Ctxt(
-                                "Parameter was not specified in XML"));
+        six::Parameter parameter;
+        parameter.setValue(value);
+        setAddedParameter(parameter, txSequence, set, name);
     }
 
     /*
@@ -239,6 +229,24 @@ struct PPPBlock
     void getPPPdata(size_t txSequence,
                     void*  data) const;
 
+    /*
+     *  \func getPPPdata
+     *  \brief Encode pulses [firstPulse, firstPulse + numPulses) only.
+     *  Bytes of a set that no parameter covers are zeroed.
+     *
+     *  \param txSequence 0 based index
+     *  \param firstPulse First pulse to encode
+     *  \param numPulses Number of pulses
+     *  \param[out] data A preallocated buffer of
+     *  numPulses * getNumBytesPPPSet() bytes
+     *
+     *  \throw except::Exception If the pulses are out of range
+     */
+    void getPPPdata(size_t txSequence,
+                    size_t firstPulse,
+                    size_t numPulses,
+                    void* data) const;
+
     /*
      *  \func getNumBytesVBP
      *  \brief Number of bytes per PPP seet
@@ -273,6 +281,8 @@ struct PPPBlock
      *  \param startPPP Offset of start of ppp block
      *  \param sizePPP Size of ppp block
      *  \param numThreads Number of threads desired for parallelism
+     *  \param threadPool (Optional) Pool for byte swapping; the default
+     *  pool if null
      *
      *  \throw except::Exception If reach EOF before reading sizePPP bytes
      *
@@ -283,8 +293,41 @@ struct PPPBlock
     int64_t load(io::SeekableInputStream& inStream,
                     int64_t startPPP,
                     int64_t sizePPP,
-                    size_t numThreads);
-    int64_t load(io::SeekableInputStream& inStream, const FileHeader&, size_t numThreads);
+                    size_t numThreads,
+                    ThreadPool* threadPool = nullptr);
+    int64_t load(io::SeekableInputStream& inStream, const FileHeader&, size_t numThreads,
+                 ThreadPool* threadPool = nullptr);
+
+    /*
+     *  \func loadTxSequence
+     *
+     *  \brief Reads in the PPP array of a single tx sequence
+     *
+     *  The other tx sequences are left as they are, so they can be
+     *  loaded on demand and from different threads.
+     *
+     *  \param inStream Input stream that contains a valid CRSD file
+     *  \param startPPP Offset of start of ppp block
+     *  \param sizePPP Size of ppp block
+     *  \param txSequence 0 based index
+     *  \param numThreads Number of threads desired for parallelism
+     *  \param threadPool (Optional) Pool for byte swapping; the default
+     *  pool if null
+     *
+     *  \throw except::Exception If the tx sequence does not exist or lies
+     *  outside of the ppp block
+     *
+     *  \return Returns the number of bytes read in
+     */
+    int64_t loadTxSequence(PositionalInputStream& inStream,
+                           int64_t startPPP,
+                           int64_t sizePPP,
+                           size_t txSequence,
+                           size_t numThreads,
+                           ThreadPool* threadPool = nullptr);
+    int64_t loadTxSequence(PositionalInputStream& inStream, const FileHeader&,
+                           size_t txSequence, size_t numThreads,
+                           ThreadPool* threadPool = nullptr);
 
     //! Equality operators
     bool operator==(const PPPBlock& other) const
@@ -298,62 +341,64 @@ struct PPPBlock
         return !((*this) == other);
     }
 
-protected:
+private:
     /*!
-     *  \struct PPPSet
+     *  \struct PPPArray
      *
-     *  \brief Parameters for each vector
+     *  \brief Parameters for every pulse of one tx sequence
      *
-     *  Stores a single set of parameters
-     *  Each txSequence consists of a PPP Array,
-     *  which consists of multiple sets
+     *  Each parameter is a column with one entry per pulse.
      */
-    struct PPPSet
+    struct PPPArray
     {
-        /*!
-         *  \func PPPSet
-         *
-         *  \brief Default constructor
-         */
-        PPPSet();
+        PPPArray() = default;
+        PPPArray(const Ppp& ppp, size_t numPulses);
+
+        size_t size() const
+        {
+            return txTime.size();
+        }
+
+        //! Decode plan from the layout of a PPP set to these columns
+        ParameterCodec getCodec(const Ppp& ppp);
+
+        //! Encode-only plan from these columns to the layout of a PPP set
+        ParameterCodec getCodec(const Ppp& ppp) const;
 
         /*
          *  \func write
          *
-         *  \brief Writes binary data input into PPP Set
+         *  \brief Writes binary PPP sets into the columns
          *
-         *  \param pppBlock A pppBlock struct to access optional parameter flags
-         *  \param ppp A filled out ppp sturcture. This will be used for
-         *  information on where to allocate memory and set each
-         *  parameter in a PPP set.
-         *  \param input A pointer to an array of bytes that contains the
-         *  parameter data to write into the ppp set
+         *  \param ppp A filled out ppp sturcture with the layout of a set
+         *  \param input Native endian PPP sets, 'stride' bytes apart, one
+         *  for each of the size() pulses
+         *  \param stride Number of bytes per PPP set in input
          */
-        void write(const PPPBlock& pppBlock, const Ppp& ppp, const sys::byte* input);
-        void write(const PPPBlock& pppBlock, const Ppp& ppp, const std::byte* input)
-        {
-            write(pppBlock, ppp, reinterpret_cast<const sys::byte*>(input));
-        }
+        void write(const Ppp& ppp, const std::byte* input, size_t stride);
 
         /*
          *  \func read
          *
-         *  \brief Read PPP set into binary data output
+         *  \brief Read some of the columns back into binary PPP sets
+         *
+         *  \param ppp A filled out ppp sturcture with the layout of a set
+         *  \param first First pulse to read
+         *  \param count Number of pulses to read
+         *  \param[out] output Buffer for 'count' PPP sets, 'stride' bytes
+         *  apart
+         *  \param stride Number of bytes per PPP set in output
          *
-         *  \param ppp A filled out ppp sturcture. This will be used for
-         *  information on where to allocate memory and set each
-         *  parameter in a PPP set.
-         *  \param[out] output A pointer to an array of allocated bytes that
-         *  will be written to
+         *  \throw except::Exception If an additional parameter is not set
          */
-        void read(const Ppp& ppp, sys::ubyte* output) const;
-        void read(const Ppp& ppp, std::byte* output) const
-        {
-            read(ppp, reinterpret_cast<sys::ubyte*>(output));
-        }
+        void read(const Ppp& ppp,
+                  size_t first,
+                  size_t count,
+                  std::byte* output,
+                  size_t stride) const;
 
         //! Equality operators
-        bool operator==(const PPPSet& other) const
+        bool operator==(const PPPArray& other) const
         {
             return txTime == other.txTime && txPos == other.txPos &&
                     txVel == other.txVel && fx1 == other.fx1 &&
@@ -361,39 +406,60 @@ protected:
                     fxFreq0 == other.fxFreq0 && fxRate == other.fxRate &&
                     txRadInt == other.txRadInt && txACX == other.txACX &&
                     txACY == other.txACY && txEB == other.txEB &&
-                    fxResponseIndex == other.fxResponseIndex && xmIndex == other.xmIndex &&
+                    fxResponseIndex == other.fxResponseIndex &&
+                    xmIndex == other.xmIndex && xmIndexSet == other.xmIndexSet &&
                     txmt == other.txmt && addedPPP == other.addedPPP;
         }
-        bool operator!=(const PPPSet& other) const
+        bool operator!=(const PPPArray& other) const
         {
             return !((*this) == other);
         }
 
         //! Required Parameters
-        std::pair<int64_t, double> txTime;
-        Vector3 txPos;
-        Vector3 txVel;
-        double fx1;
-        double fx2;
-        double txmt;
-        std::pair<int64_t, double> phiX0;
-        double fxFreq0;
-        double fxRate;
-        double txRadInt;
-        Vector3 txACX;
-        Vector3 txACY;
-        Vector2 txEB;
-        int64_t fxResponseIndex;
-        mem::ScopedCopyablePtr<std::int64_t> xmIndex;
-
-        //! (Optional) Additional parameters
-        std::unordered_map<std::string,six::Parameter> addedPPP;
+        std::vector<std::pair<int64_t, double> > txTime;
+        std::vector<Vector3> txPos;
+        std::vector<Vector3> txVel;
+        std::vector<double> fx1;
+        std::vector<double> fx2;
+        std::vector<double> txmt;
+        std::vector<std::pair<int64_t, double> > phiX0;
+        std::vector<double> fxFreq0;
+        std::vector<double> fxRate;
+        std::vector<double> txRadInt;
+        std::vector<Vector3> txACX;
+        std::vector<Vector3> txACY;
+        std::vector<Vector2> txEB;
+        std::vector<int64_t> fxResponseIndex;
+
+        //! (Optional) XMIndex, only meaningful where xmIndexSet is true
+        std::vector<int64_t> xmIndex;
+        std::vector<bool> xmIndexSet;
+
+        //! (Optional) Additional parameters, by name
+        std::unordered_map<std::string, AddedParameterColumn> addedPPP;
     };
-    friend std::ostream& operator<< (std::ostream& os, const PPPSet& p);
 
-private:
-    //! The PPP Block [Num Channles][Num Parameters]
-    std::vector<std::vector<PPPSet> > mData;
+    six::Parameter getAddedParameter(size_t txSequence,
+                                     size_t set,
+                                     const std::string& name) const;
+    void setAddedParameter(const six::Parameter& value,
+                           size_t txSequence,
+                           size_t set,
+                           const std::string& name);
+
+    //! Throws if the tx sequence doesn't exist
+    void verifyTxSequence(size_t txSequence) const;
+
+    //! Byte swap a tx sequence's PPP array read from file and store it
+    void decodeTxSequence(size_t txSequence,
+                          std::byte* buffer,
+                          size_t numThreads,
+                          ThreadPool* threadPool);
+
+    //! The PPP Block [Num TxSequences]
+    std::vector<PPPArray> mData;
+    //! Number of pulses in each tx sequence, whether or not it is allocated
+    std::vector<size_t> mNumPulses;
     //! Number of bytes per PPP vector
     size_t mNumBytesPerPulse = 0;
     //! PPP block metadata
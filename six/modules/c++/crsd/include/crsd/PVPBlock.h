@@ -31,6 +31,7 @@
 #include <unordered_map>
 
 #include <std/optional>
+#include <std/span>
 
 #include <scene/sys_Conf.h>
 #include <crsd/Types.h>
@@ -38,6 +39,8 @@
 #include <crsd/PVP.h>
 #include <crsd/Metadata.h>
 #include <crsd/ByteSwap.h>
+#include <crsd/ParameterCodec.h>
+#include <crsd/PositionalInputStream.h>
 #include <six/Parameter.h>
 
 namespace crsd
@@ -82,6 +85,9 @@ struct AddedPVP<std::string>
  *  \brief The PVP Block contains the actual PVP data
  *
  *  PVPBlock handles reading PVPBlock from CRSD file, and loading the data structure
+ *
+ *  Each channel is stored by column: every parameter has one contiguous
+ *  array holding its value for all vectors of the channel.
  */
 struct PVPBlock
 {
@@ -98,9 +104,12 @@ struct PVPBlock
      *  extract the number of channels and vectors of the VBM.
      *  The data metadata will also be updated with the number of pvp bytes required
      *  if provided number of bytes is not sufficient
+     *  \param allocate (Optional) If false, a channel's arrays aren't
+     *  allocated until loadChannel() or load() reads it; until then the
+     *  channel can't be accessed
     */
-    PVPBlock(const Pvp& pvp, const Data& data);
-    PVPBlock(const Metadata&);
+    PVPBlock(const Pvp& pvp, const Data& data, bool allocate = true);
+    PVPBlock(const Metadata&, bool allocate = true);
 
     /*!
      *  \func PVPBlock
@@ -170,17 +179,36 @@ struct PVPBlock
     template<typename T>
     T getAddedPVP(size_t channel, size_t set, const std::string& name) const
     {
-        verifyChannelVector(channel, set);
-        if(mData[channel][set].addedPVP.count(name) == 1)
-        {
-            AddedPVP<T> aP;
-            return aP.getAddedPVP(mData[channel][set].addedPVP.find(name)->second);
-            // return AddPVPNamespace::getAddedPVP<T>(mData[channel][set].addedPVP.find(name)->second);
-        }
-        throw except::Exception(Ctxt(
-                "Parameter was not set"));
+        AddedPVP<T> aP;
+        return aP.getAddedPVP(getAddedParameter(channel, set, name));
     }
 
+    /*
+     *  Bulk getter functions
+     *
+     *  Each returns the parameter for every vector of a channel as one
+     *  contiguous array, indexed by vector. The span is invalidated by
+     *  load() or assignment to this block.
+     *
+     *  \throw except::Exception If channel is out of range
+     */
+    std::span<const std::pair<int64_t, double>> getRcvStart(size_t channel) const;
+    std::span<const Vector3> getRcvPos(size_t channel) const;
+    std::span<const Vector3> getRcvVel(size_t channel) const;
+    std::span<const double> getFRCV1(size_t channel) const;
+    std::span<const double> getFRCV2(size_t channel) const;
+    std::span<const std::pair<int64_t, double>> getRefPhi0(size_t channel) const;
+    std::span<const double> getRefFreq(size_t channel) const;
+    std::span<const double> getDFIC0(size_t channel) const;
+    std::span<const double> getFICRate(size_t channel) const;
+    std::span<const Vector3> getRcvACX(size_t channel) const;
+    std::span<const Vector3> getRcvACY(size_t channel) const;
+    std::span<const Vector2> getRcvEB(size_t channel) const;
+    std::span<const int64_t> getSignal(size_t channel) const;
+    std::span<const double> getAmpSF(size_t channel) const;
+    std::span<const double> getDGRGC(size_t channel) const;
+    std::span<const int64_t> getTxPulseIndex(size_t channel) const;
+
     //! Setter functions
     void setRcvStart(std::pair<int64_t, double> value, size_t channel, size_t set);
     void setRcvPos(const Vector3& value, size_t channel, size_t set);
@@ -202,20 +230,9 @@ struct PVPBlock
     template<typename T>
     void setAddedPVP(T value, size_t channel, size_t set, const std::string& name)
     {
-        verifyChannelVector(channel, set);
-        if(mPvp.addedPVP.count(name) != 0)
-        {
-            if(mData[channel][set].addedPVP.count(name) == 0)
-            {
-                mData[channel][set].addedPVP[name] = six::Parameter();
-                mData[channel][set].addedPVP.find(name)->second.setValue(value);
-                return;
-            }
-            throw except::Exception(Ctxt(
-                                "Additional parameter requested already exists"));
-        }
-        throw except::Exception(Ctxt(
-                                "Parameter was not specified in XML"));
+        six::Parameter parameter;
+        parameter.setValue(value);
+        setAddedParameter(parameter, channel, set, name);
     }
 
     /*
@@ -241,6 +258,24 @@ struct PVPBlock
     void getPVPdata(size_t channel,
                     void*  data) const;
 
+    /*
+     *  \func getPVPdata
+     *  \brief Encode vectors [firstVector, firstVector + numVectors) only.
+     *  Bytes of a set that no parameter covers are zeroed.
+     *
+     *  \param channel 0 based index
+     *  \param firstVector First vector to encode
+     *  \param numVectors Number of vectors
+     *  \param[out] data A preallocated buffer of
+     *  numVectors * getNumBytesPVPSet() bytes
+     *
+     *  \throw except::Exception If the vectors are out of range
+     */
+    void getPVPdata(size_t channel,
+                    size_t firstVector,
+                    size_t numVectors,
+                    void* data) const;
+
     /*
      *  \func getNumBytesVBP
      *  \brief Number of bytes per PVP seet
@@ -269,6 +304,8 @@ struct PVPBlock
      *  \param startPVP Offset of start of pvp block
      *  \param sizePVP Size of pvp block
      *  \param numThreads Number of threads desired for parallelism
+     *  \param threadPool (Optional) Pool for byte swapping; the default
+     *  pool if null
      *
      *  \throw except::Exception If reach EOF before reading sizePVP bytes
      *
@@ -279,8 +316,41 @@ struct PVPBlock
     int64_t load(io::SeekableInputStream& inStream,
                     int64_t startPVP,
                     int64_t sizePVP,
-                    size_t numThreads);
-    int64_t load(io::SeekableInputStream& inStream, const FileHeader&, size_t numThreads);
+                    size_t numThreads,
+                    ThreadPool* threadPool = nullptr);
+    int64_t load(io::SeekableInputStream& inStream, const FileHeader&, size_t numThreads,
+                 ThreadPool* threadPool = nullptr);
+
+    /*
+     *  \func loadChannel
+     *
+     *  \brief Reads in the PVP array of a single channel
+     *
+     *  The other channels are left as they are, so channels can be
+     *  loaded on demand and from different threads.
+     *
+     *  \param inStream Input stream that contains a valid CRSD file
+     *  \param startPVP Offset of start of pvp block
+     *  \param sizePVP Size of pvp block
+     *  \param channel 0 based index
+     *  \param numThreads Number of threads desired for parallelism
+     *  \param threadPool (Optional) Pool for byte swapping; the default
+     *  pool if null
+     *
+     *  \throw except::Exception If the channel does not exist or lies
+     *  outside of the pvp block
+     *
+     *  \return Returns the number of bytes read in
+     */
+    int64_t loadChannel(PositionalInputStream& inStream,
+                        int64_t startPVP,
+                        int64_t sizePVP,
+                        size_t channel,
+                        size_t numThreads,
+                        ThreadPool* threadPool = nullptr);
+    int64_t loadChannel(PositionalInputStream& inStream, const FileHeader&,
+                        size_t channel, size_t numThreads,
+                        ThreadPool* threadPool = nullptr);
 
     //! Equality operators
     bool operator==(const PVPBlock& other) const
@@ -294,62 +364,64 @@ struct PVPBlock
         return !((*this) == other);
     }
 
-protected:
+private:
     /*!
-     *  \struct PVPSet
+     *  \struct PVPArray
      *
-     *  \brief Parameters for each vector
+     *  \brief Parameters for every vector of one channel
      *
-     *  Stores a single set of parameters
-     *  Each channel consists of a PVP Array,
-     *  which consists of multiple sets
+     *  Each parameter is a column with one entry per vector.
      */
-    struct PVPSet
+    struct PVPArray
     {
-        /*!
-         *  \func PVPSet
-         *
-         *  \brief Default constructor
-         */
-        PVPSet();
+        PVPArray() = default;
+        PVPArray(const Pvp& pvp, size_t numVectors);
+
+        size_t size() const
+        {
+            return rcvStart.size();
+        }
+
+        //! Decode plan from the layout of a PVP set to these columns
+        ParameterCodec getCodec(const Pvp& pvp);
+
+        //! Encode-only plan from these columns to the layout of a PVP set
+        ParameterCodec getCodec(const Pvp& pvp) const;
 
         /*
          *  \func write
          *
-         *  \brief Writes binary data input into PVP Set
+         *  \brief Writes binary PVP sets into the columns
          *
-         *  \param pvpBlock A pvpBlock struct to access optional parameter flags
-         *  \param pvp A filled out pvp sturcture. This will be used for
-         *  information on where to allocate memory and set each
-         *  parameter in a PVP set.
-         *  \param input A pointer to an array of bytes that contains the
-         *  parameter data to write into the pvp set
+         *  \param pvp A filled out pvp sturcture with the layout of a set
+         *  \param input Native endian PVP sets, 'stride' bytes apart, one
+         *  for each of the size() vectors
+         *  \param stride Number of bytes per PVP set in input
          */
-        void write(const PVPBlock& pvpBlock, const Pvp& pvp, const sys::byte* input);
-        void write(const PVPBlock& pvpBlock, const Pvp& pvp, const std::byte* input)
-        {
-            write(pvpBlock, pvp, reinterpret_cast<const sys::byte*>(input));
-        }
+        void write(const Pvp& pvp, const std::byte* input, size_t stride);
 
         /*
          *  \func read
          *
-         *  \brief Read PVP set into binary data output
+         *  \brief Read some of the columns back into binary PVP sets
          *
-         *  \param pvp A filled out pvp sturcture. This will be used for
-         *  information on where to allocate memory and set each
-         *  parameter in a PVP set.
-         *  \param[out] output A pointer to an array of allocated bytes that
-         *  will be written to
+         *  \param pvp A filled out pvp sturcture with the layout of a set
+         *  \param first First vector to read
+         *  \param count Number of vectors to read
+         *  \param[out] output Buffer for 'count' PVP sets, 'stride' bytes
+         *  apart
+         *  \param stride Number of bytes per PVP set in output
+         *
+         *  \throw except::Exception If an additional parameter is not set
          */
-        void read(const Pvp& pvp, sys::ubyte* output) const;
-        void read(const Pvp& pvp, std::byte* output) const
-        {
-            read(pvp, reinterpret_cast<sys::ubyte*>(output));
-        }
+        void read(const Pvp& pvp,
+                  size_t first,
+                  size_t count,
+                  std::byte* output,
+                  size_t stride) const;
 
         //! Equality operators
-        bool operator==(const PVPSet& other) const
+        bool operator==(const PVPArray& other) const
         {
             return rcvStart == other.rcvStart && rcvPos == other.rcvPos &&
                     rcvVel == other.rcvVel && frcv1 == other.frcv1 &&
@@ -361,37 +433,58 @@ protected:
                     dgrgc == other.dgrgc && txPulseIndex == other.txPulseIndex &&
                     addedPVP == other.addedPVP;
         }
-        bool operator!=(const PVPSet& other) const
+        bool operator!=(const PVPArray& other) const
         {
             return !((*this) == other);
         }
 
         //! Required Parameters
-        std::pair<int64_t, double> rcvStart;
-        Vector3 rcvPos;
-        Vector3 rcvVel;
-        double frcv1;
-        double frcv2;
-        std::pair<int64_t, double> refPhi0;
-        double refFreq;
-        double dfiC0;
-        double ficRate;
-        Vector3 rcvACX;
-        Vector3 rcvACY;
-        Vector2 rcvEB;
-        double signal;
-        double ampSF;
-        double dgrgc;
-        int64_t txPulseIndex;
-
-        //! (Optional) Additional parameters
-        std::unordered_map<std::string,six::Parameter> addedPVP;
+        std::vector<std::pair<int64_t, double> > rcvStart;
+        std::vector<Vector3> rcvPos;
+        std::vector<Vector3> rcvVel;
+        std::vector<double> frcv1;
+        std::vector<double> frcv2;
+        std::vector<std::pair<int64_t, double> > refPhi0;
+        std::vector<double> refFreq;
+        std::vector<double> dfiC0;
+        std::vector<double> ficRate;
+        std::vector<Vector3> rcvACX;
+        std::vector<Vector3> rcvACY;
+        std::vector<Vector2> rcvEB;
+        std::vector<int64_t> signal;
+        std::vector<double> ampSF;
+        std::vector<double> dgrgc;
+        std::vector<int64_t> txPulseIndex;
+
+        //! (Optional) Additional parameters, by name
+        std::unordered_map<std::string, AddedParameterColumn> addedPVP;
     };
-    friend std::ostream& operator<< (std::ostream& os, const PVPSet& p);
 
-private:
-    //! The PVP Block [Num Channles][Num Parameters]
-    std::vector<std::vector<PVPSet> > mData;
+    //! Returns the channel, or throws if it doesn't exist or isn't
+    //! allocated yet
+    const PVPArray& getChannel(size_t channel) const;
+
+    //! Throws if the channel doesn't exist
+    void verifyChannel(size_t channel) const;
+
+    //! Byte swap a channel's PVP array read from file and store it
+    void decodeChannel(size_t channel,
+                    std::byte* buffer,
+                    size_t numThreads,
+                    ThreadPool* threadPool);
+
+    six::Parameter getAddedParameter(size_t channel,
+                                     size_t set,
+                                     const std::string& name) const;
+    void setAddedParameter(const six::Parameter& value,
+                           size_t channel,
+                           size_t set,
+                           const std::string& name);
+
+    //! The PVP Block [Num Channels]
+    std::vector<PVPArray> mData;
+    //! Number of vectors in each channel, whether or not it is allocated
+    std::vector<size_t> mNumVectors;
     //! Number of bytes per PVP vector
     size_t mNumBytesPerVector = 0;
     //! PVP block metadata
@@ -0,0 +1,212 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CRSD_PARAMETER_CODEC_H__
+#define __CRSD_PARAMETER_CODEC_H__
+#pragma once
+
+#include <stddef.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <std/cstddef>
+
+#include <six/Parameter.h>
+
+namespace crsd
+{
+/*
+ * \class ParameterCodec
+ * \brief Copies PVP or PPP sets to and from per-parameter columns
+ *
+ * The layout of a set is compiled once into a table of fields. Each field
+ * maps a byte offset within a set to a column holding one element per
+ * set. decode() and encode() then walk any number of sets without
+ * looking at parameter names or formats.
+ */
+class ParameterCodec final
+{
+public:
+    /*
+     *  \func addField
+     *  \brief Add a field that is copied byte for byte
+     *
+     *  \param offset Byte offset of the field within a set
+     *  \param size Number of bytes in the field
+     *  \param column First element of the column
+     *  \param stride Number of bytes between elements of the column
+     */
+    void addField(size_t offset, size_t size, void* column, size_t stride);
+
+    /*
+     *  \func addField
+     *  \brief Same as above, for a column that is only encoded from.
+     *  decode() throws if any field is read-only.
+     */
+    void addField(size_t offset, size_t size, const void* column, size_t stride);
+
+    /*
+     *  \func addIntegerField
+     *  \brief Add an integer field that a set holds as a double
+     *
+     *  \param offset Byte offset of the field within a set
+     *  \param column First element of the column
+     *  \param stride Number of bytes between elements of the column
+     */
+    void addIntegerField(size_t offset, int64_t* column, size_t stride);
+
+    //! Read-only version of the above
+    void addIntegerField(size_t offset, const int64_t* column, size_t stride);
+
+    //! Add a field stored in a column of T
+    template<typename T>
+    void addColumn(size_t offset, std::vector<T>& column)
+    {
+        addField(offset, sizeof(T), column.data(), sizeof(T));
+    }
+
+    //! Add a read-only field stored in a column of T
+    template<typename T>
+    void addColumn(size_t offset, const std::vector<T>& column)
+    {
+        addField(offset, sizeof(T), column.data(), sizeof(T));
+    }
+
+    /*
+     *  \func decode
+     *  \brief Copy sets into the columns
+     *
+     *  \param input Native endian sets, 'stride' bytes apart
+     *  \param stride Number of bytes per set
+     *  \param numSets Number of sets; every column must have this many
+     *  elements
+     *
+     *  \throw except::Exception If any field is read-only
+     */
+    void decode(const std::byte* input, size_t stride, size_t numSets) const;
+
+    /*
+     *  \func encode
+     *  \brief Copy the columns into sets. Bytes of a set that aren't
+     *  covered by a field are left untouched.
+     *
+     *  \param[out] output Buffer for 'numSets' sets, 'stride' bytes apart
+     *  \param stride Number of bytes per set
+     *  \param numSets Number of sets
+     */
+    void encode(std::byte* output, size_t stride, size_t numSets) const
+    {
+        encode(output, stride, 0, numSets);
+    }
+
+    /*
+     *  \func encode
+     *  \brief Same as above, for column elements
+     *  [firstSet, firstSet + numSets) only
+     *
+     *  \param[out] output Buffer for 'numSets' sets, 'stride' bytes apart
+     *  \param stride Number of bytes per set
+     *  \param firstSet Column element that goes in the first set
+     *  \param numSets Number of sets
+     */
+    void encode(std::byte* output,
+                size_t stride,
+                size_t firstSet,
+                size_t numSets) const;
+
+    /*
+     *  \func toParameter
+     *  \brief Convert one value of an added parameter to a Parameter
+     *
+     *  \param format Format string of the parameter, e.g. "F8" or "CI4".
+     *  Unknown formats are treated as strings.
+     *  \param value The value as stored in a set
+     *  \param size Number of bytes in the value
+     */
+    static six::Parameter toParameter(const std::string& format,
+                                      const std::byte* value,
+                                      size_t size);
+
+    /*
+     *  \func fromParameter
+     *  \brief Convert a Parameter to the binary form of an added parameter
+     *
+     *  Strings are truncated or zero padded to 'size' bytes.
+     *
+     *  \param parameter The value to convert
+     *  \param format Format string of the parameter
+     *  \param[out] value Buffer of 'size' bytes
+     *  \param size Number of bytes in the value
+     */
+    static void fromParameter(const six::Parameter& parameter,
+                              const std::string& format,
+                              std::byte* value,
+                              size_t size);
+
+private:
+    struct Field
+    {
+        size_t offset;
+        size_t size;
+        //! Where encode() reads from
+        const std::byte* source;
+        //! Where decode() writes to; nullptr if the field is read-only
+        std::byte* destination;
+        size_t stride;
+        bool isInteger;
+    };
+    std::vector<Field> mFields;
+};
+
+/*
+ * \struct AddedParameterColumn
+ * \brief One added PVP or PPP parameter for every set of an array
+ *
+ * Values are kept as they are laid out in a set, byteSize bytes each,
+ * and only converted when accessed.
+ */
+struct AddedParameterColumn
+{
+    AddedParameterColumn(size_t byteSize, size_t numSets) :
+        byteSize(byteSize),
+        values(numSets * byteSize),
+        isSet(numSets, false)
+    {
+    }
+
+    bool operator==(const AddedParameterColumn& other) const
+    {
+        return values == other.values && isSet == other.isSet;
+    }
+    bool operator!=(const AddedParameterColumn& other) const
+    {
+        return !((*this) == other);
+    }
+
+    //! Number of bytes per value
+    size_t byteSize;
+    std::vector<std::byte> values;
+    std::vector<bool> isSet;
+};
+}
+
+#endif
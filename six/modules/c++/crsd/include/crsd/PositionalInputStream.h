@@ -0,0 +1,271 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CRSD_POSITIONAL_INPUT_STREAM_H__
+#define __CRSD_POSITIONAL_INPUT_STREAM_H__
+#pragma once
+
+#include <stddef.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <scene/sys_Conf.h>
+#include <std/cstddef>
+#include <std/span>
+#include <io/SeekableStreams.h>
+#include <sys/File.h>
+
+namespace crsd
+{
+class ThreadPool;
+
+/*
+ * \class MemoryMap
+ * \brief Read-only memory mapping of a byte range of a file
+ *
+ * The mapping is released when the object is destroyed.
+ */
+class MemoryMap final
+{
+public:
+    /*
+     *  \func MemoryMap
+     *  \brief Map 'size' bytes of an open file starting at 'offset'
+     *
+     *  \param file Open file to map; only needs to stay open during
+     *  construction
+     *  \param offset Absolute byte offset from the start of the file
+     *  \param size Number of bytes to map
+     *
+     *  \throw except::Exception If the range cannot be mapped
+     */
+    MemoryMap(sys::File& file, int64_t offset, size_t size);
+    ~MemoryMap();
+
+    //! Start of the requested range (not necessarily page aligned)
+    const std::byte* data() const
+    {
+        return mData;
+    }
+    //! Number of bytes in the requested range
+    size_t size() const
+    {
+        return mSize;
+    }
+
+    MemoryMap(const MemoryMap&) = delete;
+    MemoryMap& operator=(const MemoryMap&) = delete;
+
+private:
+    void* mBase = nullptr;  // page aligned start of the mapping
+    size_t mMappedSize = 0;
+    const std::byte* mData = nullptr;
+    size_t mSize = 0;
+};
+
+/*
+ * \struct ReadRequest
+ * \brief One read submitted with PositionalInputStream::readBatch()
+ */
+struct ReadRequest final
+{
+    //! Absolute byte offset from the start of the file
+    int64_t offset = 0;
+    //! Pre-allocated buffer of at least 'size' bytes
+    void* buffer = nullptr;
+    //! Number of bytes to read
+    size_t size = 0;
+};
+
+/*
+ * \class PositionalInputStream
+ * \brief Offset-addressed reads with no shared file position
+ *
+ * Every readAt() names its own absolute byte offset, so implementations
+ * must allow any number of threads to call readAt() at the same time.
+ */
+struct PositionalInputStream
+{
+    virtual ~PositionalInputStream() = default;
+
+    /*
+     *  \func readAt
+     *  \brief Read exactly 'size' bytes starting at 'offset'
+     *
+     *  \param offset Absolute byte offset from the start of the file
+     *  \param[out] buffer Pre-allocated buffer of at least 'size' bytes
+     *  \param size Number of bytes to read
+     *
+     *  \throw except::Exception If fewer than 'size' bytes are available
+     */
+    virtual void readAt(int64_t offset, void* buffer, size_t size) = 0;
+
+    /*
+     *  \func readStrided
+     *  \brief Read 'count' equally spaced runs of 'size' bytes into a
+     *  contiguous buffer
+     *
+     *  Run ii starts at 'offset + ii * stride' in the file and lands at
+     *  'buffer + ii * size'. The bytes between runs are read and thrown
+     *  away, so this only pays off when the gaps are small. The default
+     *  reads spans of several runs into a bounce buffer and compacts them.
+     *
+     *  \param offset Absolute byte offset of the first run
+     *  \param size Number of bytes in each run
+     *  \param stride Bytes from the start of one run to the next
+     *  \param count Number of runs
+     *  \param[out] buffer Pre-allocated buffer of at least size * count bytes
+     *
+     *  \throw except::Exception If stride is less than size or the file
+     *  ends early
+     */
+    virtual void readStrided(int64_t offset,
+                             size_t size,
+                             size_t stride,
+                             size_t count,
+                             void* buffer);
+
+    /*
+     *  \func readBatch
+     *  \brief Read every request in full, keeping as many of them in
+     *  flight at once as the stream supports
+     *
+     *  Requests may complete in any order, so their buffers must not
+     *  overlap. The default reads them one at a time with readAt().
+     *
+     *  \param requests Reads to do
+     *  \param threadPool Pool for streams that spread reads over threads,
+     *  or nullptr for ThreadPool::getDefault()
+     *
+     *  \throw except::Exception If any request cannot be read in full.
+     *  Every request has finished, one way or the other, by then.
+     */
+    virtual void readBatch(std::span<const ReadRequest> requests,
+                           ThreadPool* threadPool = nullptr);
+
+    /*
+     *  \func map
+     *  \brief Memory map 'size' bytes starting at 'offset', read-only
+     *
+     *  \param offset Absolute byte offset from the start of the file
+     *  \param size Number of bytes to map
+     *
+     *  \return The mapping, or nullptr if this stream cannot be mapped
+     */
+    virtual std::shared_ptr<const MemoryMap> map(int64_t /*offset*/,
+                                                 size_t /*size*/)
+    {
+        return nullptr;
+    }
+};
+
+/*
+ * \class FilePositionalInputStream
+ * \brief Reads a file with pread() (overlapped ReadFile() on Windows)
+ *
+ * Reads never touch the file pointer, so concurrent readAt() calls
+ * proceed in parallel without any locking. readBatch() queues up to
+ * QUEUE_DEPTH reads at once with io_uring on Linux, and otherwise spreads
+ * them over the ThreadPool it is given.
+ */
+class FilePositionalInputStream final : public PositionalInputStream
+{
+public:
+    /*
+     *  \func FilePositionalInputStream
+     *  \brief Open 'pathname' read-only
+     *
+     *  \param pathname File to read
+     */
+    explicit FilePositionalInputStream(const std::string& pathname);
+    ~FilePositionalInputStream();
+
+    //! Most reads readBatch() keeps queued on one io_uring
+    static const unsigned QUEUE_DEPTH = 64;
+
+    //! Whether readBatch() can use io_uring in this process; the kernel
+    //! or a seccomp policy may not allow it
+    static bool isIoUringAvailable();
+
+    void readAt(int64_t offset, void* buffer, size_t size) override;
+
+    void readBatch(std::span<const ReadRequest> requests,
+                   ThreadPool* threadPool = nullptr) override;
+
+    /*
+     *  Scatters each span of runs straight into 'buffer' with preadv(),
+     *  sending the gaps to a discard buffer, so nothing is compacted
+     *  afterwards
+     */
+    void readStrided(int64_t offset,
+                     size_t size,
+                     size_t stride,
+                     size_t count,
+                     void* buffer) override;
+
+    std::shared_ptr<const MemoryMap> map(int64_t offset,
+                                         size_t size) override;
+
+private:
+    struct Ring;
+
+    void readBatchWithThreads(std::span<const ReadRequest> requests,
+                              ThreadPool& threadPool);
+
+    sys::File mFile;
+
+    //! Idle rings, reused by later batches
+    std::mutex mRingMutex;
+    std::vector<std::unique_ptr<Ring> > mRings;
+};
+
+/*
+ * \class SeekablePositionalInputStream
+ * \brief Adapts an io::SeekableInputStream to PositionalInputStream
+ *
+ * Generic streams only have a single cursor, so each seek() + read() pair
+ * is done under a lock. This makes concurrent readAt() calls safe, but
+ * they are serialized. Other users of the same stream do not take this
+ * lock and must not read from it concurrently.
+ */
+class SeekablePositionalInputStream final : public PositionalInputStream
+{
+public:
+    /*
+     *  \func SeekablePositionalInputStream
+     *  \brief Wrap an already opened stream
+     *
+     *  \param inStream Stream to read from
+     */
+    explicit SeekablePositionalInputStream(
+            std::shared_ptr<io::SeekableInputStream> inStream);
+
+    void readAt(int64_t offset, void* buffer, size_t size) override;
+
+private:
+    const std::shared_ptr<io::SeekableInputStream> mInStream;
+    std::mutex mMutex;
+};
+}
+
+#endif
@@ -0,0 +1,225 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CRSD_SIGNAL_CHUNK_INDEX_H__
+#define __CRSD_SIGNAL_CHUNK_INDEX_H__
+#pragma once
+
+#include <stddef.h>
+#include <complex>
+#include <functional>
+#include <vector>
+
+#include <std/cstddef>
+#include <std/span>
+
+#include <except/Exception.h>
+#include <crsd/Data.h>
+#include <crsd/ThreadPool.h>
+
+namespace crsd
+{
+/*
+ * \struct SignalChunkIndex
+ * \brief Locates the zlib chunks of a chunked compressed signal block
+ *
+ * Signal blocks compressed with SignalChunkCompressor store each channel
+ * as a series of chunks of 'vectorsPerChunk' whole vectors. Every chunk is
+ * a separate zlib stream of the big-endian samples, so any range of
+ * vectors can be read by inflating only the chunks it touches.
+ *
+ * The index is kept in the metadata: SignalCompression::identifier is
+ * IDENTIFIER, and one Processing entry of type PROCESSING_TYPE holds a
+ * "VectorsPerChunk" parameter and a "ChunkOffsets<channel>" parameter per
+ * channel listing the chunk offsets.
+ */
+struct SignalChunkIndex
+{
+    //! SignalCompression::identifier of chunked signal blocks
+    static const char IDENTIFIER[];
+
+    //! Processing::type of the entry holding the index
+    static const char PROCESSING_TYPE[];
+
+    SignalChunkIndex() = default;
+
+    /*
+     *  \func SignalChunkIndex
+     *  \brief Parse the index from the metadata
+     *
+     *  \param signalCompression Signal compression of a chunked signal
+     *  block, see isChunked()
+     *  \param numChannels Number of channels the index must describe
+     *
+     *  \throw except::Exception If the index is missing or malformed
+     */
+    SignalChunkIndex(const Data::SignalCompression& signalCompression,
+                     size_t numChannels);
+
+    //! Whether the signal block was compressed by SignalChunkCompressor
+    static bool isChunked(const Data::SignalCompression& signalCompression);
+
+    /*
+     *  \func update
+     *  \brief Record the index, identifier and total compressed size
+     *
+     *  Any previous index is replaced; other processing entries are kept.
+     *
+     *  \param[out] signalCompression Signal compression to fill in
+     */
+    void update(Data::SignalCompression& signalCompression) const;
+
+    //! Number of chunks of 'channel'
+    size_t getNumChunks(size_t channel) const
+    {
+        return offsets.at(channel).size() - 1;
+    }
+
+    //! Number of vectors in each chunk but the last of a channel
+    size_t vectorsPerChunk = 0;
+
+    //! For every channel, the byte offset of each chunk from the start of
+    //! the signal block, followed by the offset of the end of the last one
+    std::vector<std::vector<size_t> > offsets;
+};
+
+/*
+ * \class SignalChunkCompressor
+ * \brief Builds a chunked compressed signal block
+ *
+ * Compress every channel, call update() on the metadata before it is
+ * handed to CRSDWriter, and write getSignalBlock() as the compressed
+ * signal data. The chunks of a channel are compressed in parallel.
+ */
+class SignalChunkCompressor final
+{
+public:
+    /*
+     *  \func SignalChunkCompressor
+     *  \brief Set up for the channels described by 'data'
+     *
+     *  \param data Describes the channels and the signal array format
+     *  \param vectorsPerChunk Number of vectors per chunk. Smaller chunks
+     *  make partial reads cheaper, larger ones compress better.
+     *  \param level zlib compression level, 1 (fastest) to 9 (smallest)
+     *  \param threadPool (Optional) Pool to compress on; the default pool
+     *  if null
+     */
+    SignalChunkCompressor(const Data& data,
+                          size_t vectorsPerChunk,
+                          int level = 6,
+                          ThreadPool* threadPool = nullptr);
+
+    /*
+     *  \func compress
+     *  \brief Compress all vectors of one channel
+     *
+     *  \param channel 0-based channel
+     *  \param samples Native endian samples of the whole channel, vector
+     *  major
+     *
+     *  \throw except::Exception If the sample type doesn't match the signal
+     *  array format or the channel size
+     */
+    template <typename T>
+    void compress(size_t channel, std::span<const std::complex<T> > samples)
+    {
+        if (sizeof(std::complex<T>) != mElementSize)
+        {
+            throw except::Exception(
+                    Ctxt("Incorrect buffer data type used for metadata!"));
+        }
+        compressImpl(channel,
+                     reinterpret_cast<const std::byte*>(samples.data()),
+                     samples.size());
+    }
+
+    /*
+     *  \func update
+     *  \brief Record the chunk index in the metadata
+     *
+     *  \param[out] data Metadata the file will be written with; its
+     *  signal compression is created if needed
+     *
+     *  \throw except::Exception If a channel hasn't been compressed
+     */
+    void update(Data& data) const;
+
+    /*
+     *  \func getSignalBlock
+     *  \brief The compressed signal block, all channels back to back
+     *
+     *  \throw except::Exception If a channel hasn't been compressed
+     */
+    std::vector<std::byte> getSignalBlock() const;
+
+    SignalChunkCompressor(const SignalChunkCompressor&) = delete;
+    SignalChunkCompressor& operator=(const SignalChunkCompressor&) = delete;
+
+private:
+    void compressImpl(size_t channel,
+                      const std::byte* samples,
+                      size_t numSamples);
+
+    SignalChunkIndex getIndex() const;
+
+    const Data& mData;
+    const size_t mElementSize;
+    const size_t mVectorsPerChunk;
+    const int mLevel;
+    ThreadPool* const mThreadPool;
+
+    //! Compressed chunks of each channel, empty until compressed
+    std::vector<std::vector<std::vector<std::byte> > > mChunks;
+};
+
+/*
+ *  \func decompressSignalChunk
+ *  \brief Inflate one chunk of a chunked signal block
+ *
+ *  \param input The compressed chunk
+ *  \param[out] output Receives exactly the big-endian samples of the chunk
+ *
+ *  \throw except::Exception If the chunk is corrupt or doesn't inflate to
+ *  output.size() bytes
+ */
+void decompressSignalChunk(std::span<const std::byte> input,
+                           std::span<std::byte> output);
+
+/*
+ *  \func processSignalChunks
+ *  \brief Call 'process' on each of a run of chunks in parallel
+ *
+ *  Shared by SignalChunkCompressor and Wideband. A single chunk is
+ *  processed on the calling thread.
+ *
+ *  \param firstChunk First chunk to process
+ *  \param numChunks Number of chunks to process
+ *  \param process Called with each chunk number
+ *  \param threadPool (Optional) Pool to run on; the default pool if null
+ */
+void processSignalChunks(size_t firstChunk,
+                         size_t numChunks,
+                         const std::function<void(size_t)>& process,
+                         ThreadPool* threadPool = nullptr);
+}
+
+#endif
@@ -0,0 +1,223 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CRSD_SUPPORT_ARRAY_VIEW_H__
+#define __CRSD_SUPPORT_ARRAY_VIEW_H__
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <std/cstddef>
+#include <std/span>
+
+#include <except/Exception.h>
+#include <crsd/SupportArray.h>
+#include <crsd/Types.h>
+
+namespace crsd
+{
+/*
+ * \class SupportArrayView
+ * \brief Decoded support array with lookups in grid coordinates
+ *
+ * Element (m, n) sits at X = x0 + m * xSS, Y = y0 + n * ySS and holds
+ * getNumComponents() values of type T (e.g. two floats for an
+ * antenna array with format "Gain=F4;Phase=F4;"). Values are in native
+ * byte order; the view shares them with the SupportBlock that decoded
+ * them, so it is cheap to copy.
+ */
+template <typename T>
+class SupportArrayView final
+{
+public:
+    /*
+     *  \func SupportArrayView
+     *  \brief Wrap decoded support array values
+     *
+     *  \param values Native byte order values, row major
+     *  \param numRows Number of rows (X samples)
+     *  \param numCols Number of columns (Y samples)
+     *  \param numComponents Number of T values in each element
+     *  \param parameter Grid origin and spacing of the array
+     *
+     *  \throw except::Exception If 'values' is the wrong size or the grid
+     *  spacing is zero
+     */
+    SupportArrayView(std::shared_ptr<const std::vector<std::byte> > values,
+                     size_t numRows,
+                     size_t numCols,
+                     size_t numComponents,
+                     const SupportArrayParameter& parameter) :
+        mValues(values),
+        mData(values ? reinterpret_cast<const T*>(values->data()) : nullptr),
+        mNumRows(numRows),
+        mNumCols(numCols),
+        mNumComponents(numComponents),
+        mX0(parameter.x0),
+        mY0(parameter.y0),
+        mXSS(parameter.xSS),
+        mYSS(parameter.ySS)
+    {
+        if (!values || numRows == 0 || numCols == 0 || numComponents == 0 ||
+            values->size() != numRows * numCols * numComponents * sizeof(T))
+        {
+            throw except::Exception(Ctxt(
+                    "Support array values don't match its dimensions"));
+        }
+        if (mXSS == 0 || mYSS == 0)
+        {
+            throw except::Exception(Ctxt(
+                    "Support array " + parameter.getIdentifier() +
+                    " has zero sample spacing"));
+        }
+    }
+
+    size_t getNumRows() const
+    {
+        return mNumRows;
+    }
+    size_t getNumCols() const
+    {
+        return mNumCols;
+    }
+    size_t getNumComponents() const
+    {
+        return mNumComponents;
+    }
+
+    //! Row major values, getNumComponents() per element
+    std::span<const T> data() const
+    {
+        return std::span<const T>(mData, mNumRows * mNumCols * mNumComponents);
+    }
+
+    //! Value of one component of element (row, col)
+    T operator()(size_t row, size_t col, size_t component = 0) const
+    {
+        return mData[(row * mNumCols + col) * mNumComponents + component];
+    }
+
+    /*
+     *  \func sample
+     *  \brief Bilinearly interpolate the array at each (X, Y) position
+     *
+     *  Positions outside the grid are clamped to its edges. Each
+     *  component is interpolated separately, in double precision, and
+     *  written to out[ii * getNumComponents() + component].
+     *
+     *  \param xy Positions in the array's X and Y coordinates
+     *  \param[out] out Pre-allocated, xy.size() * getNumComponents() values
+     *
+     *  \throw except::Exception If 'out' is the wrong size or a position
+     *  is NaN or infinite
+     */
+    void sample(std::span<const Vector2> xy, std::span<T> out) const
+    {
+        if (out.size() != xy.size() * mNumComponents)
+        {
+            throw except::Exception(Ctxt(
+                    "Output needs one value per position and component"));
+        }
+
+        // Checked up front so nothing in the loops below can throw
+        for (const auto& position : xy)
+        {
+            if (!std::isfinite(position[0]) || !std::isfinite(position[1]))
+            {
+                throw except::Exception(Ctxt(
+                        "Support array positions must be finite"));
+            }
+        }
+
+        // Grid positions are worked out a block at a time in flat loops
+        // the compiler can vectorize, then the corners are gathered
+        static constexpr size_t BLOCK_SIZE = 256;
+        size_t offsets[BLOCK_SIZE];
+        double rowWeights[BLOCK_SIZE];
+        double colWeights[BLOCK_SIZE];
+
+        const double xScale = 1.0 / mXSS;
+        const double yScale = 1.0 / mYSS;
+        const double lastRow = static_cast<double>(mNumRows - 1);
+        const double lastCol = static_cast<double>(mNumCols - 1);
+        // Start of the last 2x2 cell, so its far corner is still inside
+        const size_t maxRow0 = mNumRows > 1 ? mNumRows - 2 : 0;
+        const size_t maxCol0 = mNumCols > 1 ? mNumCols - 2 : 0;
+        const size_t rowStep = mNumRows > 1 ? mNumCols * mNumComponents : 0;
+        const size_t colStep = mNumCols > 1 ? mNumComponents : 0;
+
+        for (size_t start = 0; start < xy.size(); start += BLOCK_SIZE)
+        {
+            const size_t count = std::min(BLOCK_SIZE, xy.size() - start);
+            for (size_t ii = 0; ii < count; ++ii)
+            {
+                const Vector2& position = xy[start + ii];
+                const double row = std::min(std::max(
+                        (position[0] - mX0) * xScale, 0.0), lastRow);
+                const double col = std::min(std::max(
+                        (position[1] - mY0) * yScale, 0.0), lastCol);
+                // Truncation is floor() here, since row and col aren't
+                // negative
+                const size_t row0 = std::min(static_cast<size_t>(row), maxRow0);
+                const size_t col0 = std::min(static_cast<size_t>(col), maxCol0);
+                rowWeights[ii] = row - static_cast<double>(row0);
+                colWeights[ii] = col - static_cast<double>(col0);
+                offsets[ii] = (row0 * mNumCols + col0) * mNumComponents;
+            }
+
+            T* const output = out.data() + start * mNumComponents;
+            for (size_t ii = 0; ii < count; ++ii)
+            {
+                const T* const corner = mData + offsets[ii];
+                for (size_t cc = 0; cc < mNumComponents; ++cc)
+                {
+                    const double v00 = corner[cc];
+                    const double v01 = corner[cc + colStep];
+                    const double v10 = corner[cc + rowStep];
+                    const double v11 = corner[cc + rowStep + colStep];
+                    const double top = v00 + (v01 - v00) * colWeights[ii];
+                    const double bottom = v10 + (v11 - v10) * colWeights[ii];
+                    output[ii * mNumComponents + cc] = static_cast<T>(
+                            top + (bottom - top) * rowWeights[ii]);
+                }
+            }
+        }
+    }
+
+private:
+    std::shared_ptr<const std::vector<std::byte> > mValues;
+    const T* mData;
+    size_t mNumRows;
+    size_t mNumCols;
+    size_t mNumComponents;
+    double mX0;
+    double mY0;
+    double mXSS;
+    double mYSS;
+};
+}
+
+#endif
@@ -24,9 +24,14 @@
 #pragma once
 
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <complex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <std/cstddef>
 
@@ -37,6 +42,9 @@
 #include <mem/BufferView.h>
 
 #include <crsd/Data.h>
+#include <crsd/PositionalInputStream.h>
+#include <crsd/SupportArray.h>
+#include <crsd/SupportArrayView.h>
 #include <crsd/Utilities.h>
 
 namespace crsd
@@ -84,6 +92,22 @@ struct SupportBlock final
     SupportBlock(std::shared_ptr<io::SeekableInputStream> inStream,
         const crsd::Data& data, const FileHeader&);
 
+    /*
+     *  \func SupportBlock
+     *
+     *  \brief Constructor initializes book keeping information
+     *
+     *  Arrays are read with readAt(), so the stream can be shared with
+     *  other readers of the same file.
+     *
+     *  \param inStream Positional stream to an already opened CRSD file
+     *  \param data Data section from CRSD
+     *  \param fileHeader Header giving the support block's offset and size
+     */
+    SupportBlock(std::shared_ptr<PositionalInputStream> inStream,
+                 const crsd::Data& data,
+                 const FileHeader& fileHeader);
+
     // Noncopyable
     SupportBlock(const SupportBlock&) = delete;
     const SupportBlock& operator=(const SupportBlock&) = delete;
@@ -173,18 +197,61 @@ struct SupportBlock final
         data.reset(reinterpret_cast<std::byte*>(data_.release()));
     }
 
+    /*
+     *  \func getView
+     *
+     *  \brief Get a support array decoded to native byte order
+     *
+     *   The array is read and decoded the first time it is asked for;
+     *   later views of it share the decoded values.
+     *
+     *  \tparam T Type of each component of an element, e.g. float
+     *   for "Gain=F4;Phase=F4;"
+     *  \param id unique identifier of support array
+     *  \param parameter Grid of the array, from Metadata::supportArray
+     *  \param numThreads Number of threads to use for endian swapping if
+     *   necessary
+     *
+     *  \throws except::Exception If the id is unknown or an element is
+     *   not a whole number of T
+     */
+    template <typename T>
+    SupportArrayView<T> getView(const std::string& id,
+                                const SupportArrayParameter& parameter,
+                                size_t numThreads) const
+    {
+        const Data::SupportArray array = mData.getSupportArrayById(id);
+        return SupportArrayView<T>(readNative(id, sizeof(T), numThreads),
+                                   array.numRows, array.numCols,
+                                   array.bytesPerElement / sizeof(T),
+                                   parameter);
+    }
 
 private:
+    /*
+     *  Read a support array and swap each 'componentSize' byte value to
+     *  native order, or return the copy decoded by an earlier call
+     */
+    std::shared_ptr<const std::vector<std::byte> > readNative(
+            const std::string& id,
+            size_t componentSize,
+            size_t numThreads) const;
+
     //! Initialize mOffsets for each array
     // both for uncompressed and compressed data
     void initialize();
 
-    const std::shared_ptr<io::SeekableInputStream> mInStream;
+    const std::shared_ptr<PositionalInputStream> mInStream;
     crsd::Data mData;
     const int64_t mSupportOffset;       // offset in bytes to start of SupportBlock
     const size_t mSupportSize;             // total size in bytes of SupportBlock
     std::unordered_map<std::string,int64_t> mOffsets; // Offset to start of each support array
 
+    // Arrays decoded by getView(), by id and component size
+    mutable std::mutex mDecodedMutex;
+    mutable std::map<std::pair<std::string, size_t>,
+                     std::shared_ptr<const std::vector<std::byte> > > mDecoded;
+
     friend std::ostream& operator<< (std::ostream& os, const SupportBlock& d);
 };
 }
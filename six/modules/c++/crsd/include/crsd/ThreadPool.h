@@ -0,0 +1,119 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CRSD_THREAD_POOL_H__
+#define __CRSD_THREAD_POOL_H__
+#pragma once
+
+#include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/Runnable.h>
+
+namespace crsd
+{
+/*
+ * \class ThreadPool
+ * \brief Long-lived worker threads for the byte swapping and conversion
+ * kernels
+ *
+ * Spawning threads for every read adds up quickly when a channel is read
+ * in many small blocks, so the kernels submit their work here instead.
+ * Tasks are claimed one at a time, so threads that finish early pick up
+ * the remaining work. Any number of threads may call run() at the same
+ * time, and the calling thread helps execute its own tasks.
+ */
+class ThreadPool final
+{
+public:
+    /*
+     *  \func ThreadPool
+     *  \brief Start the worker threads
+     *
+     *  \param numThreads Number of threads, including the one calling run(),
+     *  that execute tasks at the same time. If 0, uses the number of CPUs.
+     */
+    explicit ThreadPool(size_t numThreads);
+
+    //! Waits for the workers to finish any queued tasks and exit
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    //! Number of threads, including the caller, that execute tasks
+    size_t getNumThreads() const
+    {
+        return mWorkers.size() + 1;
+    }
+
+    /*
+     *  \func run
+     *  \brief Run all tasks and wait for them to complete
+     *
+     *  \param tasks Tasks to run, in no particular order
+     *
+     *  \throw Rethrows the first exception thrown by a task, after all
+     *  tasks have finished
+     */
+    void run(const std::vector<std::unique_ptr<sys::Runnable> >& tasks);
+
+    /*
+     *  \func getDefault
+     *  \brief Process-wide pool used when no pool is supplied
+     *
+     *  Created on first use with one thread per CPU.
+     */
+    static std::shared_ptr<ThreadPool> getDefault();
+
+private:
+    struct Batch;
+
+    void work();
+    void execute(Batch& batch, size_t index);
+
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mWorkAvailable;
+    std::deque<Batch*> mBatches;
+    bool mStop = false;
+};
+
+/*
+ *  \func getThreadPool
+ *  \brief Resolve an optional pool
+ *
+ *  \param threadPool Pool to use, or nullptr
+ *
+ *  \return 'threadPool', or the process-wide default pool if it is null
+ */
+inline ThreadPool& getThreadPool(ThreadPool* threadPool)
+{
+    return threadPool ? *threadPool : *ThreadPool::getDefault();
+}
+}
+
+#endif
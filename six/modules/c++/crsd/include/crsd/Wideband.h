@@ -26,11 +26,17 @@
 #include <complex>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <scene/sys_Conf.h>
+#include <crsd/MappedSignalView.h>
 #include <crsd/MetadataBase.h>
+#include <crsd/PositionalInputStream.h>
+#include <crsd/ThreadPool.h>
 #include <crsd/Utilities.h>
 
+#include <except/Exception.h>
 #include <io/SeekableStreams.h>
 #include <mem/BufferView.h>
 #include <mem/ScopedArray.h>
@@ -45,6 +51,11 @@ namespace crsd
 /*
  * \class Wideband
  * \brief Information about the wideband CRSD data
+ *
+ * All read() overloads address the file by absolute offset and are safe
+ * to call from multiple threads at once. When constructed from a pathname
+ * (or a FilePositionalInputStream) concurrent reads run in parallel;
+ * when constructed from an io::SeekableInputStream they are serialized.
  */
 //  It contains the crsd::Data structure (for channel and vector sizes).
 //  Provides methods read wideband data from CRSD file/stream
@@ -52,6 +63,9 @@ struct Wideband final
 {
     static const size_t ALL;
 
+    //! Default for setMaxReadGap(), in bytes
+    static const size_t DEFAULT_MAX_READ_GAP;
+
     /*!
      *  \func Wideband
      *
@@ -82,6 +96,68 @@ struct Wideband final
              int64_t startWB,
              int64_t sizeWB);
 
+    /*!
+     *  \func Wideband
+     *
+     *  \brief Constructor initializes signal block book keeping
+     *
+     *  \param inStream Offset-addressed input to an already opened CRSD file
+     *  \param metadata Metadata section of CRSD file
+     *  \param startWB CRSD header keyword "CRSD_BYTE_OFFSET"
+     *  \param sizeWB CRSD header keyword "CRSD_DATA_SIZE"
+     */
+    Wideband(std::shared_ptr<PositionalInputStream> inStream,
+             const crsd::MetadataBase& metadata,
+             int64_t startWB,
+             int64_t sizeWB);
+
+    /*!
+     *  \func setThreadPool
+     *
+     *  \brief Pool used for endian swapping and scaling during reads
+     *
+     *  Set this before reading from multiple threads.
+     *
+     *  \param threadPool Pool to use, or nullptr for ThreadPool::getDefault()
+     */
+    void setThreadPool(std::shared_ptr<ThreadPool> threadPool)
+    {
+        mThreadPool = threadPool;
+    }
+
+    //! Pool set by setThreadPool(), or nullptr for the default pool
+    std::shared_ptr<ThreadPool> getThreadPool() const
+    {
+        return mThreadPool;
+    }
+
+    /*!
+     *  \func setMaxReadGap
+     *
+     *  \brief Largest gap between vectors that a sub-window read reads
+     *  through rather than skipping
+     *
+     *  Reading only some samples of each vector leaves a gap between the
+     *  vectors of the window. Gaps up to this size are read and dropped,
+     *  so many vectors come back from one vectored read; larger gaps get
+     *  one read per vector, all submitted together with
+     *  PositionalInputStream::readBatch(). 0 always reads vector by vector.
+     *
+     *  Set this before reading from multiple threads.
+     *
+     *  \param bytes Gap threshold in bytes
+     */
+    void setMaxReadGap(size_t bytes)
+    {
+        mMaxReadGap = bytes;
+    }
+
+    //! Threshold set by setMaxReadGap()
+    size_t getMaxReadGap() const
+    {
+        return mMaxReadGap;
+    }
+
     /*!
      *  \func getFileOffset
      *
@@ -346,6 +422,146 @@ struct Wideband final
              buffer);
     }
 
+    /*!
+     *  \func readChannels
+     *
+     *  \brief Read several whole channels concurrently
+     *
+     *  Each channel is split into tiles of whole vectors. Up to numThreads
+     *  tiles are read at a time, and each tile is byte swapped as soon as
+     *  its read completes, so swapping overlaps the remaining reads.
+     *  Reads only run in parallel when the input supports it; see the
+     *  class description.
+     *
+     *  \param channels 0-based channels to read, in any order
+     *  \param numThreads Maximum number of tiles read and swapped at
+     *  once. If 0, uses the size of the thread pool.
+     *  \param[out] data One pre allocated buffer per entry of 'channels',
+     *  each of at least getBytesRequiredForRead(channel) bytes
+     *
+     *  \throw except::Exception If invalid channel
+     *  \throw except::Exception If the number of buffers doesn't match the
+     *  number of channels or a buffer is too small
+     */
+    void readChannels(std::span<const size_t> channels,
+                      size_t numThreads,
+                      std::span<const std::span<std::byte> > data) const;
+
+    /*!
+     *  \func readChannels
+     *
+     *  \brief Read several whole channels concurrently, promoting the
+     *  samples to complex<float>
+     *
+     *  Same as above, but each tile is byte swapped and promoted as soon
+     *  as its read completes.
+     *
+     *  \param channels 0-based channels to read, in any order
+     *  \param numThreads Maximum number of tiles read and converted at
+     *  once. If 0, uses the size of the thread pool.
+     *  \param[out] data One pre allocated buffer per entry of 'channels',
+     *  each holding at least getBufferDims(channel, 0, ALL, 0, ALL).area()
+     *  samples
+     *
+     *  \throw except::Exception If invalid channel
+     *  \throw except::Exception If the number of buffers doesn't match the
+     *  number of channels or a buffer is too small
+     *  \throw except::Exception If wideband data is compressed
+     */
+    void readChannels(
+            std::span<const size_t> channels,
+            size_t numThreads,
+            std::span<const std::span<std::complex<float> > > data) const;
+
+    /*!
+     *  \func getMappedSignal
+     *
+     *  \brief Zero-copy view of whole vectors of a channel
+     *
+     *  The signal block is memory mapped on first use and the returned
+     *  span points straight into it. This is only possible when the
+     *  samples need no byte swapping: always for CI2, and for CI4/CF8 on
+     *  big-endian hosts. Use getMappedSignalView() otherwise.
+     *  The span is valid for the lifetime of this Wideband.
+     *
+     *  \tparam T int8_t for CI2, int16_t for CI4, float for CF8
+     *  \param channel 0-based channel
+     *  \param firstVector 0-based first vector (inclusive)
+     *  \param lastVector 0-based last vector (inclusive). Use ALL to map
+     *  all vectors
+     *
+     *  \throw except::Exception If invalid channel or vectors
+     *  \throw except::Exception If T doesn't match the signal array format
+     *  \throw except::Exception If samples need byte swapping
+     *  \throw except::Exception If wideband data is compressed or the
+     *  input can't be memory mapped
+     *
+     *  \return Samples of vectors [firstVector, lastVector], vector-major
+     */
+    template <typename T>
+    std::span<const std::complex<T>> getMappedSignal(
+            size_t channel,
+            size_t firstVector = 0,
+            size_t lastVector = ALL) const
+    {
+        if (shouldByteSwap())
+        {
+            throw except::Exception(Ctxt(
+                    "Signal samples need byte swapping; "
+                    "use getMappedSignalView() instead"));
+        }
+
+        types::RowCol<size_t> dims;
+        const std::byte* const data = mapVectors(channel,
+                                                 firstVector,
+                                                 lastVector,
+                                                 sizeof(std::complex<T>),
+                                                 dims);
+        if (reinterpret_cast<size_t>(data) % alignof(std::complex<T>) != 0)
+        {
+            throw except::Exception(Ctxt(
+                    "Mapped signal samples are not aligned; "
+                    "use getMappedSignalView() instead"));
+        }
+        return std::span<const std::complex<T>>(
+                reinterpret_cast<const std::complex<T>*>(data), dims.area());
+    }
+
+    /*!
+     *  \func getMappedSignalView
+     *
+     *  \brief Memory mapped view of whole vectors of a channel
+     *
+     *  Like getMappedSignal(), but samples are decoded and byte swapped
+     *  (if necessary) as they are accessed, so this works for every
+     *  uncompressed format on every host.
+     *
+     *  \tparam T int8_t for CI2, int16_t for CI4, float for CF8
+     *  \param channel 0-based channel
+     *  \param firstVector 0-based first vector (inclusive)
+     *  \param lastVector 0-based last vector (inclusive). Use ALL to map
+     *  all vectors
+     *
+     *  \throw except::Exception If invalid channel or vectors
+     *  \throw except::Exception If T doesn't match the signal array format
+     *  \throw except::Exception If wideband data is compressed or the
+     *  input can't be memory mapped
+     */
+    template <typename T>
+    MappedSignalView<T> getMappedSignalView(size_t channel,
+                                            size_t firstVector = 0,
+                                            size_t lastVector = ALL) const
+    {
+        types::RowCol<size_t> dims;
+        const std::byte* const data = mapVectors(channel,
+                                                 firstVector,
+                                                 lastVector,
+                                                 sizeof(std::complex<T>),
+                                                 dims);
+        return MappedSignalView<T>(
+                mSignalMap, data, dims.row, dims.col, shouldByteSwap());
+    }
+
     /*!
      * Calculate the number of bytes required to read requested channel
      * Overload for simply requesting entire channel.
@@ -450,6 +666,35 @@ private:
      */
     void readImpl(size_t channel, void* data) const;
 
+    /*
+     * Inflate the chunks holding [firstVector, lastVector] in parallel and
+     * copy 'numSamples' samples from 'firstSample' of each vector to 'data'
+     */
+    void readChunks(size_t channel,
+                    size_t firstVector,
+                    size_t lastVector,
+                    size_t firstSample,
+                    size_t numSamples,
+                    std::byte* data) const;
+
+    //! Compressed, but not in chunks, so only whole channels can be read
+    bool isOpaque() const
+    {
+        return mMetadata.isCompressed() && !mChunkIndex;
+    }
+
+    /*
+     * Read whole channels in tiles of vectors, swapping (and promoting if
+     * 'promote' is set) each tile into data[ii] right after it is read
+     */
+    void readChannelTiles(std::span<const size_t> channels,
+                          size_t numThreads,
+                          const std::vector<void*>& data,
+                          bool promote) const;
+
+    //! Target number of bytes read per tile by readChannels()
+    static const size_t READ_TILE_BYTES;
+
     /*
      *  Returns true if scale factor vector is all ones
      *  False otherwise.
@@ -458,17 +703,36 @@ private:
 
     bool shouldByteSwap() const;
 
+    /*
+     *  Memory map the signal block if that hasn't happened yet and
+     *  return the first sample of the requested vectors
+     */
+    const std::byte* mapVectors(size_t channel,
+                                size_t firstVector,
+                                size_t lastVector,
+                                size_t elementSize,
+                                types::RowCol<size_t>& dims) const;
+
     Wideband(const Wideband&) = delete;
     const Wideband& operator=(const Wideband&) = delete;
 
 private:
-    const std::shared_ptr<io::SeekableInputStream> mInStream;
+    const std::shared_ptr<PositionalInputStream> mInStream;
     const crsd::MetadataBase& mMetadata;  // pointer to data metadata
     const int64_t mWBOffset;  // offset in bytes to start of wideband
     const size_t mWBSize;  // total size in bytes of wideband
     const size_t mElementSize;  // element size (bytes / complex sample)
 
     std::vector<int64_t> mOffsets;  // Offset to start of each channel
+    // Locates the chunks of chunked compressed signal blocks, else nullptr
+    std::shared_ptr<const SignalChunkIndex> mChunkIndex;
+
+    // Signal block mapping, created on first use
+    mutable std::once_flag mMapOnce;
+    mutable std::shared_ptr<const MemoryMap> mSignalMap;
+
+    std::shared_ptr<ThreadPool> mThreadPool;  // nullptr uses the default
+    size_t mMaxReadGap = DEFAULT_MAX_READ_GAP;  // see setMaxReadGap()
 
     friend std::ostream& operator<<(std::ostream& os, const Wideband& d);
 };
@@ -0,0 +1,55 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __IMPORT_CRSD_H__
+#define __IMPORT_CRSD_H__
+
+#include <import/six.h>
+
+#include "crsd/Antenna.h"
+#include "crsd/BistaticGeometry.h"
+#include "crsd/Channel.h"
+#include "crsd/CRSDReader.h"
+#include "crsd/CRSDWriter.h"
+#include "crsd/CRSDXMLControl.h"
+#include "crsd/Data.h"
+#include "crsd/Dwell.h"
+#include "crsd/Enums.h"
+#include "crsd/ErrorParameters.h"
+#include "crsd/FileHeader.h"
+#include "crsd/Global.h"
+#include "crsd/MetadataBase.h"
+#include "crsd/Metadata.h"
+#include "crsd/PPP.h"
+#include "crsd/PPPBlock.h"
+#include "crsd/ProductInfo.h"
+#include "crsd/PVP.h"
+#include "crsd/PVPBlock.h"
+#include "crsd/ReferenceGeometry.h"
+#include "crsd/SceneCoordinates.h"
+#include "crsd/SupportArray.h"
+#include "crsd/SupportBlock.h"
+#include "crsd/Types.h"
+#include "crsd/Utilities.h"
+#include "crsd/Wideband.h"
+
+#endif
@@ -0,0 +1,388 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <crsd/BistaticGeometry.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <std/memory>
+
+#include <except/Exception.h>
+#include <math/Constants.h>
+#include <mt/ThreadPlanner.h>
+#include <sys/Runnable.h>
+
+namespace
+{
+// WGS-84 semi-major and semi-minor axes (m)
+constexpr double WGS84_A = 6378137.0;
+constexpr double WGS84_B = 6356752.314245179;
+
+// Samples are converted to structure-of-arrays form a block at a time,
+// so the arithmetic below runs as flat loops over doubles
+constexpr size_t BLOCK_SIZE = 128;
+
+constexpr double RAD_TO_DEG = math::Constants::RADIANS_TO_DEGREES;
+
+struct Columns final
+{
+    std::span<const crsd::Vector3> txPos;
+    std::span<const crsd::Vector3> txVel;
+    std::span<const crsd::Vector3> rcvPos;
+    std::span<const crsd::Vector3> rcvVel;
+    std::span<const crsd::Vector3> points;
+};
+
+// A block of 3-vectors, one array per component
+struct Block3 final
+{
+    double x[BLOCK_SIZE];
+    double y[BLOCK_SIZE];
+    double z[BLOCK_SIZE];
+
+    void load(std::span<const crsd::Vector3> column, size_t start, size_t count)
+    {
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            const crsd::Vector3& value =
+                    column.size() == 1 ? column[0] : column[start + ii];
+            x[ii] = value[0];
+            y[ii] = value[1];
+            z[ii] = value[2];
+        }
+    }
+};
+
+inline double clampUnit(double value)
+{
+    return std::min(std::max(value, -1.0), 1.0);
+}
+
+// Scales (x, y, z) to unit length and returns the original length
+inline double normalize(double& x, double& y, double& z)
+{
+    const double norm = std::sqrt(x * x + y * y + z * z);
+    const double scale = norm > 0 ? 1.0 / norm : 0.0;
+    x *= scale;
+    y *= scale;
+    z *= scale;
+    return norm;
+}
+
+void computeBlock(const Columns& in,
+                  size_t start,
+                  size_t count,
+                  crsd::BistaticGeometry& out)
+{
+    Block3 point;
+    Block3 tx;
+    Block3 txVel;
+    Block3 rcv;
+    Block3 rcvVel;
+    point.load(in.points, start, count);
+    tx.load(in.txPos, start, count);
+    txVel.load(in.txVel, start, count);
+    rcv.load(in.rcvPos, start, count);
+    rcvVel.load(in.rcvVel, start, count);
+
+    // Cosines, sines and vector components left for the trig pass
+    double cosBistatic[BLOCK_SIZE];
+    double cosBistaticRate[BLOCK_SIZE];
+    double sinGraze[BLOCK_SIZE];
+    double sinTwist[BLOCK_SIZE];
+    double cosSlope[BLOCK_SIZE];
+    double layoverEast[BLOCK_SIZE];
+    double layoverNorth[BLOCK_SIZE];
+    double txArc[2][BLOCK_SIZE];
+    double rcvArc[2][BLOCK_SIZE];
+    double earthRadius[BLOCK_SIZE];
+
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+        const double px = point.x[ii];
+        const double py = point.y[ii];
+        const double pz = point.z[ii];
+
+        // Unit line of sight from the point to each APC
+        double utx = tx.x[ii] - px;
+        double uty = tx.y[ii] - py;
+        double utz = tx.z[ii] - pz;
+        const double txRange = normalize(utx, uty, utz);
+        double urx = rcv.x[ii] - px;
+        double ury = rcv.y[ii] - py;
+        double urz = rcv.z[ii] - pz;
+        const double rcvRange = normalize(urx, ury, urz);
+
+        // Its time derivative: velocity across the line of sight / range
+        const double txRadial =
+                txVel.x[ii] * utx + txVel.y[ii] * uty + txVel.z[ii] * utz;
+        const double txScale = txRange > 0 ? 1.0 / txRange : 0.0;
+        const double dutx = (txVel.x[ii] - txRadial * utx) * txScale;
+        const double duty = (txVel.y[ii] - txRadial * uty) * txScale;
+        const double dutz = (txVel.z[ii] - txRadial * utz) * txScale;
+        const double rcvRadial = rcvVel.x[ii] * urx + rcvVel.y[ii] * ury +
+                                 rcvVel.z[ii] * urz;
+        const double rcvScale = rcvRange > 0 ? 1.0 / rcvRange : 0.0;
+        const double durx = (rcvVel.x[ii] - rcvRadial * urx) * rcvScale;
+        const double dury = (rcvVel.y[ii] - rcvRadial * ury) * rcvScale;
+        const double durz = (rcvVel.z[ii] - rcvRadial * urz) * rcvScale;
+
+        cosBistatic[ii] = utx * urx + uty * ury + utz * urz;
+        cosBistaticRate[ii] = dutx * urx + duty * ury + dutz * urz +
+                              utx * durx + uty * dury + utz * durz;
+
+        // Ellipsoid normal
+        double upx = px / (WGS84_A * WGS84_A);
+        double upy = py / (WGS84_A * WGS84_A);
+        double upz = pz / (WGS84_B * WGS84_B);
+        normalize(upx, upy, upz);
+
+        // Bistatic pointing vector and its derivative
+        double bpx = (utx + urx) * 0.5;
+        double bpy = (uty + ury) * 0.5;
+        double bpz = (utz + urz) * 0.5;
+        const double bpdx = (dutx + durx) * 0.5;
+        const double bpdy = (duty + dury) * 0.5;
+        const double bpdz = (dutz + durz) * 0.5;
+
+        // Slant plane normal, on the up side
+        double spnx = bpy * bpdz - bpz * bpdy;
+        double spny = bpz * bpdx - bpx * bpdz;
+        double spnz = bpx * bpdy - bpy * bpdx;
+        normalize(spnx, spny, spnz);
+        const double spnUp = spnx * upx + spny * upy + spnz * upz;
+        const double spnSign = spnUp < 0 ? -1.0 : 1.0;
+        spnx *= spnSign;
+        spny *= spnSign;
+        spnz *= spnSign;
+        cosSlope[ii] = spnUp * spnSign;
+
+        normalize(bpx, bpy, bpz);
+        const double bpUp = bpx * upx + bpy * upy + bpz * upz;
+        sinGraze[ii] = bpUp;
+
+        // Ground plane axes: GPX along the projected pointing vector
+        double gpxx = bpx - bpUp * upx;
+        double gpxy = bpy - bpUp * upy;
+        double gpxz = bpz - bpUp * upz;
+        normalize(gpxx, gpxy, gpxz);
+        const double gpyx = upy * gpxz - upz * gpxy;
+        const double gpyy = upz * gpxx - upx * gpxz;
+        const double gpyz = upx * gpxy - upy * gpxx;
+        sinTwist[ii] = -(gpyx * spnx + gpyy * spny + gpyz * spnz);
+
+        // Layover direction lies in the ETP
+        const double spnScale = cosSlope[ii] > 0 ? 1.0 / cosSlope[ii] : 0.0;
+        const double lox = upx - spnx * spnScale;
+        const double loy = upy - spny * spnScale;
+        const double loz = upz - spnz * spnScale;
+        double eastx = -upy;
+        double easty = upx;
+        double eastz = 0.0;
+        normalize(eastx, easty, eastz);
+        const double northx = upy * eastz - upz * easty;
+        const double northy = upz * eastx - upx * eastz;
+        const double northz = upx * easty - upy * eastx;
+        layoverEast[ii] = lox * eastx + loy * easty + loz * eastz;
+        layoverNorth[ii] = lox * northx + loy * northy + loz * northz;
+
+        // Angle subtended at the Earth's center, as |P x X| and P . X
+        const double tcx = py * tx.z[ii] - pz * tx.y[ii];
+        const double tcy = pz * tx.x[ii] - px * tx.z[ii];
+        const double tcz = px * tx.y[ii] - py * tx.x[ii];
+        txArc[0][ii] = std::sqrt(tcx * tcx + tcy * tcy + tcz * tcz);
+        txArc[1][ii] = px * tx.x[ii] + py * tx.y[ii] + pz * tx.z[ii];
+        const double rcx = py * rcv.z[ii] - pz * rcv.y[ii];
+        const double rcy = pz * rcv.x[ii] - px * rcv.z[ii];
+        const double rcz = px * rcv.y[ii] - py * rcv.x[ii];
+        rcvArc[0][ii] = std::sqrt(rcx * rcx + rcy * rcy + rcz * rcz);
+        rcvArc[1][ii] = px * rcv.x[ii] + py * rcv.y[ii] + pz * rcv.z[ii];
+        earthRadius[ii] = std::sqrt(px * px + py * py + pz * pz);
+
+        out.txSlantRange[start + ii] = txRange;
+        out.rcvSlantRange[start + ii] = rcvRange;
+    }
+
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+        const double cosB = clampUnit(cosBistatic[ii]);
+        const double sinB = std::sqrt(1.0 - cosB * cosB);
+        out.bistaticAngle[start + ii] = std::acos(cosB) * RAD_TO_DEG;
+        out.bistaticAngleRate[start + ii] =
+                sinB > 0 ? -cosBistaticRate[ii] / sinB * RAD_TO_DEG : 0.0;
+        out.grazeAngle[start + ii] = std::asin(clampUnit(sinGraze[ii])) * RAD_TO_DEG;
+        out.twistAngle[start + ii] = std::asin(clampUnit(sinTwist[ii])) * RAD_TO_DEG;
+        out.slopeAngle[start + ii] = std::acos(clampUnit(cosSlope[ii])) * RAD_TO_DEG;
+        const double layover =
+                std::atan2(layoverEast[ii], layoverNorth[ii]) * RAD_TO_DEG;
+        out.layoverAngle[start + ii] = layover < 0 ? layover + 360 : layover;
+        out.txGroundRange[start + ii] =
+                earthRadius[ii] * std::atan2(txArc[0][ii], txArc[1][ii]);
+        out.rcvGroundRange[start + ii] =
+                earthRadius[ii] * std::atan2(rcvArc[0][ii], rcvArc[1][ii]);
+    }
+}
+
+void computeRange(const Columns& in,
+                  size_t start,
+                  size_t count,
+                  crsd::BistaticGeometry& out)
+{
+    for (size_t offset = 0; offset < count; offset += BLOCK_SIZE)
+    {
+        computeBlock(in, start + offset,
+                     std::min(BLOCK_SIZE, count - offset), out);
+    }
+}
+
+class GeometryRunnable final : public sys::Runnable
+{
+public:
+    GeometryRunnable(const Columns& in,
+                     size_t start,
+                     size_t count,
+                     crsd::BistaticGeometry& out) :
+        mIn(in),
+        mStart(start),
+        mCount(count),
+        mOut(out)
+    {
+    }
+
+    void run() override
+    {
+        computeRange(mIn, mStart, mCount, mOut);
+    }
+
+private:
+    const Columns& mIn;
+    const size_t mStart;
+    const size_t mCount;
+    crsd::BistaticGeometry& mOut;
+};
+}
+
+namespace crsd
+{
+void BistaticGeometry::resize(size_t numRows)
+{
+    for (auto column : { &bistaticAngle, &bistaticAngleRate, &grazeAngle,
+                         &twistAngle, &slopeAngle, &layoverAngle,
+                         &txSlantRange, &rcvSlantRange, &txGroundRange,
+                         &rcvGroundRange })
+    {
+        column->resize(numRows);
+    }
+}
+
+BistaticGeometry computeBistaticGeometry(std::span<const Vector3> txPos,
+                                         std::span<const Vector3> txVel,
+                                         std::span<const Vector3> rcvPos,
+                                         std::span<const Vector3> rcvVel,
+                                         std::span<const Vector3> points,
+                                         size_t numThreads,
+                                         ThreadPool* threadPool)
+{
+    const Columns in{txPos, txVel, rcvPos, rcvVel, points};
+    size_t numSamples = 0;
+    for (auto column : { &in.txPos, &in.txVel, &in.rcvPos, &in.rcvVel,
+                         &in.points })
+    {
+        numSamples = std::max(numSamples, column->size());
+    }
+    for (auto column : { &in.txPos, &in.txVel, &in.rcvPos, &in.rcvVel,
+                         &in.points })
+    {
+        if (column->empty() ||
+            (column->size() != 1 && column->size() != numSamples))
+        {
+            std::ostringstream ostr;
+            ostr << "Geometry inputs must have 1 or " << numSamples
+                 << " entries, not " << column->size();
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+    }
+
+    BistaticGeometry out;
+    out.resize(numSamples);
+    if (numThreads <= 1 || numSamples <= BLOCK_SIZE)
+    {
+        computeRange(in, 0, numSamples, out);
+    }
+    else
+    {
+        std::vector<std::unique_ptr<sys::Runnable> > tasks;
+        const mt::ThreadPlanner planner(numSamples, numThreads);
+
+        size_t threadNum(0);
+        size_t startElement(0);
+        size_t numElementsThisThread(0);
+        while (planner.getThreadInfo(threadNum++,
+                                     startElement,
+                                     numElementsThisThread))
+        {
+            tasks.push_back(std::make_unique<GeometryRunnable>(
+                    in, startElement, numElementsThisThread, out));
+        }
+        getThreadPool(threadPool).run(tasks);
+    }
+    return out;
+}
+
+BistaticGeometry computeBistaticGeometry(const PVPBlock& pvpBlock,
+                                         const PPPBlock& pppBlock,
+                                         size_t channel,
+                                         size_t txSequence,
+                                         const Vector3& point,
+                                         size_t numThreads,
+                                         ThreadPool* threadPool)
+{
+    const std::span<const int64_t> pulses = pvpBlock.getTxPulseIndex(channel);
+    if (pulses.empty())
+    {
+        return BistaticGeometry();
+    }
+
+    std::vector<Vector3> txPos(pulses.size());
+    std::vector<Vector3> txVel(pulses.size());
+    for (size_t ii = 0; ii < pulses.size(); ++ii)
+    {
+        if (pulses[ii] < 0)
+        {
+            throw except::Exception(Ctxt(
+                    "Vector " + std::to_string(ii) +
+                    " has a negative TxPulseIndex"));
+        }
+        const auto pulse = static_cast<size_t>(pulses[ii]);
+        txPos[ii] = pppBlock.getTxPos(txSequence, pulse);
+        txVel[ii] = pppBlock.getTxVel(txSequence, pulse);
+    }
+    return computeBistaticGeometry(
+            std::span<const Vector3>(txPos.data(), txPos.size()),
+            std::span<const Vector3>(txVel.data(), txVel.size()),
+            pvpBlock.getRcvPos(channel),
+            pvpBlock.getRcvVel(channel),
+            std::span<const Vector3>(&point, 1),
+            numThreads,
+            threadPool);
+}
+}
@@ -26,6 +26,7 @@
 
 #include <except/Exception.h>
 #include <io/StringStream.h>
+#include <io/BufferViewStream.h>
 #include <io/FileInputStream.h>
 #include <logging/NullLogger.h>
 #include <mem/ScopedArray.h>
@@ -34,30 +35,41 @@
 
 #include <six/XmlLite.h>
 #include <crsd/CRSDXMLControl.h>
+#include <crsd/MetadataCache.h>
 
 namespace crsd
 {
 CRSDReader::CRSDReader(std::shared_ptr<io::SeekableInputStream> inStream,
                        size_t numThreads,
                        const std::vector<std::string>& schemaPaths,
-                       std::shared_ptr<logging::Logger> logger)
+                       std::shared_ptr<logging::Logger> logger,
+                       std::shared_ptr<ThreadPool> threadPool,
+                       bool loadLazily)
 {
-    initialize(inStream, numThreads, logger, schemaPaths);
+    initialize(inStream, nullptr, "", numThreads, logger, schemaPaths,
+               threadPool, loadLazily);
 }
 
 CRSDReader::CRSDReader(const std::string& fromFile,
                        size_t numThreads,
                        const std::vector<std::string>& schemaPaths,
-                       std::shared_ptr<logging::Logger> logger)
+                       std::shared_ptr<logging::Logger> logger,
+                       std::shared_ptr<ThreadPool> threadPool,
+                       bool loadLazily)
 {
     initialize(std::make_shared<io::FileInputStream>(fromFile),
-        numThreads, logger, schemaPaths);
+        std::make_shared<FilePositionalInputStream>(fromFile), fromFile,
+        numThreads, logger, schemaPaths, threadPool, loadLazily);
 }
 
 void CRSDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
+                            std::shared_ptr<PositionalInputStream> signalStream,
+                            const std::string& pathname,
                             size_t numThreads,
                             std::shared_ptr<logging::Logger> logger,
-                            const std::vector<std::string>& schemaPaths_)
+                            const std::vector<std::string>& schemaPaths_,
+                            std::shared_ptr<ThreadPool> threadPool,
+                            bool loadLazily)
 {
     const bool DEBUG = false;
     if (DEBUG)
@@ -72,10 +84,6 @@ void CRSDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
         
     inStream->seek(mFileHeader.getXMLBlockByteOffset(), io::Seekable::START);
 
-    six::MinidomParser xmlParser;
-    xmlParser.preserveCharacterData(true);
-    xmlParser.parse(*inStream, gsl::narrow<int>(mFileHeader.getXMLBlockSize()));
-
     if (logger.get() == nullptr)
     {
         logger = std::make_shared<logging::NullLogger>();
@@ -84,12 +92,55 @@ void CRSDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
     std::vector<std::filesystem::path> schemaPaths;
     std::transform(schemaPaths_.begin(), schemaPaths_.end(), std::back_inserter(schemaPaths),
         [](const std::string& s) { return s; });
-    mMetadata = CRSDXMLControl(logger.get()).fromXML(xmlParser.getDocument(), schemaPaths);
+
+    const auto parseXML = [&](io::InputStream& xmlStream)
+    {
+        six::MinidomParser xmlParser;
+        xmlParser.preserveCharacterData(true);
+        xmlParser.parse(xmlStream, gsl::narrow<int>(mFileHeader.getXMLBlockSize()));
+        mMetadata = CRSDXMLControl(logger.get()).fromXML(xmlParser.getDocument(), schemaPaths);
+    };
+
+    MetadataCache& cache = MetadataCache::getInstance();
+    if (pathname.empty() || cache.getCapacity() == 0)
+    {
+        parseXML(*inStream);
+    }
+    else
+    {
+        // Only a changed XML block has to be parsed again
+        std::vector<std::byte> xmlBlock(mFileHeader.getXMLBlockSize());
+        inStream->read(xmlBlock.data(), xmlBlock.size(), true);
+        const auto key = MetadataCache::makeKey(pathname, xmlBlock.data(),
+                                                xmlBlock.size(), schemaPaths_);
+        if (auto cached = cache.find(key))
+        {
+            mMetadata = *cached;
+        }
+        else
+        {
+            io::BufferViewStream<std::byte> xmlStream(
+                    mem::BufferView<std::byte>(xmlBlock.data(), xmlBlock.size()));
+            parseXML(xmlStream);
+            cache.insert(key, std::make_shared<const Metadata>(mMetadata));
+        }
+    }
 
     if (DEBUG)
         std::cout << "Reading in support block..." << std::endl;
 
-    mSupportBlock = std::make_unique<SupportBlock>(inStream, mMetadata.data, mFileHeader);
+    // Everything read after construction goes through this one stream, so
+    // support array, PVP, PPP and wideband reads never move each other's
+    // file position
+    if (signalStream.get() == nullptr)
+    {
+        signalStream = std::make_shared<SeekablePositionalInputStream>(inStream);
+    }
+    mStream = signalStream;
+
+    mSupportBlock = std::make_unique<SupportBlock>(mStream, mMetadata.data, mFileHeader);
+    mNumThreads = numThreads;
+    mThreadPool = threadPool;
 
     if (mMetadata.getType() != CRSDType::RCV)
     {
@@ -97,11 +148,14 @@ void CRSDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
         if (DEBUG)
             std::cout << "reading in PPP block..." << std::endl;
 
-        mPPPBlock = PPPBlock(mMetadata);
-        
-        mPPPBlock.load(*inStream, mFileHeader, numThreads);
-
-
+        mPPPBlock = PPPBlock(mMetadata, !loadLazily);
+        mPPPState.assign(getNumTxSequences(), loadLazily ?
+                LoadState::NOT_LOADED : LoadState::LOADED);
+        mAllPPPLoaded = !loadLazily;
+        if (!loadLazily)
+        {
+            mPPPBlock.load(*inStream, mFileHeader, numThreads, threadPool.get());
+        }
     }
 
     if (mMetadata.getType() != CRSDType::TX)
@@ -110,15 +164,128 @@ void CRSDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
         if (DEBUG)
             std::cout << "reading in PVP block..." << std::endl;
 
-        mPVPBlock = PVPBlock(mMetadata);
-        mPVPBlock.load(*inStream, mFileHeader, numThreads);
+        mPVPBlock = PVPBlock(mMetadata, !loadLazily);
+        mPVPState.assign(getNumChannels(), loadLazily ?
+                LoadState::NOT_LOADED : LoadState::LOADED);
+        mAllPVPLoaded = !loadLazily;
+        if (!loadLazily)
+        {
+            mPVPBlock.load(*inStream, mFileHeader, numThreads, threadPool.get());
+        }
 
         // Setup for wideband reading
         if (DEBUG)
             std::cout << "reading in wideband block..." << std::endl;
 
-        mWideband = std::make_unique<Wideband>(inStream, mMetadata,
+        mWideband = std::make_unique<Wideband>(signalStream, mMetadata,
             mFileHeader.getSignalBlockByteOffset(), mFileHeader.getSignalBlockSize());
+        mWideband->setThreadPool(threadPool);
+    }
+}
+
+const PVPBlock& CRSDReader::getPVPBlock() const
+{
+    if (!mAllPVPLoaded.load(std::memory_order_acquire))
+    {
+        for (size_t ii = 0; ii < mPVPState.size(); ++ii)
+        {
+            prefetch(ii);
+        }
+        mAllPVPLoaded.store(true, std::memory_order_release);
+    }
+    return mPVPBlock;
+}
+
+const PPPBlock& CRSDReader::getPPPBlock() const
+{
+    if (!mAllPPPLoaded.load(std::memory_order_acquire))
+    {
+        for (size_t ii = 0; ii < mPPPState.size(); ++ii)
+        {
+            prefetchTxSequence(ii);
+        }
+        mAllPPPLoaded.store(true, std::memory_order_release);
+    }
+    return mPPPBlock;
+}
+
+const PVPBlock& CRSDReader::getPVPBlock(size_t channel) const
+{
+    prefetch(channel);
+    return mPVPBlock;
+}
+
+const PPPBlock& CRSDReader::getPPPBlock(size_t txSequence) const
+{
+    prefetchTxSequence(txSequence);
+    return mPPPBlock;
+}
+
+void CRSDReader::prefetch(size_t channel) const
+{
+    if (channel >= mPVPState.size())
+    {
+        throw except::Exception(Ctxt(
+                "Invalid channel number: " + std::to_string(channel)));
+    }
+    loadOnce(mPVPState, channel, [&]()
+    {
+        mPVPBlock.loadChannel(*mStream, mFileHeader, channel, mNumThreads,
+                              mThreadPool.get());
+    });
+}
+
+void CRSDReader::prefetchTxSequence(size_t txSequence) const
+{
+    if (txSequence >= mPPPState.size())
+    {
+        throw except::Exception(Ctxt(
+                "Invalid tx sequence number: " + std::to_string(txSequence)));
+    }
+    loadOnce(mPPPState, txSequence, [&]()
+    {
+        mPPPBlock.loadTxSequence(*mStream, mFileHeader, txSequence,
+                                 mNumThreads, mThreadPool.get());
+    });
+}
+
+void CRSDReader::loadOnce(std::vector<LoadState>& states,
+                          size_t index,
+                          const std::function<void()>& load) const
+{
+    {
+        std::unique_lock<std::mutex> lock(mLoadMutex);
+        mLoadDone.wait(lock, [&]()
+        {
+            return states[index] != LoadState::LOADING;
+        });
+        if (states[index] == LoadState::LOADED)
+        {
+            return;
+        }
+        states[index] = LoadState::LOADING;
+    }
+
+    const auto finish = [&](LoadState state)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mLoadMutex);
+            states[index] = state;
+        }
+        mLoadDone.notify_all();
+    };
+
+    // Only the thread that claimed an entry writes its part of the block,
+    // so loads of different channels or tx sequences overlap
+    try
+    {
+        load();
+    }
+    catch (...)
+    {
+        finish(LoadState::NOT_LOADED);
+        throw;
     }
+    finish(LoadState::LOADED);
 }
 }
@@ -21,28 +21,65 @@
  */
 #include <crsd/CRSDWriter.h>
 
+#include <string.h>
+
+#include <algorithm>
 #include <thread>
+#include <vector>
 #include <std/bit>
 #include <std/memory>
 
 #include <except/Exception.h>
+#include <sys/Runnable.h>
 
 #include <crsd/ByteSwap.h>
 #include <crsd/CRSDXMLControl.h>
 #include <crsd/FileHeader.h>
+#include <crsd/SignalChunkIndex.h>
 #include <crsd/Utilities.h>
 #include <crsd/Wideband.h>
 
 #undef min
 #undef max
 
+namespace
+{
+// Largest staging buffer used when records are written without swapping
+const size_t STAGING_BYTES = 4 * 1024 * 1024;
+
+// Encodes one piece of a buffer's worth of records
+class EncodeRunnable final : public sys::Runnable
+{
+public:
+    EncodeRunnable(const std::function<void(size_t, size_t)>& encodePiece,
+                   size_t first,
+                   size_t count) :
+        mEncodePiece(encodePiece),
+        mFirst(first),
+        mCount(count)
+    {
+    }
+
+    void run() override
+    {
+        mEncodePiece(mFirst, mCount);
+    }
+
+private:
+    const std::function<void(size_t, size_t)>& mEncodePiece;
+    const size_t mFirst;
+    const size_t mCount;
+};
+}
 
 namespace crsd
 {
 DataWriter::DataWriter(std::shared_ptr<io::SeekableOutputStream> stream,
-                       size_t numThreads) :
+                       size_t numThreads,
+                       std::shared_ptr<ThreadPool> threadPool) :
     mStream(stream),
-    mNumThreads(numThreads == 0 ? std::thread::hardware_concurrency() : numThreads)
+    mNumThreads(numThreads == 0 ? std::thread::hardware_concurrency() : numThreads),
+    mThreadPool(threadPool)
 {
 }
 
@@ -50,36 +87,231 @@ DataWriter::~DataWriter()
 {
 }
 
+void DataWriter::encodeRecords(const RecordEncoder& encode,
+                               size_t firstRecord,
+                               size_t numRecords,
+                               size_t recordSize,
+                               size_t elementSize,
+                               bool swap,
+                               std::byte* buffer) const
+{
+    // Each piece is encoded and then swapped while it is still in cache
+    const std::function<void(size_t, size_t)> encodePiece =
+            [&](size_t first, size_t count)
+    {
+        std::byte* const piece = buffer + first * recordSize;
+        encode(firstRecord + first, count, piece);
+        if (swap)
+        {
+            crsd::byteSwap(piece, elementSize,
+                           count * recordSize / elementSize, 1);
+        }
+    };
+
+    const size_t numPieces = std::min(mNumThreads, numRecords);
+    if (numPieces <= 1)
+    {
+        encodePiece(0, numRecords);
+        return;
+    }
+
+    std::vector<std::unique_ptr<sys::Runnable> > tasks;
+    const size_t recordsPerPiece = (numRecords + numPieces - 1) / numPieces;
+    for (size_t first = 0; first < numRecords; first += recordsPerPiece)
+    {
+        tasks.push_back(std::make_unique<EncodeRunnable>(
+                encodePiece,
+                first,
+                std::min(recordsPerPiece, numRecords - first)));
+    }
+    crsd::getThreadPool(mThreadPool.get()).run(tasks);
+}
+
 DataWriterLittleEndian::DataWriterLittleEndian(
         std::shared_ptr<io::SeekableOutputStream> stream,
         size_t numThreads,
-        size_t scratchSize) :
-    DataWriter(stream, numThreads),
-    mScratch(scratchSize)
+        size_t scratchSize,
+        std::shared_ptr<ThreadPool> threadPool,
+        size_t numBuffers) :
+    DataWriter(stream, numThreads, threadPool),
+    mScratch(std::max<size_t>(numBuffers, 1),
+             std::vector<std::byte>(std::max<size_t>(
+                     scratchSize / std::max<size_t>(numBuffers, 1),
+                     sizeof(double)))),
+    mPending(mScratch.size(), 0)
+{
+    mWriter = std::thread(&DataWriterLittleEndian::writeQueued, this);
+}
+
+DataWriterLittleEndian::~DataWriterLittleEndian()
 {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+    mWriter.join();
 }
 
 void DataWriterLittleEndian::operator()(const sys::ubyte* data,
                                         size_t numElements,
                                         size_t elementSize)
 {
-    size_t dataProcessed = 0;
-    const size_t dataSize = numElements * elementSize;
-    while (dataProcessed < dataSize)
+    // Only whole elements go in each buffer so they can be swapped
+    const size_t chunkSize =
+            mScratch[0].size() - mScratch[0].size() % elementSize;
+    if (chunkSize == 0)
     {
-        const size_t dataToProcess =
-                std::min(mScratch.size(), dataSize - dataProcessed);
+        throw except::Exception(Ctxt(
+                "Scratch space is smaller than one element"));
+    }
 
-        memcpy(mScratch.data(), data + dataProcessed, dataToProcess);
+    writeChunks(numElements * elementSize, chunkSize,
+                [&](size_t offset, size_t size, std::byte* buffer)
+    {
+        memcpy(buffer, data + offset, size);
 
-        crsd::byteSwap(mScratch.data(),
+        crsd::byteSwap(buffer,
                        elementSize,
-                       dataToProcess / elementSize,
-                       mNumThreads);
+                       size / elementSize,
+                       mNumThreads,
+                       mThreadPool.get());
+    });
+}
+
+void DataWriterLittleEndian::writeRecords(const RecordEncoder& encode,
+                                          size_t numRecords,
+                                          size_t recordSize,
+                                          size_t elementSize)
+{
+    // Only whole records go in each buffer so they can be encoded
+    const size_t chunkSize =
+            mScratch[0].size() - mScratch[0].size() % recordSize;
+    if (chunkSize == 0)
+    {
+        throw except::Exception(Ctxt(
+                "Scratch space is smaller than one record"));
+    }
+
+    writeChunks(numRecords * recordSize, chunkSize,
+                [&](size_t offset, size_t size, std::byte* buffer)
+    {
+        encodeRecords(encode, offset / recordSize, size / recordSize,
+                      recordSize, elementSize, true, buffer);
+    });
+}
+
+void DataWriterLittleEndian::writeChunks(
+        size_t dataSize,
+        size_t chunkSize,
+        const std::function<void(size_t, size_t, std::byte*)>& fill)
+{
+    try
+    {
+        size_t dataProcessed = 0;
+        size_t index = 0;
+        while (dataProcessed < dataSize)
+        {
+            // Wait for the writer thread to finish with this buffer
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                while (mPending[index] != 0 && !mError)
+                {
+                    mCondition.wait(lock);
+                }
+                if (mError)
+                {
+                    break;
+                }
+            }
+
+            const size_t dataToProcess =
+                    std::min(chunkSize, dataSize - dataProcessed);
+            fill(dataProcessed, dataToProcess, mScratch[index].data());
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mPending[index] = dataToProcess;
+                mQueue.push_back(index);
+            }
+            mCondition.notify_all();
+
+            dataProcessed += dataToProcess;
+            index = (index + 1) % mScratch.size();
+        }
+    }
+    catch (...)
+    {
+        // Don't leave writes in flight behind the caller's back
+        try
+        {
+            waitForWrites();
+        }
+        catch (...)
+        {
+        }
+        throw;
+    }
+
+    waitForWrites();
+}
+
+void DataWriterLittleEndian::writeQueued()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        while (!mStop && mQueue.empty())
+        {
+            mCondition.wait(lock);
+        }
+        if (mQueue.empty())
+        {
+            return;
+        }
+
+        // Once a write fails, drop the rest of the queue
+        const size_t index = mQueue.front();
+        const bool write = !mError;
+        lock.unlock();
+
+        std::exception_ptr error;
+        if (write)
+        {
+            try
+            {
+                mStream->write(mScratch[index].data(), mPending[index]);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        lock.lock();
+        if (error)
+        {
+            mError = error;
+        }
+        mQueue.pop_front();
+        mPending[index] = 0;
+        mCondition.notify_all();
+    }
+}
 
-        mStream->write(mScratch.data(), dataToProcess);
+void DataWriterLittleEndian::waitForWrites()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mQueue.empty())
+    {
+        mCondition.wait(lock);
+    }
 
-        dataProcessed += dataToProcess;
+    if (mError)
+    {
+        std::exception_ptr error = mError;
+        mError = nullptr;
+        std::rethrow_exception(error);
     }
 }
 
@@ -97,6 +329,24 @@ void DataWriterBigEndian::operator()(const sys::ubyte* data,
                    numElements * elementSize);
 }
 
+void DataWriterBigEndian::writeRecords(const RecordEncoder& encode,
+                                       size_t numRecords,
+                                       size_t recordSize,
+                                       size_t elementSize)
+{
+    const size_t maxRecords = std::min(
+            numRecords,
+            std::max<size_t>(STAGING_BYTES / recordSize, 1));
+    std::vector<std::byte> buffer(maxRecords * recordSize);
+    for (size_t first = 0; first < numRecords; first += maxRecords)
+    {
+        const size_t count = std::min(maxRecords, numRecords - first);
+        encodeRecords(encode, first, count, recordSize, elementSize, false,
+                      buffer.data());
+        mStream->write(buffer.data(), count * recordSize);
+    }
+}
+
 void CRSDWriter::initializeDataWriter()
 {
     // Get the correct dataWriter.
@@ -110,7 +360,9 @@ void CRSDWriter::initializeDataWriter()
     {
         mDataWriter = std::make_unique<DataWriterLittleEndian>(mStream,
             mNumThreads,
-            mScratchSpaceSize);
+            mScratchSpaceSize,
+            mThreadPool,
+            mNumScratchBuffers);
     }
 }
 
@@ -119,11 +371,15 @@ CRSDWriter::CRSDWriter(const Metadata& metadata,
                        std::shared_ptr<io::SeekableOutputStream> outStream,
                        const std::vector<std::string>& schemaPaths,
                        size_t numThreads,
-                       size_t scratchSpaceSize) :
+                       size_t scratchSpaceSize,
+                       std::shared_ptr<ThreadPool> threadPool,
+                       size_t numScratchBuffers) :
     mMetadata(metadata),
     mElementSize(metadata.data.getNumBytesPerSample()),
     mScratchSpaceSize(scratchSpaceSize),
     mNumThreads(numThreads),
+    mThreadPool(threadPool),
+    mNumScratchBuffers(numScratchBuffers),
     mSchemaPaths(schemaPaths),
     mStream(outStream)
 {
@@ -134,11 +390,15 @@ CRSDWriter::CRSDWriter(const Metadata& metadata,
                        const std::string& pathname,
                        const std::vector<std::string>& schemaPaths,
                        size_t numThreads,
-                       size_t scratchSpaceSize) :
+                       size_t scratchSpaceSize,
+                       std::shared_ptr<ThreadPool> threadPool,
+                       size_t numScratchBuffers) :
     mMetadata(metadata),
     mElementSize(metadata.data.getNumBytesPerSample()),
     mScratchSpaceSize(scratchSpaceSize),
     mNumThreads(numThreads),
+    mThreadPool(threadPool),
+    mNumScratchBuffers(numScratchBuffers),
     mSchemaPaths(schemaPaths)
 {
     // Initialize output stream
@@ -173,6 +433,15 @@ void CRSDWriter::writeMetadata(size_t supportSize,
                                      "informaion must be specified"));
     }
 
+    // Chunked compressed signal blocks are exactly as big as the chunks
+    if (mMetadata.data.isCompressed() &&
+        SignalChunkIndex::isChunked(
+                *mMetadata.data.receiveParameters->signalCompression))
+    {
+        crsdSize = mMetadata.data.receiveParameters->signalCompression
+                           ->getCompressedSignalSize();
+    }
+
     // set header size, final step before write
     mHeader.set(xmlMetadata.size(), supportSize, pvpSize, pppSize, crsdSize);
 
@@ -183,25 +452,44 @@ void CRSDWriter::writeMetadata(size_t supportSize,
     mStream->write(xmlMetadata);
 
     mStream->write("\f\n");
+    mMetadataWritten = true;
 }
 
-void CRSDWriter::writePVPData(const std::byte* pvpBlock, size_t channel)
+void CRSDWriter::writePVPData(const PVPBlock& pvpBlock, size_t channel)
 {
-    const size_t size = (mMetadata.data.getNumVectors(channel) *
-                         mMetadata.data.getNumBytesPVPSet()) /
-            8;
-
+    const size_t numBytesPVPSet = pvpBlock.getNumBytesPVPSet();
     //! The vector based parameters are always 64 bit
-    (*mDataWriter)(pvpBlock, size, 8);
+    mDataWriter->writeRecords(
+            [&pvpBlock, channel](size_t first, size_t count, std::byte* buffer)
+            {
+                pvpBlock.getPVPdata(channel, first, count, buffer);
+            },
+            pvpBlock.getPVPsize(channel) / numBytesPVPSet,
+            numBytesPVPSet,
+            8);
 }
 
-void CRSDWriter::writePPPData(const std::byte* pppBlock, size_t index)
+void CRSDWriter::writePPPData(const PPPBlock& pppBlock, size_t txSequence)
 {
-    const size_t size = (mMetadata.data.transmitParameters->txSequence[index].getNumPulses() *
-                         mMetadata.data.getNumBytesPPPSet()) /
-            8;
-    //! The vector based parameters are always 64 bit
-    (*mDataWriter)(pppBlock, size, 8);
+    const size_t numBytesPPPSet = pppBlock.getNumBytesPPPSet();
+    //! The per pulse parameters are always 64 bit
+    mDataWriter->writeRecords(
+            [&pppBlock, txSequence](size_t first, size_t count, std::byte* buffer)
+            {
+                pppBlock.getPPPdata(txSequence, first, count, buffer);
+            },
+            pppBlock.getPPPsize(txSequence) / numBytesPPPSet,
+            numBytesPPPSet,
+            8);
+}
+
+void CRSDWriter::writePadding(int64_t numBytes)
+{
+    if (numBytes > 0)
+    {
+        const std::vector<std::byte> zeros(static_cast<size_t>(numBytes));
+        mStream->write(zeros.data(), zeros.size());
+    }
 }
 
 void CRSDWriter::writeCRSDDataImpl(const std::byte* data, size_t size)
@@ -327,51 +615,57 @@ template void CRSDWriter::write<std::complex<float>>(
 
 void CRSDWriter::writePVPData(const PVPBlock& pvpBlock)
 {
-    // Add padding
-    char zero = 0;
-    for (int64_t ii = 0; ii < mHeader.getPvpPadBytes(); ++ii)
-    {
-        mStream->write(&zero, 1);
-    }
+    writePadding(mHeader.getPvpPadBytes());
 
     // Write each PVP array
     const size_t numChannels = mMetadata.data.getNumChannels();
-    std::vector<std::byte> pvpData;
+    const size_t numBytesPVPSet = mMetadata.data.getNumBytesPVPSet();
     for (size_t ii = 0; ii < numChannels; ++ii)
     {
-        pvpBlock.getPVPdata(ii, pvpData);
-        if (pvpData.empty())
+        const size_t size = pvpBlock.getPVPsize(ii);
+        if (size == 0)
         {
             std::ostringstream ostr;
             ostr << "PVPBlock of channel " << ii << " is empty";
             throw except::Exception(Ctxt(ostr.str()));
         }
-        writePVPData(pvpData.data(), ii);
+        if (size != mMetadata.data.getNumVectors(ii) * numBytesPVPSet)
+        {
+            std::ostringstream ostr;
+            ostr << "PVPBlock of channel " << ii << " holds " << size
+                 << " bytes but the metadata calls for "
+                 << mMetadata.data.getNumVectors(ii) * numBytesPVPSet;
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+        writePVPData(pvpBlock, ii);
     }
 }
 
 void CRSDWriter::writePPPData(const PPPBlock& pppBlock)
 {
-    // Add padding
-    char zero = 0;
-    for (int64_t ii = 0; ii < mHeader.getPppPadBytes(); ++ii)
-    {
-        mStream->write(&zero, 1);
-    }
+    writePadding(mHeader.getPppPadBytes());
 
-    // Write each PVP array
+    // Write each PPP array
     const size_t numTxSequences = mMetadata.data.getNumTxSequences();
-    std::vector<std::byte> pppData;
+    const size_t numBytesPPPSet = mMetadata.data.getNumBytesPPPSet();
     for (size_t ii = 0; ii < numTxSequences; ++ii)
     {
-        pppBlock.getPPPdata(ii, pppData);
-        if (pppData.empty())
+        const size_t size = pppBlock.getPPPsize(ii);
+        if (size == 0)
         {
             std::ostringstream ostr;
             ostr << "PPPBlock of txSequence " << ii << " is empty";
             throw except::Exception(Ctxt(ostr.str()));
         }
-        writePPPData(pppData.data(), ii);
+        if (size != mMetadata.data.getNumPulses(ii) * numBytesPPPSet)
+        {
+            std::ostringstream ostr;
+            ostr << "PPPBlock of txSequence " << ii << " holds " << size
+                 << " bytes but the metadata calls for "
+                 << mMetadata.data.getNumPulses(ii) * numBytesPPPSet;
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+        writePPPData(pppBlock, ii);
     }
 }
 
@@ -532,4 +826,201 @@ template void CRSDWriter::writeCRSDData<std::complex<int16_t>>(
 
 template void CRSDWriter::writeCRSDData<std::complex<float>>(
         const std::complex<float>* data, size_t numElements, size_t channel);
+
+void CRSDWriter::writeMetadata()
+{
+    if (mMetadata.data.isCompressed())
+    {
+        throw except::Exception(Ctxt(
+                "Streaming writes require uncompressed signal data"));
+    }
+
+    const CRSDType type = mMetadata.getType();
+    size_t totalPVPSize = 0;
+    size_t totalPPPSize = 0;
+    size_t totalCRSDSize = 0;
+    if (type != CRSDType::TX)
+    {
+        for (size_t ii = 0; ii < mMetadata.data.getNumChannels(); ++ii)
+        {
+            totalPVPSize += mMetadata.data.getNumVectors(ii) *
+                    mMetadata.data.getNumBytesPVPSet();
+            totalCRSDSize += mMetadata.data.getSignalSize(ii);
+        }
+    }
+    if (type != CRSDType::RCV)
+    {
+        for (size_t ii = 0; ii < mMetadata.data.getNumTxSequences(); ++ii)
+        {
+            totalPPPSize += mMetadata.data.getNumPulses(ii) *
+                    mMetadata.data.getNumBytesPPPSet();
+        }
+    }
+
+    writeMetadata(mMetadata.data.getAllSupportSize(),
+                  totalPVPSize,
+                  totalPPPSize,
+                  totalCRSDSize);
+
+    // Everything but the signal block is small enough to zero fill up front,
+    // which also takes care of the pads between blocks
+    const int64_t end = type == CRSDType::TX ?
+            mHeader.getPppBlockByteOffset() + mHeader.getPppBlockSize() :
+            mHeader.getSignalBlockByteOffset();
+    const std::vector<std::byte> zeros(64 * 1024);
+    for (int64_t offset = mStream->tell(); offset < end;)
+    {
+        const size_t size = static_cast<size_t>(std::min<int64_t>(
+                end - offset, static_cast<int64_t>(zeros.size())));
+        mStream->write(zeros.data(), size);
+        offset += size;
+    }
+}
+
+template <typename T>
+void CRSDWriter::writeVectors(size_t channel,
+                              size_t firstVector,
+                              std::span<const T> data)
+{
+    if (!mMetadataWritten)
+    {
+        throw except::Exception(Ctxt("writeMetadata() must be called first"));
+    }
+    if (mMetadata.data.isCompressed())
+    {
+        throw except::Exception(Ctxt(
+                "Streaming writes require uncompressed signal data"));
+    }
+    if (mElementSize != sizeof(T))
+    {
+        throw except::Exception(
+                Ctxt("Incorrect buffer data type used for metadata!"));
+    }
+
+    const size_t numSamples = mMetadata.data.getNumSamples(channel);
+    if (numSamples == 0 || data.size() % numSamples != 0)
+    {
+        std::ostringstream ostr;
+        ostr << data.size() << " samples is not a whole number of "
+             << numSamples << " sample vectors";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+    const size_t numVectors = data.size() / numSamples;
+    if (firstVector + numVectors > mMetadata.data.getNumVectors(channel))
+    {
+        std::ostringstream ostr;
+        ostr << "Vectors [" << firstVector << ", "
+             << firstVector + numVectors << ") are out of range for channel "
+             << channel << " with " << mMetadata.data.getNumVectors(channel)
+             << " vectors";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    // Channels are stored back to back
+    int64_t offset = mHeader.getSignalBlockByteOffset();
+    for (size_t ii = 0; ii < channel; ++ii)
+    {
+        offset += mMetadata.data.getSignalSize(ii);
+    }
+    offset += firstVector * numSamples * mElementSize;
+
+    mStream->seek(offset, io::Seekable::START);
+    writeCRSDDataImpl(reinterpret_cast<const std::byte*>(data.data()),
+                      data.size());
+}
+
+template void CRSDWriter::writeVectors<std::complex<int8_t>>(
+        size_t channel,
+        size_t firstVector,
+        std::span<const std::complex<int8_t>> data);
+
+template void CRSDWriter::writeVectors<std::complex<int16_t>>(
+        size_t channel,
+        size_t firstVector,
+        std::span<const std::complex<int16_t>> data);
+
+template void CRSDWriter::writeVectors<std::complex<float>>(
+        size_t channel,
+        size_t firstVector,
+        std::span<const std::complex<float>> data);
+
+void CRSDWriter::writePVPs(size_t channel,
+                           size_t firstVector,
+                           const PVPBlock& pvpBlock)
+{
+    if (!mMetadataWritten)
+    {
+        throw except::Exception(Ctxt("writeMetadata() must be called first"));
+    }
+    const size_t numBytesPVPSet = mMetadata.data.getNumBytesPVPSet();
+    if (pvpBlock.getNumBytesPVPSet() != numBytesPVPSet)
+    {
+        std::ostringstream ostr;
+        ostr << "Number of pvp block bytes in metadata: " << numBytesPVPSet
+             << " does not match calculated size of pvp block: "
+             << pvpBlock.getNumBytesPVPSet();
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    const size_t numVectors = pvpBlock.getPVPsize(0) / numBytesPVPSet;
+    if (firstVector + numVectors > mMetadata.data.getNumVectors(channel))
+    {
+        std::ostringstream ostr;
+        ostr << "PVP sets [" << firstVector << ", "
+             << firstVector + numVectors << ") are out of range for channel "
+             << channel << " with " << mMetadata.data.getNumVectors(channel)
+             << " vectors";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    int64_t offset = mHeader.getPvpBlockByteOffset();
+    for (size_t ii = 0; ii < channel; ++ii)
+    {
+        offset += mMetadata.data.getNumVectors(ii) * numBytesPVPSet;
+    }
+    offset += firstVector * numBytesPVPSet;
+
+    mStream->seek(offset, io::Seekable::START);
+    writePVPData(pvpBlock, 0);
+}
+
+void CRSDWriter::writePPPs(size_t txSequence,
+                           size_t firstPulse,
+                           const PPPBlock& pppBlock)
+{
+    if (!mMetadataWritten)
+    {
+        throw except::Exception(Ctxt("writeMetadata() must be called first"));
+    }
+    const size_t numBytesPPPSet = mMetadata.data.getNumBytesPPPSet();
+    if (pppBlock.getNumBytesPPPSet() != numBytesPPPSet)
+    {
+        std::ostringstream ostr;
+        ostr << "Number of ppp block bytes in metadata: " << numBytesPPPSet
+             << " does not match calculated size of ppp block: "
+             << pppBlock.getNumBytesPPPSet();
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    const size_t numPulses = pppBlock.getPPPsize(0) / numBytesPPPSet;
+    if (firstPulse + numPulses > mMetadata.data.getNumPulses(txSequence))
+    {
+        std::ostringstream ostr;
+        ostr << "PPP sets [" << firstPulse << ", " << firstPulse + numPulses
+             << ") are out of range for tx sequence " << txSequence
+             << " with " << mMetadata.data.getNumPulses(txSequence)
+             << " pulses";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    int64_t offset = mHeader.getPppBlockByteOffset();
+    for (size_t ii = 0; ii < txSequence; ++ii)
+    {
+        offset += mMetadata.data.getNumPulses(ii) * numBytesPPPSet;
+    }
+    offset += firstPulse * numBytesPPPSet;
+
+    mStream->seek(offset, io::Seekable::START);
+    writePPPData(pppBlock, 0);
+}
 }
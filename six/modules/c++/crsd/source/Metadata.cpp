@@ -21,6 +21,7 @@
  */
 #include <crsd/Metadata.h>
 #include <crsd/Enums.h>
+#include <crsd/SignalChunkIndex.h>
 
 namespace crsd
 {
@@ -113,6 +114,17 @@ bool Metadata::isCompressed() const
     return data.isCompressed();
 }
 
+std::shared_ptr<const SignalChunkIndex> Metadata::getSignalChunkIndex() const
+{
+    if (!data.isCompressed() ||
+        !SignalChunkIndex::isChunked(*data.receiveParameters->signalCompression))
+    {
+        return nullptr;
+    }
+    return std::make_shared<SignalChunkIndex>(
+            *data.receiveParameters->signalCompression, getNumChannels());
+}
+
 std::string Metadata::getVersion() const
 {
     return mVersion;
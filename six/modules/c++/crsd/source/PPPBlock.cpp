@@ -21,7 +21,9 @@
  */
 
 #include <stddef.h>
+#include <string.h>
 
+#include <algorithm>
 #include <ostream>
 #include <vector>
 #include <typeinfo>
@@ -41,370 +43,139 @@
 
 namespace
 {
-// Set data from data block into data struct
-template <typename T> inline void setData(const unsigned char* data,
-                    T& dest)
-{
-    memcpy(&dest, data, sizeof(T));
-}
-template <typename T> inline void setData(const std::byte* data,
-    T& dest)
-{
-    setData(reinterpret_cast<const unsigned char*>(data), dest);
-}
-template <typename T> inline void setData(const sys::byte* data,
-    T& dest)
-{
-    setData(reinterpret_cast<const unsigned char*>(data), dest);
-}
-template <typename T> inline void setData(const double* data_,
-    T& dest)
-{
-    const void* pData_ = data_;
-    auto data = static_cast<const unsigned char*>(pData_);
-    setData(data, dest);
-}
-
-inline void setData(const std::byte* data_,
-                    crsd::Vector2& dest)
-{
-    const void* pData_ = data_;
-    auto data = static_cast<const double*>(pData_);
-    setData(&(data[0]), dest[0]);
-    setData(&(data[1]), dest[1]);
-}
-
-inline void setData(const std::byte* data_,
-                    crsd::Vector3& dest)
-{
-    const void* pData_ = data_;
-    auto data = static_cast<const double*>(pData_);
-    setData(&(data[0]), dest[0]);
-    setData(&(data[1]), dest[1]);
-    setData(&(data[2]), dest[2]);
-}
-
-// Get data from data struct and put into data block
-template <typename T> inline void getData(std::byte* dest,
-                    T value)
-{
-    memcpy(dest, &value, sizeof(value));
+// Builds the codec for either a mutable or a const array; the fields of a
+// const one are read-only
+template <typename ArrayT>
+crsd::ParameterCodec makeCodec(ArrayT& array, const crsd::Ppp& p)
+{
+    static_assert(sizeof(crsd::Vector2) == 2 * sizeof(double), "Vector2 must be packed");
+    static_assert(sizeof(crsd::Vector3) == 3 * sizeof(double), "Vector3 must be packed");
+
+    crsd::ParameterCodec codec;
+    codec.addIntegerField(p.txTime.getByteOffset(), &array.txTime.data()->first, sizeof(array.txTime[0]));
+    codec.addField(p.txTime.getByteOffset() + sizeof(int64_t), sizeof(double),
+                   &array.txTime.data()->second, sizeof(array.txTime[0]));
+    codec.addColumn(p.txPos.getByteOffset(), array.txPos);
+    codec.addColumn(p.txVel.getByteOffset(), array.txVel);
+    codec.addColumn(p.fx1.getByteOffset(), array.fx1);
+    codec.addColumn(p.fx2.getByteOffset(), array.fx2);
+    codec.addColumn(p.txmt.getByteOffset(), array.txmt);
+    codec.addIntegerField(p.phiX0.getByteOffset(), &array.phiX0.data()->first, sizeof(array.phiX0[0]));
+    codec.addField(p.phiX0.getByteOffset() + sizeof(int64_t), sizeof(double),
+                   &array.phiX0.data()->second, sizeof(array.phiX0[0]));
+    codec.addColumn(p.fxFreq0.getByteOffset(), array.fxFreq0);
+    codec.addColumn(p.fxRate.getByteOffset(), array.fxRate);
+    codec.addColumn(p.txRadInt.getByteOffset(), array.txRadInt);
+    codec.addColumn(p.txACX.getByteOffset(), array.txACX);
+    codec.addColumn(p.txACY.getByteOffset(), array.txACY);
+    codec.addColumn(p.txEB.getByteOffset(), array.txEB);
+    codec.addColumn(p.fxResponseIndex.getByteOffset(), array.fxResponseIndex);
+    for (auto it = p.addedPPP.begin(); it != p.addedPPP.end(); ++it)
+    {
+        auto& column = array.addedPPP.at(it->first);
+        codec.addField(it->second.getByteOffset(), column.byteSize,
+                       column.values.data(), column.byteSize);
+    }
+    return codec;
 }
-inline void getData(double* dest, double value)
-{
-    memcpy(dest, &value, sizeof(value));
 }
 
-template <typename T> inline void getData(std::byte* dest,
-                    T* value, size_t size)
+namespace crsd
 {
-    memcpy(dest, value, size);
-}
 
-inline void getData(std::byte* dest_,
-                    const crsd::Vector2& value)
+PPPBlock::PPPArray::PPPArray(const Ppp& p, size_t numPulses) :
+    txTime(numPulses, std::make_pair(six::Init::undefined<int64_t>(),
+                                     six::Init::undefined<double>())),
+    txPos(numPulses, six::Init::undefined<Vector3>()),
+    txVel(numPulses, six::Init::undefined<Vector3>()),
+    fx1(numPulses, six::Init::undefined<double>()),
+    fx2(numPulses, six::Init::undefined<double>()),
+    txmt(numPulses, six::Init::undefined<double>()),
+    phiX0(numPulses, std::make_pair(six::Init::undefined<int64_t>(),
+                                    six::Init::undefined<double>())),
+    fxFreq0(numPulses, six::Init::undefined<double>()),
+    fxRate(numPulses, six::Init::undefined<double>()),
+    txRadInt(numPulses, six::Init::undefined<double>()),
+    txACX(numPulses, six::Init::undefined<Vector3>()),
+    txACY(numPulses, six::Init::undefined<Vector3>()),
+    txEB(numPulses, six::Init::undefined<Vector2>()),
+    fxResponseIndex(numPulses, six::Init::undefined<int64_t>()),
+    xmIndex(numPulses, six::Init::undefined<int64_t>()),
+    xmIndexSet(numPulses, false)
 {
-    void* pDest_ = dest_;
-    auto dest = static_cast<double*>(pDest_);
-
-    getData(&(dest[0]), value[0]);
-    getData(&(dest[1]), value[1]);
+    for (auto it = p.addedPPP.begin(); it != p.addedPPP.end(); ++it)
+    {
+        addedPPP.emplace(it->first,
+                         AddedParameterColumn(it->second.getByteSize(), numPulses));
+    }
 }
 
-inline void getData(std::byte* dest_,
-                    const std::pair<int64_t, double>& value)
+ParameterCodec PPPBlock::PPPArray::getCodec(const Ppp& p)
 {
-    memcpy(dest_, &value.first, sizeof(int64_t));
-    int offset = sizeof(int64_t)/sizeof(std::byte);
-    getData(&(dest_[offset - 1]), value.second);
+    return makeCodec(*this, p);
 }
 
-inline void getData(std::byte* dest_,
-                    const crsd::Vector3& value)
+ParameterCodec PPPBlock::PPPArray::getCodec(const Ppp& p) const
 {
-    void* pDest_ = dest_;
-    auto dest = static_cast<double*>(pDest_);
-
-    getData(&(dest[0]), value[0]);
-    getData(&(dest[1]), value[1]);
-    getData(&(dest[2]), value[2]);
-}
+    return makeCodec(*this, p);
 }
 
-namespace crsd
+void PPPBlock::PPPArray::write(const Ppp& p,
+                               const std::byte* input,
+                               size_t stride)
 {
-
-PPPBlock::PPPSet::PPPSet() :
-    txTime(six::Init::undefined<int64_t>(),
-             six::Init::undefined<double>()),
-    txPos(six::Init::undefined<Vector3>()),
-    txVel(six::Init::undefined<Vector3>()),
-    fx1(six::Init::undefined<double>()),
-    fx2(six::Init::undefined<double>()),
-    txmt(six::Init::undefined<double>()),
-    phiX0(six::Init::undefined<int64_t>(),
-            six::Init::undefined<double>()),
-    fxFreq0(six::Init::undefined<double>()),
-    fxRate(six::Init::undefined<double>()),
-    txRadInt(six::Init::undefined<double>()),
-    txACX(six::Init::undefined<Vector3>()),
-    txACY(six::Init::undefined<Vector3>()),
-    txEB(six::Init::undefined<Vector2>()),
-    fxResponseIndex(six::Init::undefined<int64_t>())
-{
-}
-
-void PPPBlock::PPPSet::write(const PPPBlock& pppBlock, const Ppp& p, const sys::byte* input)
-{
-     double tmpVal;
-    ::setData(input + p.txTime.getByteOffset(), tmpVal);
-    txTime.first = static_cast<int64_t>(tmpVal);
-    ::setData(input + p.txTime.getByteOffset() + sizeof(txTime.first), txTime.second);
-    ::setData(input + p.txPos.getByteOffset(), txPos);
-    ::setData(input + p.txVel.getByteOffset(), txVel);
-    ::setData(input + p.fx1.getByteOffset(), fx1);
-    ::setData(input + p.fx2.getByteOffset(), fx2);
-    ::setData(input + p.txmt.getByteOffset(), txmt);
-    ::setData(input + p.phiX0.getByteOffset(), tmpVal);
-    phiX0.first = static_cast<int64_t>(tmpVal);
-    ::setData(input + p.phiX0.getByteOffset() + sizeof(phiX0.first), phiX0.second);
-    ::setData(input + p.fxFreq0.getByteOffset(), fxFreq0);
-    ::setData(input + p.fxRate.getByteOffset(), fxRate);
-    ::setData(input + p.txRadInt.getByteOffset(), txRadInt);
-    ::setData(input + p.txACX.getByteOffset(), txACX);
-    ::setData(input + p.txACY.getByteOffset(), txACY);
-    ::setData(input + p.txEB.getByteOffset(), txEB);
-    ::setData(input + p.fxResponseIndex.getByteOffset(), fxResponseIndex);
-     if (pppBlock.hasXMIndex())
-    {
-        xmIndex.reset(new int64_t());
-        ::setData(input + p.xmIndex.getByteOffset(), *xmIndex);
+    if (size() == 0)
+    {
+        return;
+    }
+    getCodec(p).decode(input, stride, size());
+    for (auto& column : addedPPP)
+    {
+        std::fill(column.second.isSet.begin(), column.second.isSet.end(), true);
     }
 
-    for (auto it = p.addedPPP.begin(); it != p.addedPPP.end(); ++it)
+    if (!six::Init::isUndefined<size_t>(p.xmIndex.getOffset()))
     {
-        if (it->second.getFormat() == "F4")
-        {
-            float val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "F8")
-        {
-            double val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "U1")
-        {
-            std::uint8_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "U2")
-        {
-            std::uint16_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "U4")
-        {
-            std::uint32_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "U8")
+        input += p.xmIndex.getByteOffset();
+        for (size_t ii = 0; ii < size(); ++ii, input += stride)
         {
-            std::int64_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "I1")
-        {
-            std::int8_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "I2")
-        {
-            std::int16_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "I4")
-        {
-            std::int32_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "I8")
-        {
-            std::int64_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CI2")
-        {
-            std::complex<std::int8_t> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CI4")
-        {
-            std::complex<std::int16_t> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CI8")
-        {
-            std::complex<std::int32_t> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CI16")
-        {
-            std::complex<std::int64_t> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CF8")
-        {
-            std::complex<float> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CF16")
-        {
-            std::complex<double> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
-        }
-        else
-        {
-            const auto pVal = input + it->second.getByteOffset();
-            std::string val;
-            val.assign(reinterpret_cast<const char*>(pVal),
-                       it->second.getByteSize());
-            addedPPP[it->first] = six::Parameter();
-            addedPPP.find(it->first)->second.setValue(val);
+            memcpy(&xmIndex[ii], input, sizeof(int64_t));
         }
+        std::fill(xmIndexSet.begin(), xmIndexSet.end(), true);
     }
 }
 
-void PPPBlock::PPPSet::read(const Ppp& p, sys::ubyte* dest_) const
+void PPPBlock::PPPArray::read(const Ppp& p,
+                              size_t first,
+                              size_t count,
+                              std::byte* output,
+                              size_t stride) const
 {
-    auto dest = reinterpret_cast<std::byte*>(dest_);
-    ::getData(dest + p.txTime.getByteOffset(), static_cast<double>(txTime.first));
-    ::getData(dest + p.txTime.getByteOffset() + sizeof(txTime.first), txTime.second);
-    ::getData(dest + p.txPos.getByteOffset(), txPos);
-    ::getData(dest + p.txVel.getByteOffset(), txVel);
-    ::getData(dest + p.fx1.getByteOffset(), fx1);
-    ::getData(dest + p.fx2.getByteOffset(), fx2);
-    ::getData(dest + p.txmt.getByteOffset(), txmt);
-    ::getData(dest + p.phiX0.getByteOffset(),static_cast<double>(phiX0.first));
-    ::getData(dest + p.phiX0.getByteOffset() + sizeof(phiX0.first), phiX0.second);
-    ::getData(dest + p.fxFreq0.getByteOffset(), fxFreq0);
-    ::getData(dest + p.fxRate.getByteOffset(), fxRate);
-    ::getData(dest + p.txRadInt.getByteOffset(), txRadInt);
-    ::getData(dest + p.txACX.getByteOffset(), txACX);
-    ::getData(dest + p.txACY.getByteOffset(), txACY);
-    ::getData(dest + p.txEB.getByteOffset(), txEB);
-    ::getData(dest + p.fxResponseIndex.getByteOffset(), fxResponseIndex);
-    if (xmIndex.get())
+    if (count == 0)
     {
-        ::getData(dest + p.xmIndex.getByteOffset(), *xmIndex);
-    }
-
-    if (addedPPP.size() != p.addedPPP.size())
-    {
-        throw except::Exception(Ctxt(
-            "Incorrect number of additional parameters instantiated"));
+        return;
     }
-    for (auto it = p.addedPPP.begin(); it != p.addedPPP.end(); ++it)
+    for (const auto& column : addedPPP)
     {
-        if (it->second.getFormat() == "F4")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<float>(addedPPP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "F8")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<double>(addedPPP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "U1")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::uint8_t>(addedPPP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "U2")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::uint16_t>(addedPPP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "U4")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::uint32_t>(addedPPP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "U8")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::int64_t>(addedPPP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "I1")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::int8_t>(addedPPP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "I2")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::int16_t>(addedPPP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "I4")
+        const auto isSet = column.second.isSet.begin() + first;
+        if (std::find(isSet, isSet + count, false) != isSet + count)
         {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::int32_t>(addedPPP.find(it->first)->second));
+            throw except::Exception(Ctxt(
+                "Incorrect number of additional parameters instantiated"));
         }
-        else if (it->second.getFormat() == "I8")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::int64_t>(addedPPP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "CI2")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPPP.find(it->first)->second.getComplex<std::int8_t>());
-        }
-        else if (it->second.getFormat() == "CI4")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPPP.find(it->first)->second.getComplex<std::int16_t>());
-        }
-        else if (it->second.getFormat() == "CI8")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPPP.find(it->first)->second.getComplex<std::int32_t>());
-        }
-        else if (it->second.getFormat() == "CI16")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPPP.find(it->first)->second.getComplex<std::int64_t>());
-        }
-        else if (it->second.getFormat() == "CF8")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPPP.find(it->first)->second.getComplex<float>());
-        }
-        else if (it->second.getFormat() == "CF16")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPPP.find(it->first)->second.getComplex<double>());
-        }
-        else
+    }
+
+    getCodec(p).encode(output, stride, first, count);
+
+    if (!six::Init::isUndefined<size_t>(p.xmIndex.getOffset()))
+    {
+        output += p.xmIndex.getByteOffset();
+        for (size_t ii = first; ii < first + count; ++ii, output += stride)
         {
-            ::getData(dest + it->second.getByteOffset(), addedPPP.find(it->first)->second.str().c_str(), it->second.getByteSize());
+            if (xmIndexSet[ii])
+            {
+                memcpy(output, &xmIndex[ii], sizeof(int64_t));
+            }
         }
     }
 }
@@ -412,15 +183,23 @@ void PPPBlock::PPPSet::read(const Ppp& p, sys::ubyte* dest_) const
 /*
  * Initialize PPP Array with a data object
  */
-PPPBlock::PPPBlock(const Ppp& p, const Data& d) :
+PPPBlock::PPPBlock(const Ppp& p, const Data& d, bool allocate) :
     mXMIndexEnabled(!six::Init::isUndefined<size_t>(p.xmIndex.getOffset()))
 {
     mPpp = p;
     mNumBytesPerPulse = d.getNumBytesPPPSet();
-    mData.resize(d.getNumTxSequences());
+    mData.reserve(d.getNumTxSequences());
     for (size_t ii = 0; ii < d.getNumTxSequences(); ++ii)
     {
-        mData[ii].resize(d.getNumPulses(ii));
+        mNumPulses.push_back(d.getNumPulses(ii));
+        if (allocate)
+        {
+            mData.emplace_back(mPpp, mNumPulses.back());
+        }
+        else
+        {
+            mData.emplace_back();
+        }
     }
     size_t calculateBytesPerPulse = mPpp.getReqSetSize()*sizeof(double);
 
@@ -434,8 +213,8 @@ PPPBlock::PPPBlock(const Ppp& p, const Data& d) :
     }
 }
 
-PPPBlock::PPPBlock(const Metadata& metadata)
-    : PPPBlock(*metadata.ppp.get(), metadata.data)
+PPPBlock::PPPBlock(const Metadata& metadata, bool allocate)
+    : PPPBlock(*metadata.ppp.get(), metadata.data, allocate)
 {
 }
 
@@ -449,15 +228,16 @@ PPPBlock::PPPBlock(size_t numTxSequences,
     mNumBytesPerPulse(0),
     mPpp(p)
 {
-    mData.resize(numTxSequences);
     if(numTxSequences != numPulses.size())
     {
         throw except::Exception(Ctxt(
                 "number of vector dims provided does not match number of pulses"));
     }
+    mNumPulses = numPulses;
+    mData.reserve(numTxSequences);
     for (size_t ii = 0; ii < numTxSequences; ++ii)
     {
-        mData[ii].resize(numPulses[ii]);
+        mData.emplace_back(mPpp, numPulses[ii]);
     }
     size_t calculateBytesPerPulse = mPpp.getReqSetSize()*sizeof(double);
     if (six::Init::isUndefined<size_t>(mNumBytesPerPulse) ||
@@ -483,13 +263,9 @@ PPPBlock::PPPBlock(size_t numTxSequences,
 
     for (size_t pulse = 0; pulse < numTxSequences; ++pulse)
     {
-        const std::byte* buf = static_cast<const std::byte*>(data[pulse]);
-
-        for (size_t vector = 0; vector < numPulses[pulse]; ++vector)
-        {
-            mData[pulse][vector].write(*this, mPpp, buf);
-            buf += mPpp.sizeInBytes();
-        }
+        mData[pulse].write(mPpp,
+                           static_cast<const std::byte*>(data[pulse]),
+                           mPpp.sizeInBytes());
     }
 }
 
@@ -500,22 +276,37 @@ size_t PPPBlock::getNumBytesPPPSet() const
 
 void PPPBlock::verifyTxSequencePulse(size_t pulse, size_t vector) const
 {
-    if (pulse >= mData.size())
+    if (pulse >= mNumPulses.size())
     {
         throw except::Exception(Ctxt(
                 "Invalid pulse number: " + std::to_string(pulse)));
     }
-    if (vector >= mData[pulse].size())
+    if (mData[pulse].size() != mNumPulses[pulse])
+    {
+        throw except::Exception(Ctxt(
+                "PPP array of tx sequence " + std::to_string(pulse) +
+                " has not been loaded"));
+    }
+    if (vector >= mNumPulses[pulse])
     {
         throw except::Exception(Ctxt(
                 "Invalid vector number: " + std::to_string(vector)));
     }
 }
 
+void PPPBlock::verifyTxSequence(size_t txSequence) const
+{
+    if (txSequence >= mNumPulses.size())
+    {
+        throw except::Exception(Ctxt(
+                "Invalid tx sequence number: " + std::to_string(txSequence)));
+    }
+}
+
 size_t PPPBlock::getPPPsize(size_t pulse) const
 {
-    verifyTxSequencePulse(pulse, 0);
-    return getNumBytesPPPSet() * mData[pulse].size();
+    verifyTxSequence(pulse);
+    return getNumBytesPPPSet() * mNumPulses[pulse];
 }
 
 void PPPBlock::getPPPdata(size_t pulse,
@@ -532,21 +323,36 @@ void PPPBlock::getPPPdata(size_t pulse,
                           void* data) const
 {
     verifyTxSequencePulse(pulse, 0);
-    const size_t numBytes = getNumBytesPPPSet();
-    auto ptr = static_cast<std::byte*>(data);
+    mData[pulse].read(mPpp,
+                      0,
+                      mData[pulse].size(),
+                      static_cast<std::byte*>(data),
+                      getNumBytesPPPSet());
+}
 
-    for (size_t ii = 0;
-         ii < mData[pulse].size();
-         ++ii, ptr += numBytes)
+void PPPBlock::getPPPdata(size_t txSequence,
+                          size_t firstPulse,
+                          size_t numPulses,
+                          void* data) const
+{
+    if (numPulses == 0)
     {
-        mData[pulse][ii].read(mPpp, ptr);
+        return;
     }
+    verifyTxSequencePulse(txSequence, firstPulse + numPulses - 1);
+    memset(data, 0, numPulses * getNumBytesPPPSet());
+    mData[txSequence].read(mPpp,
+                           firstPulse,
+                           numPulses,
+                           static_cast<std::byte*>(data),
+                           getNumBytesPPPSet());
 }
 
 int64_t PPPBlock::load(io::SeekableInputStream& inStream,
                      int64_t startPPP,
                      int64_t sizePPP,
-                     size_t numThreads)
+                     size_t numThreads,
+                     ThreadPool* threadPool)
 {
     // Allocate the buffers
     size_t numBytesIn(0);
@@ -566,13 +372,10 @@ int64_t PPPBlock::load(io::SeekableInputStream& inStream,
         throw except::Exception(Ctxt(oss.str()));
     }
 
-    const bool swapToLittleEndian = std::endian::native == std::endian::little;
-
     // Seek to start of PPPBlock
     size_t totalBytesRead(0);
     inStream.seek(startPPP, io::Seekable::START);
     std::vector<std::byte> readBuf;
-    const size_t numBytesPerPulse = getNumBytesPPPSet();
 
     // Read the data for each pulse
     for (size_t ii = 0; ii < mData.size(); ++ii)
@@ -590,121 +393,175 @@ int64_t PPPBlock::load(io::SeekableInputStream& inStream,
             }
             totalBytesRead += bytesThisRead;
 
-            // Input CRSD is always Big Endian; swap to Little Endian if
-            // necessary
-            if (swapToLittleEndian)
-            {
-                byteSwap(buf,
-                         sizeof(double),
-                         readBuf.size() / sizeof(double),
-                         numThreads);
-            }
-
-            std::byte* ptr = buf;
-            for (size_t jj = 0; jj < mData[ii].size(); ++jj, ptr += numBytesPerPulse)
-            {
-                mData[ii][jj].write(*this, mPpp, ptr);
-            }
+            decodeTxSequence(ii, buf, numThreads, threadPool);
         }
     }
     return totalBytesRead;
 }
-int64_t PPPBlock::load(io::SeekableInputStream& inStream, const FileHeader& fileHeader, size_t numThreads)
+int64_t PPPBlock::load(io::SeekableInputStream& inStream, const FileHeader& fileHeader, size_t numThreads,
+                       ThreadPool* threadPool)
 {
-    return load(inStream, fileHeader.getPppBlockByteOffset(), fileHeader.getPppBlockSize(), numThreads);
+    return load(inStream, fileHeader.getPppBlockByteOffset(), fileHeader.getPppBlockSize(), numThreads,
+                threadPool);
+}
+
+int64_t PPPBlock::loadTxSequence(PositionalInputStream& inStream,
+                                 int64_t startPPP,
+                                 int64_t sizePPP,
+                                 size_t txSequence,
+                                 size_t numThreads,
+                                 ThreadPool* threadPool)
+{
+    verifyTxSequence(txSequence);
+
+    // Tx sequences are stored back to back, in order
+    const size_t numBytesPerPulse = getNumBytesPPPSet();
+    size_t offset = 0;
+    for (size_t ii = 0; ii < txSequence; ++ii)
+    {
+        offset += mNumPulses[ii] * numBytesPerPulse;
+    }
+    std::vector<std::byte> readBuf(mNumPulses[txSequence] * numBytesPerPulse);
+    if (offset + readBuf.size() > static_cast<size_t>(sizePPP))
+    {
+        std::ostringstream oss;
+        oss << "PPPBlock::loadTxSequence: PPP array of tx sequence " << txSequence
+            << " ends past header PPP_DATA_SIZE(" << sizePPP << ")";
+        throw except::Exception(Ctxt(oss.str()));
+    }
+
+    if (!readBuf.empty())
+    {
+        inStream.readAt(startPPP + offset, readBuf.data(), readBuf.size());
+        decodeTxSequence(txSequence, readBuf.data(), numThreads, threadPool);
+    }
+    return readBuf.size();
+}
+int64_t PPPBlock::loadTxSequence(PositionalInputStream& inStream, const FileHeader& fileHeader,
+                                 size_t txSequence, size_t numThreads,
+                                 ThreadPool* threadPool)
+{
+    return loadTxSequence(inStream, fileHeader.getPppBlockByteOffset(), fileHeader.getPppBlockSize(),
+                          txSequence, numThreads, threadPool);
+}
+
+void PPPBlock::decodeTxSequence(size_t txSequence,
+                                std::byte* buffer,
+                                size_t numThreads,
+                                ThreadPool* threadPool)
+{
+    const size_t numBytesPerPulse = getNumBytesPPPSet();
+    const size_t numBytes = mNumPulses[txSequence] * numBytesPerPulse;
+    if (mData[txSequence].size() != mNumPulses[txSequence])
+    {
+        mData[txSequence] = PPPArray(mPpp, mNumPulses[txSequence]);
+    }
+
+    // Input CRSD is always Big Endian; swap to Little Endian if
+    // necessary
+    if (std::endian::native == std::endian::little)
+    {
+        byteSwap(buffer,
+                 sizeof(double),
+                 numBytes / sizeof(double),
+                 numThreads,
+                 threadPool);
+    }
+
+    mData[txSequence].write(mPpp, buffer, numBytesPerPulse);
 }
 
 
 std::pair<int64_t, double> PPPBlock::getTxStart(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].txTime;
+    return mData[pulse].txTime[set];
 }
 
 Vector3 PPPBlock::getTxPos(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].txPos;
+    return mData[pulse].txPos[set];
 }
 
 Vector3 PPPBlock::getTxVel(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].txVel;
+    return mData[pulse].txVel[set];
 }
 
 double PPPBlock::getFX1(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].fx1;
+    return mData[pulse].fx1[set];
 }
 
 double PPPBlock::getTXMT(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].txmt;
+    return mData[pulse].txmt[set];
 }
 
 double PPPBlock::getFX2(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].fx2;
+    return mData[pulse].fx2[set];
 }
 
 std::pair<int64_t, double> PPPBlock::getPhiX0(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].phiX0;
+    return mData[pulse].phiX0[set];
 }
 
 double PPPBlock::getFxFreq0(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].fxFreq0;
+    return mData[pulse].fxFreq0[set];
 }
 
 double PPPBlock::getFxRate(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].fxRate;
+    return mData[pulse].fxRate[set];
 }
 
 double PPPBlock::getTxRadInt(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].txRadInt;
+    return mData[pulse].txRadInt[set];
 }
 
 Vector3 PPPBlock::getTxACX(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].txACX;
+    return mData[pulse].txACX[set];
 }
 
 Vector3 PPPBlock::getTxACY(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].txACY;
+    return mData[pulse].txACY[set];
 }
 
 Vector2 PPPBlock::getTxEB(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].txEB;
+    return mData[pulse].txEB[set];
 }
 
 std::int64_t PPPBlock::getFxResponseIndex(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    return mData[pulse][set].fxResponseIndex;
+    return mData[pulse].fxResponseIndex[set];
 }
 
 std::int64_t  PPPBlock::getXMIndex(size_t pulse, size_t set) const
 {
     verifyTxSequencePulse(pulse, set);
-    if (mData[pulse][set].xmIndex.get())
+    if (mData[pulse].xmIndexSet[set])
     {
-        return *mData[pulse][set].xmIndex;
+        return mData[pulse].xmIndex[set];
     }
     throw except::Exception(Ctxt(
                     "Parameter was not set"));
@@ -713,85 +570,85 @@ std::int64_t  PPPBlock::getXMIndex(size_t pulse, size_t set) const
 void PPPBlock::setTxStart(std::pair<int64_t, double> value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].txTime = value;
+    mData[pulse].txTime[vector] = value;
 }
 
 void PPPBlock::setTxPos(const crsd::Vector3& value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].txPos = value;
+    mData[pulse].txPos[vector] = value;
 }
 
 void PPPBlock::setTxVel(const crsd::Vector3& value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].txVel = value;
+    mData[pulse].txVel[vector] = value;
 }
 
 void PPPBlock::setFX1(double value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].fx1 = value;
+    mData[pulse].fx1[vector] = value;
 }
 
 void PPPBlock::setFX2(double value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].fx2 = value;
+    mData[pulse].fx2[vector] = value;
 }
 
 void PPPBlock::setTXMT(double value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].txmt = value;
+    mData[pulse].txmt[vector] = value;
 }
 
 void PPPBlock::setPhiX0(std::pair<int64_t, double> value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].phiX0 = value;
+    mData[pulse].phiX0[vector] = value;
 }
 
 void PPPBlock::setFxFreq0(double value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].fxFreq0 = value;
+    mData[pulse].fxFreq0[vector] = value;
 }
 
 void PPPBlock::setFxRate(double value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].fxRate = value;
+    mData[pulse].fxRate[vector] = value;
 }
 
 void PPPBlock::setTxRadInt(double value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].txRadInt = value;
+    mData[pulse].txRadInt[vector] = value;
 }
 
 void PPPBlock::setTxACX(const crsd::Vector3& value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].txACX = value;
+    mData[pulse].txACX[vector] = value;
 }
 
 void PPPBlock::setTxACY(const crsd::Vector3& value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].txACY = value;
+    mData[pulse].txACY[vector] = value;
 }
 
 void PPPBlock::setTxEB(const Vector2& value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].txEB = value;
+    mData[pulse].txEB[vector] = value;
 }
 
 void PPPBlock::setFxResponseIndex(std::int64_t  value, size_t pulse, size_t vector)
 {
     verifyTxSequencePulse(pulse, vector);
-    mData[pulse][vector].fxResponseIndex = value;
+    mData[pulse].fxResponseIndex[vector] = value;
 }
 
 void PPPBlock::setXMIndex(std::int64_t value, size_t pulse, size_t vector)
@@ -799,44 +656,55 @@ void PPPBlock::setXMIndex(std::int64_t value, size_t pulse, size_t vector)
     verifyTxSequencePulse(pulse, vector);
     if (hasXMIndex())
     {
-        mData[pulse][vector].xmIndex.reset(new std::int64_t(value));
+        mData[pulse].xmIndex[vector] = value;
+        mData[pulse].xmIndexSet[vector] = true;
         return;
     }
     throw except::Exception(Ctxt(
                             "Parameter was not specified in XML"));
 }
 
-std::ostream& operator<< (std::ostream& os, const PPPBlock::PPPSet& p)
+six::Parameter PPPBlock::getAddedParameter(size_t txSequence,
+                                           size_t set,
+                                           const std::string& name) const
 {
-    os  << "  TxTime         : " << p.txTime.first
-        << " , "                 << p.txTime.second << "\n"
-        << "  TxPos          : " << p.txPos << "\n"
-        << "  TxVel          : " << p.txVel << "\n"
-        << "  FRCV1          : " << p.fx1 << "\n"
-        << "  FRCV2          : " << p.fx2 << "\n"
-        << "  TXMT           : " << p.txmt << "\n"
-        << "  PhiX0          : " << p.phiX0.first
-        << " , "                 << p.phiX0.second << "\n"
-        << "  FxFreq0        : " << p.fxFreq0 << "\n"
-        << "  FxRate         : " << p.fxRate << "\n"
-        << "  TxRadInt       : " << p.txRadInt << "\n"
-        << "  RcvACX         : " << p.txACX << "\n"
-        << "  RcvACY         : " << p.txACY << "\n"
-        << "  RcvEB          : " << p.txEB << "\n"
-        << "  SIGNAL         : " << p.fxResponseIndex << "\n";
-    if (p.xmIndex.get())
+    verifyTxSequencePulse(txSequence, set);
+    auto it = mData[txSequence].addedPPP.find(name);
+    if (it != mData[txSequence].addedPPP.end() && it->second.isSet[set])
     {
-        os << "  XMIndex       : " << *p.xmIndex << "\n";
+        const AddedParameterColumn& column = it->second;
+        return ParameterCodec::toParameter(mPpp.addedPPP.find(name)->second.getFormat(),
+                                           column.values.data() + set * column.byteSize,
+                                           column.byteSize);
     }
+    throw except::Exception(Ctxt(
+            "Parameter was not set"));
+}
 
-    for (auto it = p.addedPPP.begin(); it != p.addedPPP.end(); ++it)
+void PPPBlock::setAddedParameter(const six::Parameter& value,
+                                 size_t txSequence,
+                                 size_t set,
+                                 const std::string& name)
+{
+    verifyTxSequencePulse(txSequence, set);
+    auto param = mPpp.addedPPP.find(name);
+    if (param == mPpp.addedPPP.end())
     {
-        os << "  Additional Parameter : " << it->second.str() << "\n";
+        throw except::Exception(Ctxt(
+                                "Parameter was not specified in XML"));
     }
-    return os;
+    AddedParameterColumn& column = mData[txSequence].addedPPP.at(name);
+    if (column.isSet[set])
+    {
+        throw except::Exception(Ctxt(
+                            "Additional parameter requested already exists"));
+    }
+    ParameterCodec::fromParameter(value, param->second.getFormat(),
+                                  column.values.data() + set * column.byteSize,
+                                  column.byteSize);
+    column.isSet[set] = true;
 }
 
-
 std::ostream& operator<< (std::ostream& os, const PPPBlock& p)
 {
     os << "PPPBlock:: \n";
@@ -854,22 +722,45 @@ std::ostream& operator<< (std::ostream& os, const PPPBlock& p)
 
         for (size_t ii = 0; ii < p.mData.size(); ++ii)
         {
-            if (p.mData[ii].empty())
+            const PPPBlock::PPPArray& array = p.mData[ii];
+            if (array.size() == 0)
             {
                 os << "[" << ii << "] mData: (empty)\n";
+                continue;
             }
-            else
+            for (size_t jj = 0; jj < array.size(); ++jj)
             {
-                for (size_t jj = 0; jj < p.mData[ii].size(); ++jj)
+                os << "[" << ii << "] [" << jj << "] mData: "
+                   << "  TxTime         : " << array.txTime[jj].first
+                   << " , "                 << array.txTime[jj].second << "\n"
+                   << "  TxPos          : " << array.txPos[jj] << "\n"
+                   << "  TxVel          : " << array.txVel[jj] << "\n"
+                   << "  FRCV1          : " << array.fx1[jj] << "\n"
+                   << "  FRCV2          : " << array.fx2[jj] << "\n"
+                   << "  TXMT           : " << array.txmt[jj] << "\n"
+                   << "  PhiX0          : " << array.phiX0[jj].first
+                   << " , "                 << array.phiX0[jj].second << "\n"
+                   << "  FxFreq0        : " << array.fxFreq0[jj] << "\n"
+                   << "  FxRate         : " << array.fxRate[jj] << "\n"
+                   << "  TxRadInt       : " << array.txRadInt[jj] << "\n"
+                   << "  RcvACX         : " << array.txACX[jj] << "\n"
+                   << "  RcvACY         : " << array.txACY[jj] << "\n"
+                   << "  RcvEB          : " << array.txEB[jj] << "\n"
+                   << "  SIGNAL         : " << array.fxResponseIndex[jj] << "\n";
+                if (array.xmIndexSet[jj])
                 {
-                    if (p.mData[ii].empty())
+                    os << "  XMIndex       : " << array.xmIndex[jj] << "\n";
+                }
+
+                for (auto it = array.addedPPP.begin(); it != array.addedPPP.end(); ++it)
+                {
+                    if (it->second.isSet[jj])
                     {
-                        os << "[" << ii << "] [" << jj << "] mData: (empty)\n";
-                    }
-                    else {
-                        os << "[" << ii << "] [" << jj << "] mData: " << p.mData[ii][jj] << "\n";
+                        os << "  Additional Parameter : "
+                           << p.getAddedParameter(ii, jj, it->first).str() << "\n";
                     }
                 }
+                os << "\n";
             }
         }
     }
@@ -21,7 +21,9 @@
  */
 
 #include <stddef.h>
+#include <string.h>
 
+#include <algorithm>
 #include <ostream>
 #include <vector>
 #include <typeinfo>
@@ -41,396 +43,156 @@
 
 namespace
 {
-// Set data from data block into data struct
-template <typename T> inline void setData(const unsigned char* data,
-                    T& dest)
+template <typename T>
+inline std::span<const T> makeSpan(const std::vector<T>& column)
 {
-    memcpy(&dest, data, sizeof(T));
-}
-template <typename T> inline void setData(const std::byte* data,
-    T& dest)
-{
-    setData(reinterpret_cast<const unsigned char*>(data), dest);
-}
-template <typename T> inline void setData(const sys::byte* data,
-    T& dest)
-{
-    setData(reinterpret_cast<const unsigned char*>(data), dest);
-}
-template <typename T> inline void setData(const double* data_,
-    T& dest)
-{
-    const void* pData_ = data_;
-    auto data = static_cast<const unsigned char*>(pData_);
-    setData(data, dest);
-}
-
-inline void setData(const std::byte* data_,
-                    crsd::Vector2& dest)
-{
-    const void* pData_ = data_;
-    auto data = static_cast<const double*>(pData_);
-    setData(&(data[0]), dest[0]);
-    setData(&(data[1]), dest[1]);
-}
-
-inline void setData(const std::byte* data_,
-                    int64_t& dest)
-{
-    const void* pData_ = data_;
-    auto data = static_cast<const unsigned char*>(pData_);
-    setData(data, dest);
-
-}
-
-inline void setData(const std::byte* data_,
-                    crsd::Vector3& dest)
-{
-    const void* pData_ = data_;
-    auto data = static_cast<const double*>(pData_);
-    setData(&(data[0]), dest[0]);
-    setData(&(data[1]), dest[1]);
-    setData(&(data[2]), dest[2]);
-}
-
-// Get data from data struct and put into data block
-template <typename T> inline void getData(std::byte* dest,
-                    T value)
-{
-    memcpy(dest, &value, sizeof(value));
+    if (column.empty())
+    {
+        return std::span<const T>();
+    }
+    return std::span<const T>(column.data(), column.size());
+}
+
+// Builds the codec for either a mutable or a const array; the fields of a
+// const one are read-only
+template <typename ArrayT>
+crsd::ParameterCodec makeCodec(ArrayT& array, const crsd::Pvp& p)
+{
+    static_assert(sizeof(crsd::Vector2) == 2 * sizeof(double), "Vector2 must be packed");
+    static_assert(sizeof(crsd::Vector3) == 3 * sizeof(double), "Vector3 must be packed");
+
+    crsd::ParameterCodec codec;
+    codec.addIntegerField(p.rcvStart.getByteOffset(), &array.rcvStart.data()->first, sizeof(array.rcvStart[0]));
+    codec.addField(p.rcvStart.getByteOffset() + sizeof(int64_t), sizeof(double),
+                   &array.rcvStart.data()->second, sizeof(array.rcvStart[0]));
+    codec.addColumn(p.rcvPos.getByteOffset(), array.rcvPos);
+    codec.addColumn(p.rcvVel.getByteOffset(), array.rcvVel);
+    codec.addColumn(p.frcv1.getByteOffset(), array.frcv1);
+    codec.addColumn(p.frcv2.getByteOffset(), array.frcv2);
+    codec.addIntegerField(p.refPhi0.getByteOffset(), &array.refPhi0.data()->first, sizeof(array.refPhi0[0]));
+    codec.addField(p.refPhi0.getByteOffset() + sizeof(int64_t), sizeof(double),
+                   &array.refPhi0.data()->second, sizeof(array.refPhi0[0]));
+    codec.addColumn(p.refFreq.getByteOffset(), array.refFreq);
+    codec.addColumn(p.dfiC0.getByteOffset(), array.dfiC0);
+    codec.addColumn(p.ficRate.getByteOffset(), array.ficRate);
+    codec.addColumn(p.rcvACX.getByteOffset(), array.rcvACX);
+    codec.addColumn(p.rcvACY.getByteOffset(), array.rcvACY);
+    codec.addColumn(p.rcvEB.getByteOffset(), array.rcvEB);
+    codec.addIntegerField(p.signal.getByteOffset(), array.signal.data(), sizeof(array.signal[0]));
+    codec.addColumn(p.ampSF.getByteOffset(), array.ampSF);
+    codec.addColumn(p.dgrgc.getByteOffset(), array.dgrgc);
+    if (!six::Init::isUndefined<size_t>(p.txPulseIndex.getOffset()))
+    {
+        codec.addColumn(p.txPulseIndex.getByteOffset(), array.txPulseIndex);
+    }
+    for (auto it = p.addedPVP.begin(); it != p.addedPVP.end(); ++it)
+    {
+        auto& column = array.addedPVP.at(it->first);
+        codec.addField(it->second.getByteOffset(), column.byteSize,
+                       column.values.data(), column.byteSize);
+    }
+    return codec;
 }
-inline void getData(double* dest, double value)
-{
-    memcpy(dest, &value, sizeof(value));
 }
 
-template <typename T> inline void getData(std::byte* dest,
-                    T* value, size_t size)
+namespace crsd
 {
-    memcpy(dest, value, size);
-}
 
-inline void getData(std::byte* dest_,
-                    const crsd::Vector2& value)
+PVPBlock::PVPArray::PVPArray(const Pvp& p, size_t numVectors) :
+    rcvStart(numVectors, std::make_pair(six::Init::undefined<int64_t>(),
+                                        six::Init::undefined<double>())),
+    rcvPos(numVectors, six::Init::undefined<Vector3>()),
+    rcvVel(numVectors, six::Init::undefined<Vector3>()),
+    frcv1(numVectors, six::Init::undefined<double>()),
+    frcv2(numVectors, six::Init::undefined<double>()),
+    refPhi0(numVectors, std::make_pair(six::Init::undefined<int64_t>(),
+                                       six::Init::undefined<double>())),
+    refFreq(numVectors, six::Init::undefined<double>()),
+    dfiC0(numVectors, six::Init::undefined<double>()),
+    ficRate(numVectors, six::Init::undefined<double>()),
+    rcvACX(numVectors, six::Init::undefined<Vector3>()),
+    rcvACY(numVectors, six::Init::undefined<Vector3>()),
+    rcvEB(numVectors, six::Init::undefined<Vector2>()),
+    signal(numVectors, six::Init::undefined<int64_t>()),
+    ampSF(numVectors, six::Init::undefined<double>()),
+    dgrgc(numVectors, six::Init::undefined<double>()),
+    txPulseIndex(numVectors, six::Init::undefined<int64_t>())
 {
-    void* pDest_ = dest_;
-    auto dest = static_cast<double*>(pDest_);
-
-    getData(&(dest[0]), value[0]);
-    getData(&(dest[1]), value[1]);
+    for (auto it = p.addedPVP.begin(); it != p.addedPVP.end(); ++it)
+    {
+        addedPVP.emplace(it->first,
+                         AddedParameterColumn(it->second.getByteSize(), numVectors));
+    }
 }
 
-inline void getData(std::byte* dest_,
-                    const std::pair<int64_t, double>& value)
+ParameterCodec PVPBlock::PVPArray::getCodec(const Pvp& p)
 {
-    memcpy(dest_, &value.first, sizeof(int64_t));
-    int offset = sizeof(int64_t)/sizeof(std::byte);
-    getData(&(dest_[offset - 1]), value.second);
+    return makeCodec(*this, p);
 }
 
-inline void getData(std::byte* dest_,
-                    const crsd::Vector3& value)
+ParameterCodec PVPBlock::PVPArray::getCodec(const Pvp& p) const
 {
-    void* pDest_ = dest_;
-    auto dest = static_cast<double*>(pDest_);
-
-    getData(&(dest[0]), value[0]);
-    getData(&(dest[1]), value[1]);
-    getData(&(dest[2]), value[2]);
-}
+    return makeCodec(*this, p);
 }
 
-namespace crsd
+void PVPBlock::PVPArray::write(const Pvp& p,
+                               const std::byte* input,
+                               size_t stride)
 {
-
-PVPBlock::PVPSet::PVPSet() :
-    rcvStart(six::Init::undefined<int64_t>(),
-             six::Init::undefined<double>()),
-    rcvPos(six::Init::undefined<Vector3>()),
-    rcvVel(six::Init::undefined<Vector3>()),
-    frcv1(six::Init::undefined<double>()),
-    frcv2(six::Init::undefined<double>()),
-    refPhi0(six::Init::undefined<int64_t>(),
-            six::Init::undefined<double>()),
-    refFreq(six::Init::undefined<double>()),
-    dfiC0(six::Init::undefined<double>()),
-    ficRate(six::Init::undefined<double>()),
-    rcvACX(six::Init::undefined<Vector3>()),
-    rcvACY(six::Init::undefined<Vector3>()),
-    rcvEB(six::Init::undefined<Vector2>()),
-    signal(six::Init::undefined<int64_t>()),
-    ampSF(six::Init::undefined<double>()),
-    dgrgc(six::Init::undefined<double>()),
-    txPulseIndex(six::Init::undefined<int64_t>())
-{
-}
-
-void PVPBlock::PVPSet::write(const PVPBlock& pvpBlock, const Pvp& p, const sys::byte* input)
-{
-    double tmpVal;
-    ::setData(input + p.rcvStart.getByteOffset(), tmpVal);
-    rcvStart.first = static_cast<int64_t>(tmpVal);
-    ::setData(input + p.rcvStart.getByteOffset() + sizeof(rcvStart.first), rcvStart.second);
-    ::setData(input + p.rcvPos.getByteOffset(), rcvPos);
-    ::setData(input + p.rcvVel.getByteOffset(), rcvVel);
-    ::setData(input + p.frcv1.getByteOffset(), frcv1);
-    ::setData(input + p.frcv2.getByteOffset(), frcv2);
-    ::setData(input + p.refPhi0.getByteOffset(), tmpVal);
-    refPhi0.first = static_cast<int64_t>(tmpVal);
-    ::setData(input + p.refPhi0.getByteOffset() + sizeof(refPhi0.first), refPhi0.second);
-    ::setData(input + p.refFreq.getByteOffset(), refFreq);
-    ::setData(input + p.dfiC0.getByteOffset(), dfiC0);
-    ::setData(input + p.ficRate.getByteOffset(), ficRate);
-    ::setData(input + p.rcvACX.getByteOffset(), rcvACX);
-    ::setData(input + p.rcvACY.getByteOffset(), rcvACY);
-    ::setData(input + p.rcvEB.getByteOffset(), rcvEB);
-    ::setData(input + p.signal.getByteOffset(), signal);
-    ::setData(input + p.ampSF.getByteOffset(), ampSF);
-    ::setData(input + p.dgrgc.getByteOffset(), dgrgc);
-    if (!six::Init::isUndefined<size_t>(p.txPulseIndex.getOffset()))
+    if (size() == 0)
     {
-        ::setData(input + p.txPulseIndex.getByteOffset(), txPulseIndex);
+        return;
     }
-    for (auto it = p.addedPVP.begin(); it != p.addedPVP.end(); ++it)
+    getCodec(p).decode(input, stride, size());
+    for (auto& column : addedPVP)
     {
-        if (it->second.getFormat() == "F4")
-        {
-            float val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "F8")
-        {
-            double val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "U1")
-        {
-            std::uint8_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "U2")
-        {
-            std::uint16_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "U4")
-        {
-            std::uint32_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "U8")
-        {
-            std::int64_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "I1")
-        {
-            std::int8_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "I2")
-        {
-            std::int16_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "I4")
-        {
-            std::int32_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "I8")
-        {
-            std::int64_t val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CI2")
-        {
-            std::complex<std::int8_t> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CI4")
-        {
-            std::complex<std::int16_t> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CI8")
-        {
-            std::complex<std::int32_t> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CI16")
-        {
-            std::complex<std::int64_t> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CF8")
-        {
-            std::complex<float> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else if (it->second.getFormat() == "CF16")
-        {
-            std::complex<double> val;
-            ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
-        else
-        {
-            const auto pVal = input + it->second.getByteOffset();
-            std::string val;
-            val.assign(reinterpret_cast<const char*>(pVal),
-                       it->second.getByteSize());
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
-        }
+        std::fill(column.second.isSet.begin(), column.second.isSet.end(), true);
     }
 }
 
-void PVPBlock::PVPSet::read(const Pvp& p, sys::ubyte* dest_) const
-{
-    auto dest = reinterpret_cast<std::byte*>(dest_);
-    ::getData(dest + p.rcvStart.getByteOffset(), static_cast<double>(rcvStart.first));
-    ::getData(dest + p.rcvStart.getByteOffset() + sizeof(rcvStart.first), rcvStart.second);
-    ::getData(dest + p.rcvPos.getByteOffset(), rcvPos);
-    ::getData(dest + p.rcvVel.getByteOffset(), rcvVel);
-    ::getData(dest + p.frcv1.getByteOffset(), frcv1);
-    ::getData(dest + p.frcv2.getByteOffset(), frcv2);
-    ::getData(dest + p.refPhi0.getByteOffset(), static_cast<double>(refPhi0.first));
-    ::getData(dest + p.refPhi0.getByteOffset() + sizeof(refPhi0.first), refPhi0.second);
-    ::getData(dest + p.refFreq.getByteOffset(), refFreq);
-    ::getData(dest + p.dfiC0.getByteOffset(), dfiC0);
-    ::getData(dest + p.ficRate.getByteOffset(), ficRate);
-    ::getData(dest + p.rcvACX.getByteOffset(), rcvACX);
-    ::getData(dest + p.rcvACY.getByteOffset(), rcvACY);
-    ::getData(dest + p.rcvEB.getByteOffset(), rcvEB);
-    ::getData(dest + p.signal.getByteOffset(), signal);
-    ::getData(dest + p.ampSF.getByteOffset(), ampSF);
-    ::getData(dest + p.dgrgc.getByteOffset(), dgrgc);
-    if (!six::Init::isUndefined<size_t>(p.txPulseIndex.getOffset()))
-    {
-        ::getData(dest + p.txPulseIndex.getByteOffset(), txPulseIndex);
-    }
-    if (addedPVP.size() != p.addedPVP.size())
+void PVPBlock::PVPArray::read(const Pvp& p,
+                              size_t first,
+                              size_t count,
+                              std::byte* output,
+                              size_t stride) const
+{
+    if (count == 0)
     {
-        throw except::Exception(Ctxt(
-            "Incorrect number of additional parameters instantiated"));
+        return;
     }
-    for (auto it = p.addedPVP.begin(); it != p.addedPVP.end(); ++it)
+    for (const auto& column : addedPVP)
     {
-        if (it->second.getFormat() == "F4")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<float>(addedPVP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "F8")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<double>(addedPVP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "U1")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::uint8_t>(addedPVP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "U2")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::uint16_t>(addedPVP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "U4")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::uint32_t>(addedPVP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "U8")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::int64_t>(addedPVP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "I1")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::int8_t>(addedPVP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "I2")
+        const auto isSet = column.second.isSet.begin() + first;
+        if (std::find(isSet, isSet + count, false) != isSet + count)
         {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::int16_t>(addedPVP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "I4")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::int32_t>(addedPVP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "I8")
-        {
-            ::getData(dest + it->second.getByteOffset(), static_cast<std::int64_t>(addedPVP.find(it->first)->second));
-        }
-        else if (it->second.getFormat() == "CI2")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPVP.find(it->first)->second.getComplex<std::int8_t>());
-        }
-        else if (it->second.getFormat() == "CI4")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPVP.find(it->first)->second.getComplex<std::int16_t>());
-        }
-        else if (it->second.getFormat() == "CI8")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPVP.find(it->first)->second.getComplex<std::int32_t>());
-        }
-        else if (it->second.getFormat() == "CI16")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPVP.find(it->first)->second.getComplex<std::int64_t>());
-        }
-        else if (it->second.getFormat() == "CF8")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPVP.find(it->first)->second.getComplex<float>());
-        }
-        else if (it->second.getFormat() == "CF16")
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPVP.find(it->first)->second.getComplex<double>());
-        }
-        else
-        {
-            ::getData(dest + it->second.getByteOffset(), addedPVP.find(it->first)->second.str().c_str(), it->second.getByteSize());
+            throw except::Exception(Ctxt(
+                "Incorrect number of additional parameters instantiated"));
         }
     }
+
+    getCodec(p).encode(output, stride, first, count);
 }
 
 /*
  * Initialize PVP Array with a data object
  */
-PVPBlock::PVPBlock(const Pvp& p, const Data& d)
+PVPBlock::PVPBlock(const Pvp& p, const Data& d, bool allocate)
 {
     mPvp = p;
     mNumBytesPerVector = d.getNumBytesPVPSet();
 
-    mData.resize(d.getNumChannels());
+    mData.reserve(d.getNumChannels());
     for (size_t ii = 0; ii < d.getNumChannels(); ++ii)
     {
-        mData[ii].resize(d.getNumVectors(ii));
+        mNumVectors.push_back(d.getNumVectors(ii));
+        if (allocate)
+        {
+            mData.emplace_back(mPvp, mNumVectors.back());
+        }
+        else
+        {
+            mData.emplace_back();
+        }
     }
  
     size_t calculateBytesPerVector = mPvp.getReqSetSize()*sizeof(double);
@@ -443,8 +205,8 @@ PVPBlock::PVPBlock(const Pvp& p, const Data& d)
         throw except::Exception(oss.str());
     }
 }
-PVPBlock::PVPBlock(const Metadata& metadata)
-    : PVPBlock(*metadata.pvp.get(), metadata.data)
+PVPBlock::PVPBlock(const Metadata& metadata, bool allocate)
+    : PVPBlock(*metadata.pvp.get(), metadata.data, allocate)
 {
 }
 
@@ -458,15 +220,16 @@ PVPBlock::PVPBlock(size_t numChannels,
     mNumBytesPerVector(0),
     mPvp(p)
 {
-    mData.resize(numChannels);
     if(numChannels != numVectors.size())
     {
         throw except::Exception(Ctxt(
                 "number of vector dims provided does not match number of channels"));
     }
+    mNumVectors = numVectors;
+    mData.reserve(numChannels);
     for (size_t ii = 0; ii < numChannels; ++ii)
     {
-        mData[ii].resize(numVectors[ii]);
+        mData.emplace_back(mPvp, numVectors[ii]);
     }
     size_t calculateBytesPerVector = mPvp.getReqSetSize()*sizeof(double);
     if (six::Init::isUndefined<size_t>(mNumBytesPerVector) ||
@@ -492,13 +255,9 @@ PVPBlock::PVPBlock(size_t numChannels,
 
     for (size_t channel = 0; channel < numChannels; ++channel)
     {
-        const std::byte* buf = static_cast<const std::byte*>(data[channel]);
-
-        for (size_t vector = 0; vector < numVectors[channel]; ++vector)
-        {
-            mData[channel][vector].write(*this, mPvp, buf);
-            buf += mPvp.sizeInBytes();
-        }
+        mData[channel].write(mPvp,
+                             static_cast<const std::byte*>(data[channel]),
+                             mPvp.sizeInBytes());
     }
 }
 
@@ -509,22 +268,39 @@ size_t PVPBlock::getNumBytesPVPSet() const
 
 void PVPBlock::verifyChannelVector(size_t channel, size_t vector) const
 {
-    if (channel >= mData.size())
+    getChannel(channel);
+    if (vector >= mNumVectors[channel])
+    {
+        throw except::Exception(Ctxt(
+                "Invalid vector number: " + std::to_string(vector)));
+    }
+}
+
+void PVPBlock::verifyChannel(size_t channel) const
+{
+    if (channel >= mNumVectors.size())
     {
         throw except::Exception(Ctxt(
                 "Invalid channel number: " + std::to_string(channel)));
     }
-    if (vector >= mData[channel].size())
+}
+
+const PVPBlock::PVPArray& PVPBlock::getChannel(size_t channel) const
+{
+    verifyChannel(channel);
+    if (mData[channel].size() != mNumVectors[channel])
     {
         throw except::Exception(Ctxt(
-                "Invalid vector number: " + std::to_string(vector)));
+                "PVP array of channel " + std::to_string(channel) +
+                " has not been loaded"));
     }
+    return mData[channel];
 }
 
 size_t PVPBlock::getPVPsize(size_t channel) const
 {
-    verifyChannelVector(channel, 0);
-    return getNumBytesPVPSet() * mData[channel].size();
+    verifyChannel(channel);
+    return getNumBytesPVPSet() * mNumVectors[channel];
 }
 
 void PVPBlock::getPVPdata(size_t channel,
@@ -541,28 +317,43 @@ void PVPBlock::getPVPdata(size_t channel,
                           void* data) const
 {
     verifyChannelVector(channel, 0);
-    const size_t numBytes = getNumBytesPVPSet();
-    auto ptr = static_cast<std::byte*>(data);
+    mData[channel].read(mPvp,
+                        0,
+                        mData[channel].size(),
+                        static_cast<std::byte*>(data),
+                        getNumBytesPVPSet());
+}
 
-    for (size_t ii = 0;
-         ii < mData[channel].size();
-         ++ii, ptr += numBytes)
+void PVPBlock::getPVPdata(size_t channel,
+                          size_t firstVector,
+                          size_t numVectors,
+                          void* data) const
+{
+    if (numVectors == 0)
     {
-        mData[channel][ii].read(mPvp, ptr);
+        return;
     }
+    verifyChannelVector(channel, firstVector + numVectors - 1);
+    memset(data, 0, numVectors * getNumBytesPVPSet());
+    mData[channel].read(mPvp,
+                        firstVector,
+                        numVectors,
+                        static_cast<std::byte*>(data),
+                        getNumBytesPVPSet());
 }
 
 int64_t PVPBlock::load(io::SeekableInputStream& inStream,
                      int64_t startPVP,
                      int64_t sizePVP,
-                     size_t numThreads)
+                     size_t numThreads,
+                     ThreadPool* threadPool)
 {
     // Allocate the buffers
     size_t numBytesIn(0);
 
     // Compute the PVPBlock size per channel
     // (channels aren't necessarily the same size)
-    for (size_t ii = 0; ii < mData.size(); ++ii)
+    for (size_t ii = 0; ii < mNumVectors.size(); ++ii)
     {
         numBytesIn += getPVPsize(ii);
     }
@@ -575,16 +366,13 @@ int64_t PVPBlock::load(io::SeekableInputStream& inStream,
         throw except::Exception(Ctxt(oss.str()));
     }
 
-    const bool swapToLittleEndian = std::endian::native == std::endian::little;
-
     // Seek to start of PVPBlock
     size_t totalBytesRead(0);
     inStream.seek(startPVP, io::Seekable::START);
     std::vector<std::byte> readBuf;
-    const size_t numBytesPerVector = getNumBytesPVPSet();
 
     // Read the data for each channel
-    for (size_t ii = 0; ii < mData.size(); ++ii)
+    for (size_t ii = 0; ii < mNumVectors.size(); ++ii)
     {
         readBuf.resize(getPVPsize(ii));
         if (!readBuf.empty())
@@ -599,256 +387,397 @@ int64_t PVPBlock::load(io::SeekableInputStream& inStream,
             }
             totalBytesRead += bytesThisRead;
 
-            // Input CRSD is always Big Endian; swap to Little Endian if
-            // necessary
-            if (swapToLittleEndian)
-            {
-                byteSwap(buf,
-                         sizeof(double),
-                         readBuf.size() / sizeof(double),
-                         numThreads);
-            }
-
-            std::byte* ptr = buf;
-            for (size_t jj = 0; jj < mData[ii].size(); ++jj, ptr += numBytesPerVector)
-            {
-                mData[ii][jj].write(*this, mPvp, ptr);
-            }
+            decodeChannel(ii, buf, numThreads, threadPool);
         }
     }
     return totalBytesRead;
 }
-int64_t PVPBlock::load(io::SeekableInputStream& inStream, const FileHeader& fileHeader, size_t numThreads)
+int64_t PVPBlock::load(io::SeekableInputStream& inStream, const FileHeader& fileHeader, size_t numThreads,
+                       ThreadPool* threadPool)
 {
-    return load(inStream, fileHeader.getPvpBlockByteOffset(), fileHeader.getPvpBlockSize(), numThreads);
+    return load(inStream, fileHeader.getPvpBlockByteOffset(), fileHeader.getPvpBlockSize(), numThreads,
+                threadPool);
+}
+
+int64_t PVPBlock::loadChannel(PositionalInputStream& inStream,
+                              int64_t startPVP,
+                              int64_t sizePVP,
+                              size_t channel,
+                              size_t numThreads,
+                              ThreadPool* threadPool)
+{
+    verifyChannel(channel);
+
+    // Channels are stored back to back, in order
+    const size_t numBytesPerVector = getNumBytesPVPSet();
+    size_t offset = 0;
+    for (size_t ii = 0; ii < channel; ++ii)
+    {
+        offset += mNumVectors[ii] * numBytesPerVector;
+    }
+    std::vector<std::byte> readBuf(mNumVectors[channel] * numBytesPerVector);
+    if (offset + readBuf.size() > static_cast<size_t>(sizePVP))
+    {
+        std::ostringstream oss;
+        oss << "PVPBlock::loadChannel: PVP array of channel " << channel
+            << " ends past header PVP_DATA_SIZE(" << sizePVP << ")";
+        throw except::Exception(Ctxt(oss.str()));
+    }
+
+    if (!readBuf.empty())
+    {
+        inStream.readAt(startPVP + offset, readBuf.data(), readBuf.size());
+        decodeChannel(channel, readBuf.data(), numThreads, threadPool);
+    }
+    return readBuf.size();
+}
+int64_t PVPBlock::loadChannel(PositionalInputStream& inStream, const FileHeader& fileHeader,
+                              size_t channel, size_t numThreads,
+                              ThreadPool* threadPool)
+{
+    return loadChannel(inStream, fileHeader.getPvpBlockByteOffset(), fileHeader.getPvpBlockSize(),
+                       channel, numThreads, threadPool);
+}
+
+void PVPBlock::decodeChannel(size_t channel,
+                          std::byte* buffer,
+                          size_t numThreads,
+                          ThreadPool* threadPool)
+{
+    const size_t numBytesPerVector = getNumBytesPVPSet();
+    const size_t numBytes = mNumVectors[channel] * numBytesPerVector;
+    if (mData[channel].size() != mNumVectors[channel])
+    {
+        mData[channel] = PVPArray(mPvp, mNumVectors[channel]);
+    }
+
+    // Input CRSD is always Big Endian; swap to Little Endian if
+    // necessary
+    if (std::endian::native == std::endian::little)
+    {
+        byteSwap(buffer,
+                 sizeof(double),
+                 numBytes / sizeof(double),
+                 numThreads,
+                 threadPool);
+    }
+    mData[channel].write(mPvp, buffer, numBytesPerVector);
 }
 
 
 std::pair<int64_t, double> PVPBlock::getRcvStart(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].rcvStart;
+    return mData[channel].rcvStart[set];
 }
 
 Vector3 PVPBlock::getRcvPos(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].rcvPos;
+    return mData[channel].rcvPos[set];
 }
 
 Vector3 PVPBlock::getRcvVel(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].rcvVel;
+    return mData[channel].rcvVel[set];
 }
 
 double PVPBlock::getFRCV1(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].frcv1;
+    return mData[channel].frcv1[set];
 }
 
 double PVPBlock::getFRCV2(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].frcv2;
+    return mData[channel].frcv2[set];
 }
 
 std::pair<int64_t, double> PVPBlock::getRefPhi0(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].refPhi0;
+    return mData[channel].refPhi0[set];
 }
 
 double PVPBlock::getRefFreq(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].refFreq;
+    return mData[channel].refFreq[set];
 }
 
 double PVPBlock::getDFIC0(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].dfiC0;
+    return mData[channel].dfiC0[set];
 }
 
 double PVPBlock::getFICRate(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].ficRate;
+    return mData[channel].ficRate[set];
 }
 
 Vector3 PVPBlock::getRcvACX(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].rcvACX;
+    return mData[channel].rcvACX[set];
 }
 
 Vector3 PVPBlock::getRcvACY(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].rcvACY;
+    return mData[channel].rcvACY[set];
 }
 
 Vector2 PVPBlock::getRcvEB(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].rcvEB;
+    return mData[channel].rcvEB[set];
 }
 
 std::int64_t PVPBlock::getSignal(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].signal;
+    return mData[channel].signal[set];
 }
 
 double PVPBlock::getAmpSF(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].ampSF;
+    return mData[channel].ampSF[set];
 }
 
 double PVPBlock::getDGRGC(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].dgrgc;
+    return mData[channel].dgrgc[set];
 }
 
 double PVPBlock::getTxPulseIndex(size_t channel, size_t set) const
 {
     verifyChannelVector(channel, set);
-    return mData[channel][set].txPulseIndex;
+    return static_cast<double>(mData[channel].txPulseIndex[set]);
+}
+
+std::span<const std::pair<int64_t, double>> PVPBlock::getRcvStart(size_t channel) const
+{
+    return makeSpan(getChannel(channel).rcvStart);
+}
+
+std::span<const Vector3> PVPBlock::getRcvPos(size_t channel) const
+{
+    return makeSpan(getChannel(channel).rcvPos);
+}
+
+std::span<const Vector3> PVPBlock::getRcvVel(size_t channel) const
+{
+    return makeSpan(getChannel(channel).rcvVel);
+}
+
+std::span<const double> PVPBlock::getFRCV1(size_t channel) const
+{
+    return makeSpan(getChannel(channel).frcv1);
+}
+
+std::span<const double> PVPBlock::getFRCV2(size_t channel) const
+{
+    return makeSpan(getChannel(channel).frcv2);
+}
+
+std::span<const std::pair<int64_t, double>> PVPBlock::getRefPhi0(size_t channel) const
+{
+    return makeSpan(getChannel(channel).refPhi0);
+}
+
+std::span<const double> PVPBlock::getRefFreq(size_t channel) const
+{
+    return makeSpan(getChannel(channel).refFreq);
+}
+
+std::span<const double> PVPBlock::getDFIC0(size_t channel) const
+{
+    return makeSpan(getChannel(channel).dfiC0);
+}
+
+std::span<const double> PVPBlock::getFICRate(size_t channel) const
+{
+    return makeSpan(getChannel(channel).ficRate);
+}
+
+std::span<const Vector3> PVPBlock::getRcvACX(size_t channel) const
+{
+    return makeSpan(getChannel(channel).rcvACX);
+}
+
+std::span<const Vector3> PVPBlock::getRcvACY(size_t channel) const
+{
+    return makeSpan(getChannel(channel).rcvACY);
+}
+
+std::span<const Vector2> PVPBlock::getRcvEB(size_t channel) const
+{
+    return makeSpan(getChannel(channel).rcvEB);
+}
+
+std::span<const int64_t> PVPBlock::getSignal(size_t channel) const
+{
+    return makeSpan(getChannel(channel).signal);
+}
+
+std::span<const double> PVPBlock::getAmpSF(size_t channel) const
+{
+    return makeSpan(getChannel(channel).ampSF);
+}
+
+std::span<const double> PVPBlock::getDGRGC(size_t channel) const
+{
+    return makeSpan(getChannel(channel).dgrgc);
+}
+
+std::span<const int64_t> PVPBlock::getTxPulseIndex(size_t channel) const
+{
+    return makeSpan(getChannel(channel).txPulseIndex);
+}
+
+six::Parameter PVPBlock::getAddedParameter(size_t channel,
+                                           size_t set,
+                                           const std::string& name) const
+{
+    verifyChannelVector(channel, set);
+    auto it = mData[channel].addedPVP.find(name);
+    if (it != mData[channel].addedPVP.end() && it->second.isSet[set])
+    {
+        const AddedParameterColumn& column = it->second;
+        return ParameterCodec::toParameter(mPvp.addedPVP.find(name)->second.getFormat(),
+                           column.values.data() + set * column.byteSize,
+                           column.byteSize);
+    }
+    throw except::Exception(Ctxt(
+            "Parameter was not set"));
+}
+
+void PVPBlock::setAddedParameter(const six::Parameter& value,
+                                 size_t channel,
+                                 size_t set,
+                                 const std::string& name)
+{
+    verifyChannelVector(channel, set);
+    auto param = mPvp.addedPVP.find(name);
+    if (param == mPvp.addedPVP.end())
+    {
+        throw except::Exception(Ctxt(
+                                "Parameter was not specified in XML"));
+    }
+    AddedParameterColumn& column = mData[channel].addedPVP.at(name);
+    if (column.isSet[set])
+    {
+        throw except::Exception(Ctxt(
+                            "Additional parameter requested already exists"));
+    }
+    ParameterCodec::fromParameter(value, param->second.getFormat(),
+                                  column.values.data() + set * column.byteSize,
+                                  column.byteSize);
+    column.isSet[set] = true;
 }
 
 void PVPBlock::setRcvStart(std::pair<int64_t, double> value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].rcvStart = value;
+    mData[channel].rcvStart[vector] = value;
 }
 
 void PVPBlock::setRcvPos(const crsd::Vector3& value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].rcvPos = value;
+    mData[channel].rcvPos[vector] = value;
 }
 
 void PVPBlock::setRcvVel(const crsd::Vector3& value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].rcvVel = value;
+    mData[channel].rcvVel[vector] = value;
 }
 
 void PVPBlock::setFRCV1(double value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].frcv1 = value;
+    mData[channel].frcv1[vector] = value;
 }
 
 void PVPBlock::setFRCV2(double value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].frcv2 = value;
+    mData[channel].frcv2[vector] = value;
 }
 
 void PVPBlock::setRefPhi0(std::pair<int64_t, double> value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].refPhi0 = value;
+    mData[channel].refPhi0[vector] = value;
 }
 
 void PVPBlock::setRefFreq(double value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].refFreq = value;
+    mData[channel].refFreq[vector] = value;
 }
 
 void PVPBlock::setDFIC0(double value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].dfiC0 = value;
+    mData[channel].dfiC0[vector] = value;
 }
 
 void PVPBlock::setFICRate(double value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].ficRate = value;
+    mData[channel].ficRate[vector] = value;
 }
 
 void PVPBlock::setRcvACX(const crsd::Vector3& value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].rcvACX = value;
+    mData[channel].rcvACX[vector] = value;
 }
 
 void PVPBlock::setRcvACY(const crsd::Vector3& value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].rcvACY = value;
+    mData[channel].rcvACY[vector] = value;
 }
 
 void PVPBlock::setRcvEB(const Vector2& value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].rcvEB = value;
+    mData[channel].rcvEB[vector] = value;
 }
 
 void PVPBlock::setSignal(int64_t value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].signal = value;
+    mData[channel].signal[vector] = value;
 }
 
 void PVPBlock::setAmpSF(double value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].ampSF = value;
+    mData[channel].ampSF[vector] = value;
 }
 
 void PVPBlock::setDGRGC(double value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].dgrgc = value;
+    mData[channel].dgrgc[vector] = value;
 }
 
 void PVPBlock::setTxPulseIndex(double value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].txPulseIndex = value;
+    mData[channel].txPulseIndex[vector] = static_cast<int64_t>(value);
 }
 
-std::ostream& operator<< (std::ostream& os, const PVPBlock::PVPSet& p)
-{
-    os  << "  RcvStart       : " << p.rcvStart.first
-        << " , "                 << p.rcvStart.second << "\n"
-        << "  RcvPos         : " << p.rcvPos << "\n"
-        << "  RcvVel         : " << p.rcvVel << "\n"
-        << "  FRCV1          : " << p.frcv1 << "\n"
-        << "  FRCV2          : " << p.frcv2 << "\n"
-        << "  RefPhi0        : " << p.refPhi0.first
-        << " , "                 << p.refPhi0.second << "\n"
-        << "  RefFreq        : " << p.refFreq << "\n"
-        << "  DFIC0          : " << p.dfiC0 << "\n"
-        << "  FICRate        : " << p.ficRate << "\n"
-        << "  RcvACX         : " << p.rcvACX << "\n"
-        << "  RcvACY         : " << p.rcvACY << "\n"
-        << "  RcvEB          : " << p.rcvEB << "\n"
-        << "  SIGNAL         : " << p.signal << "\n"
-        << "  AmpSF          : " << p.ampSF << "\n"
-        << "  DGRGC          : " << p.dgrgc << "\n";
-
-    if (!six::Init::isUndefined<int64_t>(p.txPulseIndex))
-    {
-        os << "  TxPulseIndex        :" << p.txPulseIndex << "\n";
-    }
-
-    for (auto it = p.addedPVP.begin(); it != p.addedPVP.end(); ++it)
-    {
-        os << "  Additional Parameter : " << it->second.str() << "\n";
-    }
-    return os;
-}
-
-
 std::ostream& operator<< (std::ostream& os, const PVPBlock& p)
 {
     os << "PVPBlock:: \n";
@@ -866,22 +795,47 @@ std::ostream& operator<< (std::ostream& os, const PVPBlock& p)
 
         for (size_t ii = 0; ii < p.mData.size(); ++ii)
         {
-            if (p.mData[ii].empty())
+            const PVPBlock::PVPArray& array = p.mData[ii];
+            if (array.size() == 0)
             {
                 os << "[" << ii << "] mData: (empty)\n";
+                continue;
             }
-            else
+            for (size_t jj = 0; jj < array.size(); ++jj)
             {
-                for (size_t jj = 0; jj < p.mData[ii].size(); ++jj)
+                os << "[" << ii << "] [" << jj << "] mData: "
+                   << "  RcvStart       : " << array.rcvStart[jj].first
+                   << " , "                 << array.rcvStart[jj].second << "\n"
+                   << "  RcvPos         : " << array.rcvPos[jj] << "\n"
+                   << "  RcvVel         : " << array.rcvVel[jj] << "\n"
+                   << "  FRCV1          : " << array.frcv1[jj] << "\n"
+                   << "  FRCV2          : " << array.frcv2[jj] << "\n"
+                   << "  RefPhi0        : " << array.refPhi0[jj].first
+                   << " , "                 << array.refPhi0[jj].second << "\n"
+                   << "  RefFreq        : " << array.refFreq[jj] << "\n"
+                   << "  DFIC0          : " << array.dfiC0[jj] << "\n"
+                   << "  FICRate        : " << array.ficRate[jj] << "\n"
+                   << "  RcvACX         : " << array.rcvACX[jj] << "\n"
+                   << "  RcvACY         : " << array.rcvACY[jj] << "\n"
+                   << "  RcvEB          : " << array.rcvEB[jj] << "\n"
+                   << "  SIGNAL         : " << array.signal[jj] << "\n"
+                   << "  AmpSF          : " << array.ampSF[jj] << "\n"
+                   << "  DGRGC          : " << array.dgrgc[jj] << "\n";
+
+                if (!six::Init::isUndefined<int64_t>(array.txPulseIndex[jj]))
                 {
-                    if (p.mData[ii].empty())
+                    os << "  TxPulseIndex        :" << array.txPulseIndex[jj] << "\n";
+                }
+
+                for (auto it = array.addedPVP.begin(); it != array.addedPVP.end(); ++it)
+                {
+                    if (it->second.isSet[jj])
                     {
-                        os << "[" << ii << "] [" << jj << "] mData: (empty)\n";
-                    }
-                    else {
-                        os << "[" << ii << "] [" << jj << "] mData: " << p.mData[ii][jj] << "\n";
+                        os << "  Additional Parameter : "
+                           << p.getAddedParameter(ii, jj, it->first).str() << "\n";
                     }
                 }
+                os << "\n";
             }
         }
     }
@@ -0,0 +1,341 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <crsd/ParameterCodec.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <complex>
+
+#include <except/Exception.h>
+
+namespace
+{
+// Sets are handled a block at a time, one field at a time within a block.
+// The inner loops then copy a fixed number of bytes, and the block's sets
+// stay in cache while each field is visited.
+constexpr size_t SETS_PER_BLOCK = 256;
+
+template <size_t N>
+inline void copy(const std::byte* src, size_t srcStride,
+                 std::byte* dest, size_t destStride,
+                 size_t numSets)
+{
+    for (size_t ii = 0; ii < numSets; ++ii, src += srcStride, dest += destStride)
+    {
+        memcpy(dest, src, N);
+    }
+}
+
+inline void copy(size_t size,
+                 const std::byte* src, size_t srcStride,
+                 std::byte* dest, size_t destStride,
+                 size_t numSets)
+{
+    switch (size)
+    {
+    case 1: copy<1>(src, srcStride, dest, destStride, numSets); break;
+    case 2: copy<2>(src, srcStride, dest, destStride, numSets); break;
+    case 4: copy<4>(src, srcStride, dest, destStride, numSets); break;
+    case 8: copy<8>(src, srcStride, dest, destStride, numSets); break;
+    case 16: copy<16>(src, srcStride, dest, destStride, numSets); break;
+    case 24: copy<24>(src, srcStride, dest, destStride, numSets); break;
+    default:
+        for (size_t ii = 0; ii < numSets; ++ii, src += srcStride, dest += destStride)
+        {
+            memcpy(dest, src, size);
+        }
+    }
+}
+
+template <typename T> inline void setData(const std::byte* data, T& dest)
+{
+    memcpy(static_cast<void*>(&dest), data, sizeof(T));
+}
+
+template <typename T> inline void getData(std::byte* dest, const T& value)
+{
+    memcpy(dest, &value, sizeof(value));
+}
+
+// Convert an additional parameter between its binary format and a Parameter
+template <typename T>
+six::Parameter makeParameter(const std::byte* value)
+{
+    T val;
+    setData(value, val);
+    six::Parameter parameter;
+    parameter.setValue(val);
+    return parameter;
+}
+}
+
+namespace crsd
+{
+void ParameterCodec::addField(size_t offset, size_t size, void* column, size_t stride)
+{
+    auto bytes = static_cast<std::byte*>(column);
+    mFields.push_back({offset, size, bytes, bytes, stride, false});
+}
+
+void ParameterCodec::addField(size_t offset, size_t size, const void* column, size_t stride)
+{
+    mFields.push_back({offset, size, static_cast<const std::byte*>(column),
+                       nullptr, stride, false});
+}
+
+void ParameterCodec::addIntegerField(size_t offset, int64_t* column, size_t stride)
+{
+    auto bytes = reinterpret_cast<std::byte*>(column);
+    mFields.push_back({offset, sizeof(int64_t), bytes, bytes, stride, true});
+}
+
+void ParameterCodec::addIntegerField(size_t offset, const int64_t* column, size_t stride)
+{
+    mFields.push_back({offset, sizeof(int64_t),
+                       reinterpret_cast<const std::byte*>(column),
+                       nullptr, stride, true});
+}
+
+void ParameterCodec::decode(const std::byte* input, size_t stride, size_t numSets) const
+{
+    for (const auto& field : mFields)
+    {
+        if (field.destination == nullptr)
+        {
+            throw except::Exception(Ctxt("Cannot decode into a read-only column"));
+        }
+    }
+
+    for (size_t first = 0; first < numSets; first += SETS_PER_BLOCK)
+    {
+        const size_t count = std::min(SETS_PER_BLOCK, numSets - first);
+        const std::byte* const sets = input + first * stride;
+        for (const auto& field : mFields)
+        {
+            const std::byte* src = sets + field.offset;
+            std::byte* dest = field.destination + first * field.stride;
+            if (field.isInteger)
+            {
+                for (size_t ii = 0; ii < count; ++ii, src += stride, dest += field.stride)
+                {
+                    double value;
+                    memcpy(&value, src, sizeof(value));
+                    const auto intValue = static_cast<int64_t>(value);
+                    memcpy(dest, &intValue, sizeof(intValue));
+                }
+            }
+            else
+            {
+                copy(field.size, src, stride, dest, field.stride, count);
+            }
+        }
+    }
+}
+
+void ParameterCodec::encode(std::byte* output,
+                            size_t stride,
+                            size_t firstSet,
+                            size_t numSets) const
+{
+    for (size_t first = 0; first < numSets; first += SETS_PER_BLOCK)
+    {
+        const size_t count = std::min(SETS_PER_BLOCK, numSets - first);
+        std::byte* const sets = output + first * stride;
+        for (const auto& field : mFields)
+        {
+            const std::byte* src =
+                    field.source + (firstSet + first) * field.stride;
+            std::byte* dest = sets + field.offset;
+            if (field.isInteger)
+            {
+                for (size_t ii = 0; ii < count; ++ii, src += field.stride, dest += stride)
+                {
+                    int64_t intValue;
+                    memcpy(&intValue, src, sizeof(intValue));
+                    const auto value = static_cast<double>(intValue);
+                    memcpy(dest, &value, sizeof(value));
+                }
+            }
+            else
+            {
+                copy(field.size, src, field.stride, dest, stride, count);
+            }
+        }
+    }
+}
+
+six::Parameter ParameterCodec::toParameter(const std::string& format,
+                                           const std::byte* value,
+                                           size_t size)
+{
+    if (format == "F4")
+    {
+        return makeParameter<float>(value);
+    }
+    else if (format == "F8")
+    {
+        return makeParameter<double>(value);
+    }
+    else if (format == "U1")
+    {
+        return makeParameter<std::uint8_t>(value);
+    }
+    else if (format == "U2")
+    {
+        return makeParameter<std::uint16_t>(value);
+    }
+    else if (format == "U4")
+    {
+        return makeParameter<std::uint32_t>(value);
+    }
+    else if (format == "U8")
+    {
+        return makeParameter<std::int64_t>(value);
+    }
+    else if (format == "I1")
+    {
+        return makeParameter<std::int8_t>(value);
+    }
+    else if (format == "I2")
+    {
+        return makeParameter<std::int16_t>(value);
+    }
+    else if (format == "I4")
+    {
+        return makeParameter<std::int32_t>(value);
+    }
+    else if (format == "I8")
+    {
+        return makeParameter<std::int64_t>(value);
+    }
+    else if (format == "CI2")
+    {
+        return makeParameter<std::complex<std::int8_t> >(value);
+    }
+    else if (format == "CI4")
+    {
+        return makeParameter<std::complex<std::int16_t> >(value);
+    }
+    else if (format == "CI8")
+    {
+        return makeParameter<std::complex<std::int32_t> >(value);
+    }
+    else if (format == "CI16")
+    {
+        return makeParameter<std::complex<std::int64_t> >(value);
+    }
+    else if (format == "CF8")
+    {
+        return makeParameter<std::complex<float> >(value);
+    }
+    else if (format == "CF16")
+    {
+        return makeParameter<std::complex<double> >(value);
+    }
+
+    std::string val;
+    val.assign(reinterpret_cast<const char*>(value), size);
+    six::Parameter parameter;
+    parameter.setValue(val);
+    return parameter;
+}
+
+void ParameterCodec::fromParameter(const six::Parameter& parameter,
+                                   const std::string& format,
+                                   std::byte* dest,
+                                   size_t size)
+{
+    if (format == "F4")
+    {
+        getData(dest, static_cast<float>(parameter));
+    }
+    else if (format == "F8")
+    {
+        getData(dest, static_cast<double>(parameter));
+    }
+    else if (format == "U1")
+    {
+        getData(dest, static_cast<std::uint8_t>(parameter));
+    }
+    else if (format == "U2")
+    {
+        getData(dest, static_cast<std::uint16_t>(parameter));
+    }
+    else if (format == "U4")
+    {
+        getData(dest, static_cast<std::uint32_t>(parameter));
+    }
+    else if (format == "U8")
+    {
+        getData(dest, static_cast<std::int64_t>(parameter));
+    }
+    else if (format == "I1")
+    {
+        getData(dest, static_cast<std::int8_t>(parameter));
+    }
+    else if (format == "I2")
+    {
+        getData(dest, static_cast<std::int16_t>(parameter));
+    }
+    else if (format == "I4")
+    {
+        getData(dest, static_cast<std::int32_t>(parameter));
+    }
+    else if (format == "I8")
+    {
+        getData(dest, static_cast<std::int64_t>(parameter));
+    }
+    else if (format == "CI2")
+    {
+        getData(dest, parameter.getComplex<std::int8_t>());
+    }
+    else if (format == "CI4")
+    {
+        getData(dest, parameter.getComplex<std::int16_t>());
+    }
+    else if (format == "CI8")
+    {
+        getData(dest, parameter.getComplex<std::int32_t>());
+    }
+    else if (format == "CI16")
+    {
+        getData(dest, parameter.getComplex<std::int64_t>());
+    }
+    else if (format == "CF8")
+    {
+        getData(dest, parameter.getComplex<float>());
+    }
+    else if (format == "CF16")
+    {
+        getData(dest, parameter.getComplex<double>());
+    }
+    else
+    {
+        // Strings are padded with zeros to the size of the field
+        const std::string val = parameter.str();
+        const size_t numChars = std::min(val.size(), size);
+        memcpy(dest, val.data(), numChars);
+        std::fill_n(dest + numChars, size - numChars, static_cast<std::byte>(0));
+    }
+}
+}
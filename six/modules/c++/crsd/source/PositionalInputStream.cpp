@@ -0,0 +1,836 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <crsd/PositionalInputStream.h>
+
+#include <string.h>
+
+#include <limits>
+#include <algorithm>
+#include <vector>
+
+#include <except/Exception.h>
+#include <sys/Runnable.h>
+#include <sys/SystemException.h>
+#include <crsd/ThreadPool.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#endif
+
+// io_uring is driven through the raw system calls so there is no
+// dependency on liburing
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define CRSD_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#undef min
+#undef max
+
+namespace
+{
+// Largest span (runs plus the gaps between them) fetched by one read in
+// readStrided()
+const size_t MAX_STRIDED_READ_BYTES = 4 * 1024 * 1024;
+
+// Number of runs that fit in one strided read, at least one
+size_t getRunsPerRead(size_t size, size_t stride)
+{
+    if (size >= MAX_STRIDED_READ_BYTES)
+    {
+        return 1;
+    }
+    return (MAX_STRIDED_READ_BYTES - size) / stride + 1;
+}
+
+void checkStride(size_t size, size_t stride)
+{
+    if (stride < size)
+    {
+        throw except::Exception(Ctxt("Stride must be at least the run size"));
+    }
+}
+
+// Reads requests [start, start + count) one after the other
+class ReadRequestsRunnable final : public sys::Runnable
+{
+public:
+    ReadRequestsRunnable(crsd::PositionalInputStream& inStream,
+                         const crsd::ReadRequest* requests,
+                         size_t count) :
+        mInStream(inStream),
+        mRequests(requests),
+        mCount(count)
+    {
+    }
+
+    void run() override
+    {
+        for (size_t ii = 0; ii < mCount; ++ii)
+        {
+            mInStream.readAt(mRequests[ii].offset,
+                             mRequests[ii].buffer,
+                             mRequests[ii].size);
+        }
+    }
+
+private:
+    crsd::PositionalInputStream& mInStream;
+    const crsd::ReadRequest* const mRequests;
+    const size_t mCount;
+};
+}
+
+namespace crsd
+{
+void PositionalInputStream::readStrided(int64_t offset,
+                                        size_t size,
+                                        size_t stride,
+                                        size_t count,
+                                        void* buffer)
+{
+    checkStride(size, stride);
+    auto bufferPtr = static_cast<std::byte*>(buffer);
+    if (stride == size)
+    {
+        readAt(offset, bufferPtr, size * count);
+        return;
+    }
+
+    const size_t runsPerRead = std::min(getRunsPerRead(size, stride), count);
+    if (runsPerRead <= 1)
+    {
+        for (size_t run = 0; run < count; ++run)
+        {
+            readAt(offset + run * stride, bufferPtr + run * size, size);
+        }
+        return;
+    }
+
+    std::vector<std::byte> bounce((runsPerRead - 1) * stride + size);
+    for (size_t run = 0; run < count; run += runsPerRead)
+    {
+        const size_t numRuns = std::min(runsPerRead, count - run);
+        readAt(offset + run * stride,
+               bounce.data(),
+               (numRuns - 1) * stride + size);
+        for (size_t ii = 0; ii < numRuns; ++ii)
+        {
+            memcpy(bufferPtr + (run + ii) * size,
+                   bounce.data() + ii * stride,
+                   size);
+        }
+    }
+}
+
+void PositionalInputStream::readBatch(std::span<const ReadRequest> requests,
+                                      ThreadPool* /*threadPool*/)
+{
+    for (const auto& request : requests)
+    {
+        readAt(request.offset, request.buffer, request.size);
+    }
+}
+
+#if defined(_WIN32)
+MemoryMap::MemoryMap(sys::File& file, int64_t offset, size_t size)
+{
+    if (size == 0)
+    {
+        throw except::Exception(Ctxt("Cannot map an empty range"));
+    }
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const int64_t granularity = info.dwAllocationGranularity;
+    const int64_t alignedOffset = (offset / granularity) * granularity;
+    const size_t leading = static_cast<size_t>(offset - alignedOffset);
+
+    HANDLE mapping = CreateFileMapping(file.getHandle(), nullptr,
+                                       PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        throw except::Exception(Ctxt("Error creating file mapping"));
+    }
+
+    mMappedSize = size + leading;
+    mBase = MapViewOfFile(mapping,
+                          FILE_MAP_READ,
+                          static_cast<DWORD>(alignedOffset >> 32),
+                          static_cast<DWORD>(alignedOffset & 0xFFFFFFFF),
+                          mMappedSize);
+
+    // The view keeps the mapping object alive
+    CloseHandle(mapping);
+    if (mBase == nullptr)
+    {
+        throw except::Exception(Ctxt("Error mapping view of file"));
+    }
+    mData = static_cast<const std::byte*>(mBase) + leading;
+    mSize = size;
+}
+
+MemoryMap::~MemoryMap()
+{
+    UnmapViewOfFile(mBase);
+}
+#else
+MemoryMap::MemoryMap(sys::File& file, int64_t offset, size_t size)
+{
+    if (size == 0)
+    {
+        throw except::Exception(Ctxt("Cannot map an empty range"));
+    }
+
+    // mmap() requires the file offset to be a multiple of the page size
+    const int64_t pageSize = sysconf(_SC_PAGESIZE);
+    const int64_t alignedOffset = (offset / pageSize) * pageSize;
+    const size_t leading = static_cast<size_t>(offset - alignedOffset);
+
+    mMappedSize = size + leading;
+    mBase = mmap(nullptr, mMappedSize, PROT_READ, MAP_SHARED,
+                 file.getHandle(), static_cast<off_t>(alignedOffset));
+    if (mBase == MAP_FAILED)
+    {
+        mBase = nullptr;
+        throw except::Exception(Ctxt("Error memory mapping file"));
+    }
+    mData = static_cast<const std::byte*>(mBase) + leading;
+    mSize = size;
+}
+
+MemoryMap::~MemoryMap()
+{
+    munmap(mBase, mMappedSize);
+}
+#endif
+
+#if defined(CRSD_HAVE_IO_URING)
+/*
+ * A submission and completion queue pair. Only one batch uses a ring at a
+ * time, so the only other party touching the shared indices is the kernel.
+ */
+struct FilePositionalInputStream::Ring final
+{
+    explicit Ring(unsigned entries)
+    {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        const long fd = syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0)
+        {
+            throw sys::SystemException(Ctxt("Error creating io_uring"));
+        }
+        mFd = static_cast<int>(fd);
+        mEntries = params.sq_entries;
+
+        mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        mCqRingSize = params.cq_off.cqes +
+                params.cq_entries * sizeof(io_uring_cqe);
+        mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        mSqRing = mapRegion(mSqRingSize, IORING_OFF_SQ_RING);
+        mCqRing = mapRegion(mCqRingSize, IORING_OFF_CQ_RING);
+        mSqes = static_cast<io_uring_sqe*>(
+                mapRegion(mSqesSize, IORING_OFF_SQES));
+        if (mSqRing == nullptr || mCqRing == nullptr || mSqes == nullptr)
+        {
+            release();
+            throw except::Exception(Ctxt("Error mapping io_uring queues"));
+        }
+
+        auto sq = static_cast<char*>(mSqRing);
+        mSqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        mSqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        mSqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto cq = static_cast<char*>(mCqRing);
+        mCqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        mCqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        mCqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        mCqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        mIov.resize(mEntries);
+    }
+
+    ~Ring()
+    {
+        release();
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    //! Number of reads that can be queued at once
+    unsigned getDepth() const
+    {
+        return mEntries;
+    }
+
+    // Queue a read into slot 'slot' (less than getDepth()); the slot comes
+    // back as the completion's user data
+    void prepareRead(int fd, unsigned slot, void* buffer, size_t size,
+                     int64_t offset)
+    {
+        mIov[slot].iov_base = buffer;
+        mIov[slot].iov_len = size;
+
+        const unsigned tail = *mSqTail;
+        const unsigned index = tail & mSqMask;
+        io_uring_sqe& sqe = mSqes[index];
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = fd;
+        sqe.off = static_cast<uint64_t>(offset);
+        sqe.addr = reinterpret_cast<uint64_t>(&mIov[slot]);
+        sqe.len = 1;
+        sqe.user_data = slot;
+        mSqArray[index] = index;
+
+        // The entry must be visible before the kernel sees the new tail
+        __atomic_store_n(mSqTail, tail + 1, __ATOMIC_RELEASE);
+        ++mToSubmit;
+    }
+
+    // Submit everything queued and wait for at least one completion
+    void submitAndWait()
+    {
+        for (;;)
+        {
+            const long submitted = syscall(__NR_io_uring_enter, mFd,
+                                           mToSubmit, 1,
+                                           IORING_ENTER_GETEVENTS,
+                                           nullptr, 0);
+            if (submitted >= 0)
+            {
+                mToSubmit -= static_cast<unsigned>(submitted);
+                mInFlight += static_cast<unsigned>(submitted);
+                if (mToSubmit == 0)
+                {
+                    return;
+                }
+            }
+            else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            {
+                throw sys::SystemException(Ctxt("Error submitting reads"));
+            }
+        }
+    }
+
+    // Pop the next completion, if any
+    bool popCompletion(unsigned& slot, int& result)
+    {
+        const unsigned head = *mCqHead;
+        if (head == __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE))
+        {
+            return false;
+        }
+        const io_uring_cqe& cqe = mCqes[head & mCqMask];
+        slot = static_cast<unsigned>(cqe.user_data);
+        result = cqe.res;
+        __atomic_store_n(mCqHead, head + 1, __ATOMIC_RELEASE);
+        --mInFlight;
+        return true;
+    }
+
+    // After a failed submitAndWait(), take back the reads the kernel hasn't
+    // seen and wait out the ones it has, so none of them can land in a
+    // buffer once the caller has moved on. Returns false if the wait
+    // itself fails, in which case the ring must not be reused.
+    bool drain()
+    {
+        // Without SQPOLL the kernel only reads the queue in io_uring_enter
+        __atomic_store_n(mSqTail, *mSqTail - mToSubmit, __ATOMIC_RELEASE);
+        mToSubmit = 0;
+
+        while (mInFlight > 0)
+        {
+            unsigned slot = 0;
+            int result = 0;
+            while (popCompletion(slot, result))
+            {
+            }
+            if (mInFlight == 0)
+            {
+                break;
+            }
+            if (syscall(__NR_io_uring_enter, mFd, 0, 1,
+                        IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    void* mapRegion(size_t size, uint64_t offset)
+    {
+        void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, mFd,
+                            static_cast<off_t>(offset));
+        return region == MAP_FAILED ? nullptr : region;
+    }
+
+    void release()
+    {
+        if (mSqes != nullptr)
+        {
+            munmap(mSqes, mSqesSize);
+        }
+        if (mCqRing != nullptr)
+        {
+            munmap(mCqRing, mCqRingSize);
+        }
+        if (mSqRing != nullptr)
+        {
+            munmap(mSqRing, mSqRingSize);
+        }
+        if (mFd >= 0)
+        {
+            ::close(mFd);
+        }
+        mSqes = nullptr;
+        mCqRing = nullptr;
+        mSqRing = nullptr;
+        mFd = -1;
+    }
+
+    int mFd = -1;
+    unsigned mEntries = 0;
+    unsigned mToSubmit = 0;
+    //! Submitted reads whose completions haven't been popped
+    unsigned mInFlight = 0;
+
+    void* mSqRing = nullptr;
+    size_t mSqRingSize = 0;
+    void* mCqRing = nullptr;
+    size_t mCqRingSize = 0;
+    io_uring_sqe* mSqes = nullptr;
+    size_t mSqesSize = 0;
+
+    unsigned* mSqTail = nullptr;
+    unsigned mSqMask = 0;
+    unsigned* mSqArray = nullptr;
+    unsigned* mCqHead = nullptr;
+    unsigned* mCqTail = nullptr;
+    unsigned mCqMask = 0;
+    io_uring_cqe* mCqes = nullptr;
+
+    //! One iovec per slot; must outlive the read it describes
+    std::vector<iovec> mIov;
+};
+#else
+struct FilePositionalInputStream::Ring final
+{
+};
+#endif
+
+FilePositionalInputStream::FilePositionalInputStream(
+        const std::string& pathname) :
+    mFile(pathname)
+{
+}
+
+FilePositionalInputStream::~FilePositionalInputStream()
+{
+}
+
+bool FilePositionalInputStream::isIoUringAvailable()
+{
+#if defined(CRSD_HAVE_IO_URING)
+    static const bool available = []()
+    {
+        try
+        {
+            Ring ring(1);
+            return true;
+        }
+        catch (const except::Exception&)
+        {
+            return false;
+        }
+    }();
+    return available;
+#else
+    return false;
+#endif
+}
+
+void FilePositionalInputStream::readBatchWithThreads(
+        std::span<const ReadRequest> requests, ThreadPool& threadPool)
+{
+    // Several tasks per thread so threads that draw short reads pick up
+    // more of the batch
+    const size_t numTasks =
+            std::min(requests.size(), 4 * threadPool.getNumThreads());
+    const size_t perTask = (requests.size() + numTasks - 1) / numTasks;
+
+    std::vector<std::unique_ptr<sys::Runnable> > tasks;
+    for (size_t start = 0; start < requests.size(); start += perTask)
+    {
+        tasks.emplace_back(new ReadRequestsRunnable(
+                *this,
+                requests.data() + start,
+                std::min(perTask, requests.size() - start)));
+    }
+    threadPool.run(tasks);
+}
+
+void FilePositionalInputStream::readBatch(std::span<const ReadRequest> requests,
+                                          ThreadPool* threadPool)
+{
+    if (requests.size() < 2)
+    {
+        PositionalInputStream::readBatch(requests);
+        return;
+    }
+
+#if defined(CRSD_HAVE_IO_URING)
+    if (!isIoUringAvailable())
+    {
+        readBatchWithThreads(requests, getThreadPool(threadPool));
+        return;
+    }
+
+    std::unique_ptr<Ring> ring;
+    {
+        std::lock_guard<std::mutex> lock(mRingMutex);
+        if (!mRings.empty())
+        {
+            ring = std::move(mRings.back());
+            mRings.pop_back();
+        }
+    }
+    if (ring.get() == nullptr)
+    {
+        try
+        {
+            ring.reset(new Ring(QUEUE_DEPTH));
+        }
+        catch (const except::Exception&)
+        {
+            // e.g. out of locked memory for the queues
+            readBatchWithThreads(requests, getThreadPool(threadPool));
+            return;
+        }
+    }
+
+    // One read can't move more than about 2 GiB
+    static const size_t MAX_READ_SIZE = static_cast<size_t>(1) << 30;
+
+    // Which request each slot is reading, and how far each request has got
+    const unsigned depth = ring->getDepth();
+    std::vector<size_t> slotRequest(depth);
+    std::vector<unsigned> freeSlots(depth);
+    for (unsigned slot = 0; slot < depth; ++slot)
+    {
+        freeSlots[slot] = depth - 1 - slot;
+    }
+    std::vector<size_t> bytesRead(requests.size(), 0);
+
+    const int fd = mFile.getHandle();
+    auto queueRead = [&](size_t index)
+    {
+        const unsigned slot = freeSlots.back();
+        freeSlots.pop_back();
+        slotRequest[slot] = index;
+
+        const ReadRequest& request = requests[index];
+        const size_t done = bytesRead[index];
+        ring->prepareRead(fd,
+                          slot,
+                          static_cast<std::byte*>(request.buffer) + done,
+                          std::min(request.size - done, MAX_READ_SIZE),
+                          request.offset + static_cast<int64_t>(done));
+    };
+
+    // After an error nothing new is queued, but reads already in flight
+    // are still waited for since they write into the caller's buffers
+    int error = 0;
+    bool endOfFile = false;
+    size_t next = 0;
+    while (freeSlots.size() < depth ||
+           (next < requests.size() && error == 0 && !endOfFile))
+    {
+        while (!freeSlots.empty() && next < requests.size() &&
+               error == 0 && !endOfFile)
+        {
+            if (requests[next].size > 0)
+            {
+                queueRead(next);
+            }
+            ++next;
+        }
+        if (freeSlots.size() == depth)
+        {
+            break;
+        }
+
+        try
+        {
+            ring->submitAndWait();
+        }
+        catch (const except::Exception&)
+        {
+            // Reads already in flight still write into the caller's
+            // buffers, so wait for them before letting the error out
+            if (ring->drain())
+            {
+                std::lock_guard<std::mutex> lock(mRingMutex);
+                mRings.push_back(std::move(ring));
+            }
+            throw;
+        }
+
+        unsigned slot = 0;
+        int result = 0;
+        while (ring->popCompletion(slot, result))
+        {
+            const size_t index = slotRequest[slot];
+            freeSlots.push_back(slot);
+
+            if (result == -EINTR || result == -EAGAIN)
+            {
+                result = 0;
+            }
+            else if (result < 0)
+            {
+                error = -result;
+                continue;
+            }
+            else if (result == 0)
+            {
+                endOfFile = true;
+                continue;
+            }
+
+            // Short reads pick up where they left off
+            bytesRead[index] += static_cast<size_t>(result);
+            if (bytesRead[index] < requests[index].size &&
+                error == 0 && !endOfFile)
+            {
+                queueRead(index);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mRingMutex);
+        mRings.push_back(std::move(ring));
+    }
+
+    if (error != 0)
+    {
+        errno = error;
+        throw sys::SystemException(Ctxt("Error reading from file"));
+    }
+    if (endOfFile)
+    {
+        throw sys::SystemException(Ctxt("Unexpected end of file"));
+    }
+#else
+    readBatchWithThreads(requests, getThreadPool(threadPool));
+#endif
+}
+
+#if defined(_WIN32)
+void FilePositionalInputStream::readAt(int64_t offset,
+                                       void* buffer,
+                                       size_t size)
+{
+    static const size_t MAX_READ_SIZE = std::numeric_limits<DWORD>::max();
+    auto bufferPtr = static_cast<sys::byte*>(buffer);
+
+    size_t bytesRead = 0;
+    while (bytesRead < size)
+    {
+        const DWORD bytesToRead = static_cast<DWORD>(
+                std::min(MAX_READ_SIZE, size - bytesRead));
+        const uint64_t position = static_cast<uint64_t>(offset) + bytesRead;
+
+        // An explicit offset in the OVERLAPPED struct makes this a
+        // positional read on a synchronous handle
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+        DWORD bytesThisRead = 0;
+        if (!ReadFile(mFile.getHandle(),
+                      bufferPtr + bytesRead,
+                      bytesToRead,
+                      &bytesThisRead,
+                      &overlapped))
+        {
+            throw sys::SystemException(Ctxt("Error reading from file"));
+        }
+        if (bytesThisRead == 0)
+        {
+            throw sys::SystemException(Ctxt("Unexpected end of file"));
+        }
+        bytesRead += bytesThisRead;
+    }
+}
+
+void FilePositionalInputStream::readStrided(int64_t offset,
+                                            size_t size,
+                                            size_t stride,
+                                            size_t count,
+                                            void* buffer)
+{
+    // There is no vectored positional read for a synchronous handle
+    PositionalInputStream::readStrided(offset, size, stride, count, buffer);
+}
+#else
+void FilePositionalInputStream::readAt(int64_t offset,
+                                       void* buffer,
+                                       size_t size)
+{
+    auto bufferPtr = static_cast<sys::byte*>(buffer);
+
+    size_t bytesRead = 0;
+    while (bytesRead < size)
+    {
+        const ssize_t bytesThisRead =
+                ::pread(mFile.getHandle(),
+                        bufferPtr + bytesRead,
+                        size - bytesRead,
+                        static_cast<off_t>(offset + bytesRead));
+        if (bytesThisRead < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+            {
+                continue;
+            }
+            throw sys::SystemException(Ctxt("Error reading from file"));
+        }
+        if (bytesThisRead == 0)
+        {
+            throw sys::SystemException(Ctxt("Unexpected end of file"));
+        }
+        bytesRead += static_cast<size_t>(bytesThisRead);
+    }
+}
+
+void FilePositionalInputStream::readStrided(int64_t offset,
+                                            size_t size,
+                                            size_t stride,
+                                            size_t count,
+                                            void* buffer)
+{
+    checkStride(size, stride);
+    auto bufferPtr = static_cast<std::byte*>(buffer);
+    if (stride == size || count < 2)
+    {
+        readAt(offset, bufferPtr, size * count);
+        return;
+    }
+
+    // Each run takes one iovec and each gap another. Every gap lands in the
+    // same discard buffer since its contents are never looked at.
+    const size_t gap = stride - size;
+    const size_t runsPerRead = std::min(
+            {getRunsPerRead(size, stride),
+             static_cast<size_t>((IOV_MAX + 1) / 2),
+             count});
+    std::vector<std::byte> discard(gap);
+    std::vector<iovec> iov;
+    iov.reserve(2 * runsPerRead - 1);
+
+    for (size_t run = 0; run < count; run += runsPerRead)
+    {
+        const size_t numRuns = std::min(runsPerRead, count - run);
+        iov.clear();
+        for (size_t ii = 0; ii < numRuns; ++ii)
+        {
+            if (ii > 0)
+            {
+                iov.push_back({discard.data(), gap});
+            }
+            iov.push_back({bufferPtr + (run + ii) * size, size});
+        }
+
+        const int64_t spanOffset = offset + run * stride;
+        const size_t spanSize = (numRuns - 1) * stride + size;
+        ssize_t bytesRead = -1;
+        do
+        {
+            bytesRead = ::preadv(mFile.getHandle(),
+                                 iov.data(),
+                                 static_cast<int>(iov.size()),
+                                 static_cast<off_t>(spanOffset));
+        } while (bytesRead < 0 && (errno == EINTR || errno == EAGAIN));
+
+        if (bytesRead < 0)
+        {
+            throw sys::SystemException(Ctxt("Error reading from file"));
+        }
+        if (static_cast<size_t>(bytesRead) != spanSize)
+        {
+            // Short read; finish this span a run at a time
+            for (size_t ii = 0; ii < numRuns; ++ii)
+            {
+                readAt(spanOffset + ii * stride,
+                       bufferPtr + (run + ii) * size,
+                       size);
+            }
+        }
+    }
+}
+#endif
+
+std::shared_ptr<const MemoryMap> FilePositionalInputStream::map(
+        int64_t offset, size_t size)
+{
+    return std::make_shared<const MemoryMap>(mFile, offset, size);
+}
+
+SeekablePositionalInputStream::SeekablePositionalInputStream(
+        std::shared_ptr<io::SeekableInputStream> inStream) :
+    mInStream(inStream)
+{
+    if (mInStream.get() == nullptr)
+    {
+        throw except::Exception(Ctxt("Input stream must not be null"));
+    }
+}
+
+void SeekablePositionalInputStream::readAt(int64_t offset,
+                                           void* buffer,
+                                           size_t size)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mInStream->seek(offset, io::Seekable::START);
+    mInStream->read(buffer, size, true /*verifyFullRead*/);
+}
+}
@@ -0,0 +1,299 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <crsd/SignalChunkIndex.h>
+
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <sstream>
+
+#include <zlib.h>
+
+#include <std/bit>
+
+#include <str/Convert.h>
+#include <crsd/ByteSwap.h>
+
+namespace
+{
+const char VECTORS_PER_CHUNK[] = "VectorsPerChunk";
+const char CHUNK_OFFSETS[] = "ChunkOffsets";
+
+std::string chunkOffsetsName(size_t channel)
+{
+    return CHUNK_OFFSETS + std::to_string(channel);
+}
+}
+
+namespace crsd
+{
+const char SignalChunkIndex::IDENTIFIER[] = "ZLIB_CHUNKED";
+const char SignalChunkIndex::PROCESSING_TYPE[] = "ChunkIndex";
+
+SignalChunkIndex::SignalChunkIndex(
+        const Data::SignalCompression& signalCompression,
+        size_t numChannels)
+{
+    const Data::Processing* processing = nullptr;
+    for (const auto& entry : signalCompression.processing)
+    {
+        if (entry.type == PROCESSING_TYPE)
+        {
+            processing = &entry;
+        }
+    }
+    if (!isChunked(signalCompression) || processing == nullptr)
+    {
+        throw except::Exception(Ctxt(
+                "Signal compression has no chunk index"));
+    }
+
+    try
+    {
+        vectorsPerChunk = str::toType<size_t>(
+                processing->parameter.findParameter(VECTORS_PER_CHUNK).str());
+        offsets.resize(numChannels);
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            std::istringstream values(processing->parameter.findParameter(
+                    chunkOffsetsName(channel)).str());
+            size_t offset;
+            while (values >> offset)
+            {
+                offsets[channel].push_back(offset);
+            }
+        }
+    }
+    catch (const except::Exception& ex)
+    {
+        throw except::Exception(ex, Ctxt("Invalid signal chunk index"));
+    }
+
+    for (const auto& channelOffsets : offsets)
+    {
+        if (vectorsPerChunk == 0 || channelOffsets.empty() ||
+            !std::is_sorted(channelOffsets.begin(), channelOffsets.end()) ||
+            channelOffsets.back() > signalCompression.compressedSignalSize)
+        {
+            throw except::Exception(Ctxt("Invalid signal chunk index"));
+        }
+    }
+}
+
+bool SignalChunkIndex::isChunked(
+        const Data::SignalCompression& signalCompression)
+{
+    return signalCompression.identifier == IDENTIFIER;
+}
+
+void SignalChunkIndex::update(Data::SignalCompression& signalCompression) const
+{
+    signalCompression.identifier = IDENTIFIER;
+    signalCompression.compressedSignalSize = 0;
+    for (const auto& channelOffsets : offsets)
+    {
+        signalCompression.compressedSignalSize = std::max(
+                signalCompression.compressedSignalSize, channelOffsets.back());
+    }
+
+    auto& processing = signalCompression.processing;
+    processing.erase(std::remove_if(processing.begin(), processing.end(),
+                                    [](const Data::Processing& entry)
+                                    {
+                                        return entry.type == PROCESSING_TYPE;
+                                    }),
+                     processing.end());
+
+    Data::Processing index(PROCESSING_TYPE);
+    six::Parameter parameter(vectorsPerChunk);
+    parameter.setName(VECTORS_PER_CHUNK);
+    index.parameter.push_back(parameter);
+    for (size_t channel = 0; channel < offsets.size(); ++channel)
+    {
+        std::ostringstream values;
+        for (size_t ii = 0; ii < offsets[channel].size(); ++ii)
+        {
+            values << (ii == 0 ? "" : " ") << offsets[channel][ii];
+        }
+        parameter.setValue(values.str());
+        parameter.setName(chunkOffsetsName(channel));
+        index.parameter.push_back(parameter);
+    }
+    processing.push_back(index);
+}
+
+SignalChunkCompressor::SignalChunkCompressor(const Data& data,
+                                             size_t vectorsPerChunk,
+                                             int level,
+                                             ThreadPool* threadPool) :
+    mData(data),
+    mElementSize(data.getNumBytesPerSample()),
+    mVectorsPerChunk(vectorsPerChunk),
+    mLevel(level),
+    mThreadPool(threadPool),
+    mChunks(data.getNumChannels())
+{
+    if (mVectorsPerChunk == 0)
+    {
+        throw except::Exception(Ctxt("Chunks need at least one vector"));
+    }
+}
+
+void SignalChunkCompressor::compressImpl(size_t channel,
+                                         const std::byte* samples,
+                                         size_t numSamples)
+{
+    if (channel >= mChunks.size())
+    {
+        throw except::Exception(Ctxt("Invalid channel"));
+    }
+    const size_t samplesPerVector = mData.getNumSamples(channel);
+    const size_t numVectors = mData.getNumVectors(channel);
+    if (numSamples != samplesPerVector * numVectors)
+    {
+        std::ostringstream ostr;
+        ostr << "Expected " << samplesPerVector * numVectors
+             << " samples for channel " << channel << " but got "
+             << numSamples;
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    const size_t numChunks =
+            (numVectors + mVectorsPerChunk - 1) / mVectorsPerChunk;
+    const size_t bytesPerVector = samplesPerVector * mElementSize;
+    const bool swap = (std::endian::native == std::endian::little) &&
+            mElementSize > 2;
+
+    std::vector<std::vector<std::byte> > chunks(numChunks);
+    const std::function<void(size_t)> compressChunk = [&](size_t chunk)
+    {
+        const size_t firstVector = chunk * mVectorsPerChunk;
+        const size_t size = std::min(mVectorsPerChunk,
+                                     numVectors - firstVector) *
+                bytesPerVector;
+        const std::byte* input = samples + firstVector * bytesPerVector;
+
+        // Chunks hold the samples as they'd be stored uncompressed
+        std::vector<std::byte> swapped;
+        if (swap)
+        {
+            swapped.assign(input, input + size);
+            crsd::byteSwap(swapped.data(), mElementSize / 2,
+                           size / (mElementSize / 2), 1);
+            input = swapped.data();
+        }
+
+        uLongf compressedSize = compressBound(static_cast<uLong>(size));
+        chunks[chunk].resize(compressedSize);
+        const int status = compress2(
+                reinterpret_cast<Bytef*>(chunks[chunk].data()),
+                &compressedSize,
+                reinterpret_cast<const Bytef*>(input),
+                static_cast<uLong>(size),
+                mLevel);
+        if (status != Z_OK)
+        {
+            throw except::Exception(Ctxt(
+                    "zlib failed to compress signal chunk: " +
+                    std::to_string(status)));
+        }
+        chunks[chunk].resize(compressedSize);
+    };
+    processSignalChunks(0, numChunks, compressChunk, mThreadPool);
+
+    mChunks[channel].swap(chunks);
+}
+
+SignalChunkIndex SignalChunkCompressor::getIndex() const
+{
+    SignalChunkIndex index;
+    index.vectorsPerChunk = mVectorsPerChunk;
+    index.offsets.resize(mChunks.size());
+
+    size_t offset = 0;
+    for (size_t channel = 0; channel < mChunks.size(); ++channel)
+    {
+        if (mChunks[channel].empty() && mData.getNumVectors(channel) > 0)
+        {
+            throw except::Exception(Ctxt(
+                    "Channel " + std::to_string(channel) +
+                    " has not been compressed"));
+        }
+        index.offsets[channel].push_back(offset);
+        for (const auto& chunk : mChunks[channel])
+        {
+            offset += chunk.size();
+            index.offsets[channel].push_back(offset);
+        }
+    }
+    return index;
+}
+
+void SignalChunkCompressor::update(Data& data) const
+{
+    if (!data.receiveParameters.get())
+    {
+        throw except::Exception(Ctxt("Metadata has no receive parameters"));
+    }
+    if (!data.receiveParameters->signalCompression.get())
+    {
+        data.receiveParameters->signalCompression.reset(
+                new Data::SignalCompression());
+    }
+    getIndex().update(*data.receiveParameters->signalCompression);
+}
+
+std::vector<std::byte> SignalChunkCompressor::getSignalBlock() const
+{
+    const SignalChunkIndex index = getIndex();
+    std::vector<std::byte> signalBlock;
+    signalBlock.reserve(index.offsets.back().back());
+    for (const auto& channel : mChunks)
+    {
+        for (const auto& chunk : channel)
+        {
+            signalBlock.insert(signalBlock.end(), chunk.begin(), chunk.end());
+        }
+    }
+    return signalBlock;
+}
+
+void decompressSignalChunk(std::span<const std::byte> input,
+                           std::span<std::byte> output)
+{
+    uLongf size = static_cast<uLongf>(output.size());
+    const int status = uncompress(
+            reinterpret_cast<Bytef*>(output.data()),
+            &size,
+            reinterpret_cast<const Bytef*>(input.data()),
+            static_cast<uLong>(input.size()));
+    if (status != Z_OK || size != output.size())
+    {
+        std::ostringstream ostr;
+        ostr << "Signal chunk of " << input.size() << " bytes did not "
+             << "inflate to " << output.size() << " bytes (zlib status "
+             << status << ")";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+}
+}
@@ -29,7 +29,6 @@
 #include <mt/ThreadGroup.h>
 #include <mt/ThreadPlanner.h>
 #include <except/Exception.h>
-#include <io/FileInputStream.h>
 
 #include <six/Init.h>
 
@@ -42,7 +41,7 @@ SupportBlock::SupportBlock(const std::string& pathname,
                            const crsd::Data& data,
                            int64_t startSupport,
                            int64_t sizeSupport) :
-    mInStream(std::make_shared<io::FileInputStream>(pathname)),
+    mInStream(std::make_shared<FilePositionalInputStream>(pathname)),
     mData(data),
     mSupportOffset(startSupport),
     mSupportSize(sizeSupport)
@@ -54,7 +53,7 @@ SupportBlock::SupportBlock(std::shared_ptr<io::SeekableInputStream> inStream,
                            const crsd::Data& data,
                            int64_t startSupport,
                            int64_t sizeSupport) :
-    mInStream(inStream),
+    mInStream(std::make_shared<SeekablePositionalInputStream>(inStream)),
     mData(data),
     mSupportOffset(startSupport),
     mSupportSize(sizeSupport)
@@ -68,6 +67,16 @@ SupportBlock::SupportBlock(std::shared_ptr<io::SeekableInputStream> inStream,
 {
     initialize();
 }
+SupportBlock::SupportBlock(std::shared_ptr<PositionalInputStream> inStream,
+                           const crsd::Data& data,
+                           const crsd::FileHeader& fileHeader) :
+    mInStream(inStream),
+    mData(data),
+    mSupportOffset(fileHeader.getSupportBlockByteOffset()),
+    mSupportSize(fileHeader.getSupportBlockSize())
+{
+    initialize();
+}
 
 void SupportBlock::initialize()
 {
@@ -105,9 +114,8 @@ void SupportBlock::read(const std::string& id,
     // First to the start of the first support array we're going to read
     int64_t inOffset = getFileOffset(id);
     auto dataPtr = data.data;
-    mInStream->seek(inOffset, io::FileInputStream::START);
     size_t size = mData.getSupportArrayById(id).getSize();
-    mInStream->read(dataPtr, size);
+    mInStream->readAt(inOffset, dataPtr, size);
 
     if ((std::endian::native == std::endian::little) && mData.getElementSize(id) > 1)
     {
@@ -138,6 +146,39 @@ void SupportBlock::read(const std::string& id,
     read(id, numThreads, mem::BufferView<sys::ubyte>(data.get(), bufSize));
 }
 
+std::shared_ptr<const std::vector<std::byte> > SupportBlock::readNative(
+        const std::string& id,
+        size_t componentSize,
+        size_t numThreads) const
+{
+    std::lock_guard<std::mutex> lock(mDecodedMutex);
+    auto& decoded = mDecoded[std::make_pair(id, componentSize)];
+    if (decoded.get() != nullptr)
+    {
+        return decoded;
+    }
+
+    const Data::SupportArray array = mData.getSupportArrayById(id);
+    if (componentSize == 0 || array.bytesPerElement % componentSize != 0)
+    {
+        std::ostringstream ostr;
+        ostr << "Support array " << id << " has " << array.bytesPerElement
+             << " byte elements, which can't be split into "
+             << componentSize << " byte components";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    auto values = std::make_shared<std::vector<std::byte> >(array.getSize());
+    mInStream->readAt(getFileOffset(id), values->data(), values->size());
+    if ((std::endian::native == std::endian::little) && componentSize > 1)
+    {
+        crsd::byteSwap(values->data(), componentSize,
+                       values->size() / componentSize, numThreads);
+    }
+    decoded = values;
+    return decoded;
+}
+
 std::ostream& operator<< (std::ostream& os, const SupportBlock& d)
 {
     os << "SupportBlock::\n"
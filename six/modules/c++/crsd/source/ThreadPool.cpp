@@ -0,0 +1,175 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <crsd/ThreadPool.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace crsd
+{
+struct ThreadPool::Batch
+{
+    explicit Batch(const std::vector<std::unique_ptr<sys::Runnable> >& tasks_) :
+        tasks(tasks_),
+        remaining(tasks_.size())
+    {
+    }
+
+    const std::vector<std::unique_ptr<sys::Runnable> >& tasks;
+
+    // All guarded by ThreadPool::mMutex
+    size_t next = 0;
+    size_t remaining;
+    std::exception_ptr error;
+    std::condition_variable done;
+};
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+    if (numThreads == 0)
+    {
+        numThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    // The thread calling run() is the last one
+    mWorkers.reserve(numThreads - 1);
+    for (size_t ii = 1; ii < numThreads; ++ii)
+    {
+        mWorkers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWorkAvailable.notify_all();
+
+    for (auto& worker : mWorkers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(const std::vector<std::unique_ptr<sys::Runnable> >& tasks)
+{
+    if (tasks.empty())
+    {
+        return;
+    }
+
+    Batch batch(tasks);
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (tasks.size() > 1 && !mWorkers.empty())
+    {
+        mBatches.push_back(&batch);
+        mWorkAvailable.notify_all();
+    }
+
+    // Help out until every task has been claimed
+    while (batch.next < tasks.size())
+    {
+        const size_t index = batch.next++;
+        if (batch.next == tasks.size())
+        {
+            const auto iter =
+                    std::find(mBatches.begin(), mBatches.end(), &batch);
+            if (iter != mBatches.end())
+            {
+                mBatches.erase(iter);
+            }
+        }
+        lock.unlock();
+        execute(batch, index);
+        lock.lock();
+    }
+
+    // Then wait on any still running on the workers
+    while (batch.remaining > 0)
+    {
+        batch.done.wait(lock);
+    }
+
+    if (batch.error)
+    {
+        std::rethrow_exception(batch.error);
+    }
+}
+
+std::shared_ptr<ThreadPool> ThreadPool::getDefault()
+{
+    static const std::shared_ptr<ThreadPool> pool =
+            std::make_shared<ThreadPool>(0);
+    return pool;
+}
+
+void ThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        while (!mStop && mBatches.empty())
+        {
+            mWorkAvailable.wait(lock);
+        }
+        if (mBatches.empty())
+        {
+            return;
+        }
+
+        Batch& batch = *mBatches.front();
+        const size_t index = batch.next++;
+        if (batch.next == batch.tasks.size())
+        {
+            mBatches.pop_front();
+        }
+        lock.unlock();
+        execute(batch, index);
+        lock.lock();
+    }
+}
+
+void ThreadPool::execute(Batch& batch, size_t index)
+{
+    std::exception_ptr error;
+    try
+    {
+        batch.tasks[index]->run();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (error && !batch.error)
+    {
+        batch.error = error;
+    }
+    if (--batch.remaining == 0)
+    {
+        batch.done.notify_all();
+    }
+}
+}
@@ -20,6 +20,10 @@
  *
  */
 
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <limits>
 #include <sstream>
 #include <thread>
@@ -29,225 +33,140 @@
 #include <nitf/coda-oss.hpp>
 #include <except/Exception.h>
 #include <io/FileInputStream.h>
-#include <mt/ThreadGroup.h>
-#include <mt/ThreadPlanner.h>
 
 #include <six/Init.h>
 #include <crsd/ByteSwap.h>
 #include <crsd/Wideband.h>
 #include <crsd/FileHeader.h>
+#include <crsd/SignalChunkIndex.h>
 
 #undef min
 #undef max
 
 namespace
 {
-template <typename InT>
-class PromoteRunnable : public sys::Runnable
+// Whole vectors of one channel that are read and converted together
+struct ChannelTile
+{
+    size_t index;  // into the list of channels being read
+    size_t firstVector;
+    size_t numVectors;
+};
+
+// Claims tiles one at a time until none are left, so that threads reading
+// small tiles, or getting faster I/O, pick up the remaining work
+class TileReader final : public sys::Runnable
 {
 public:
-    PromoteRunnable(const std::complex<InT>* input,
-                    size_t startRow,
-                    size_t numRows,
-                    size_t numCols,
-                    std::complex<float>* output) :
-        mInput(input + startRow * numCols),
-        mDims(numRows, numCols),
-        mOutput(output + startRow * numCols)
+    TileReader(const std::function<void(const ChannelTile&,
+                                        std::vector<std::byte>&)>& readTile,
+               const std::vector<ChannelTile>& tiles,
+               std::atomic<size_t>& nextTile) :
+        mReadTile(readTile),
+        mTiles(tiles),
+        mNextTile(nextTile)
     {
     }
 
-    virtual void run()
+    void run() override
     {
-        for (size_t row = 0, idx = 0; row < mDims.row; ++row)
+        for (size_t tile = mNextTile++; tile < mTiles.size();
+             tile = mNextTile++)
         {
-            for (size_t col = 0; col < mDims.col; ++col, ++idx)
-            {
-                const std::complex<InT>& input(mInput[idx]);
-                mOutput[idx] = std::complex<float>(input.real(), input.imag());
-            }
+            mReadTile(mTiles[tile], mScratch);
         }
     }
 
 private:
-    const std::complex<InT>* const mInput;
-    const types::RowCol<size_t> mDims;
-    std::complex<float>* const mOutput;
+    const std::function<void(const ChannelTile&,
+                             std::vector<std::byte>&)>& mReadTile;
+    const std::vector<ChannelTile>& mTiles;
+    std::atomic<size_t>& mNextTile;
+    std::vector<std::byte> mScratch;  // reused across this thread's tiles
 };
 
-template <typename InT>
-class ScaleRunnable : public sys::Runnable
+// Reads larger than this are split into pieces of this size submitted
+// together, so the device sees a deep queue rather than one long request
+const size_t BATCH_PIECE_BYTES = 4 * 1024 * 1024;
+
+void readContiguous(crsd::PositionalInputStream& inStream,
+                    int64_t offset,
+                    std::byte* data,
+                    size_t size,
+                    crsd::ThreadPool* threadPool)
 {
-public:
-    ScaleRunnable(const std::complex<InT>* input,
-                  size_t startRow,
-                  size_t numRows,
-                  size_t numCols,
-                  const double* scaleFactors,
-                  std::complex<float>* output) :
-        mInput(input + startRow * numCols),
-        mDims(numRows, numCols),
-        mScaleFactors(scaleFactors + startRow),
-        mOutput(output + startRow * numCols)
+    if (size <= BATCH_PIECE_BYTES)
     {
+        inStream.readAt(offset, data, size);
+        return;
     }
 
-    virtual void run()
+    std::vector<crsd::ReadRequest> requests(
+            (size + BATCH_PIECE_BYTES - 1) / BATCH_PIECE_BYTES);
+    for (size_t ii = 0; ii < requests.size(); ++ii)
     {
-        for (size_t row = 0, idx = 0; row < mDims.row; ++row)
-        {
-            const double scaleFactor(mScaleFactors[row]);
-            for (size_t col = 0; col < mDims.col; ++col, ++idx)
-            {
-                const std::complex<InT>& input(mInput[idx]);
-                mOutput[idx] = std::complex<float>(static_cast<float>(input.real() * scaleFactor),
-                                                   static_cast<float>(input.imag() * scaleFactor));
-            }
-        }
+        const size_t start = ii * BATCH_PIECE_BYTES;
+        requests[ii].offset = offset + static_cast<int64_t>(start);
+        requests[ii].buffer = data + start;
+        requests[ii].size = std::min(BATCH_PIECE_BYTES, size - start);
     }
+    inStream.readBatch(std::span<const crsd::ReadRequest>(requests.data(),
+                                                          requests.size()),
+                       threadPool);
+}
 
-private:
-    const std::complex<InT>* const mInput;
-    const types::RowCol<size_t> mDims;
-    const double* const mScaleFactors;
-    std::complex<float>* const mOutput;
-};
-
-template <typename InT>
-void promote(const void* input,
-             const types::RowCol<size_t>& dims,
-             size_t numThreads,
-             std::complex<float>* output)
+// Processes one signal chunk; the pool hands chunks to threads as they
+// free up
+class ChunkRunnable final : public sys::Runnable
 {
-    if (numThreads <= 1)
+public:
+    ChunkRunnable(const std::function<void(size_t)>& process, size_t chunk) :
+        mProcess(process),
+        mChunk(chunk)
     {
-        PromoteRunnable<InT>(static_cast<const std::complex<InT>*>(input),
-                             0,
-                             dims.row,
-                             dims.col,
-                             output)
-                .run();
     }
-    else
-    {
-        mt::ThreadGroup threads;
-        const mt::ThreadPlanner planner(dims.row, numThreads);
-
-        size_t threadNum(0);
-        size_t startRow(0);
-        size_t numRowsThisThread(0);
-        while (planner.getThreadInfo(threadNum++, startRow, numRowsThisThread))
-        {
-           auto scaler = std::make_unique<PromoteRunnable<InT>>(
-                    static_cast<const std::complex<InT>*>(input),
-                    startRow,
-                    numRowsThisThread,
-                    dims.col,
-                    output);
-            threads.createThread(std::move(scaler));
-        }
 
-        threads.joinAll();
+    void run() override
+    {
+        mProcess(mChunk);
     }
-}
 
-void promote(const void* input,
-             size_t elementSize,
-             const types::RowCol<size_t>& dims,
-             size_t numThreads,
-             std::complex<float>* output)
-{
-    switch (elementSize)
-    {
-    case 2:
-        promote<int8_t>(input, dims, numThreads, output);
-        break;
-    case 4:
-        promote<int16_t>(input, dims, numThreads, output);
-        break;
-    case 8:
-        promote<float>(input, dims, numThreads, output);
-        break;
-    default:
-        throw except::Exception(
-                Ctxt("Unexpected element size " + std::to_string(elementSize)));
-    }
+private:
+    const std::function<void(size_t)>& mProcess;
+    const size_t mChunk;
+};
 }
-template <typename InT>
-void scale(const void* input,
-           const types::RowCol<size_t>& dims,
-           const double* scaleFactors,
-           size_t numThreads,
-           std::complex<float>* output)
-{
-    if (numThreads <= 1)
-    {
-        ScaleRunnable<InT>(static_cast<const std::complex<InT>*>(input),
-                           0,
-                           dims.row,
-                           dims.col,
-                           scaleFactors,
-                           output)
-                .run();
-    }
-    else
-    {
-        mt::ThreadGroup threads;
-        const mt::ThreadPlanner planner(dims.row, numThreads);
 
-        size_t threadNum(0);
-        size_t startRow(0);
-        size_t numRowsThisThread(0);
-        while (planner.getThreadInfo(threadNum++, startRow, numRowsThisThread))
-        {
-           auto scaler = std::make_unique<ScaleRunnable<InT>>(
-                    static_cast<const std::complex<InT>*>(input),
-                    startRow,
-                    numRowsThisThread,
-                    dims.col,
-                    scaleFactors,
-                    output);
-            threads.createThread(std::move(scaler));
-        }
+namespace crsd
+{
+const size_t Wideband::ALL = std::numeric_limits<size_t>::max();
+const size_t Wideband::READ_TILE_BYTES = 4 * 1024 * 1024;
+const size_t Wideband::DEFAULT_MAX_READ_GAP = 16 * 1024;
 
-        threads.joinAll();
+void processSignalChunks(size_t firstChunk,
+                         size_t numChunks,
+                         const std::function<void(size_t)>& process,
+                         ThreadPool* threadPool)
+{
+    if (numChunks == 1)
+    {
+        process(firstChunk);
+        return;
     }
-}
 
-void scale(const void* input,
-           size_t elementSize,
-           const types::RowCol<size_t>& dims,
-           const double* scaleFactors,
-           size_t numThreads,
-           std::complex<float>* output)
-{
-    switch (elementSize)
-    {
-    case 2:
-        scale<int8_t>(input, dims, scaleFactors, numThreads, output);
-        break;
-    case 4:
-        scale<int16_t>(input, dims, scaleFactors, numThreads, output);
-        break;
-    case 8:
-        scale<float>(input, dims, scaleFactors, numThreads, output);
-        break;
-    default:
-        throw except::Exception(
-                Ctxt("Unexpected element size " + std::to_string(elementSize)));
+    std::vector<std::unique_ptr<sys::Runnable> > tasks;
+    for (size_t chunk = firstChunk; chunk < firstChunk + numChunks; ++chunk)
+    {
+        tasks.push_back(std::make_unique<ChunkRunnable>(process, chunk));
     }
+    getThreadPool(threadPool).run(tasks);
 }
-}
-
-namespace crsd
-{
-const size_t Wideband::ALL = std::numeric_limits<size_t>::max();
 
 Wideband::Wideband(const std::string& pathname,
                    const crsd::MetadataBase& metadata,
                    int64_t startWB,
                    int64_t sizeWB) :
-    mInStream(std::make_shared<io::FileInputStream>(pathname)),
+    mInStream(std::make_shared<FilePositionalInputStream>(pathname)),
     mMetadata(metadata),
     mWBOffset(startWB),
     mWBSize(sizeWB),
@@ -261,6 +180,20 @@ Wideband::Wideband(std::shared_ptr<io::SeekableInputStream> inStream,
                    const crsd::MetadataBase& metadata,
                    int64_t startWB,
                    int64_t sizeWB) :
+    mInStream(std::make_shared<SeekablePositionalInputStream>(inStream)),
+    mMetadata(metadata),
+    mWBOffset(startWB),
+    mWBSize(sizeWB),
+    mElementSize(mMetadata.getNumBytesPerSample()),
+    mOffsets(mMetadata.getNumChannels())
+{
+    initialize();
+}
+
+Wideband::Wideband(std::shared_ptr<PositionalInputStream> inStream,
+                   const crsd::MetadataBase& metadata,
+                   int64_t startWB,
+                   int64_t sizeWB) :
     mInStream(inStream),
     mMetadata(metadata),
     mWBOffset(startWB),
@@ -274,7 +207,17 @@ Wideband::Wideband(std::shared_ptr<io::SeekableInputStream> inStream,
 void Wideband::initialize()
 {
     mOffsets[0] = mWBOffset;
-    if (!mMetadata.isCompressed())
+    mChunkIndex = mMetadata.getSignalChunkIndex();
+    if (mChunkIndex.get())
+    {
+        // Chunked compression: channels start wherever their first chunk is
+        for (size_t ii = 0; ii < mMetadata.getNumChannels(); ++ii)
+        {
+            mOffsets[ii] = mWBOffset +
+                    static_cast<int64_t>(mChunkIndex->offsets[ii].front());
+        }
+    }
+    else if (!mMetadata.isCompressed())
     {
         // No Signal Array Compression
         for (size_t ii = 1; ii < mMetadata.getNumChannels(); ++ii)
@@ -377,7 +320,7 @@ void Wideband::checkReadInputs(size_t channel,
     dims.row = lastVector - firstVector + 1;
     dims.col = lastSample - firstSample + 1;
 
-    if (isPartialRead(channel, dims) && mMetadata.isCompressed())
+    if (isPartialRead(channel, dims) && isOpaque())
     {
         throw except::Exception(
                 Ctxt("Cannot do partial read of compressed channel"));
@@ -410,6 +353,13 @@ void Wideband::readImpl(size_t channel,
     checkReadInputs(
             channel, firstVector, lastVector, firstSample, lastSample, dims);
 
+    if (mChunkIndex.get())
+    {
+        readChunks(channel, firstVector, lastVector, firstSample, dims.col,
+                   static_cast<std::byte*>(data));
+        return;
+    }
+
     // Compute the byte offset into this channel's wideband in the CRSD file
     // First to the start of the first pulse we're going to read
     int64_t inOffset = getFileOffset(channel, firstVector, firstSample);
@@ -417,37 +367,139 @@ void Wideband::readImpl(size_t channel,
     auto dataPtr = static_cast<std::byte*>(data);
     if (dims.col == mMetadata.getNumSamples(channel))
     {
-        // Life is easy - can do a single seek and read
-        mInStream->seek(inOffset, io::FileInputStream::START);
-        mInStream->read(dataPtr, dims.row * dims.col * mElementSize);
+        // Life is easy - can do a single read
+        readContiguous(*mInStream,
+                       inOffset,
+                       dataPtr,
+                       dims.row * dims.col * mElementSize,
+                       mThreadPool.get());
     }
     else
     {
-        // We're stuck reading a row at a time since we're only reading some
-        // of the columns
+        // We're only reading some of the columns
         const size_t bytesPerVectorAOI = dims.col * mElementSize;
         const size_t bytesPerVectorFile =
                 mMetadata.getNumSamples(channel) * mElementSize;
 
+        if (bytesPerVectorFile - bytesPerVectorAOI <= mMaxReadGap)
+        {
+            // The rows are close together; reading through the gaps
+            // costs less than a read per row
+            mInStream->readStrided(inOffset,
+                                   bytesPerVectorAOI,
+                                   bytesPerVectorFile,
+                                   dims.row,
+                                   dataPtr);
+            return;
+        }
+
+        std::vector<ReadRequest> requests(dims.row);
         for (size_t row = 0; row < dims.row; ++row)
         {
-            mInStream->seek(inOffset, io::FileInputStream::START);
-            mInStream->read(dataPtr, bytesPerVectorAOI);
+            requests[row].offset = inOffset;
+            requests[row].buffer = dataPtr;
+            requests[row].size = bytesPerVectorAOI;
             dataPtr += bytesPerVectorAOI;
             inOffset += bytesPerVectorFile;
         }
+        mInStream->readBatch(std::span<const ReadRequest>(requests.data(),
+                                                          requests.size()),
+                             mThreadPool.get());
     }
 }
 
 void Wideband::readImpl(size_t channel, void* data) const
 {
+    if (mChunkIndex.get())
+    {
+        readImpl(channel, 0, ALL, 0, ALL, data);
+        return;
+    }
+
     // Compute the byte offset into this channel's wideband in the CRSD file
     // First to the start of the first pulse we're going to read
     int64_t inOffset = getFileOffset(channel);
 
-    auto dataPtr = static_cast<std::byte*>(data);
-    mInStream->seek(inOffset, io::FileInputStream::START);
-    mInStream->read(dataPtr, getBytesRequiredForRead(channel));
+    readContiguous(*mInStream,
+                   inOffset,
+                   static_cast<std::byte*>(data),
+                   getBytesRequiredForRead(channel),
+                   mThreadPool.get());
+}
+
+void Wideband::readChunks(size_t channel,
+                          size_t firstVector,
+                          size_t lastVector,
+                          size_t firstSample,
+                          size_t numSamples,
+                          std::byte* data) const
+{
+    const size_t vectorsPerChunk = mChunkIndex->vectorsPerChunk;
+    const std::vector<size_t>& offsets = mChunkIndex->offsets[channel];
+    const size_t firstChunk = firstVector / vectorsPerChunk;
+    const size_t lastChunk = lastVector / vectorsPerChunk;
+    if (lastChunk >= mChunkIndex->getNumChunks(channel))
+    {
+        throw except::Exception(Ctxt(
+                "Signal chunk index doesn't cover channel " +
+                std::to_string(channel)));
+    }
+
+    const size_t numVectors = mMetadata.getNumVectors(channel);
+    const size_t bytesPerVectorFile =
+            mMetadata.getNumSamples(channel) * mElementSize;
+    const size_t bytesPerVectorAOI = numSamples * mElementSize;
+    const bool wholeVectors = bytesPerVectorAOI == bytesPerVectorFile;
+
+    const std::function<void(size_t)> readChunk = [&](size_t chunk)
+    {
+        const size_t chunkFirstVector = chunk * vectorsPerChunk;
+        const size_t chunkLastVector = std::min(
+                chunkFirstVector + vectorsPerChunk, numVectors) - 1;
+        const size_t chunkBytes =
+                (chunkLastVector - chunkFirstVector + 1) * bytesPerVectorFile;
+
+        std::vector<std::byte> compressed(offsets[chunk + 1] - offsets[chunk]);
+        if (!compressed.empty())
+        {
+            mInStream->readAt(mWBOffset + static_cast<int64_t>(offsets[chunk]),
+                              compressed.data(),
+                              compressed.size());
+        }
+        const std::span<const std::byte> input(
+                compressed.empty() ? nullptr : compressed.data(),
+                compressed.size());
+
+        // Chunks that are wanted in full inflate straight into the output
+        if (wholeVectors && chunkFirstVector >= firstVector &&
+            chunkLastVector <= lastVector)
+        {
+            decompressSignalChunk(
+                    input,
+                    std::span<std::byte>(
+                            data + (chunkFirstVector - firstVector) *
+                                    bytesPerVectorAOI,
+                            chunkBytes));
+            return;
+        }
+
+        std::vector<std::byte> vectors(chunkBytes);
+        decompressSignalChunk(
+                input, std::span<std::byte>(vectors.data(), vectors.size()));
+        const size_t begin = std::max(firstVector, chunkFirstVector);
+        const size_t end = std::min(lastVector, chunkLastVector);
+        for (size_t vector = begin; vector <= end; ++vector)
+        {
+            memcpy(data + (vector - firstVector) * bytesPerVectorAOI,
+                   vectors.data() + (vector - chunkFirstVector) *
+                           bytesPerVectorFile +
+                           firstSample * mElementSize,
+                   bytesPerVectorAOI);
+        }
+    };
+
+    processSignalChunks(firstChunk, lastChunk - firstChunk + 1, readChunk,
+                        mThreadPool.get());
 }
 
 void Wideband::read(size_t channel,
@@ -485,13 +537,17 @@ void Wideband::read(size_t channel,
     // Element size is half mElementSize because it's complex
     if (shouldByteSwap())
     {
-        crsd::byteSwap(data.data, mElementSize / 2, numPixels * 2, numThreads);
+        crsd::byteSwap(data.data,
+                       mElementSize / 2,
+                       numPixels * 2,
+                       numThreads,
+                       mThreadPool.get());
     }
 }
 
 size_t Wideband::getBytesRequiredForRead(size_t channel) const
 {
-    if (mMetadata.isCompressed())
+    if (isOpaque())
     {
         return mMetadata.getCompressedSignalSize(channel);
     }
@@ -536,17 +592,238 @@ void Wideband::read(size_t channel,
     {
         // TODO: Would be nice to have a way to test this without
         // logging onto Solaris...
-        const size_t numPixels = getBufferDims(0, 0, ALL, 0, ALL).area();
+        const size_t numPixels = getBufferDims(channel, 0, ALL, 0, ALL).area();
         crsd::byteSwap(data.data,
                        mElementSize / 2,
                        numPixels * 2,
-                       std::thread::hardware_concurrency());
+                       std::thread::hardware_concurrency(),
+                       mThreadPool.get());
+    }
+}
+
+void Wideband::readChannels(std::span<const size_t> channels,
+                            size_t numThreads,
+                            std::span<const std::span<std::byte> > data) const
+{
+    if (data.size() != channels.size())
+    {
+        std::ostringstream ostr;
+        ostr << "Expected " << channels.size() << " buffers but got "
+             << data.size();
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    std::vector<void*> buffers(channels.size());
+    for (size_t ii = 0; ii < channels.size(); ++ii)
+    {
+        checkChannelInput(channels[ii]);
+        const size_t minSize = getBytesRequiredForRead(channels[ii]);
+        if (data[ii].size() < minSize)
+        {
+            std::ostringstream ostr;
+            ostr << "Need at least " << minSize << " bytes for channel "
+                 << channels[ii] << " but only got " << data[ii].size();
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+        buffers[ii] = data[ii].data();
+    }
+
+    readChannelTiles(channels, numThreads, buffers, false);
+}
+
+void Wideband::readChannels(
+        std::span<const size_t> channels,
+        size_t numThreads,
+        std::span<const std::span<std::complex<float> > > data) const
+{
+    if (isOpaque())
+    {
+        throw except::Exception(
+                Ctxt("Cannot promote compressed signal arrays"));
+    }
+    if (data.size() != channels.size())
+    {
+        std::ostringstream ostr;
+        ostr << "Expected " << channels.size() << " buffers but got "
+             << data.size();
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    std::vector<void*> buffers(channels.size());
+    for (size_t ii = 0; ii < channels.size(); ++ii)
+    {
+        checkChannelInput(channels[ii]);
+        const size_t numPixels = mMetadata.getNumVectors(channels[ii]) *
+                mMetadata.getNumSamples(channels[ii]);
+        if (data[ii].size() < numPixels)
+        {
+            std::ostringstream ostr;
+            ostr << "Need at least " << numPixels << " pixels for channel "
+                 << channels[ii] << " but only got " << data[ii].size();
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+        buffers[ii] = data[ii].data();
+    }
+
+    readChannelTiles(channels, numThreads, buffers, true);
+}
+
+void Wideband::readChannelTiles(std::span<const size_t> channels,
+                                size_t numThreads,
+                                const std::vector<void*>& data,
+                                bool promote) const
+{
+    // Opaque compressed channels can only be read as a whole, and tiles of
+    // chunked ones line up with the chunks
+    std::vector<ChannelTile> tiles;
+    for (size_t ii = 0; ii < channels.size(); ++ii)
+    {
+        const size_t numVectors = mMetadata.getNumVectors(channels[ii]);
+        const size_t bytesPerVector =
+                mMetadata.getNumSamples(channels[ii]) * mElementSize;
+        size_t vectorsPerTile = std::max<size_t>(
+                1, READ_TILE_BYTES / bytesPerVector);
+        if (mChunkIndex.get())
+        {
+            const size_t vectorsPerChunk = mChunkIndex->vectorsPerChunk;
+            vectorsPerTile = std::max<size_t>(
+                    1, vectorsPerTile / vectorsPerChunk) * vectorsPerChunk;
+        }
+        else if (mMetadata.isCompressed())
+        {
+            vectorsPerTile = numVectors;
+        }
+        for (size_t vector = 0; vector < numVectors; vector += vectorsPerTile)
+        {
+            ChannelTile tile;
+            tile.index = ii;
+            tile.firstVector = vector;
+            tile.numVectors = std::min(vectorsPerTile, numVectors - vector);
+            tiles.push_back(tile);
+        }
     }
+    if (tiles.empty())
+    {
+        return;
+    }
+
+    const bool swap = (std::endian::native == std::endian::little) &&
+            mElementSize > 2;
+    const std::function<void(const ChannelTile&, std::vector<std::byte>&)>
+            readTile = [&](const ChannelTile& tile,
+                           std::vector<std::byte>& scratch)
+    {
+        const size_t channel = channels[tile.index];
+        if (isOpaque())
+        {
+            readImpl(channel, data[tile.index]);
+            return;
+        }
+
+        const types::RowCol<size_t> dims(tile.numVectors,
+                                         mMetadata.getNumSamples(channel));
+        const size_t numBytes = dims.area() * mElementSize;
+        const size_t lastVector = tile.firstVector + tile.numVectors - 1;
+        const size_t firstPixel = tile.firstVector * dims.col;
+
+        // Samples that are already complex<float> are swapped in place
+        if (!promote || mElementSize == 8)
+        {
+            std::byte* out = static_cast<std::byte*>(data[tile.index]) +
+                    firstPixel * mElementSize;
+            readImpl(channel, tile.firstVector, lastVector, 0, ALL, out);
+            if (swap)
+            {
+                crsd::byteSwap(out, mElementSize / 2, dims.area() * 2, 1);
+            }
+            return;
+        }
+
+        scratch.resize(numBytes);
+        readImpl(channel, tile.firstVector, lastVector, 0, ALL,
+                 scratch.data());
+        std::complex<float>* out =
+                static_cast<std::complex<float>*>(data[tile.index]) +
+                firstPixel;
+        if (swap)
+        {
+            crsd::byteSwapAndPromote(scratch.data(), mElementSize, dims, 1, out);
+        }
+        else
+        {
+            crsd::promote(scratch.data(), mElementSize, dims, 1, out);
+        }
+    };
+
+    ThreadPool& threadPool = crsd::getThreadPool(mThreadPool.get());
+    if (numThreads == 0)
+    {
+        numThreads = threadPool.getNumThreads();
+    }
+
+    std::atomic<size_t> nextTile(0);
+    std::vector<std::unique_ptr<sys::Runnable> > tasks;
+    const size_t numTasks = std::min(numThreads, tiles.size());
+    for (size_t ii = 0; ii < numTasks; ++ii)
+    {
+        tasks.push_back(std::make_unique<TileReader>(readTile, tiles, nextTile));
+    }
+
+    if (tasks.size() == 1)
+    {
+        tasks[0]->run();
+    }
+    else
+    {
+        threadPool.run(tasks);
+    }
+}
+
+const std::byte* Wideband::mapVectors(size_t channel,
+                                      size_t firstVector,
+                                      size_t lastVector,
+                                      size_t elementSize,
+                                      types::RowCol<size_t>& dims) const
+{
+    if (mMetadata.isCompressed())
+    {
+        throw except::Exception(
+                Ctxt("Cannot memory map compressed signal arrays"));
+    }
+    if (elementSize != mElementSize)
+    {
+        std::ostringstream ostr;
+        ostr << "Requested " << elementSize << " byte samples but signal "
+             << "array has " << mElementSize << " byte samples";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    size_t lastSample = ALL;
+    checkReadInputs(channel, firstVector, lastVector, 0, lastSample, dims);
+
+    std::call_once(mMapOnce, [this]()
+    {
+        const size_t lastChannel = mOffsets.size() - 1;
+        const size_t signalSize = static_cast<size_t>(
+                mOffsets[lastChannel] - mWBOffset) +
+                getBytesRequiredForRead(lastChannel);
+        auto signalMap = mInStream->map(mWBOffset, signalSize);
+        if (signalMap.get() == nullptr)
+        {
+            throw except::Exception(Ctxt(
+                    "Signal block input can't be memory mapped; "
+                    "construct Wideband from a pathname"));
+        }
+        mSignalMap = signalMap;
+    });
+
+    return mSignalMap->data() +
+            (getFileOffset(channel, firstVector, 0) - mWBOffset);
 }
 
 bool Wideband::shouldByteSwap() const
 {
-    return (std::endian::native == std::endian::little) && !mMetadata.isCompressed() &&
+    return (std::endian::native == std::endian::little) && !isOpaque() &&
             mElementSize > 2;
 }
 
@@ -664,17 +941,19 @@ void Wideband::read(size_t channel,
                                    dims,
                                    vectorScaleFactors.data(),
                                    numThreads,
-                                   data.data);
+                                   data.data,
+                                   mThreadPool.get());
         }
         else
         {
             // Just need to scale
-            scale(scratch.data,
-                  mElementSize,
-                  dims,
-                  vectorScaleFactors.data(),
-                  numThreads,
-                  data.data);
+            crsd::scale(scratch.data,
+                        mElementSize,
+                        dims,
+                        vectorScaleFactors.data(),
+                        numThreads,
+                        data.data,
+                        mThreadPool.get());
         }
     }
     // We need to convert the output to floating-point data
@@ -690,12 +969,21 @@ void Wideband::read(size_t channel,
 
         if ((std::endian::native == std::endian::little) && mElementSize > 2)
         {
-            crsd::byteSwapAndPromote(
-                    scratch.data, mElementSize, dims, numThreads, data.data);
+            crsd::byteSwapAndPromote(scratch.data,
+                                     mElementSize,
+                                     dims,
+                                     numThreads,
+                                     data.data,
+                                     mThreadPool.get());
         }
         else
         {
-            promote(scratch.data, mElementSize, dims, numThreads, data.data);
+            crsd::promote(scratch.data,
+                          mElementSize,
+                          dims,
+                          numThreads,
+                          data.data,
+                          mThreadPool.get());
         }
     }
     else
@@ -715,7 +1003,8 @@ void Wideband::read(size_t channel,
             crsd::byteSwap(data.data,
                            mElementSize / 2,
                            numPixels * 2,
-                           numThreads);
+                           numThreads,
+                           mThreadPool.get());
         }
     }
 }
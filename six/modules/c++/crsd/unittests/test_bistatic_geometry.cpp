@@ -0,0 +1,221 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cmath>
+#include <vector>
+
+#include <std/span>
+
+#include <crsd/BistaticGeometry.h>
+#include <crsd/PPPBlock.h>
+#include <crsd/PVPBlock.h>
+#include <crsd/TestDataGenerator.h>
+
+#include "TestCase.h"
+
+namespace
+{
+static constexpr double EARTH_RADIUS = 6378137.0;
+static constexpr double DEG = M_PI / 180.0;
+
+crsd::Vector3 makeVector(double x, double y, double z)
+{
+    crsd::Vector3 value;
+    value[0] = x;
+    value[1] = y;
+    value[2] = z;
+    return value;
+}
+
+std::span<const crsd::Vector3> column(const std::vector<crsd::Vector3>& values)
+{
+    return std::span<const crsd::Vector3>(values.data(), values.size());
+}
+
+double bistaticAngle(const crsd::Vector3& tx,
+                     const crsd::Vector3& rcv,
+                     const crsd::Vector3& point)
+{
+    const crsd::Vector3 toTx = tx - point;
+    const crsd::Vector3 toRcv = rcv - point;
+    return std::acos(toTx.dot(toRcv) / (toTx.norm() * toRcv.norm())) / DEG;
+}
+}
+
+TEST_CASE(testMonostaticOnEquator)
+{
+    // On the equator up is +X, east +Y and north +Z. The platform is
+    // 30 degrees up, looking south at the point, flying east.
+    const auto point = makeVector(EARTH_RADIUS, 0, 0);
+    const double range = 10000;
+    const auto apc = point + makeVector(range * 0.5, 0,
+                                        range * std::cos(30 * DEG));
+    const auto velocity = makeVector(0, 100, 0);
+
+    const std::vector<crsd::Vector3> apcs(1, apc);
+    const std::vector<crsd::Vector3> velocities(1, velocity);
+    const std::vector<crsd::Vector3> points(1, point);
+    const crsd::BistaticGeometry geometry = crsd::computeBistaticGeometry(
+            column(apcs), column(velocities), column(apcs),
+            column(velocities), column(points), 1);
+
+    TEST_ASSERT_EQ(geometry.size(), static_cast<size_t>(1));
+    TEST_ASSERT_ALMOST_EQ_EPS(geometry.bistaticAngle[0], 0.0, 1e-6);
+    TEST_ASSERT_ALMOST_EQ_EPS(geometry.bistaticAngleRate[0], 0.0, 1e-9);
+    TEST_ASSERT_ALMOST_EQ_EPS(geometry.grazeAngle[0], 30.0, 1e-9);
+    TEST_ASSERT_ALMOST_EQ_EPS(geometry.slopeAngle[0], 30.0, 1e-9);
+    TEST_ASSERT_ALMOST_EQ_EPS(geometry.twistAngle[0], 0.0, 1e-9);
+    TEST_ASSERT_ALMOST_EQ_EPS(geometry.layoverAngle[0], 0.0, 1e-9);
+    TEST_ASSERT_ALMOST_EQ_EPS(geometry.txSlantRange[0], range, 1e-6);
+    TEST_ASSERT_ALMOST_EQ_EPS(geometry.rcvSlantRange[0], range, 1e-6);
+
+    const double groundRange = EARTH_RADIUS * std::atan2(
+            range * std::cos(30 * DEG), EARTH_RADIUS + range * 0.5);
+    TEST_ASSERT_ALMOST_EQ_EPS(geometry.txGroundRange[0], groundRange, 1e-6);
+    TEST_ASSERT_ALMOST_EQ_EPS(geometry.rcvGroundRange[0], groundRange, 1e-6);
+}
+
+TEST_CASE(testBatchedAgainstScalar)
+{
+    // A grid of scene points seen from one bistatic pair, split over
+    // several threads and blocks
+    const auto tx = makeVector(EARTH_RADIUS + 5000, 3000, 12000);
+    const auto txVel = makeVector(10, 150, -20);
+    const auto rcv = makeVector(EARTH_RADIUS + 8000, -9000, 4000);
+    const auto rcvVel = makeVector(-30, 80, 200);
+
+    std::vector<crsd::Vector3> points;
+    for (int row = -20; row < 20; ++row)
+    {
+        for (int col = -10; col < 10; ++col)
+        {
+            points.push_back(makeVector(EARTH_RADIUS, row * 50.0, col * 75.0));
+        }
+    }
+
+    const std::vector<crsd::Vector3> txs(1, tx);
+    const std::vector<crsd::Vector3> txVels(1, txVel);
+    const std::vector<crsd::Vector3> rcvs(1, rcv);
+    const std::vector<crsd::Vector3> rcvVels(1, rcvVel);
+    const crsd::BistaticGeometry geometry = crsd::computeBistaticGeometry(
+            column(txs), column(txVels), column(rcvs), column(rcvVels),
+            column(points), 3);
+    TEST_ASSERT_EQ(geometry.size(), points.size());
+
+    const double dt = 1e-3;
+    for (size_t ii = 0; ii < points.size(); ++ii)
+    {
+        const crsd::Vector3& point = points[ii];
+        TEST_ASSERT_ALMOST_EQ_EPS(geometry.bistaticAngle[ii],
+                                  bistaticAngle(tx, rcv, point), 1e-9);
+
+        // Central difference of the angle as both APCs move
+        const double rate =
+                (bistaticAngle(tx + txVel * dt, rcv + rcvVel * dt, point) -
+                 bistaticAngle(tx - txVel * dt, rcv - rcvVel * dt, point)) /
+                (2 * dt);
+        TEST_ASSERT_ALMOST_EQ_EPS(geometry.bistaticAngleRate[ii], rate, 1e-6);
+
+        TEST_ASSERT_ALMOST_EQ_EPS(geometry.txSlantRange[ii],
+                                  (tx - point).norm(), 1e-6);
+        TEST_ASSERT_ALMOST_EQ_EPS(geometry.rcvSlantRange[ii],
+                                  (rcv - point).norm(), 1e-6);
+        TEST_ASSERT_TRUE(geometry.slopeAngle[ii] >= 0 &&
+                         geometry.slopeAngle[ii] <= 90);
+        TEST_ASSERT_TRUE(geometry.layoverAngle[ii] >= 0 &&
+                         geometry.layoverAngle[ii] < 360);
+
+        // Same answer one sample at a time
+        const std::vector<crsd::Vector3> single(1, point);
+        const crsd::BistaticGeometry one = crsd::computeBistaticGeometry(
+                column(txs), column(txVels), column(rcvs), column(rcvVels),
+                column(single), 1);
+        TEST_ASSERT_EQ(one.grazeAngle[0], geometry.grazeAngle[ii]);
+        TEST_ASSERT_EQ(one.twistAngle[0], geometry.twistAngle[ii]);
+        TEST_ASSERT_EQ(one.layoverAngle[0], geometry.layoverAngle[ii]);
+        TEST_ASSERT_EQ(one.txGroundRange[0], geometry.txGroundRange[ii]);
+    }
+
+    const std::vector<crsd::Vector3> two(2, tx);
+    TEST_EXCEPTION(crsd::computeBistaticGeometry(
+            column(two), column(txVels), column(rcvs), column(rcvVels),
+            column(points), 1));
+    TEST_EXCEPTION(crsd::computeBistaticGeometry(
+            column(txs), column(txVels), column(rcvs), column(rcvVels),
+            std::span<const crsd::Vector3>(), 1));
+}
+
+TEST_CASE(testChannelVectors)
+{
+    crsd::Pvp pvp;
+    crsd::setPVPXML(pvp);
+    crsd::Ppp ppp;
+    crsd::setPPPXML(ppp);
+
+    static constexpr size_t NUM_VECTORS = 3;
+    static constexpr size_t NUM_PULSES = 4;
+    crsd::PVPBlock pvpBlock(1, std::vector<size_t>{NUM_VECTORS}, pvp);
+    crsd::PPPBlock pppBlock(1, std::vector<size_t>{NUM_PULSES}, ppp);
+    for (size_t pulse = 0; pulse < NUM_PULSES; ++pulse)
+    {
+        pppBlock.setTxPos(makeVector(EARTH_RADIUS + 4000, pulse * 10.0, 9000),
+                          0, pulse);
+        pppBlock.setTxVel(makeVector(0, 100, 0), 0, pulse);
+    }
+
+    std::vector<crsd::Vector3> txs;
+    std::vector<crsd::Vector3> txVels;
+    std::vector<crsd::Vector3> rcvs;
+    std::vector<crsd::Vector3> rcvVels;
+    for (size_t vector = 0; vector < NUM_VECTORS; ++vector)
+    {
+        const size_t pulse = NUM_PULSES - 1 - vector;
+        pvpBlock.setTxPulseIndex(static_cast<double>(pulse), 0, vector);
+        rcvs.push_back(makeVector(EARTH_RADIUS + 6000, -7000, vector * 20.0));
+        rcvVels.push_back(makeVector(0, 0, 120));
+        pvpBlock.setRcvPos(rcvs.back(), 0, vector);
+        pvpBlock.setRcvVel(rcvVels.back(), 0, vector);
+        txs.push_back(pppBlock.getTxPos(0, pulse));
+        txVels.push_back(pppBlock.getTxVel(0, pulse));
+    }
+
+    const auto point = makeVector(EARTH_RADIUS, 0, 0);
+    const std::vector<crsd::Vector3> points(1, point);
+    const crsd::BistaticGeometry expected = crsd::computeBistaticGeometry(
+            column(txs), column(txVels), column(rcvs), column(rcvVels),
+            column(points), 1);
+    const crsd::BistaticGeometry geometry = crsd::computeBistaticGeometry(
+            pvpBlock, pppBlock, 0, 0, point, 2);
+    TEST_ASSERT_EQ(geometry.size(), NUM_VECTORS);
+    TEST_ASSERT_TRUE(geometry.bistaticAngle == expected.bistaticAngle);
+    TEST_ASSERT_TRUE(geometry.bistaticAngleRate == expected.bistaticAngleRate);
+    TEST_ASSERT_TRUE(geometry.slopeAngle == expected.slopeAngle);
+
+    pvpBlock.setTxPulseIndex(static_cast<double>(NUM_PULSES), 0, 1);
+    TEST_EXCEPTION(crsd::computeBistaticGeometry(pvpBlock, pppBlock, 0, 0,
+                                                 point, 1));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testMonostaticOnEquator);
+    TEST_CHECK(testBatchedAgainstScalar);
+    TEST_CHECK(testChannelVectors);
+    )
@@ -0,0 +1,183 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+#include <types/RowCol.h>
+#include <crsd/ByteSwap.h>
+
+#include "TestCase.h"
+
+namespace
+{
+// Odd sizes so the vectorized kernels also have to handle a scalar tail
+const types::RowCol<size_t> DIMS(3, 37);
+
+template <typename T>
+T reverseBytes(T value)
+{
+    unsigned char* const bytes = reinterpret_cast<unsigned char*>(&value);
+    std::reverse(bytes, bytes + sizeof(T));
+    return value;
+}
+
+template <typename T>
+std::vector<std::complex<T> > makeInput()
+{
+    std::vector<std::complex<T> > input(DIMS.area());
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        // Span negative and positive values, including the extremes
+        const int value = static_cast<int>(ii * 37 % 256) - 128;
+        input[ii] = std::complex<T>(static_cast<T>(value * (sizeof(T) - 1)),
+                                    static_cast<T>(-value * 3 + 1));
+    }
+    return input;
+}
+
+std::vector<double> makeScaleFactors()
+{
+    std::vector<double> scaleFactors(DIMS.row);
+    for (size_t ii = 0; ii < scaleFactors.size(); ++ii)
+    {
+        scaleFactors[ii] = 0.1 + 1.7 * ii;
+    }
+    return scaleFactors;
+}
+
+// Straightforward conversion of what's in memory, optionally scaled
+template <typename T>
+std::vector<std::complex<float> > expected(
+        const std::vector<std::complex<T> >& input,
+        const double* scaleFactors)
+{
+    std::vector<std::complex<float> > output(input.size());
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        const double scaleFactor =
+                scaleFactors ? scaleFactors[ii / DIMS.col] : 1.0;
+        output[ii] = std::complex<float>(
+                static_cast<float>(input[ii].real() * scaleFactor),
+                static_cast<float>(input[ii].imag() * scaleFactor));
+    }
+    return output;
+}
+
+template <typename T>
+bool convertsLikeScalar(size_t numThreads)
+{
+    const std::vector<std::complex<T> > input = makeInput<T>();
+    std::vector<std::complex<T> > swapped(input.size());
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        swapped[ii] = std::complex<T>(reverseBytes(input[ii].real()),
+                                      reverseBytes(input[ii].imag()));
+    }
+    const std::vector<double> scaleFactors = makeScaleFactors();
+    const size_t elementSize = sizeof(std::complex<T>);
+
+    const std::vector<std::complex<float> > promoted =
+            expected(input, nullptr);
+    const std::vector<std::complex<float> > scaled =
+            expected(input, scaleFactors.data());
+
+    std::vector<std::complex<float> > output(input.size());
+    bool ok = true;
+
+    crsd::promote(input.data(), elementSize, DIMS, numThreads,
+                  output.data());
+    ok = ok && output == promoted;
+
+    crsd::scale(input.data(), elementSize, DIMS, scaleFactors.data(),
+                numThreads, output.data());
+    ok = ok && output == scaled;
+
+    crsd::byteSwapAndPromote(swapped.data(), elementSize, DIMS, numThreads,
+                             output.data());
+    ok = ok && output == (sizeof(T) == 1 ? expected(swapped, nullptr) :
+                                           promoted);
+
+    crsd::byteSwapAndScale(swapped.data(), elementSize, DIMS,
+                           scaleFactors.data(), numThreads, output.data());
+    ok = ok && output == (sizeof(T) == 1 ?
+            expected(swapped, scaleFactors.data()) : scaled);
+    return ok;
+}
+
+template <typename T>
+bool swapsInPlace(size_t numThreads)
+{
+    std::vector<T> buffer(DIMS.area());
+    for (size_t ii = 0; ii < buffer.size(); ++ii)
+    {
+        buffer[ii] = static_cast<T>(ii * 0x0102030405060708ULL);
+    }
+    std::vector<T> swapped(buffer);
+    crsd::byteSwap(swapped.data(), sizeof(T), swapped.size(), numThreads);
+
+    for (size_t ii = 0; ii < buffer.size(); ++ii)
+    {
+        if (swapped[ii] != reverseBytes(buffer[ii]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+TEST_CASE(testPromoteAndScale)
+{
+    for (size_t numThreads = 1; numThreads <= 3; numThreads += 2)
+    {
+        TEST_ASSERT_TRUE(convertsLikeScalar<int8_t>(numThreads));
+        TEST_ASSERT_TRUE(convertsLikeScalar<int16_t>(numThreads));
+        TEST_ASSERT_TRUE(convertsLikeScalar<float>(numThreads));
+    }
+}
+
+TEST_CASE(testByteSwapInPlace)
+{
+    for (size_t numThreads = 1; numThreads <= 3; numThreads += 2)
+    {
+        TEST_ASSERT_TRUE(swapsInPlace<uint16_t>(numThreads));
+        TEST_ASSERT_TRUE(swapsInPlace<uint32_t>(numThreads));
+        TEST_ASSERT_TRUE(swapsInPlace<uint64_t>(numThreads));
+    }
+}
+
+TEST_CASE(testInvalidElementSizeThrows)
+{
+    std::vector<std::complex<float> > output(DIMS.area());
+    std::vector<std::complex<double> > input(DIMS.area());
+    TEST_EXCEPTION(crsd::promote(input.data(), sizeof(input[0]), DIMS, 1,
+                                 output.data()));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testPromoteAndScale);
+    TEST_CHECK(testByteSwapInPlace);
+    TEST_CHECK(testInvalidElementSizeThrows);
+    )
@@ -20,6 +20,7 @@
  *
  */
 
+#include <algorithm>
 #include <thread>
 
 #include <TestCase.h>
@@ -807,6 +808,74 @@ bool runTest(bool /*scale*/,
     return checkDataTX("./outputTX.crsd", numThreads, meta, pppBlock, writeData, writeSupportData);
 }
 
+// Writes everything in small chunks, last chunk first, through the
+// streaming API. With 'supportLast', the support arrays are written one
+// at a time, in reverse order, after everything else.
+template <typename T>
+void writeCRSDStreaming(const std::string& outPathname,
+                        size_t numThreads,
+                        const types::RowCol<size_t> dims,
+                        const std::vector<std::complex<T>>& writeData,
+                        const std::vector<double>& writeSupportData,
+                        crsd::Metadata& metadata,
+                        crsd::PVPBlock& pvpBlock,
+                        crsd::PPPBlock& pppBlock,
+                        bool supportLast = false)
+{
+    const size_t chunkSize = 50;  // doesn't evenly divide dims.row
+
+    crsd::CRSDWriter writer(metadata,
+                            outPathname,
+                            std::vector<std::string>(),
+                            numThreads);
+    writer.writeMetadata();
+    if (!supportLast)
+    {
+        writer.writeSupportData(writeSupportData.data());
+    }
+
+    std::vector<std::byte> pvpData;
+    pvpBlock.getPVPdata(0, pvpData);
+    std::vector<std::byte> pppData;
+    pppBlock.getPPPdata(0, pppData);
+
+    const size_t numChunks = (dims.row + chunkSize - 1) / chunkSize;
+    for (size_t chunk = numChunks; chunk-- > 0;)
+    {
+        const size_t first = chunk * chunkSize;
+        const size_t count = std::min(chunkSize, dims.row - first);
+
+        writer.writeVectors(0, first, std::span<const std::complex<T>>(
+                writeData.data() + first * dims.col, count * dims.col));
+
+        const std::vector<const void*> pvpChunk(
+                1, pvpData.data() + first * pvpBlock.getNumBytesPVPSet());
+        writer.writePVPs(0, first, crsd::PVPBlock(
+                1, std::vector<size_t>(1, count), *metadata.pvp, pvpChunk));
+
+        const std::vector<const void*> pppChunk(
+                1, pppData.data() + first * pppBlock.getNumBytesPPPSet());
+        writer.writePPPs(0, first, crsd::PPPBlock(
+                1, std::vector<size_t>(1, count), *metadata.ppp, pppChunk));
+    }
+
+    if (supportLast)
+    {
+        const auto supportData =
+                reinterpret_cast<const std::byte*>(writeSupportData.data());
+        std::vector<std::pair<size_t, std::string>> arrays;
+        for (const auto& array : metadata.data.supportArrayMap)
+        {
+            arrays.emplace_back(array.second.arrayByteOffset, array.first);
+        }
+        std::sort(arrays.rbegin(), arrays.rend());
+        for (const auto& array : arrays)
+        {
+            writer.writeSupportData(supportData + array.first, array.second);
+        }
+    }
+}
+
 TEST_CASE(testCRSDWriteReadSimpleSAR)
 {
     six::CRSDType type = six::CRSDType::SAR;
@@ -880,8 +949,145 @@ TEST_CASE(testCRSDWriteReadSimpleTX)
     TEST_ASSERT_TRUE(runTest(scale, writeData, writeSupportData, meta, pppBlock, dims));
 }
 
+TEST_CASE(testCRSDWriteReadStreamingSAR)
+{
+    const types::RowCol<size_t> dims(128, 256);
+    const std::vector<std::complex<int16_t>> writeData =
+            generateComplexData<int16_t>(dims.area());
+    crsd::Metadata meta = crsd::Metadata(six::CRSDType::SAR);
+    crsd::setUpData(meta, dims, writeData);
+    meta.pvp.reset(new crsd::Pvp());
+    meta.ppp.reset(new crsd::Ppp());
+    meta.setVersion("1.0.0");
+    crsd::setPVPXML(*(meta.pvp));
+    crsd::setPPPXML(*(meta.ppp));
+    crsd::PVPBlock pvpBlock(*(meta.pvp), meta.data);
+    setPVPBlock(dims, pvpBlock, std::vector<std::string>());
+    crsd::PPPBlock pppBlock(*(meta.ppp), meta.data);
+    setPPPBlock(dims, pppBlock, std::vector<std::string>());
+    setSupport(meta.data);
+    const std::vector<double> writeSupportData =
+            generateSupportData<double>(NUM_SUPPORT*NUM_ROWS*NUM_COLS);
+
+    io::TempFile tempfile;
+    const size_t numThreads = std::thread::hardware_concurrency();
+    writeCRSDStreaming(tempfile.pathname(), numThreads, dims, writeData,
+                       writeSupportData, meta, pvpBlock, pppBlock);
+    TEST_ASSERT_TRUE(checkDataSAR(tempfile.pathname(), numThreads, meta,
+                                  pvpBlock, pppBlock, writeData,
+                                  writeSupportData));
+
+    crsd::CRSDReader reader(tempfile.pathname(), numThreads);
+    std::vector<std::complex<int16_t>> readData(dims.area());
+    reader.getWideband().read(0, 0, crsd::Wideband::ALL, 0,
+                              crsd::Wideband::ALL, numThreads,
+                              std::span<std::byte>(
+                                      reinterpret_cast<std::byte*>(
+                                              readData.data()),
+                                      readData.size() * sizeof(readData[0])));
+    TEST_ASSERT_TRUE(readData == writeData);
+}
+
+TEST_CASE(testCRSDWriteReadStreamingSupportLast)
+{
+    const types::RowCol<size_t> dims(128, 256);
+    const std::vector<std::complex<int16_t>> writeData =
+            generateComplexData<int16_t>(dims.area());
+    crsd::Metadata meta = crsd::Metadata(six::CRSDType::SAR);
+    crsd::setUpData(meta, dims, writeData);
+    meta.pvp.reset(new crsd::Pvp());
+    meta.ppp.reset(new crsd::Ppp());
+    meta.setVersion("1.0.0");
+    crsd::setPVPXML(*(meta.pvp));
+    crsd::setPPPXML(*(meta.ppp));
+    crsd::PVPBlock pvpBlock(*(meta.pvp), meta.data);
+    setPVPBlock(dims, pvpBlock, std::vector<std::string>());
+    crsd::PPPBlock pppBlock(*(meta.ppp), meta.data);
+    setPPPBlock(dims, pppBlock, std::vector<std::string>());
+    setSupport(meta.data);
+    const std::vector<double> writeSupportData =
+            generateSupportData<double>(NUM_SUPPORT*NUM_ROWS*NUM_COLS);
+
+    io::TempFile tempfile;
+    const size_t numThreads = std::thread::hardware_concurrency();
+    writeCRSDStreaming(tempfile.pathname(), numThreads, dims, writeData,
+                       writeSupportData, meta, pvpBlock, pppBlock, true);
+    TEST_ASSERT_TRUE(checkDataSAR(tempfile.pathname(), numThreads, meta,
+                                  pvpBlock, pppBlock, writeData,
+                                  writeSupportData));
+}
+
+TEST_CASE(testStreamingWriteOutOfRangeThrows)
+{
+    const types::RowCol<size_t> dims(4, 8);
+    const std::vector<std::complex<int16_t>> writeData =
+            generateComplexData<int16_t>(dims.area());
+    crsd::Metadata meta = crsd::Metadata(six::CRSDType::RCV);
+    crsd::setUpData(meta, dims, writeData);
+    meta.pvp.reset(new crsd::Pvp());
+    meta.setVersion("1.0.0");
+    crsd::setPVPXML(*(meta.pvp));
+    setSupport(meta.data);
+
+    io::TempFile tempfile;
+    crsd::CRSDWriter writer(meta, tempfile.pathname());
+    const std::span<const std::complex<int16_t>> twoVectors(
+            writeData.data(), 2 * dims.col);
+
+    // Metadata has to come first
+    TEST_EXCEPTION(writer.writeVectors(0, 0, twoVectors));
+
+    writer.writeMetadata();
+    writer.writeVectors(0, 2, twoVectors);
+    TEST_EXCEPTION(writer.writeVectors(0, 3, twoVectors));
+    TEST_EXCEPTION(writer.writeVectors(0, 0,
+            std::span<const std::complex<int16_t>>(writeData.data(),
+                                                   dims.col + 1)));
+}
+
+TEST_CASE(testCRSDReadLazySAR)
+{
+    const types::RowCol<size_t> dims(128, 256);
+    const std::vector<std::complex<int16_t>> writeData =
+            generateComplexData<int16_t>(dims.area());
+    crsd::Metadata meta = crsd::Metadata(six::CRSDType::SAR);
+    crsd::setUpData(meta, dims, writeData);
+    meta.pvp.reset(new crsd::Pvp());
+    meta.ppp.reset(new crsd::Ppp());
+    meta.setVersion("1.0.0");
+    crsd::setPVPXML(*(meta.pvp));
+    crsd::setPPPXML(*(meta.ppp));
+    crsd::PVPBlock pvpBlock(*(meta.pvp), meta.data);
+    setPVPBlock(dims, pvpBlock, std::vector<std::string>());
+    crsd::PPPBlock pppBlock(*(meta.ppp), meta.data);
+    setPPPBlock(dims, pppBlock, std::vector<std::string>());
+    setSupport(meta.data);
+    const std::vector<double> writeSupportData =
+            generateSupportData<double>(NUM_SUPPORT*NUM_ROWS*NUM_COLS);
+
+    io::TempFile tempfile;
+    const size_t numThreads = std::thread::hardware_concurrency();
+    writeCRSDStreaming(tempfile.pathname(), numThreads, dims, writeData,
+                       writeSupportData, meta, pvpBlock, pppBlock);
+
+    const crsd::CRSDReader eager(tempfile.pathname(), numThreads);
+    const crsd::CRSDReader lazy(tempfile.pathname(), numThreads,
+                                std::vector<std::string>(), nullptr, nullptr,
+                                true);
+    TEST_ASSERT_EQ(lazy.getPVPBlock(0).getRcvPos(0, dims.row - 1),
+                   eager.getPVPBlock().getRcvPos(0, dims.row - 1));
+    lazy.prefetchTxSequence(0);
+    TEST_EXCEPTION(lazy.prefetch(lazy.getNumChannels()));
+    TEST_ASSERT_TRUE(lazy.getPVPBlock() == eager.getPVPBlock());
+    TEST_ASSERT_TRUE(lazy.getPPPBlock() == eager.getPPPBlock());
+}
+
 TEST_MAIN(
         TEST_CHECK(testCRSDWriteReadSimpleSAR);
         TEST_CHECK(testCRSDWriteReadSimpleRCV);
         TEST_CHECK(testCRSDWriteReadSimpleTX);
+        TEST_CHECK(testCRSDWriteReadStreamingSAR);
+        TEST_CHECK(testCRSDWriteReadStreamingSupportLast);
+        TEST_CHECK(testStreamingWriteOutOfRangeThrows);
+        TEST_CHECK(testCRSDReadLazySAR);
         )
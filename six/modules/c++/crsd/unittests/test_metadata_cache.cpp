@@ -0,0 +1,142 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <io/FileOutputStream.h>
+#include <io/TempFile.h>
+#include <crsd/MetadataCache.h>
+
+#include "TestCase.h"
+
+namespace
+{
+crsd::MetadataCache::Key makeKey(const std::string& pathname)
+{
+    crsd::MetadataCache::Key key;
+    key.pathname = pathname;
+    return key;
+}
+
+void writeFile(const std::string& pathname, const std::string& contents)
+{
+    io::FileOutputStream stream(pathname);
+    stream.write(contents);
+    stream.close();
+}
+}
+
+TEST_CASE(testDisabledByDefault)
+{
+    crsd::MetadataCache cache;
+    TEST_ASSERT_EQ(cache.getCapacity(), static_cast<size_t>(0));
+    cache.insert(makeKey("a"), std::make_shared<const crsd::Metadata>());
+    TEST_ASSERT_EQ(cache.size(), static_cast<size_t>(0));
+    TEST_ASSERT_NULL(cache.find(makeKey("a")).get());
+}
+
+TEST_CASE(testLeastRecentlyUsedIsEvicted)
+{
+    crsd::MetadataCache cache(2);
+    auto a = std::make_shared<const crsd::Metadata>();
+    auto b = std::make_shared<const crsd::Metadata>();
+    auto c = std::make_shared<const crsd::Metadata>();
+    cache.insert(makeKey("a"), a);
+    cache.insert(makeKey("b"), b);
+
+    // Touching "a" leaves "b" as the oldest
+    TEST_ASSERT_TRUE(cache.find(makeKey("a")) == a);
+    cache.insert(makeKey("c"), c);
+    TEST_ASSERT_EQ(cache.size(), static_cast<size_t>(2));
+    TEST_ASSERT_TRUE(cache.find(makeKey("a")) == a);
+    TEST_ASSERT_NULL(cache.find(makeKey("b")).get());
+    TEST_ASSERT_TRUE(cache.find(makeKey("c")) == c);
+
+    cache.setCapacity(1);
+    TEST_ASSERT_EQ(cache.size(), static_cast<size_t>(1));
+    TEST_ASSERT_TRUE(cache.find(makeKey("c")) == c);
+    cache.clear();
+    TEST_ASSERT_EQ(cache.size(), static_cast<size_t>(0));
+}
+
+TEST_CASE(testSchemasAreKeyed)
+{
+    crsd::MetadataCache cache(4);
+    auto unvalidated = std::make_shared<const crsd::Metadata>();
+    cache.insert(makeKey("a"), unvalidated);
+
+    auto validatedKey = makeKey("a");
+    validatedKey.schemaPaths.push_back("schemas");
+    TEST_ASSERT_NULL(cache.find(validatedKey).get());
+
+    auto validated = std::make_shared<const crsd::Metadata>();
+    cache.insert(validatedKey, validated);
+    TEST_ASSERT_EQ(cache.size(), static_cast<size_t>(2));
+    TEST_ASSERT_TRUE(cache.find(validatedKey) == validated);
+    TEST_ASSERT_TRUE(cache.find(makeKey("a")) == unvalidated);
+
+    auto otherSchemas = validatedKey;
+    otherSchemas.schemaPaths.push_back("more schemas");
+    TEST_ASSERT_NULL(cache.find(otherSchemas).get());
+}
+
+TEST_CASE(testKeyTracksFileContents)
+{
+    io::TempFile tempfile;
+    const std::string xml = "<CRSDsar/>";
+    writeFile(tempfile.pathname(), "header" + xml);
+    const auto key = crsd::MetadataCache::makeKey(tempfile.pathname(),
+                                                  xml.data(), xml.size());
+    TEST_ASSERT_EQ(key.fileSize, static_cast<int64_t>(6 + xml.size()));
+    const auto same = crsd::MetadataCache::makeKey(tempfile.pathname(),
+                                                   xml.data(), xml.size());
+    TEST_ASSERT_FALSE(key < same || same < key);
+
+    // Same size and probably the same timestamp, but different XML
+    const std::string edited = "<CRSDtx/> ";
+    writeFile(tempfile.pathname(), "header" + edited);
+    const auto changed = crsd::MetadataCache::makeKey(tempfile.pathname(),
+                                                      edited.data(),
+                                                      edited.size());
+    TEST_ASSERT_TRUE(key < changed || changed < key);
+
+    // The order schema paths are given in doesn't matter
+    const std::vector<std::string> schemas{"b", "a"};
+    const auto forward = crsd::MetadataCache::makeKey(
+            tempfile.pathname(), edited.data(), edited.size(), schemas);
+    const auto backward = crsd::MetadataCache::makeKey(
+            tempfile.pathname(), edited.data(), edited.size(),
+            std::vector<std::string>(schemas.rbegin(), schemas.rend()));
+    TEST_ASSERT_FALSE(forward < backward || backward < forward);
+    TEST_ASSERT_TRUE(forward < changed || changed < forward);
+
+    TEST_EXCEPTION(crsd::MetadataCache::makeKey(
+            tempfile.pathname() + ".missing", xml.data(), xml.size()));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testDisabledByDefault);
+    TEST_CHECK(testLeastRecentlyUsedIsEvicted);
+    TEST_CHECK(testSchemasAreKeyed);
+    TEST_CHECK(testKeyTracksFileContents);
+    )
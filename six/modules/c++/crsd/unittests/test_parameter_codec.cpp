@@ -0,0 +1,112 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <complex>
+#include <vector>
+
+#include <std/cstddef>
+
+#include <crsd/ParameterCodec.h>
+
+#include "TestCase.h"
+
+using crsd::ParameterCodec;
+
+TEST_CASE(testRoundTrip)
+{
+    // Set layout: [int as F8][F8][3 pad bytes][S5]
+    static constexpr size_t STRIDE = 24;
+    static constexpr size_t NUM_SETS = 300;  // more than one block
+
+    std::vector<std::byte> input(STRIDE * NUM_SETS);
+    for (size_t ii = 0; ii < NUM_SETS; ++ii)
+    {
+        std::byte* set = input.data() + ii * STRIDE;
+        const double index = static_cast<double>(ii);
+        const double value = 0.5 * ii;
+        memcpy(set, &index, sizeof(double));
+        memcpy(set + 8, &value, sizeof(double));
+        memcpy(set + 19, "abcde", 5);
+    }
+
+    std::vector<int64_t> indices(NUM_SETS);
+    std::vector<double> values(NUM_SETS);
+    std::vector<std::byte> strings(5 * NUM_SETS);
+
+    ParameterCodec codec;
+    codec.addIntegerField(0, indices.data(), sizeof(int64_t));
+    codec.addColumn(8, values);
+    codec.addField(19, 5, strings.data(), 5);
+    codec.decode(input.data(), STRIDE, NUM_SETS);
+
+    TEST_ASSERT_EQ(indices[299], 299);
+    TEST_ASSERT_EQ(values[3], 1.5);
+    TEST_ASSERT_EQ(memcmp(&strings[5 * 257], "abcde", 5), 0);
+
+    std::vector<std::byte> output(input.size());
+    codec.encode(output.data(), STRIDE, NUM_SETS);
+    TEST_ASSERT_TRUE(output == input);
+}
+
+TEST_CASE(testReadOnlyColumns)
+{
+    static constexpr size_t NUM_SETS = 3;
+    const std::vector<int64_t> indices{4, 5, 6};
+    const std::vector<double> values{0.25, 0.5, 0.75};
+
+    ParameterCodec codec;
+    codec.addIntegerField(0, indices.data(), sizeof(int64_t));
+    codec.addColumn(8, values);
+
+    std::vector<std::byte> output(16 * NUM_SETS);
+    codec.encode(output.data(), 16, 1, 2);
+    double value;
+    memcpy(&value, output.data(), sizeof(value));
+    TEST_ASSERT_EQ(value, 5.0);
+    memcpy(&value, output.data() + 24, sizeof(value));
+    TEST_ASSERT_EQ(value, 0.75);
+
+    TEST_EXCEPTION(codec.decode(output.data(), 16, 2));
+}
+
+TEST_CASE(testParameterConversion)
+{
+    std::byte value[8];
+    six::Parameter parameter;
+    parameter.setValue(std::complex<float>(1.0f, -2.0f));
+    ParameterCodec::fromParameter(parameter, "CF8", value, sizeof(value));
+    const six::Parameter complex = ParameterCodec::toParameter("CF8", value, sizeof(value));
+    TEST_ASSERT_TRUE(complex.getComplex<float>() == std::complex<float>(1.0f, -2.0f));
+
+    parameter.setValue(std::string("abc"));
+    ParameterCodec::fromParameter(parameter, "S8", value, sizeof(value));
+    TEST_ASSERT_EQ(value[7], static_cast<std::byte>(0));
+    TEST_ASSERT_EQ(ParameterCodec::toParameter("S8", value, sizeof(value)).str(),
+                   std::string("abc\0\0\0\0\0", 8));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testRoundTrip);
+    TEST_CHECK(testReadOnlyColumns);
+    TEST_CHECK(testParameterConversion);
+    )
@@ -20,10 +20,14 @@
  *
  */
 
+#include <algorithm>
 #include <complex>
 #include <thread>
 #include <tuple>
 
+#include <io/ByteStream.h>
+
+#include <crsd/ByteSwap.h>
 #include <crsd/PVP.h>
 #include <crsd/PVPBlock.h>
 #include <crsd/TestDataGenerator.h>
@@ -286,9 +290,173 @@ TEST_CASE(testLoadPVPBlockFromMemory)
     TEST_ASSERT_EQ(pvpBlock.getRcvPos(0, 0)[2], 12);
 }
 
+TEST_CASE(testBulkGetters)
+{
+    call_srand();
+
+    crsd::Pvp pvp;
+    crsd::setPVPXML(pvp);
+    crsd::PVPBlock pvpBlock(NUM_CHANNELS,
+                            std::vector<size_t>{1, NUM_VECTORS, 0},
+                            pvp);
+    for (size_t vector = 0; vector < NUM_VECTORS; ++vector)
+    {
+        crsd::setVectorParameters(1, vector, pvpBlock);
+    }
+
+    const auto rcvPos = pvpBlock.getRcvPos(1);
+    const auto signal = pvpBlock.getSignal(1);
+    const auto refFreq = pvpBlock.getRefFreq(1);
+    TEST_ASSERT_EQ(rcvPos.size(), NUM_VECTORS);
+    for (size_t vector = 0; vector < NUM_VECTORS; ++vector)
+    {
+        TEST_ASSERT_EQ(rcvPos[vector], pvpBlock.getRcvPos(1, vector));
+        TEST_ASSERT_EQ(signal[vector], pvpBlock.getSignal(1, vector));
+        TEST_ASSERT_EQ(refFreq[vector], pvpBlock.getRefFreq(1, vector));
+    }
+    TEST_ASSERT_EQ(pvpBlock.getRcvPos(0).size(), static_cast<size_t>(1));
+    TEST_ASSERT_TRUE(pvpBlock.getRcvStart(2).empty());
+    TEST_EXCEPTION(pvpBlock.getRcvPos(NUM_CHANNELS));
+}
+
+TEST_CASE(testPVPdataRoundTrip)
+{
+    call_srand();
+
+    // getNumBytesPVPSet() does not count TxPulseIndex, so leave it out
+    crsd::Pvp pvp;
+    for (auto param : { &pvp.rcvStart, &pvp.rcvPos, &pvp.rcvVel, &pvp.frcv1,
+                        &pvp.frcv2, &pvp.refPhi0, &pvp.refFreq, &pvp.dfiC0,
+                        &pvp.ficRate, &pvp.rcvACX, &pvp.rcvACY, &pvp.rcvEB,
+                        &pvp.signal, &pvp.ampSF, &pvp.dgrgc })
+    {
+        pvp.append(*param);
+    }
+    pvp.appendCustomParameter(1, "F8", "Param1");
+    pvp.appendCustomParameter(1, "CI8", "Param2");
+    const std::vector<size_t> numVectors(NUM_CHANNELS, NUM_VECTORS);
+    crsd::PVPBlock pvpBlock(NUM_CHANNELS, numVectors, pvp);
+
+    for (size_t channel = 0; channel < NUM_CHANNELS; ++channel)
+    {
+        for (size_t vector = 0; vector < NUM_VECTORS; ++vector)
+        {
+            crsd::setVectorParameters(channel, vector, pvpBlock);
+            pvpBlock.setAddedPVP(crsd::getRandom(), channel, vector, "Param1");
+            TEST_EXCEPTION(pvpBlock.getAddedPVP<std::complex<int> >(channel, vector, "Param2"));
+            pvpBlock.setAddedPVP(std::complex<int>(3, -4), channel, vector, "Param2");
+            TEST_EXCEPTION(pvpBlock.setAddedPVP(std::complex<int>(3, -4), channel, vector, "Param2"));
+        }
+    }
+
+    std::vector<std::vector<std::byte> > buffers(NUM_CHANNELS);
+    std::vector<const void*> data(NUM_CHANNELS);
+    for (size_t channel = 0; channel < NUM_CHANNELS; ++channel)
+    {
+        pvpBlock.getPVPdata(channel, buffers[channel]);
+        data[channel] = buffers[channel].data();
+    }
+
+    // A range of sets encodes to the same bytes as the whole channel
+    const size_t numBytes = pvpBlock.getNumBytesPVPSet();
+    std::vector<std::byte> range((NUM_VECTORS - 1) * numBytes);
+    pvpBlock.getPVPdata(1, 1, NUM_VECTORS - 1, range.data());
+    TEST_ASSERT_TRUE(std::equal(range.begin(), range.end(),
+                                buffers[1].begin() + numBytes));
+    TEST_EXCEPTION(pvpBlock.getPVPdata(1, 1, NUM_VECTORS, range.data()));
+
+    const crsd::PVPBlock pvpBlock2(NUM_CHANNELS, numVectors, pvp, data);
+    for (size_t channel = 0; channel < NUM_CHANNELS; ++channel)
+    {
+        std::vector<std::byte> buffer;
+        pvpBlock2.getPVPdata(channel, buffer);
+        TEST_ASSERT_TRUE(buffer == buffers[channel]);
+    }
+    TEST_ASSERT_EQ(pvpBlock2.getRcvVel(0, 1), pvpBlock.getRcvVel(0, 1));
+    TEST_ASSERT_EQ(pvpBlock2.getAddedPVP<std::complex<int> >(2, 1, "Param2"),
+                   std::complex<int>(3, -4));
+    TEST_ASSERT_EQ(pvpBlock2.getAddedPVP<double>(1, 0, "Param1"),
+                   pvpBlock.getAddedPVP<double>(1, 0, "Param1"));
+}
+
+TEST_CASE(testLoadChannel)
+{
+    call_srand();
+
+    crsd::Pvp pvp;
+    for (auto param : { &pvp.rcvStart, &pvp.rcvPos, &pvp.rcvVel, &pvp.frcv1,
+                        &pvp.frcv2, &pvp.refPhi0, &pvp.refFreq, &pvp.dfiC0,
+                        &pvp.ficRate, &pvp.rcvACX, &pvp.rcvACY, &pvp.rcvEB,
+                        &pvp.signal, &pvp.ampSF, &pvp.dgrgc })
+    {
+        pvp.append(*param);
+    }
+    const std::vector<size_t> numVectors{NUM_VECTORS, NUM_VECTORS + 1, 1};
+    crsd::PVPBlock pvpBlock(NUM_CHANNELS, numVectors, pvp);
+
+    // Write the block out big endian, as it is in a file, after some padding
+    static constexpr int64_t START_PVP = 16;
+    auto stream = std::make_shared<io::ByteStream>();
+    stream->write(std::string(START_PVP, 'x'));
+    int64_t sizePVP = 0;
+    for (size_t channel = 0; channel < NUM_CHANNELS; ++channel)
+    {
+        for (size_t vector = 0; vector < numVectors[channel]; ++vector)
+        {
+            crsd::setVectorParameters(channel, vector, pvpBlock);
+        }
+        std::vector<std::byte> buffer;
+        pvpBlock.getPVPdata(channel, buffer);
+        crsd::byteSwap(buffer.data(), sizeof(double),
+                       buffer.size() / sizeof(double), 1);
+        stream->write(buffer.data(), buffer.size());
+        sizePVP += buffer.size();
+    }
+    crsd::SeekablePositionalInputStream inStream(stream);
+
+    crsd::PVPBlock loaded(NUM_CHANNELS, numVectors, pvp);
+    TEST_ASSERT_EQ(loaded.loadChannel(inStream, START_PVP, sizePVP, 1, 1),
+                   static_cast<int64_t>(pvpBlock.getPVPsize(1)));
+    for (size_t vector = 0; vector < numVectors[1]; ++vector)
+    {
+        TEST_ASSERT_EQ(loaded.getRcvPos(1, vector), pvpBlock.getRcvPos(1, vector));
+        TEST_ASSERT_EQ(loaded.getSignal(1, vector), pvpBlock.getSignal(1, vector));
+    }
+    TEST_ASSERT_TRUE(six::Init::isUndefined(loaded.getFRCV1(0, 0)));
+
+    loaded.loadChannel(inStream, START_PVP, sizePVP, 2, 1);
+    loaded.loadChannel(inStream, START_PVP, sizePVP, 0, 1);
+    TEST_ASSERT_TRUE(loaded.getRefPhi0(2, 0) == pvpBlock.getRefPhi0(2, 0));
+    TEST_ASSERT_EQ(loaded.getRcvEB(0, 1), pvpBlock.getRcvEB(0, 1));
+
+    TEST_EXCEPTION(loaded.loadChannel(inStream, START_PVP, sizePVP, NUM_CHANNELS, 1));
+    TEST_EXCEPTION(loaded.loadChannel(inStream, START_PVP, sizePVP - 1, 2, 1));
+
+    // Channels of an unallocated block only exist once they are loaded
+    crsd::Data data;
+    data.receiveParameters.reset(
+            new crsd::Data::Receive(pvpBlock.getNumBytesPVPSet()));
+    for (size_t channel = 0; channel < NUM_CHANNELS; ++channel)
+    {
+        data.receiveParameters->channels.push_back(
+                crsd::Data::Channel(numVectors[channel], 1));
+    }
+    crsd::PVPBlock deferred(pvp, data, false);
+    TEST_ASSERT_EQ(deferred.getPVPsize(1), pvpBlock.getPVPsize(1));
+    TEST_EXCEPTION(deferred.getRcvPos(1, 0));
+    TEST_EXCEPTION(deferred.getSignal(1));
+    deferred.loadChannel(inStream, START_PVP, sizePVP, 1, 1);
+    TEST_ASSERT_EQ(deferred.getRcvPos(1, 2), pvpBlock.getRcvPos(1, 2));
+    TEST_ASSERT_EQ(deferred.getSignal(1).size(), numVectors[1]);
+    TEST_EXCEPTION(deferred.getRcvPos(0, 0));
+}
+
 TEST_MAIN(
     TEST_CHECK(testPvpRequired);
     TEST_CHECK(testPvpThrow);
     TEST_CHECK(testPvpEquality);
     TEST_CHECK(testLoadPVPBlockFromMemory);
+    TEST_CHECK(testBulkGetters);
+    TEST_CHECK(testPVPdataRoundTrip);
+    TEST_CHECK(testLoadChannel);
     )
@@ -21,10 +21,124 @@
  */
 #include <crsd/Wideband.h>
 
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <crsd/Metadata.h>
+#include <crsd/PositionalInputStream.h>
+#include <crsd/SignalChunkIndex.h>
+#include <crsd/ThreadPool.h>
 #include <io/ByteStream.h>
+#include <io/FileOutputStream.h>
+#include <io/TempFile.h>
 #include "TestCase.h"
 
+namespace
+{
+// One CI2 channel where byte pair 'vector' holds (vector, sample)
+crsd::Metadata concurrentMetadata(size_t numVectors, size_t numSamples)
+{
+    crsd::Metadata metadata;
+    metadata.data.receiveParameters.reset(new crsd::Data::Receive());
+    metadata.data.receiveParameters->channels.resize(1);
+    metadata.data.receiveParameters->channels[0].numSamples = numSamples;
+    metadata.data.receiveParameters->channels[0].numVectors = numVectors;
+    metadata.data.receiveParameters->signalArrayFormat = crsd::SignalArrayFormat::CI2;
+    return metadata;
+}
+
+std::string concurrentData(size_t numVectors, size_t numSamples)
+{
+    std::string data;
+    for (size_t vector = 0; vector < numVectors; ++vector)
+    {
+        for (size_t sample = 0; sample < numSamples; ++sample)
+        {
+            data += static_cast<char>(vector);
+            data += static_cast<char>(sample);
+        }
+    }
+    return data;
+}
+
+// Each thread reads a different window of vectors many times over
+bool readConcurrently(const crsd::Wideband& wideband,
+                      size_t numVectors,
+                      size_t numSamples)
+{
+    const size_t numThreads = 4;
+    const size_t vectorsPerThread = numVectors / numThreads;
+    std::vector<int> ok(numThreads, 1);
+    std::vector<std::thread> threads;
+    for (size_t tt = 0; tt < numThreads; ++tt)
+    {
+        threads.emplace_back([&, tt]()
+        {
+            const size_t firstVector = tt * vectorsPerThread;
+            const size_t lastVector = firstVector + vectorsPerThread - 1;
+            for (size_t iter = 0; iter < 50; ++iter)
+            {
+                const auto data = wideband.read(
+                        0, firstVector, lastVector, 1, numSamples - 1, 1);
+                for (size_t vector = firstVector, idx = 0;
+                     vector <= lastVector;
+                     ++vector)
+                {
+                    for (size_t sample = 1; sample < numSamples; ++sample)
+                    {
+                        if (data[idx++] != static_cast<std::byte>(vector) ||
+                            data[idx++] != static_cast<std::byte>(sample))
+                        {
+                            ok[tt] = 0;
+                        }
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t tt = 0; tt < numThreads; ++tt)
+    {
+        if (!ok[tt])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads samples [firstSample, lastSample] of every other vector and
+// checks them against concurrentData()
+bool readWindow(const crsd::Wideband& wideband,
+                size_t numVectors,
+                size_t firstSample,
+                size_t lastSample)
+{
+    const size_t firstVector = 1;
+    const size_t lastVector = numVectors - 2;
+    const auto data = wideband.read(
+            0, firstVector, lastVector, firstSample, lastSample, 1);
+    size_t idx = 0;
+    for (size_t vector = firstVector; vector <= lastVector; ++vector)
+    {
+        for (size_t sample = firstSample; sample <= lastSample; ++sample)
+        {
+            if (data[idx++] != static_cast<std::byte>(vector) ||
+                data[idx++] != static_cast<std::byte>(sample))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+}
+
 TEST_CASE(testReadCompressedChannel)
 {
     auto input = std::make_shared<io::ByteStream>();
@@ -143,6 +257,79 @@ TEST_CASE(testReadChannelSubset)
     TEST_ASSERT_EQ(readData[7], static_cast<std::byte>('G'));
 }
 
+TEST_CASE(testReadChunkedCompressedChannel)
+{
+    // Two CI4 channels of 10 x 3 samples, compressed 4 vectors per chunk
+    const size_t numVectors = 10;
+    const size_t numSamples = 3;
+    crsd::Metadata metadata = concurrentMetadata(numVectors, numSamples);
+    metadata.data.receiveParameters->channels.resize(2);
+    metadata.data.receiveParameters->channels[1] =
+            metadata.data.receiveParameters->channels[0];
+    metadata.data.receiveParameters->signalArrayFormat = crsd::SignalArrayFormat::CI4;
+
+    std::vector<std::vector<std::complex<int16_t>>> samples(2);
+    for (size_t channel = 0; channel < samples.size(); ++channel)
+    {
+        for (size_t ii = 0; ii < numVectors * numSamples; ++ii)
+        {
+            samples[channel].emplace_back(
+                    static_cast<int16_t>(1000 * channel + ii),
+                    static_cast<int16_t>(-static_cast<int>(ii)));
+        }
+    }
+
+    crsd::SignalChunkCompressor compressor(metadata.data, 4);
+    TEST_EXCEPTION(compressor.getSignalBlock());
+    for (size_t channel = 0; channel < samples.size(); ++channel)
+    {
+        compressor.compress(channel,
+                            std::span<const std::complex<int16_t>>(
+                                    samples[channel].data(),
+                                    samples[channel].size()));
+    }
+    compressor.update(metadata.data);
+    const std::vector<std::byte> signalBlock = compressor.getSignalBlock();
+
+    const auto index = metadata.getSignalChunkIndex();
+    TEST_ASSERT_TRUE(index.get() != nullptr);
+    TEST_ASSERT_EQ(index->getNumChunks(1), static_cast<size_t>(3));
+    TEST_ASSERT_EQ(index->offsets[1].back(), signalBlock.size());
+    TEST_ASSERT_EQ(metadata.getCompressedSignalSize(0), signalBlock.size());
+
+    auto input = std::make_shared<io::ByteStream>();
+    input->write(signalBlock.data(), signalBlock.size());
+    input->seek(0, io::Seekable::START);
+    crsd::Wideband wideband(input, metadata, 0, signalBlock.size());
+
+    // Whole channel
+    std::vector<std::complex<int16_t>> all(numVectors * numSamples);
+    wideband.read(1, std::span<std::byte>(reinterpret_cast<std::byte*>(all.data()),
+                                          all.size() * sizeof(all[0])));
+    TEST_ASSERT_TRUE(all == samples[1]);
+
+    // Vectors 3 through 8 span all three chunks; only read samples 1 and 2
+    const auto window = wideband.read(1, 3, 8, 1, 2, 1);
+    const auto windowSamples =
+            reinterpret_cast<const std::complex<int16_t>*>(window.get());
+    TEST_ASSERT_EQ(windowSamples[0], samples[1][3 * numSamples + 1]);
+    TEST_ASSERT_EQ(windowSamples[11], samples[1][8 * numSamples + 2]);
+
+    // Promoted reads of several channels go through the chunks too
+    std::vector<std::complex<float>> promoted0(all.size()), promoted1(all.size());
+    const std::vector<size_t> channels = {0, 1};
+    const std::vector<std::span<std::complex<float>>> buffers = {
+            std::span<std::complex<float>>(promoted0.data(), promoted0.size()),
+            std::span<std::complex<float>>(promoted1.data(), promoted1.size())};
+    wideband.readChannels(
+            std::span<const size_t>(channels.data(), channels.size()),
+            0,
+            std::span<const std::span<std::complex<float>>>(buffers.data(),
+                                                            buffers.size()));
+    TEST_ASSERT_EQ(promoted0[29], std::complex<float>(29, -29));
+    TEST_ASSERT_EQ(promoted1[5], std::complex<float>(1005, -5));
+}
+
 TEST_CASE(testCannotDoPartialReadOfCompressedChannel)
 {
     auto input = std::make_shared<io::ByteStream>();
@@ -165,9 +352,370 @@ TEST_CASE(testCannotDoPartialReadOfCompressedChannel)
     TEST_EXCEPTION(wideband.getBytesRequiredForRead(0, 0, 0, 1, 1));
 }
 
+TEST_CASE(testConcurrentReadsFromStream)
+{
+    const size_t numVectors = 64;
+    const size_t numSamples = 16;
+    auto input = std::make_shared<io::ByteStream>();
+    input->write(concurrentData(numVectors, numSamples));
+    input->seek(0, io::Seekable::START);
+
+    const crsd::Metadata metadata = concurrentMetadata(numVectors, numSamples);
+    crsd::Wideband wideband(input, metadata, 0, numVectors * numSamples * 2);
+
+    TEST_ASSERT_TRUE(readConcurrently(wideband, numVectors, numSamples));
+}
+
+TEST_CASE(testConcurrentReadsFromFile)
+{
+    const size_t numVectors = 64;
+    const size_t numSamples = 16;
+    io::TempFile tempfile;
+    {
+        io::FileOutputStream output(tempfile.pathname());
+        output.write(concurrentData(numVectors, numSamples));
+        output.close();
+    }
+
+    const crsd::Metadata metadata = concurrentMetadata(numVectors, numSamples);
+    crsd::Wideband wideband(tempfile.pathname(), metadata, 0,
+                            numVectors * numSamples * 2);
+
+    TEST_ASSERT_TRUE(readConcurrently(wideband, numVectors, numSamples));
+}
+
+TEST_CASE(testReadChannels)
+{
+    // Three big-endian CI4 channels of 2 x 2 samples. Sample 'ii' of
+    // channel 'channel' is (100 * channel + ii, -ii).
+    const size_t numChannels = 3;
+    std::string data;
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        for (size_t ii = 0; ii < 4; ++ii)
+        {
+            const int16_t values[] = {static_cast<int16_t>(100 * channel + ii),
+                                      static_cast<int16_t>(-static_cast<int>(ii))};
+            for (const auto value : values)
+            {
+                data += static_cast<char>((value >> 8) & 0xFF);
+                data += static_cast<char>(value & 0xFF);
+            }
+        }
+    }
+    io::TempFile tempfile;
+    {
+        io::FileOutputStream output(tempfile.pathname());
+        output.write(data);
+        output.close();
+    }
+
+    crsd::Metadata metadata = concurrentMetadata(2, 2);
+    metadata.data.receiveParameters->channels.resize(numChannels);
+    for (auto& channel : metadata.data.receiveParameters->channels)
+    {
+        channel.numSamples = 2;
+        channel.numVectors = 2;
+    }
+    metadata.data.receiveParameters->signalArrayFormat = crsd::SignalArrayFormat::CI4;
+    crsd::Wideband wideband(tempfile.pathname(), metadata, 0, data.size());
+
+    const std::vector<size_t> channels = {2, 0};
+
+    std::vector<std::complex<int16_t>> raw2(4), raw0(4);
+    const std::vector<std::span<std::byte>> rawBuffers = {
+            std::span<std::byte>(reinterpret_cast<std::byte*>(raw2.data()), 16),
+            std::span<std::byte>(reinterpret_cast<std::byte*>(raw0.data()), 16)};
+    wideband.readChannels(std::span<const size_t>(channels.data(), channels.size()),
+                          2,
+                          std::span<const std::span<std::byte>>(rawBuffers.data(),
+                                                                rawBuffers.size()));
+    TEST_ASSERT_EQ(raw2[3], std::complex<int16_t>(203, -3));
+    TEST_ASSERT_EQ(raw0[1], std::complex<int16_t>(1, -1));
+
+    std::vector<std::complex<float>> promoted2(4), promoted0(4);
+    const std::vector<std::span<std::complex<float>>> promotedBuffers = {
+            std::span<std::complex<float>>(promoted2.data(), promoted2.size()),
+            std::span<std::complex<float>>(promoted0.data(), promoted0.size())};
+    wideband.readChannels(
+            std::span<const size_t>(channels.data(), channels.size()),
+            0,
+            std::span<const std::span<std::complex<float>>>(promotedBuffers.data(),
+                                                            promotedBuffers.size()));
+    TEST_ASSERT_EQ(promoted2[2], std::complex<float>(202, -2));
+    TEST_ASSERT_EQ(promoted0[3], std::complex<float>(3, -3));
+
+    // One buffer per channel, each big enough for the whole channel
+    TEST_EXCEPTION(wideband.readChannels(
+            std::span<const size_t>(channels.data(), 1),
+            1,
+            std::span<const std::span<std::byte>>(rawBuffers.data(),
+                                                  rawBuffers.size())));
+    const std::vector<std::span<std::byte>> smallBuffers = {
+            std::span<std::byte>(rawBuffers[0].data(), 15),
+            rawBuffers[1]};
+    TEST_EXCEPTION(wideband.readChannels(
+            std::span<const size_t>(channels.data(), channels.size()),
+            1,
+            std::span<const std::span<std::byte>>(smallBuffers.data(),
+                                                  smallBuffers.size())));
+}
+
+TEST_CASE(testPositionalReadPastEndThrows)
+{
+    io::TempFile tempfile;
+    {
+        io::FileOutputStream output(tempfile.pathname());
+        output.write("1234");
+        output.close();
+    }
+
+    crsd::FilePositionalInputStream input(tempfile.pathname());
+    std::byte buffer[4];
+    input.readAt(2, buffer, 2);
+    TEST_ASSERT_EQ(buffer[0], static_cast<std::byte>('3'));
+    TEST_ASSERT_EQ(buffer[1], static_cast<std::byte>('4'));
+    TEST_EXCEPTION(input.readAt(2, buffer, 4));
+}
+
+TEST_CASE(testReadSubWindowThroughGaps)
+{
+    const size_t numVectors = 200;
+    const size_t numSamples = 64;
+    io::TempFile tempfile;
+    {
+        io::FileOutputStream output(tempfile.pathname());
+        output.write(concurrentData(numVectors, numSamples));
+        output.close();
+    }
+    auto stream = std::make_shared<io::ByteStream>();
+    stream->write(concurrentData(numVectors, numSamples));
+    stream->seek(0, io::Seekable::START);
+
+    const crsd::Metadata metadata = concurrentMetadata(numVectors, numSamples);
+    crsd::Wideband fromFile(tempfile.pathname(), metadata, 0,
+                            numVectors * numSamples * 2);
+    crsd::Wideband fromStream(stream, metadata, 0,
+                              numVectors * numSamples * 2);
+    TEST_ASSERT_EQ(fromFile.getMaxReadGap(),
+                   crsd::Wideband::DEFAULT_MAX_READ_GAP);
+
+    // Vector by vector, then reading through gaps of 96 and 2 bytes
+    for (const size_t maxGap : {static_cast<size_t>(0),
+                                crsd::Wideband::DEFAULT_MAX_READ_GAP})
+    {
+        fromFile.setMaxReadGap(maxGap);
+        fromStream.setMaxReadGap(maxGap);
+        TEST_ASSERT_TRUE(readWindow(fromFile, numVectors, 8, 23));
+        TEST_ASSERT_TRUE(readWindow(fromStream, numVectors, 8, 23));
+        TEST_ASSERT_TRUE(readWindow(fromFile, numVectors, 0, 62));
+        TEST_ASSERT_TRUE(readWindow(fromStream, numVectors, 1, 63));
+    }
+}
+
+TEST_CASE(testReadStrided)
+{
+    // More runs than fit in one preadv()
+    const size_t count = 3000;
+    const size_t size = 2;
+    const size_t stride = 5;
+    std::string file;
+    for (size_t ii = 0; ii < count * stride; ++ii)
+    {
+        file += static_cast<char>(ii % 251);
+    }
+    io::TempFile tempfile;
+    {
+        io::FileOutputStream output(tempfile.pathname());
+        output.write(file);
+        output.close();
+    }
+    auto stream = std::make_shared<io::ByteStream>();
+    stream->write(file);
+
+    crsd::FilePositionalInputStream fromFile(tempfile.pathname());
+    crsd::SeekablePositionalInputStream fromStream(stream);
+    crsd::ThreadPool threadPool(2);
+    for (crsd::PositionalInputStream* input :
+         {static_cast<crsd::PositionalInputStream*>(&fromFile),
+          static_cast<crsd::PositionalInputStream*>(&fromStream)})
+    {
+        std::vector<std::byte> buffer(count * size);
+        input->readStrided(1, size, stride, count, buffer.data());
+        bool matches = true;
+        for (size_t run = 0; run < count; ++run)
+        {
+            for (size_t ii = 0; ii < size; ++ii)
+            {
+                const size_t offset = 1 + run * stride + ii;
+                matches &= buffer[run * size + ii] ==
+                        static_cast<std::byte>(offset % 251);
+            }
+        }
+        TEST_ASSERT_TRUE(matches);
+        TEST_EXCEPTION(input->readStrided(0, 4, 2, 2, buffer.data()));
+        TEST_EXCEPTION(input->readStrided(10, size, stride, count,
+                                          buffer.data()));
+    }
+}
+
+TEST_CASE(testReadBatch)
+{
+    const size_t fileSize = 100000;
+    std::string file;
+    for (size_t ii = 0; ii < fileSize; ++ii)
+    {
+        file += static_cast<char>(ii % 251);
+    }
+    io::TempFile tempfile;
+    {
+        io::FileOutputStream output(tempfile.pathname());
+        output.write(file);
+        output.close();
+    }
+    auto stream = std::make_shared<io::ByteStream>();
+    stream->write(file);
+
+    // More requests than fit in one queue, out of file order, some empty
+    const size_t numRequests =
+            3 * crsd::FilePositionalInputStream::QUEUE_DEPTH + 5;
+    std::vector<std::vector<std::byte> > buffers(numRequests);
+    std::vector<crsd::ReadRequest> requests(numRequests);
+    for (size_t ii = 0; ii < numRequests; ++ii)
+    {
+        buffers[ii].resize(ii % 7 == 0 ? 0 : 1 + (ii * 37) % 900);
+        requests[ii].offset = static_cast<int64_t>(
+                (ii * 7919) % (fileSize - 1000));
+        requests[ii].buffer = buffers[ii].data();
+        requests[ii].size = buffers[ii].size();
+    }
+
+    crsd::FilePositionalInputStream fromFile(tempfile.pathname());
+    crsd::SeekablePositionalInputStream fromStream(stream);
+    crsd::ThreadPool threadPool(2);
+    for (crsd::PositionalInputStream* input :
+         {static_cast<crsd::PositionalInputStream*>(&fromFile),
+          static_cast<crsd::PositionalInputStream*>(&fromStream)})
+    {
+        // Twice, so the file stream reuses its queue; the second time
+        // with a pool of our own in case it falls back to threads
+        for (size_t pass = 0; pass < 2; ++pass)
+        {
+            for (auto& buffer : buffers)
+            {
+                std::fill(buffer.begin(), buffer.end(), std::byte(0xFF));
+            }
+            input->readBatch(std::span<const crsd::ReadRequest>(
+                                     requests.data(), requests.size()),
+                             pass == 0 ? nullptr : &threadPool);
+            bool matches = true;
+            for (size_t ii = 0; ii < numRequests; ++ii)
+            {
+                for (size_t jj = 0; jj < buffers[ii].size(); ++jj)
+                {
+                    const size_t offset = requests[ii].offset + jj;
+                    matches &= buffers[ii][jj] ==
+                            static_cast<std::byte>(offset % 251);
+                }
+            }
+            TEST_ASSERT_TRUE(matches);
+        }
+
+        std::vector<crsd::ReadRequest> pastEnd(requests.begin(),
+                                               requests.begin() + 10);
+        pastEnd[3].offset = fileSize - 1;
+        pastEnd[3].size = 2;
+        TEST_EXCEPTION(input->readBatch(std::span<const crsd::ReadRequest>(
+                pastEnd.data(), pastEnd.size())));
+    }
+}
+
+TEST_CASE(testMappedSignal)
+{
+    io::TempFile tempfile;
+    {
+        io::FileOutputStream output(tempfile.pathname());
+        output.write("xx0A1B2C3D");
+        output.close();
+    }
+
+    crsd::Metadata metadata = concurrentMetadata(2, 2);
+    crsd::Wideband wideband(tempfile.pathname(), metadata, 2, 8);
+
+    const auto all = wideband.getMappedSignal<int8_t>(0);
+    TEST_ASSERT_EQ(all.size(), static_cast<size_t>(4));
+    TEST_ASSERT_EQ(all[0], std::complex<int8_t>('0', 'A'));
+    TEST_ASSERT_EQ(all[3], std::complex<int8_t>('3', 'D'));
+
+    const auto last = wideband.getMappedSignal<int8_t>(0, 1, 1);
+    TEST_ASSERT_EQ(last.size(), static_cast<size_t>(2));
+    TEST_ASSERT_EQ(last[0], std::complex<int8_t>('2', 'C'));
+
+    const auto view = wideband.getMappedSignalView<int8_t>(0, 1);
+    TEST_ASSERT_EQ(view.getNumVectors(), static_cast<size_t>(1));
+    TEST_ASSERT_EQ(view(0, 1), std::complex<int8_t>('3', 'D'));
+
+    // Sample type has to match the signal array format
+    TEST_EXCEPTION(wideband.getMappedSignal<int16_t>(0));
+    TEST_EXCEPTION(wideband.getMappedSignal<int8_t>(0, 2));
+}
+
+TEST_CASE(testMappedSignalViewSwaps)
+{
+    // Two big-endian CI4 samples: (1, -2) and (256, 3)
+    io::TempFile tempfile;
+    {
+        const unsigned char bytes[] = {0x00, 0x01, 0xFF, 0xFE,
+                                       0x01, 0x00, 0x00, 0x03};
+        io::FileOutputStream output(tempfile.pathname());
+        output.write(bytes, sizeof(bytes));
+        output.close();
+    }
+
+    crsd::Metadata metadata = concurrentMetadata(1, 2);
+    metadata.data.receiveParameters->signalArrayFormat = crsd::SignalArrayFormat::CI4;
+    crsd::Wideband wideband(tempfile.pathname(), metadata, 0, 8);
+
+    const auto view = wideband.getMappedSignalView<int16_t>(0);
+    TEST_ASSERT_EQ(view.size(), static_cast<size_t>(2));
+    TEST_ASSERT_EQ(view[0], std::complex<int16_t>(1, -2));
+    TEST_ASSERT_EQ(view[1], std::complex<int16_t>(256, 3));
+
+    const std::vector<std::complex<int16_t>> copied(view.begin(), view.end());
+    TEST_ASSERT_EQ(copied.size(), static_cast<size_t>(2));
+    TEST_ASSERT_EQ(copied[1], std::complex<int16_t>(256, 3));
+
+    if (std::endian::native == std::endian::little)
+    {
+        TEST_EXCEPTION(wideband.getMappedSignal<int16_t>(0));
+    }
+}
+
+TEST_CASE(testMappedSignalFromStreamThrows)
+{
+    auto input = std::make_shared<io::ByteStream>();
+    input->write("0A1B2C3D");
+    input->seek(0, io::Seekable::START);
+
+    const crsd::Metadata metadata = concurrentMetadata(2, 2);
+    crsd::Wideband wideband(input, metadata, 0, 8);
+    TEST_EXCEPTION(wideband.getMappedSignal<int8_t>(0));
+}
+
 TEST_MAIN(
     TEST_CHECK(testReadCompressedChannel);
     TEST_CHECK(testReadUncompressedChannel);
     TEST_CHECK(testReadChannelSubset);
+    TEST_CHECK(testReadChunkedCompressedChannel);
     TEST_CHECK(testCannotDoPartialReadOfCompressedChannel);
+    TEST_CHECK(testConcurrentReadsFromStream);
+    TEST_CHECK(testConcurrentReadsFromFile);
+    TEST_CHECK(testReadChannels);
+    TEST_CHECK(testPositionalReadPastEndThrows);
+    TEST_CHECK(testReadSubWindowThroughGaps);
+    TEST_CHECK(testReadStrided);
+    TEST_CHECK(testReadBatch);
+    TEST_CHECK(testMappedSignal);
+    TEST_CHECK(testMappedSignalViewSwaps);
+    TEST_CHECK(testMappedSignalFromStreamThrows);
     )
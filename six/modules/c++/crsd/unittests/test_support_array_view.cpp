@@ -0,0 +1,199 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <std/bit>
+#include <std/span>
+
+#include <io/ByteStream.h>
+#include <crsd/ByteSwap.h>
+#include <crsd/Data.h>
+#include <crsd/SupportBlock.h>
+
+#include "TestCase.h"
+
+namespace
+{
+static constexpr size_t NUM_ROWS = 3;
+static constexpr size_t NUM_COLS = 4;
+static constexpr int64_t START_SUPPORT = 16;
+
+// Gain is linear in the grid, so bilinear interpolation is exact
+float gain(double row, double col)
+{
+    return static_cast<float>(row * 10 + col);
+}
+float phase(double row, double col)
+{
+    return static_cast<float>(-(row + col));
+}
+
+crsd::Vector2 makePosition(double row, double col)
+{
+    // x0 = 100, xSS = 0.5, y0 = -1, ySS = 2
+    crsd::Vector2 position;
+    position[0] = 100 + row * 0.5;
+    position[1] = -1 + col * 2;
+    return position;
+}
+
+std::unique_ptr<crsd::SupportBlock> makeSupportBlock(crsd::Data& data)
+{
+    data.setSupportArray("AGP", NUM_ROWS, NUM_COLS, 2 * sizeof(float), 0);
+    data.setSupportArray("ODD", 2, 1, 6, NUM_ROWS * NUM_COLS * 8);
+
+    std::vector<float> values;
+    for (size_t row = 0; row < NUM_ROWS; ++row)
+    {
+        for (size_t col = 0; col < NUM_COLS; ++col)
+        {
+            values.push_back(gain(row, col));
+            values.push_back(phase(row, col));
+        }
+    }
+    if (std::endian::native == std::endian::little)
+    {
+        crsd::byteSwap(values.data(), sizeof(float), values.size(), 1);
+    }
+
+    auto stream = std::make_shared<io::ByteStream>();
+    stream->write(std::string(START_SUPPORT, 'x'));
+    stream->write(values.data(), values.size() * sizeof(float));
+    stream->write(std::string(12, 'y'));
+    return std::make_unique<crsd::SupportBlock>(
+            stream, data, START_SUPPORT,
+            static_cast<int64_t>(values.size() * sizeof(float) + 12));
+}
+}
+
+TEST_CASE(testDecodedValues)
+{
+    crsd::Data data;
+    const auto supportBlock = makeSupportBlock(data);
+    const crsd::SupportArrayParameter parameter(
+            "Gain=F4;Phase=F4;", "AGP", 100, -1, 0.5, 2);
+    const auto view = supportBlock->getView<float>("AGP", parameter, 2);
+    TEST_ASSERT_EQ(view.getNumRows(), NUM_ROWS);
+    TEST_ASSERT_EQ(view.getNumCols(), NUM_COLS);
+    TEST_ASSERT_EQ(view.getNumComponents(), static_cast<size_t>(2));
+    TEST_ASSERT_EQ(view(1, 2, 0), gain(1, 2));
+    TEST_ASSERT_EQ(view(2, 3, 1), phase(2, 3));
+
+    // Decoded once and shared
+    const auto again = supportBlock->getView<float>("AGP", parameter, 1);
+    TEST_ASSERT_TRUE(again.data().data() == view.data().data());
+
+    TEST_EXCEPTION(supportBlock->getView<float>("ODD", parameter, 1));
+    TEST_EXCEPTION(supportBlock->getView<float>("MISSING", parameter, 1));
+}
+
+TEST_CASE(testSample)
+{
+    crsd::Data data;
+    const auto supportBlock = makeSupportBlock(data);
+    const crsd::SupportArrayParameter parameter(
+            "Gain=F4;Phase=F4;", "AGP", 100, -1, 0.5, 2);
+    const auto view = supportBlock->getView<float>("AGP", parameter, 1);
+
+    // Grid points, points between them, and points off each edge
+    std::vector<crsd::Vector2> xy;
+    std::vector<float> expected;
+    for (double row = -1; row <= 3; row += 0.25)
+    {
+        for (double col = -0.5; col <= 4; col += 0.5)
+        {
+            xy.push_back(makePosition(row, col));
+            const double clampedRow = std::min(std::max(row, 0.0), 2.0);
+            const double clampedCol = std::min(std::max(col, 0.0), 3.0);
+            expected.push_back(gain(clampedRow, clampedCol));
+            expected.push_back(phase(clampedRow, clampedCol));
+        }
+    }
+    // More than one block
+    for (size_t ii = 0; xy.size() < 600; ++ii)
+    {
+        xy.push_back(xy[ii]);
+        expected.push_back(expected[2 * ii]);
+        expected.push_back(expected[2 * ii + 1]);
+    }
+
+    std::vector<float> out(xy.size() * 2);
+    view.sample(std::span<const crsd::Vector2>(xy.data(), xy.size()),
+                std::span<float>(out.data(), out.size()));
+    for (size_t ii = 0; ii < out.size(); ++ii)
+    {
+        TEST_ASSERT_ALMOST_EQ_EPS(out[ii], expected[ii], 1e-4);
+    }
+
+    std::vector<float> tooSmall(xy.size());
+    TEST_EXCEPTION(view.sample(
+            std::span<const crsd::Vector2>(xy.data(), xy.size()),
+            std::span<float>(tooSmall.data(), tooSmall.size())));
+
+    // Non-finite positions have no place on or off the grid
+    for (const double bad : {std::numeric_limits<double>::quiet_NaN(),
+                             std::numeric_limits<double>::infinity()})
+    {
+        std::vector<crsd::Vector2> badXY(xy.begin(), xy.begin() + 300);
+        badXY[299] = makePosition(1, bad);
+        TEST_EXCEPTION(view.sample(
+                std::span<const crsd::Vector2>(badXY.data(), badXY.size()),
+                std::span<float>(out.data(), badXY.size() * 2)));
+    }
+}
+
+TEST_CASE(testSampleSingleRow)
+{
+    auto values = std::make_shared<std::vector<std::byte> >(3 * sizeof(double));
+    const double row[] = {1, 2, 4};
+    memcpy(values->data(), row, sizeof(row));
+    const crsd::SupportArrayParameter parameter("DT=F8;", "DT", 0, 0, 1, 1);
+    const crsd::SupportArrayView<double> view(values, 1, 3, 1, parameter);
+
+    std::vector<crsd::Vector2> xy(3);
+    xy[0][0] = 5;
+    xy[0][1] = 0.5;
+    xy[1][0] = -2;
+    xy[1][1] = 1.75;
+    xy[2][0] = 0;
+    xy[2][1] = 9;
+    std::vector<double> out(3);
+    view.sample(std::span<const crsd::Vector2>(xy.data(), xy.size()),
+                std::span<double>(out.data(), out.size()));
+    TEST_ASSERT_ALMOST_EQ(out[0], 1.5);
+    TEST_ASSERT_ALMOST_EQ(out[1], 3.5);
+    TEST_ASSERT_ALMOST_EQ(out[2], 4.0);
+
+    TEST_EXCEPTION(crsd::SupportArrayView<double>(values, 2, 3, 1, parameter));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testDecodedValues);
+    TEST_CHECK(testSample);
+    TEST_CHECK(testSampleSingleRow);
+    )
@@ -0,0 +1,143 @@
+/* =========================================================================
+ * This file is part of crsd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <except/Exception.h>
+#include <sys/Runnable.h>
+#include <crsd/ThreadPool.h>
+
+#include "TestCase.h"
+
+namespace
+{
+class CountRunnable : public sys::Runnable
+{
+public:
+    explicit CountRunnable(std::atomic<size_t>& count) :
+        mCount(count)
+    {
+    }
+
+    virtual void run()
+    {
+        ++mCount;
+    }
+
+private:
+    std::atomic<size_t>& mCount;
+};
+
+class ThrowRunnable : public sys::Runnable
+{
+public:
+    virtual void run()
+    {
+        throw except::Exception(Ctxt("Task failed"));
+    }
+};
+
+std::vector<std::unique_ptr<sys::Runnable> > makeTasks(
+        std::atomic<size_t>& count, size_t numTasks)
+{
+    std::vector<std::unique_ptr<sys::Runnable> > tasks;
+    for (size_t ii = 0; ii < numTasks; ++ii)
+    {
+        tasks.push_back(std::unique_ptr<sys::Runnable>(
+                new CountRunnable(count)));
+    }
+    return tasks;
+}
+}
+
+TEST_CASE(testRunsAllTasks)
+{
+    for (size_t numThreads = 1; numThreads <= 4; ++numThreads)
+    {
+        crsd::ThreadPool pool(numThreads);
+        TEST_ASSERT_EQ(pool.getNumThreads(), numThreads);
+
+        // Reuse the same workers for many batches
+        for (size_t batch = 0; batch < 50; ++batch)
+        {
+            std::atomic<size_t> count(0);
+            pool.run(makeTasks(count, 7));
+            TEST_ASSERT_EQ(count.load(), static_cast<size_t>(7));
+        }
+    }
+}
+
+TEST_CASE(testConcurrentCallers)
+{
+    crsd::ThreadPool pool(3);
+    std::atomic<size_t> count(0);
+
+    std::vector<std::thread> callers;
+    for (size_t ii = 0; ii < 4; ++ii)
+    {
+        callers.emplace_back([&pool, &count]()
+        {
+            for (size_t batch = 0; batch < 25; ++batch)
+            {
+                pool.run(makeTasks(count, 5));
+            }
+        });
+    }
+    for (auto& caller : callers)
+    {
+        caller.join();
+    }
+    TEST_ASSERT_EQ(count.load(), static_cast<size_t>(4 * 25 * 5));
+}
+
+TEST_CASE(testTaskExceptionIsRethrown)
+{
+    crsd::ThreadPool pool(2);
+    std::atomic<size_t> count(0);
+    std::vector<std::unique_ptr<sys::Runnable> > tasks = makeTasks(count, 4);
+    tasks.push_back(std::unique_ptr<sys::Runnable>(new ThrowRunnable()));
+
+    TEST_EXCEPTION(pool.run(tasks));
+    TEST_ASSERT_EQ(count.load(), static_cast<size_t>(4));
+
+    // The pool is still usable afterwards
+    pool.run(makeTasks(count, 3));
+    TEST_ASSERT_EQ(count.load(), static_cast<size_t>(7));
+}
+
+TEST_CASE(testDefaultPool)
+{
+    const std::shared_ptr<crsd::ThreadPool> pool =
+            crsd::ThreadPool::getDefault();
+    TEST_ASSERT_TRUE(pool.get() != nullptr);
+    TEST_ASSERT_TRUE(pool == crsd::ThreadPool::getDefault());
+    TEST_ASSERT_TRUE(&crsd::getThreadPool(nullptr) == pool.get());
+}
+
+TEST_MAIN(
+    TEST_CHECK(testRunsAllTasks);
+    TEST_CHECK(testConcurrentCallers);
+    TEST_CHECK(testTaskExceptionIsRethrown);
+    TEST_CHECK(testDefaultPool);
+    )
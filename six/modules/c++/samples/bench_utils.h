@@ -0,0 +1,135 @@
+/* ==========================================================================
+* This file is part of six-c++
+* ==========================================================================
+*
+* (C) Copyright 2004 - 2017, MDA Information Systems LLC
+*
+* six-c++ is free software; you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this program; If not,
+* see <http://www.gnu.org/licenses/>.
+*
+*/
+#ifndef __SIX_BENCH_UTILS_H__
+#define __SIX_BENCH_UTILS_H__
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <except/Exception.h>
+#include <str/Convert.h>
+#include <str/Manip.h>
+
+/*!
+ *  Helpers shared by the CRSD and CPHD I/O benchmarks
+ */
+namespace bench
+{
+//! Best time of one operation at one thread count
+struct Result
+{
+    std::string name;
+    size_t numThreads;
+    double seconds;
+    double bytes;    // bytes moved per run
+    double vectors;  // vectors (or pulses) moved per run
+};
+
+//! Run 'func' 'iterations' times and return the fastest run, in seconds
+template <typename Func>
+double timeBest(size_t iterations, Func func)
+{
+    double best = std::numeric_limits<double>::max();
+    for (size_t ii = 0; ii < std::max<size_t>(iterations, 1); ++ii)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+//! Parse a comma separated list of thread counts, e.g. "1,2,4,8"
+inline std::vector<size_t> parseThreadCounts(const std::string& list)
+{
+    std::vector<size_t> threadCounts;
+    for (auto& count : str::split(list, ","))
+    {
+        str::trim(count);
+        if (!count.empty())
+        {
+            threadCounts.push_back(str::toType<size_t>(count));
+        }
+    }
+    if (threadCounts.empty())
+    {
+        throw except::Exception(Ctxt("No thread counts given"));
+    }
+    return threadCounts;
+}
+
+inline std::string quote(const std::string& value)
+{
+    std::string quoted = "\"";
+    for (const char ch : value)
+    {
+        if (ch == '"' || ch == '\\')
+        {
+            quoted += '\\';
+        }
+        quoted += ch;
+    }
+    return quoted + "\"";
+}
+
+/*!
+ *  Write the results as a JSON object:
+ *  {"benchmark": ..., "config": {...}, "results": [{"name", "threads",
+ *  "seconds", "MBps", "vectorsPerSecond"}, ...]}
+ */
+inline void writeJSON(
+        std::ostream& os,
+        const std::string& benchmark,
+        const std::vector<std::pair<std::string, std::string> >& config,
+        const std::vector<Result>& results)
+{
+    os << "{\n  \"benchmark\": " << quote(benchmark) << ",\n"
+       << "  \"config\": {";
+    for (size_t ii = 0; ii < config.size(); ++ii)
+    {
+        os << (ii == 0 ? "\n" : ",\n") << "    " << quote(config[ii].first)
+           << ": " << quote(config[ii].second);
+    }
+    os << "\n  },\n  \"results\": [";
+    for (size_t ii = 0; ii < results.size(); ++ii)
+    {
+        const Result& result = results[ii];
+        os << (ii == 0 ? "\n" : ",\n")
+           << "    {\"name\": " << quote(result.name)
+           << ", \"threads\": " << result.numThreads
+           << ", \"seconds\": " << result.seconds
+           << ", \"MBps\": " << result.bytes / result.seconds / 1e6
+           << ", \"vectorsPerSecond\": " << result.vectors / result.seconds
+           << "}";
+    }
+    os << "\n  ]\n}" << std::endl;
+}
+}
+
+#endif
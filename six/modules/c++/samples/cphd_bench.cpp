@@ -0,0 +1,335 @@
+/* ==========================================================================
+* This file is part of six-c++
+* ==========================================================================
+*
+* (C) Copyright 2004 - 2017, MDA Information Systems LLC
+*
+* six-c++ is free software; you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this program; If not,
+* see <http://www.gnu.org/licenses/>.
+*
+*/
+#include <stdint.h>
+
+#include <complex>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <import/cli.h>
+#include <io/FileInputStream.h>
+#include <io/TempFile.h>
+#include <str/Convert.h>
+#include <cphd/CPHDReader.h>
+#include <cphd/CPHDWriter.h>
+#include <cphd/Enums.h>
+#include <cphd/Metadata.h>
+#include <cphd/PVPBlock.h>
+#include <cphd/TestDataGenerator.h>
+#include <cphd/Wideband.h>
+
+#include "bench_utils.h"
+
+/*!
+ *  Measures CPHD I/O throughput on a synthetic file
+ *
+ *  A file of the requested size and sample format is generated with the
+ *  cphd TestDataGenerator. For each thread count, the best of several
+ *  runs is reported for writing the file, opening it, loading the PVP
+ *  array, and reading the signal arrays in full, in part (the center
+ *  quarter of each channel) and scaled to CF8.
+ */
+namespace
+{
+struct Config
+{
+    size_t numVectors = 0;
+    size_t numSamples = 0;
+    size_t numChannels = 0;
+    size_t iterations = 0;
+    std::vector<size_t> threadCounts;
+    std::string pathname;
+};
+
+// A deterministic ramp; the values don't matter, only the volume does
+template <typename T>
+std::vector<std::complex<T> > generateSignal(size_t length)
+{
+    std::vector<std::complex<T> > signal(length);
+    for (size_t ii = 0; ii < length; ++ii)
+    {
+        signal[ii] = std::complex<T>(static_cast<T>(ii % 64),
+                                     static_cast<T>((ii + 32) % 64));
+    }
+    return signal;
+}
+
+template <typename T>
+void setUpMetadata(const Config& config, cphd::Metadata& metadata)
+{
+    const types::RowCol<size_t> dims(config.numVectors, config.numSamples);
+    cphd::setUpData(metadata, dims, std::vector<std::complex<T> >(1));
+
+    // setUpData() only makes one channel; the rest are copies of it
+    auto& channels = metadata.data.channels;
+    const auto channel = channels[0];
+    channels.resize(config.numChannels, channel);
+    for (size_t ii = 0; ii < config.numChannels; ++ii)
+    {
+        channels[ii].identifier = "Channel" + str::toString(ii + 1);
+    }
+    cphd::setPVPXML(metadata.pvp);
+}
+
+template <typename T>
+std::vector<bench::Result> run(const Config& config)
+{
+    cphd::Metadata metadata;
+    setUpMetadata<T>(config, metadata);
+
+    cphd::PVPBlock pvpBlock(metadata.pvp, metadata.data);
+    double numPVPBytes = 0;
+    double numSignalBytes = 0;
+    double numVectors = 0;
+    for (size_t ii = 0; ii < config.numChannels; ++ii)
+    {
+        for (size_t jj = 0; jj < config.numVectors; ++jj)
+        {
+            cphd::setVectorParameters(ii, jj, pvpBlock);
+        }
+        numPVPBytes += pvpBlock.getPVPsize(ii);
+        numSignalBytes += static_cast<double>(config.numVectors) *
+                config.numSamples * sizeof(std::complex<T>);
+        numVectors += config.numVectors;
+    }
+
+    // Every channel holds the same samples
+    const std::vector<std::complex<T> > channelSignal =
+            generateSignal<T>(config.numVectors * config.numSamples);
+    std::vector<std::complex<T> > signal;
+    for (size_t ii = 0; ii < config.numChannels; ++ii)
+    {
+        signal.insert(signal.end(), channelSignal.begin(), channelSignal.end());
+    }
+
+    // Center quarter of each channel
+    const size_t firstVector = config.numVectors / 4;
+    const size_t lastVector = firstVector + (config.numVectors + 1) / 2 - 1;
+    const size_t firstSample = config.numSamples / 4;
+    const size_t lastSample = firstSample + (config.numSamples + 1) / 2 - 1;
+    const size_t partialElements = (lastVector - firstVector + 1) *
+            (lastSample - firstSample + 1);
+
+    std::vector<std::byte> readBuffer(
+            channelSignal.size() * sizeof(std::complex<T>));
+    std::vector<std::complex<float> > scaledBuffer(channelSignal.size());
+    const std::vector<double> scaleFactors(config.numVectors, 0.5);
+
+    std::vector<bench::Result> results;
+    for (const size_t numThreads : config.threadCounts)
+    {
+        auto add = [&](const std::string& name, double seconds,
+                       double bytes, double vectors)
+        {
+            const bench::Result result = {name, numThreads, seconds,
+                                          bytes, vectors};
+            results.push_back(result);
+        };
+
+        add("CPHDWriter::write",
+            bench::timeBest(config.iterations, [&]()
+            {
+                cphd::CPHDWriter writer(metadata,
+                                        config.pathname,
+                                        std::vector<std::string>(),
+                                        numThreads);
+                writer.write(pvpBlock, signal.data(),
+                             static_cast<const std::byte*>(nullptr));
+            }),
+            numSignalBytes + numPVPBytes, numVectors);
+
+        add("CPHDReader",
+            bench::timeBest(config.iterations, [&]()
+            {
+                cphd::CPHDReader reader(config.pathname, numThreads);
+            }),
+            numPVPBytes, numVectors);
+
+        cphd::CPHDReader reader(config.pathname, numThreads);
+        add("PVPBlock::load",
+            bench::timeBest(config.iterations, [&]()
+            {
+                io::FileInputStream inStream(config.pathname);
+                cphd::PVPBlock block(metadata.pvp, metadata.data);
+                block.load(inStream, reader.getFileHeader(), numThreads);
+            }),
+            numPVPBytes, numVectors);
+
+        const cphd::Wideband& wideband = reader.getWideband();
+        add("Wideband::read",
+            bench::timeBest(config.iterations, [&]()
+            {
+                for (size_t ii = 0; ii < config.numChannels; ++ii)
+                {
+                    wideband.read(ii, 0, cphd::Wideband::ALL,
+                                  0, cphd::Wideband::ALL, numThreads,
+                                  std::span<std::byte>(readBuffer.data(),
+                                                       readBuffer.size()));
+                }
+            }),
+            numSignalBytes, numVectors);
+
+        add("Wideband::read partial",
+            bench::timeBest(config.iterations, [&]()
+            {
+                for (size_t ii = 0; ii < config.numChannels; ++ii)
+                {
+                    wideband.read(ii, firstVector, lastVector,
+                                  firstSample, lastSample, numThreads,
+                                  std::span<std::byte>(
+                                          readBuffer.data(),
+                                          partialElements *
+                                                  sizeof(std::complex<T>)));
+                }
+            }),
+            static_cast<double>(config.numChannels) * partialElements *
+                    sizeof(std::complex<T>),
+            static_cast<double>(config.numChannels) *
+                    (lastVector - firstVector + 1));
+
+        add("Wideband::read scaled CF8",
+            bench::timeBest(config.iterations, [&]()
+            {
+                for (size_t ii = 0; ii < config.numChannels; ++ii)
+                {
+                    wideband.read(ii, 0, cphd::Wideband::ALL,
+                                  0, cphd::Wideband::ALL, scaleFactors,
+                                  numThreads,
+                                  std::span<std::byte>(readBuffer.data(),
+                                                       readBuffer.size()),
+                                  std::span<std::complex<float> >(
+                                          scaledBuffer.data(),
+                                          scaledBuffer.size()));
+                }
+            }),
+            numSignalBytes, numVectors);
+    }
+    return results;
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription("Benchmark CPHD writing and reading on a "
+                              "synthetic file.");
+        parser.addArgument("-v --vectors", "Vectors per channel",
+                           cli::STORE, "vectors")->setDefault(1024);
+        parser.addArgument("-s --samples", "Samples per vector",
+                           cli::STORE, "samples")->setDefault(1024);
+        parser.addArgument("-c --channels", "Number of channels",
+                           cli::STORE, "channels")->setDefault(1);
+        parser.addArgument("-f --format", "Signal array format (CI2, CI4 or CF8)",
+                           cli::STORE, "format")->setDefault("CF8");
+        parser.addArgument("--threads", "Comma separated thread counts",
+                           cli::STORE, "threads")->setDefault("1,2,4,8");
+        parser.addArgument("-i --iterations", "Runs per measurement; the "
+                           "fastest is reported",
+                           cli::STORE, "iterations")->setDefault(3);
+        parser.addArgument("--file", "CPHD file to write (default: a "
+                           "temporary file)",
+                           cli::STORE, "file")->setDefault("");
+        parser.addArgument("-o --output", "JSON output file (default: "
+                           "standard out)",
+                           cli::STORE, "output")->setDefault("");
+
+        const std::unique_ptr<cli::Results>
+            options(parser.parse(argc, (const char**) argv));
+
+        io::TempFile tempFile;
+        Config config;
+        config.numVectors = options->get<size_t>("vectors");
+        config.numSamples = options->get<size_t>("samples");
+        config.numChannels = options->get<size_t>("channels");
+        config.iterations = options->get<size_t>("iterations");
+        config.threadCounts =
+                bench::parseThreadCounts(options->get<std::string>("threads"));
+        config.pathname = options->get<std::string>("file");
+        if (config.pathname.empty())
+        {
+            config.pathname = tempFile.pathname();
+        }
+        if (config.numVectors == 0 || config.numSamples == 0 ||
+            config.numChannels == 0)
+        {
+            throw except::Exception(Ctxt(
+                    "Vectors, samples and channels must all be positive"));
+        }
+
+        const std::string format = options->get<std::string>("format");
+        std::vector<bench::Result> results;
+        switch (cphd::SignalArrayFormat::toType(format))
+        {
+        case cphd::SignalArrayFormat::CI2:
+            results = run<int8_t>(config);
+            break;
+        case cphd::SignalArrayFormat::CI4:
+            results = run<int16_t>(config);
+            break;
+        case cphd::SignalArrayFormat::CF8:
+            results = run<float>(config);
+            break;
+        default:
+            throw except::Exception(Ctxt("Invalid format " + format));
+        }
+
+        const std::vector<std::pair<std::string, std::string> > settings = {
+                {"vectors", str::toString(config.numVectors)},
+                {"samples", str::toString(config.numSamples)},
+                {"channels", str::toString(config.numChannels)},
+                {"format", format},
+                {"iterations", str::toString(config.iterations)}};
+
+        const std::string output = options->get<std::string>("output");
+        if (output.empty())
+        {
+            bench::writeJSON(std::cout, "cphd_bench", settings, results);
+        }
+        else
+        {
+            std::ofstream os(output.c_str());
+            bench::writeJSON(os, "cphd_bench", settings, results);
+        }
+        return 0;
+    }
+    catch (const except::Exception& e)
+    {
+        std::cerr << e.getMessage() << std::endl;
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,401 @@
+/* ==========================================================================
+* This file is part of six-c++
+* ==========================================================================
+*
+* (C) Copyright 2004 - 2017, MDA Information Systems LLC
+*
+* six-c++ is free software; you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this program; If not,
+* see <http://www.gnu.org/licenses/>.
+*
+*/
+#include <stdint.h>
+
+#include <complex>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <import/cli.h>
+#include <io/FileInputStream.h>
+#include <io/TempFile.h>
+#include <str/Convert.h>
+#include <crsd/CRSDReader.h>
+#include <crsd/CRSDWriter.h>
+#include <crsd/Enums.h>
+#include <crsd/Metadata.h>
+#include <crsd/PPPBlock.h>
+#include <crsd/PVPBlock.h>
+#include <crsd/TestDataGenerator.h>
+#include <crsd/Wideband.h>
+
+#include "bench_utils.h"
+
+/*!
+ *  Measures CRSD I/O throughput on a synthetic file
+ *
+ *  A file of the requested type, size and sample format is generated with
+ *  the crsd TestDataGenerator. For each thread count, the best of
+ *  several runs is reported for writing the file, opening it, loading the
+ *  PVP and PPP arrays, and reading the signal arrays in full, in part
+ *  (the center quarter of each channel) and scaled to CF8.
+ */
+namespace
+{
+struct Config
+{
+    six::CRSDType type = six::CRSDType::SAR;
+    size_t numVectors = 0;
+    size_t numSamples = 0;
+    size_t numChannels = 0;
+    size_t iterations = 0;
+    std::vector<size_t> threadCounts;
+    std::string pathname;
+};
+
+// A deterministic ramp; the values don't matter, only the volume does
+template <typename T>
+std::vector<std::complex<T> > generateSignal(size_t length)
+{
+    std::vector<std::complex<T> > signal(length);
+    for (size_t ii = 0; ii < length; ++ii)
+    {
+        signal[ii] = std::complex<T>(static_cast<T>(ii % 64),
+                                     static_cast<T>((ii + 32) % 64));
+    }
+    return signal;
+}
+
+template <typename T>
+void setUpMetadata(const Config& config, crsd::Metadata& metadata)
+{
+    const types::RowCol<size_t> dims(config.numVectors, config.numSamples);
+    crsd::setUpData(metadata, dims, std::vector<std::complex<T> >(1));
+
+    if (metadata.getType() != six::CRSDType::TX)
+    {
+        // setUpData() only makes one channel; the rest are copies of it
+        auto& channels = metadata.data.receiveParameters->channels;
+        auto& parameters = metadata.channel->parameters;
+        const auto channel = channels[0];
+        const auto channelParameters = parameters[0];
+        channels.resize(config.numChannels, channel);
+        parameters.resize(config.numChannels, channelParameters);
+        for (size_t ii = 0; ii < config.numChannels; ++ii)
+        {
+            const std::string identifier =
+                    "Channel" + str::toString(ii + 1);
+            channels[ii].identifier = identifier;
+            parameters[ii].identifier = identifier;
+        }
+        metadata.pvp.reset(new crsd::Pvp());
+        crsd::setPVPXML(*metadata.pvp);
+    }
+    if (metadata.getType() != six::CRSDType::RCV)
+    {
+        metadata.ppp.reset(new crsd::Ppp());
+        crsd::setPPPXML(*metadata.ppp);
+    }
+    metadata.setVersion("1.0.0");
+}
+
+template <typename T>
+std::vector<bench::Result> run(const Config& config)
+{
+    crsd::Metadata metadata(config.type);
+    setUpMetadata<T>(config, metadata);
+    const bool hasSignal = metadata.getType() != six::CRSDType::TX;
+    const bool hasPPP = metadata.getType() != six::CRSDType::RCV;
+
+    crsd::PVPBlock pvpBlock;
+    crsd::PPPBlock pppBlock;
+    double numPVPBytes = 0;
+    double numPPPBytes = 0;
+    double numSignalBytes = 0;
+    double numVectors = 0;
+    double numPulses = 0;
+    if (hasSignal)
+    {
+        pvpBlock = crsd::PVPBlock(*metadata.pvp, metadata.data);
+        for (size_t ii = 0; ii < config.numChannels; ++ii)
+        {
+            for (size_t jj = 0; jj < config.numVectors; ++jj)
+            {
+                crsd::setVectorParameters(ii, jj, pvpBlock);
+            }
+            numPVPBytes += pvpBlock.getPVPsize(ii);
+            numSignalBytes += static_cast<double>(config.numVectors) *
+                    config.numSamples * sizeof(std::complex<T>);
+            numVectors += config.numVectors;
+        }
+    }
+    if (hasPPP)
+    {
+        pppBlock = crsd::PPPBlock(*metadata.ppp, metadata.data);
+        for (size_t ii = 0; ii < metadata.data.getNumTxSequences(); ++ii)
+        {
+            for (size_t jj = 0; jj < metadata.data.getNumPulses(ii); ++jj)
+            {
+                crsd::setPulseParameters(ii, jj, pppBlock);
+            }
+            numPPPBytes += pppBlock.getPPPsize(ii);
+            numPulses += metadata.data.getNumPulses(ii);
+        }
+    }
+
+    // Every channel holds the same samples
+    const std::vector<std::complex<T> > channelSignal =
+            generateSignal<T>(hasSignal ? config.numVectors * config.numSamples : 0);
+    std::vector<std::complex<T> > signal;
+    for (size_t ii = 0; hasSignal && ii < config.numChannels; ++ii)
+    {
+        signal.insert(signal.end(), channelSignal.begin(), channelSignal.end());
+    }
+
+    // Center quarter of each channel
+    const size_t firstVector = config.numVectors / 4;
+    const size_t lastVector = firstVector + (config.numVectors + 1) / 2 - 1;
+    const size_t firstSample = config.numSamples / 4;
+    const size_t lastSample = firstSample + (config.numSamples + 1) / 2 - 1;
+    const size_t partialElements = (lastVector - firstVector + 1) *
+            (lastSample - firstSample + 1);
+
+    std::vector<std::byte> readBuffer(
+            signal.size() / std::max<size_t>(config.numChannels, 1) *
+            sizeof(std::complex<T>));
+    std::vector<std::complex<float> > scaledBuffer(channelSignal.size());
+    const std::vector<double> scaleFactors(config.numVectors, 0.5);
+
+    std::vector<bench::Result> results;
+    for (const size_t numThreads : config.threadCounts)
+    {
+        auto add = [&](const std::string& name, double seconds,
+                       double bytes, double vectors)
+        {
+            const bench::Result result = {name, numThreads, seconds,
+                                          bytes, vectors};
+            results.push_back(result);
+        };
+
+        add("CRSDWriter::write",
+            bench::timeBest(config.iterations, [&]()
+            {
+                crsd::CRSDWriter writer(metadata,
+                                        config.pathname,
+                                        std::vector<std::string>(),
+                                        numThreads);
+                writer.write(pvpBlock, pppBlock,
+                             hasSignal ? signal.data() : nullptr,
+                             static_cast<const std::byte*>(nullptr));
+            }),
+            numSignalBytes + numPVPBytes + numPPPBytes,
+            numVectors + numPulses);
+
+        add("CRSDReader",
+            bench::timeBest(config.iterations, [&]()
+            {
+                crsd::CRSDReader reader(config.pathname, numThreads);
+            }),
+            numPVPBytes + numPPPBytes, numVectors + numPulses);
+
+        crsd::CRSDReader reader(config.pathname, numThreads);
+        if (hasSignal)
+        {
+            add("PVPBlock::load",
+                bench::timeBest(config.iterations, [&]()
+                {
+                    io::FileInputStream inStream(config.pathname);
+                    crsd::PVPBlock block(*metadata.pvp, metadata.data);
+                    block.load(inStream, reader.getFileHeader(), numThreads);
+                }),
+                numPVPBytes, numVectors);
+        }
+        if (hasPPP)
+        {
+            add("PPPBlock::load",
+                bench::timeBest(config.iterations, [&]()
+                {
+                    io::FileInputStream inStream(config.pathname);
+                    crsd::PPPBlock block(*metadata.ppp, metadata.data);
+                    block.load(inStream, reader.getFileHeader(), numThreads);
+                }),
+                numPPPBytes, numPulses);
+        }
+        if (!hasSignal)
+        {
+            continue;
+        }
+
+        const crsd::Wideband& wideband = reader.getWideband();
+        add("Wideband::read",
+            bench::timeBest(config.iterations, [&]()
+            {
+                for (size_t ii = 0; ii < config.numChannels; ++ii)
+                {
+                    wideband.read(ii, 0, crsd::Wideband::ALL,
+                                  0, crsd::Wideband::ALL, numThreads,
+                                  std::span<std::byte>(readBuffer.data(),
+                                                       readBuffer.size()));
+                }
+            }),
+            numSignalBytes, numVectors);
+
+        add("Wideband::read partial",
+            bench::timeBest(config.iterations, [&]()
+            {
+                for (size_t ii = 0; ii < config.numChannels; ++ii)
+                {
+                    wideband.read(ii, firstVector, lastVector,
+                                  firstSample, lastSample, numThreads,
+                                  std::span<std::byte>(
+                                          readBuffer.data(),
+                                          partialElements *
+                                                  sizeof(std::complex<T>)));
+                }
+            }),
+            static_cast<double>(config.numChannels) * partialElements *
+                    sizeof(std::complex<T>),
+            static_cast<double>(config.numChannels) *
+                    (lastVector - firstVector + 1));
+
+        add("Wideband::read scaled CF8",
+            bench::timeBest(config.iterations, [&]()
+            {
+                for (size_t ii = 0; ii < config.numChannels; ++ii)
+                {
+                    wideband.read(ii, 0, crsd::Wideband::ALL,
+                                  0, crsd::Wideband::ALL, scaleFactors,
+                                  numThreads,
+                                  std::span<std::byte>(readBuffer.data(),
+                                                       readBuffer.size()),
+                                  std::span<std::complex<float> >(
+                                          scaledBuffer.data(),
+                                          scaledBuffer.size()));
+                }
+            }),
+            numSignalBytes, numVectors);
+    }
+    return results;
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription("Benchmark CRSD writing and reading on a "
+                              "synthetic file.");
+        parser.addArgument("-t --type", "CRSD type (SAR, TX or RCV)",
+                           cli::STORE, "type")->setDefault("SAR");
+        parser.addArgument("-v --vectors", "Vectors per channel",
+                           cli::STORE, "vectors")->setDefault(1024);
+        parser.addArgument("-s --samples", "Samples per vector",
+                           cli::STORE, "samples")->setDefault(1024);
+        parser.addArgument("-c --channels", "Number of channels",
+                           cli::STORE, "channels")->setDefault(1);
+        parser.addArgument("-f --format", "Signal array format (CI2, CI4 or CF8)",
+                           cli::STORE, "format")->setDefault("CF8");
+        parser.addArgument("--threads", "Comma separated thread counts",
+                           cli::STORE, "threads")->setDefault("1,2,4,8");
+        parser.addArgument("-i --iterations", "Runs per measurement; the "
+                           "fastest is reported",
+                           cli::STORE, "iterations")->setDefault(3);
+        parser.addArgument("--file", "CRSD file to write (default: a "
+                           "temporary file)",
+                           cli::STORE, "file")->setDefault("");
+        parser.addArgument("-o --output", "JSON output file (default: "
+                           "standard out)",
+                           cli::STORE, "output")->setDefault("");
+
+        const std::unique_ptr<cli::Results>
+            options(parser.parse(argc, (const char**) argv));
+
+        io::TempFile tempFile;
+        Config config;
+        const std::string type = options->get<std::string>("type");
+        config.type = six::CRSDType::toType(type);
+        config.numVectors = options->get<size_t>("vectors");
+        config.numSamples = options->get<size_t>("samples");
+        config.numChannels = options->get<size_t>("channels");
+        config.iterations = options->get<size_t>("iterations");
+        config.threadCounts =
+                bench::parseThreadCounts(options->get<std::string>("threads"));
+        config.pathname = options->get<std::string>("file");
+        if (config.pathname.empty())
+        {
+            config.pathname = tempFile.pathname();
+        }
+        if (config.numVectors == 0 || config.numSamples == 0 ||
+            config.numChannels == 0)
+        {
+            throw except::Exception(Ctxt(
+                    "Vectors, samples and channels must all be positive"));
+        }
+
+        const std::string format = options->get<std::string>("format");
+        std::vector<bench::Result> results;
+        switch (crsd::SignalArrayFormat::toType(format))
+        {
+        case crsd::SignalArrayFormat::CI2:
+            results = run<int8_t>(config);
+            break;
+        case crsd::SignalArrayFormat::CI4:
+            results = run<int16_t>(config);
+            break;
+        case crsd::SignalArrayFormat::CF8:
+            results = run<float>(config);
+            break;
+        default:
+            throw except::Exception(Ctxt("Invalid format " + format));
+        }
+
+        const std::vector<std::pair<std::string, std::string> > settings = {
+                {"type", type},
+                {"vectors", str::toString(config.numVectors)},
+                {"samples", str::toString(config.numSamples)},
+                {"channels", str::toString(config.numChannels)},
+                {"format", format},
+                {"iterations", str::toString(config.iterations)}};
+
+        const std::string output = options->get<std::string>("output");
+        if (output.empty())
+        {
+            bench::writeJSON(std::cout, "crsd_bench", settings, results);
+        }
+        else
+        {
+            std::ofstream os(output.c_str());
+            bench::writeJSON(os, "crsd_bench", settings, results);
+        }
+        return 0;
+    }
+    catch (const except::Exception& e)
+    {
+        std::cerr << e.getMessage() << std::endl;
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception" << std::endl;
+        return 1;
+    }
+}
@@ -30,6 +30,8 @@
 #include <memory>
 #include <vector>
 
+#include <std/span>
+
 #include <six/sicd/ImageData.h>
 
 namespace six
@@ -64,6 +66,20 @@ public:
      */
     AMP8I_PHS8I_t nearest_neighbor(const std::complex<float>& v) const;
 
+    /*!
+     * Get the nearest amplitude and phase value for every complex value.
+     *
+     * Most values are converted in single precision (with AVX2 when the CPU has it);
+     * any value close enough to a phase or magnitude boundary that float rounding
+     * could matter goes through nearest_neighbor() instead, so the results are
+     * always identical to calling nearest_neighbor() on each value.
+     * @param inputs complex values to query with
+     * @param results nearest amplitude and phase values; must be the same size as inputs
+     * @param vectorize false to always use the scalar code, even if the CPU has AVX2 (for testing)
+     */
+    void nearest_neighbors(std::span<const std::complex<float>> inputs, std::span<AMP8I_PHS8I_t> results,
+        bool vectorize = true) const;
+
 private:
     //! The sorted set of possible magnitudes order from small to large.
     std::vector<long double> uncached_magnitudes; // Order is important! This must be ...
@@ -73,6 +89,16 @@ private:
     long double phase_delta;
     //! Unit vector rays that represent each direction that phase can point.
     std::array<std::complex<long double>, UINT8_MAX + 1> phase_directions;
+
+    //! Single precision versions of the above for nearest_neighbors().
+    float phase_scale; // 1 / phase_delta
+    float phase_wrap; // 2PI / phase_delta
+    std::array<float, UINT8_MAX + 1> phase_directions_real;
+    std::array<float, UINT8_MAX + 1> phase_directions_imag;
+    //! Midpoints between consecutive magnitudes, bracketed by -inf and +inf.
+    std::array<float, UINT8_MAX + 2> magnitude_midpoints;
+    //! nearest_neighbor() of (+/-0, +/-0); the signs pick the phase.
+    std::array<AMP8I_PHS8I_t, 4> zero_neighbors;
 };
 }
 }
@@ -24,9 +24,16 @@
 #define __SIX_SICD_WRITE_CONTROL_H__
 #pragma once
 
-#include <vector>
+#include <atomic>
+#include <complex>
 #include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
+#include <std/span>
+#include <sys/File.h>
 #include <types/RowCol.h>
 #include <six/NITFWriteControl.h>
 #include <six/sicd/ComplexData.h>
@@ -48,6 +55,13 @@ namespace sicd
  * a use case where you will be getting/generating pixels gradually rather
  * than all at once, and you may get/generate them in an order other than the
  * order they'll be written to disk, you can use this class instead.
+ *
+ * Once initialized, save() may be called from any number of threads at once,
+ * e.g. by image formation workers each writing their own tiles as they finish
+ * them.  Any conversion or byte swapping is done on the calling thread, and
+ * the pixels are written straight to their place in the file with positional
+ * writes, so calls only contend for the moment it takes to record which
+ * pixels they covered.
  */
 class SICDWriteControl : public six::NITFWriteControl
 {
@@ -83,10 +97,9 @@ public:
     /*!
      * Writes a portion of the pixels to the file.  The first time this is
      * called, the headers will be written to the file.  This may be called
-     * as many times as desired with different AOIs in any order.
-     *
-     * TODO: No sanity checks are done that the offset and dims are within the
-     * global image dimensions.
+     * as many times as desired with different AOIs in any order, and from
+     * several threads at once provided their 'imageData' buffers are
+     * distinct.
      *
      * \param imageData The image data pixels to write.  The underlying type
      *     will be complex short or complex float based on the complex data
@@ -101,31 +114,81 @@ public:
      *     For memory efficiency, this is done in-place.  This flag controls
      *     if the incoming data should be swapped back afterwards.  By default,
      *     the data will be swapped back.
+     *
+     * \throw except::Exception If the AOI is not within the image
      */
     void save(void* imageData,
               const types::RowCol<size_t>& offset,
               const types::RowCol<size_t>& dims,
               bool restoreData = true);
 
+    /*!
+     * Same as above, but takes complex float pixels whatever the pixel type
+     * of the SICD and leaves them untouched.  For AMP8I_PHS8I they are
+     * converted using the amplitude table (honoring the AMP8I_PHS8I_CUTOFF
+     * option) and for RE32F_IM32F they are byte swapped, if needed, into a
+     * copy.
+     *
+     * \param imageData dims.area() pixels
+     *
+     * \throw except::Exception If the AOI is not within the image, the
+     *     wrong number of pixels is given or the pixel type is RE16I_IM16I
+     */
+    void save(std::span<const std::complex<float>> imageData,
+              const types::RowCol<size_t>& offset,
+              const types::RowCol<size_t>& dims);
+
+    /*!
+     * True once every pixel of the image has been passed to save()
+     */
+    bool isComplete() const;
+
     /*!
      * Closes the underlying IO interface.  This will occur implicitly in the
      * destructor if it's not called.
+     *
+     * \throw except::Exception If save() was called but some pixels of the
+     *     image were never written.  The file is closed either way.
      */
     void close();
 
 private:
     void writeHeaders();
 
+    void writeHeadersOnce();
+
+    // Writes pixels in the file's format, already byte swapped if needed
+    void writePixels(const std::byte* pixels,
+                     const types::RowCol<size_t>& offset,
+                     const types::RowCol<size_t>& dims);
+
+    void writeAt(nitf::Off offset, const std::byte* data, size_t size);
+
+    void markWritten(const types::RowCol<size_t>& offset,
+                     const types::RowCol<size_t>& dims);
+
     void write(const std::vector<sys::byte>& data);
     void write(const std::vector<std::byte>& data);
 
 private:
-    std::unique_ptr<nitf::IOInterface> mIO;
+    const std::string mOutputPathname;
+    std::unique_ptr<nitf::BufferedWriter> mIO;
     const std::vector<std::string> mSchemaPaths;
 
     std::vector<nitf::Off> mImageDataStart;
     std::vector<NITFSegmentInfo> mImageSegmentInfo;
-    bool mHaveWrittenHeaders;
+    //! Checked before taking mHeaderMutex, so save() only locks until the
+    //! headers are out
+    std::atomic<bool> mHaveWrittenHeaders;
+    std::mutex mHeaderMutex;
+
+    //! Second handle on the output for positional writes of the pixels
+    sys::File mPixelFile;
+
+    //! Columns written so far in each row, as [begin, end) keyed by begin
+    std::vector<std::map<size_t, size_t> > mColumnsWritten;
+    size_t mNumRowsComplete;
+    mutable std::mutex mCoverageMutex;
 };
 }
 }
@@ -24,6 +24,9 @@
 #include <math.h>
 
 #include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include <std/memory>
 
 #include <gsl/gsl.h>
@@ -31,6 +34,23 @@
 #include <math/Utilities.h>
 #include <units/Angles.h>
 
+// The AVX2 kernel is compiled with a function attribute and picked at runtime
+// based on what the CPU supports, so the library itself doesn't need to be
+// built with -mavx2.
+#if (defined(__GNUC__) || defined(__clang__)) && \
+        (defined(__x86_64__) || defined(__i386__))
+#define SIX_SICD_X86_SIMD 1
+#define SIX_SICD_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SIX_SICD_X86_SIMD 1
+#define SIX_SICD_TARGET(isa)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#define SIX_SICD_X86_SIMD 0
+#endif
+
 // https://github.com/ngageoint/six-library/pull/537#issuecomment-1026453353
 /*
 I can add more detail, but be warned that my powerpoint skills aren't amazing and this is best drawn on a whiteboard or graph paper.
@@ -114,7 +134,23 @@ six::sicd::details::ComplexToAMP8IPHS8I::ComplexToAMP8IPHS8I(const six::Amplitud
         long double y, x;
         SinCos(angle, y, x);
         phase_directions[i] = { x, y };
+        phase_directions_real[i] = static_cast<float>(x);
+        phase_directions_imag[i] = static_cast<float>(y);
+    }
+    phase_scale = static_cast<float>(1.0L / phase_delta);
+    phase_wrap = static_cast<float>((M_PI * 2.0) / phase_delta);
+
+    magnitude_midpoints.front() = -std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < UINT8_MAX; i++)
+    {
+        magnitude_midpoints[i + 1] = static_cast<float>((magnitudes[i] + magnitudes[i + 1]) / 2);
     }
+    magnitude_midpoints.back() = std::numeric_limits<float>::infinity();
+
+    zero_neighbors[0] = nearest_neighbor({ 0.0f, 0.0f });
+    zero_neighbors[1] = nearest_neighbor({ 0.0f, -0.0f });
+    zero_neighbors[2] = nearest_neighbor({ -0.0f, 0.0f });
+    zero_neighbors[3] = nearest_neighbor({ -0.0f, -0.0f });
 }
 
 /*!
@@ -158,6 +194,278 @@ six::sicd::AMP8I_PHS8I_t six::sicd::details::ComplexToAMP8IPHS8I::nearest_neighb
     return retval;
 }
 
+namespace
+{
+/*
+The single precision search mirrors nearest_neighbor():
+- phase is atan2() scaled by 1/phase_delta and rounded; atan() comes from a
+  polynomial on [0, 1] that is good to about 2e-6 radians.
+- the nearest magnitude is the number of magnitude midpoints below the projection,
+  found with a fixed eight step binary search instead of std::lower_bound().
+Any value within kPhaseMargin of a phase boundary (in units of phase_delta) or
+within kMagnitudeMargin * (|re| + |im|) of a magnitude midpoint is flagged for
+nearest_neighbor(); both margins are more than ten times the worst float error.
+So are zeros, infinities, NaNs and anything so small or large that denormals or
+overflow get involved.
+*/
+constexpr float kPhaseMargin = 1.0f / 512;
+constexpr float kMagnitudeMargin = 1.0f / (1 << 18);
+constexpr float kSmallest = 7.8886091e-31f; // 2^-100
+constexpr float kLargest = 1.2676506e30f; // 2^100
+
+constexpr float kPi = 3.14159265358979f;
+constexpr float kHalfPi = 1.57079632679490f;
+
+// atan(r) ~= r * P(r^2) for r in [0, 1]
+constexpr float kAtan0 = 0.99997723f;
+constexpr float kAtan1 = -0.33262283f;
+constexpr float kAtan2 = 0.19354032f;
+constexpr float kAtan3 = -0.11642635f;
+constexpr float kAtan4 = 0.052647196f;
+constexpr float kAtan5 = -0.011719072f;
+
+struct Lookup final
+{
+    float phaseScale;
+    float phaseWrap;
+    const float* directionsReal;
+    const float* directionsImag;
+    const float* midpoints; // UINT8_MAX + 2 values
+};
+
+// Converts 'size' values, writing the positions of those that still need
+// nearest_neighbor() to 'exact'; returns how many there are.
+typedef size_t (*EncodeKernel)(const Lookup& lookup,
+                               const std::complex<float>* inputs,
+                               size_t size,
+                               six::sicd::AMP8I_PHS8I_t* results,
+                               uint32_t* exact);
+
+size_t encodeScalar(const Lookup& lookup,
+                    const std::complex<float>* inputs,
+                    size_t size,
+                    six::sicd::AMP8I_PHS8I_t* results,
+                    uint32_t* exact)
+{
+    size_t numExact = 0;
+    for (size_t ii = 0; ii < size; ++ii)
+    {
+        const float re = inputs[ii].real();
+        const float im = inputs[ii].imag();
+        const float ax = std::abs(re);
+        const float ay = std::abs(im);
+        const float mx = std::max(ax, ay);
+        if (!(mx >= kSmallest && mx <= kLargest))
+        {
+            exact[numExact++] = static_cast<uint32_t>(ii);
+            continue;
+        }
+
+        const float r = std::min(ax, ay) / mx;
+        const float z = r * r;
+        float atn = ((((kAtan5 * z + kAtan4) * z + kAtan3) * z + kAtan2) * z + kAtan1) * z + kAtan0;
+        atn *= r;
+        if (ay > ax) atn = kHalfPi - atn;
+        if (re < 0) atn = kPi - atn;
+        const float t = im < 0 ? lookup.phaseWrap - atn * lookup.phaseScale : atn * lookup.phaseScale;
+        const float rounded = std::nearbyint(t);
+        const auto phase = static_cast<uint32_t>(rounded) & UINT8_MAX;
+
+        const float projection = lookup.directionsReal[phase] * re + lookup.directionsImag[phase] * im;
+        uint32_t amplitude = 0;
+        for (uint32_t step = 128; step > 0; step >>= 1)
+        {
+            amplitude += lookup.midpoints[amplitude + step] < projection ? step : 0;
+        }
+
+        const float tolerance = kMagnitudeMargin * (ax + ay);
+        if (std::abs(t - rounded) < 0.5f - kPhaseMargin &&
+            projection - lookup.midpoints[amplitude] > tolerance &&
+            lookup.midpoints[amplitude + 1] - projection > tolerance)
+        {
+            results[ii] = { static_cast<uint8_t>(amplitude), static_cast<uint8_t>(phase) };
+        }
+        else
+        {
+            exact[numExact++] = static_cast<uint32_t>(ii);
+        }
+    }
+    return numExact;
+}
+
+#if SIX_SICD_X86_SIMD
+// Eight values per step
+SIX_SICD_TARGET("avx2")
+size_t encodeAVX2(const Lookup& lookup,
+                  const std::complex<float>* inputs,
+                  size_t size,
+                  six::sicd::AMP8I_PHS8I_t* results,
+                  uint32_t* exact)
+{
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256i byteMask = _mm256_set1_epi32(UINT8_MAX);
+    const __m256 phaseScale = _mm256_set1_ps(lookup.phaseScale);
+    const __m256 phaseWrap = _mm256_set1_ps(lookup.phaseWrap);
+    const __m256 phaseLimit = _mm256_set1_ps(0.5f - kPhaseMargin);
+    const __m256 magnitudeMargin = _mm256_set1_ps(kMagnitudeMargin);
+
+    size_t numExact = 0;
+    size_t ii = 0;
+    for (; ii + 8 <= size; ii += 8)
+    {
+        // re0 im0 re1 im1 ... -> re0 ... re7, im0 ... im7
+        const float* const in = reinterpret_cast<const float*>(inputs + ii);
+        const __m256 lo = _mm256_loadu_ps(in);
+        const __m256 hi = _mm256_loadu_ps(in + 8);
+        const __m256 re = _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))),
+                _MM_SHUFFLE(3, 1, 2, 0)));
+        const __m256 im = _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))),
+                _MM_SHUFFLE(3, 1, 2, 0)));
+
+        const __m256 ax = _mm256_and_ps(re, absMask);
+        const __m256 ay = _mm256_and_ps(im, absMask);
+        const __m256 mx = _mm256_max_ps(ax, ay);
+        const __m256 regular = _mm256_and_ps(
+                _mm256_cmp_ps(mx, _mm256_set1_ps(kSmallest), _CMP_GE_OQ),
+                _mm256_cmp_ps(mx, _mm256_set1_ps(kLargest), _CMP_LE_OQ));
+
+        const __m256 r = _mm256_div_ps(_mm256_min_ps(ax, ay), mx);
+        const __m256 z = _mm256_mul_ps(r, r);
+        __m256 atn = _mm256_set1_ps(kAtan5);
+        atn = _mm256_add_ps(_mm256_mul_ps(atn, z), _mm256_set1_ps(kAtan4));
+        atn = _mm256_add_ps(_mm256_mul_ps(atn, z), _mm256_set1_ps(kAtan3));
+        atn = _mm256_add_ps(_mm256_mul_ps(atn, z), _mm256_set1_ps(kAtan2));
+        atn = _mm256_add_ps(_mm256_mul_ps(atn, z), _mm256_set1_ps(kAtan1));
+        atn = _mm256_add_ps(_mm256_mul_ps(atn, z), _mm256_set1_ps(kAtan0));
+        atn = _mm256_mul_ps(atn, r);
+        atn = _mm256_blendv_ps(atn, _mm256_sub_ps(_mm256_set1_ps(kHalfPi), atn),
+                               _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+        atn = _mm256_blendv_ps(atn, _mm256_sub_ps(_mm256_set1_ps(kPi), atn),
+                               _mm256_cmp_ps(re, zero, _CMP_LT_OQ));
+        const __m256 scaled = _mm256_mul_ps(atn, phaseScale);
+        const __m256 t = _mm256_blendv_ps(scaled, _mm256_sub_ps(phaseWrap, scaled),
+                                          _mm256_cmp_ps(im, zero, _CMP_LT_OQ));
+        const __m256 rounded = _mm256_round_ps(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        const __m256i phase = _mm256_and_si256(_mm256_cvttps_epi32(rounded), byteMask);
+
+        const __m256 projection = _mm256_add_ps(
+                _mm256_mul_ps(_mm256_i32gather_ps(lookup.directionsReal, phase, 4), re),
+                _mm256_mul_ps(_mm256_i32gather_ps(lookup.directionsImag, phase, 4), im));
+        __m256i amplitude = _mm256_setzero_si256();
+        for (int step = 128; step > 0; step >>= 1)
+        {
+            const __m256i stepV = _mm256_set1_epi32(step);
+            const __m256 midpoint = _mm256_i32gather_ps(lookup.midpoints, _mm256_add_epi32(amplitude, stepV), 4);
+            const __m256 below = _mm256_cmp_ps(midpoint, projection, _CMP_LT_OQ);
+            amplitude = _mm256_add_epi32(amplitude, _mm256_and_si256(_mm256_castps_si256(below), stepV));
+        }
+
+        const __m256 tolerance = _mm256_mul_ps(magnitudeMargin, _mm256_add_ps(ax, ay));
+        const __m256 lower = _mm256_i32gather_ps(lookup.midpoints, amplitude, 4);
+        const __m256 upper = _mm256_i32gather_ps(lookup.midpoints, _mm256_add_epi32(amplitude, _mm256_set1_epi32(1)), 4);
+        __m256 ok = _mm256_and_ps(regular,
+                _mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(t, rounded), absMask), phaseLimit, _CMP_LT_OQ));
+        ok = _mm256_and_ps(ok, _mm256_cmp_ps(_mm256_sub_ps(projection, lower), tolerance, _CMP_GT_OQ));
+        ok = _mm256_and_ps(ok, _mm256_cmp_ps(_mm256_sub_ps(upper, projection), tolerance, _CMP_GT_OQ));
+
+        alignas(32) uint32_t packed[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(packed),
+                           _mm256_or_si256(amplitude, _mm256_slli_epi32(phase, 8)));
+        const int okMask = _mm256_movemask_ps(ok);
+        for (size_t jj = 0; jj < 8; ++jj)
+        {
+            if (okMask & (1 << jj))
+            {
+                results[ii + jj] = { static_cast<uint8_t>(packed[jj]), static_cast<uint8_t>(packed[jj] >> 8) };
+            }
+            else
+            {
+                exact[numExact++] = static_cast<uint32_t>(ii + jj);
+            }
+        }
+    }
+
+    const size_t numTail = encodeScalar(lookup, inputs + ii, size - ii, results + ii, exact + numExact);
+    for (size_t jj = 0; jj < numTail; ++jj)
+    {
+        exact[numExact++] += static_cast<uint32_t>(ii);
+    }
+    return numExact;
+}
+
+bool hasAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (maxLeaf >= 7 && osxsave && avx &&
+        (_xgetbv(0) & 0x6) == 0x6)  // OS saves XMM and YMM state
+    {
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+    return false;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+EncodeKernel getEncodeKernel()
+{
+#if SIX_SICD_X86_SIMD
+    static const EncodeKernel kernel = hasAVX2() ? &encodeAVX2 : &encodeScalar;
+    return kernel;
+#else
+    return &encodeScalar;
+#endif
+}
+}
+
+void six::sicd::details::ComplexToAMP8IPHS8I::nearest_neighbors(std::span<const std::complex<float>> inputs,
+    std::span<AMP8I_PHS8I_t> results, bool vectorize) const
+{
+    if (inputs.size() != results.size())
+    {
+        throw std::invalid_argument("inputs and results must be the same size");
+    }
+
+    const Lookup lookup{ phase_scale, phase_wrap,
+        phase_directions_real.data(), phase_directions_imag.data(), magnitude_midpoints.data() };
+    const EncodeKernel encode = vectorize ? getEncodeKernel() : &encodeScalar;
+
+    constexpr size_t blockSize = 4096;
+    uint32_t exact[blockSize];
+    for (size_t start = 0; start < inputs.size(); start += blockSize)
+    {
+        const auto size = std::min(blockSize, inputs.size() - start);
+        const auto pInputs = inputs.data() + start;
+        const auto pResults = results.data() + start;
+        const auto numExact = encode(lookup, pInputs, size, pResults, exact);
+        for (size_t ii = 0; ii < numExact; ++ii)
+        {
+            const auto& v = pInputs[exact[ii]];
+            if ((v.real() == 0.0f) && (v.imag() == 0.0f))
+            {
+                pResults[exact[ii]] = zero_neighbors[(std::signbit(v.real()) ? 2 : 0) + (std::signbit(v.imag()) ? 1 : 0)];
+            }
+            else
+            {
+                pResults[exact[ii]] = nearest_neighbor(v);
+            }
+        }
+    }
+}
+
 const six::sicd::details::ComplexToAMP8IPHS8I* six::sicd::details::ComplexToAMP8IPHS8I::make(const six::AmplitudeTable* pAmplitudeTable,
     std::unique_ptr<ComplexToAMP8IPHS8I>& pTree)
 {
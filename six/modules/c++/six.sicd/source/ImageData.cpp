@@ -23,6 +23,7 @@
 
 #include <stdexcept>
 #include <array>
+#include <functional>
 #include <std/memory>
 
 #include <gsl/gsl.h>
@@ -254,19 +255,40 @@ void ImageData::from_AMP8I_PHS8I(const input_amplitudes_t& values, std::span<con
     }
 }
 
-template<typename TConverter>
+static void to_AMP8I_PHS8I_async(std::span<const cx_float> inputs, std::span<AMP8I_PHS8I_t> results,
+    const six::sicd::details::ComplexToAMP8IPHS8I& tree, size_t cutoff)
+{
+    // Same splitting as mt::transform_async(), but each piece is converted in one batch.
+    const auto len = inputs.size();
+    if ((len < cutoff) || (len < 2))
+    {
+        tree.nearest_neighbors(inputs, results);
+        return;
+    }
+
+    const auto mid = len / 2;
+    const std::span<const cx_float> inputs2(inputs.data() + mid, len - mid);
+    const std::span<AMP8I_PHS8I_t> results2(results.data() + mid, len - mid);
+    auto handle = std::async(std::launch::async, to_AMP8I_PHS8I_async, inputs2, results2, std::ref(tree), cutoff);
+    to_AMP8I_PHS8I_async(std::span<const cx_float>(inputs.data(), mid), std::span<AMP8I_PHS8I_t>(results.data(), mid), tree, cutoff);
+    handle.get();
+}
+
 static void to_AMP8I_PHS8I_(std::span<const cx_float> inputs, std::span<AMP8I_PHS8I_t> results,
-    const TConverter& tree, ptrdiff_t cutoff_)
+    const six::sicd::details::ComplexToAMP8IPHS8I& tree, ptrdiff_t cutoff_)
 {
-    const auto nearest_neighbor_f = [&](const std::complex<float>& v)
+    if (inputs.size() != results.size())
     {
-        return tree.nearest_neighbor(v);
-    };
+        throw std::invalid_argument("inputs and results must be the same size");
+    }
+    if (inputs.empty())
+    {
+        return;
+    }
 
     if (cutoff_ < 0)
     {
-        (void) std::transform(inputs.begin(), inputs.end(), results.begin(),
-            nearest_neighbor_f);
+        tree.nearest_neighbors(inputs, results);
     }
     else
     {
@@ -274,8 +296,7 @@ static void to_AMP8I_PHS8I_(std::span<const cx_float> inputs, std::span<AMP8I_PH
         constexpr auto dimension = 128 * 8;
         constexpr auto default_cutoff = dimension * dimension;
         const auto cutoff = cutoff_ == 0 ? default_cutoff : cutoff_;
-        (void) mt::transform_async(inputs.begin(), inputs.end(), results.begin(),
-            nearest_neighbor_f, cutoff, std::launch::async);
+        to_AMP8I_PHS8I_async(inputs, results, tree, gsl::narrow<size_t>(cutoff));
     }
 }
 void ImageData::to_AMP8I_PHS8I(std::span<const cx_float> inputs, std::span<AMP8I_PHS8I_t> results,
@@ -20,19 +20,91 @@
  *
  */
 
-#include <six/sicd/SICDByteProvider.h>
 #include <six/sicd/SICDWriteControl.h>
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <string>
+
+#include <except/Exception.h>
+#include <gsl/gsl.h>
+#include <sys/SystemException.h>
+
+#include <six/sicd/ImageData.h>
+#include <six/sicd/SICDByteProvider.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Adds [begin, end) to a set of disjoint intervals, merging any it touches
+void addInterval(std::map<size_t, size_t>& intervals, size_t begin, size_t end)
+{
+    auto iter = intervals.upper_bound(begin);
+    if (iter != intervals.begin())
+    {
+        auto previous = std::prev(iter);
+        if (previous->second >= begin)
+        {
+            begin = previous->first;
+            end = std::max(end, previous->second);
+            iter = intervals.erase(previous);
+        }
+    }
+    while (iter != intervals.end() && iter->first <= end)
+    {
+        end = std::max(end, iter->second);
+        iter = intervals.erase(iter);
+    }
+    intervals[begin] = end;
+}
+
+// First column of a row that hasn't been written, or numCols if none
+size_t getFirstMissingColumn(const std::map<size_t, size_t>& columns,
+                             size_t numCols)
+{
+    if (columns.empty() || columns.begin()->first != 0)
+    {
+        return 0;
+    }
+    return std::min(columns.begin()->second, numCols);
+}
+
+void checkAOI(const types::RowCol<size_t>& offset,
+              const types::RowCol<size_t>& dims,
+              const types::RowCol<size_t>& extent)
+{
+    if (offset.row + dims.row > extent.row ||
+        offset.col + dims.col > extent.col)
+    {
+        throw except::Exception(Ctxt(
+                "AOI at " + std::to_string(offset.row) + ", " +
+                std::to_string(offset.col) + " of " +
+                std::to_string(dims.row) + " x " + std::to_string(dims.col) +
+                " is outside the " + std::to_string(extent.row) + " x " +
+                std::to_string(extent.col) + " image"));
+    }
+}
+}
+
 namespace six
 {
 namespace sicd
 {
 SICDWriteControl::SICDWriteControl(const std::string& outputPathname,
                                    const std::vector<std::string>& schemaPaths) :
+    mOutputPathname(outputPathname),
     mIO(new nitf::BufferedWriter(outputPathname,
                                  NITFHeaderCreator::DEFAULT_BUFFER_SIZE)),
     mSchemaPaths(schemaPaths),
-    mHaveWrittenHeaders(false)
+    mHaveWrittenHeaders(false),
+    mNumRowsComplete(0)
 {
 }
 
@@ -87,12 +159,18 @@ void SICDWriteControl::writeHeaders()
     // Write DES subheader and data (i.e. XML)
     mIO->seek(byteProvider.getDesSubheaderFileOffset(), NITF_SEEK_SET);
     write(byteProvider.getDesSubheaderAndData());
+
+    // The pixels go straight to the file from here on, so nothing can be
+    // left sitting in the buffer
+    mIO->flushBuffer();
+    mPixelFile.create(mOutputPathname, sys::File::WRITE_ONLY,
+                      sys::File::EXISTING);
+
+    mColumnsWritten.assign(getContainer()->getData(0)->getNumRows(),
+                           std::map<size_t, size_t>());
 }
 
-void SICDWriteControl::save(void* imageData,
-                            const types::RowCol<size_t>& offset,
-                            const types::RowCol<size_t>& dims,
-                            bool restoreData)
+void SICDWriteControl::writeHeadersOnce()
 {
     if (getContainer().get() == nullptr)
     {
@@ -100,27 +178,105 @@ void SICDWriteControl::save(void* imageData,
                 "initialize() must be called prior to calling save()"));
     }
 
+    if (mHaveWrittenHeaders.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
     // The first time through we'll write out all the headers
-    if (!mHaveWrittenHeaders)
+    std::lock_guard<std::mutex> lock(mHeaderMutex);
+    if (!mHaveWrittenHeaders.load(std::memory_order_relaxed))
     {
         writeHeaders();
-        mHaveWrittenHeaders = true;
+        mHaveWrittenHeaders.store(true, std::memory_order_release);
     }
+}
 
-    const six::Data* const data = getContainer()->getData(0);
-    constexpr size_t NUM_BANDS = 2;
-    const size_t numBytesPerPixel = data->getNumBytesPerPixel() / NUM_BANDS;
-    const size_t numPixelsTotal = dims.area() * NUM_BANDS;
-    const bool doByteSwap = shouldByteSwap();
+#if defined(_WIN32)
+void SICDWriteControl::writeAt(nitf::Off offset,
+                               const std::byte* data,
+                               size_t size)
+{
+    static const size_t MAX_WRITE_SIZE = std::numeric_limits<DWORD>::max();
 
-    // Byte swap if needed
-    if (doByteSwap)
+    size_t bytesWritten = 0;
+    while (bytesWritten < size)
     {
-        sys::byteSwap(imageData,
-                      static_cast<unsigned short>(numBytesPerPixel),
-                      numPixelsTotal);
+        const DWORD bytesToWrite = static_cast<DWORD>(
+                std::min(MAX_WRITE_SIZE, size - bytesWritten));
+        const uint64_t position = static_cast<uint64_t>(offset) + bytesWritten;
+
+        // An explicit offset in the OVERLAPPED struct makes this a
+        // positional write on a synchronous handle
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+        DWORD bytesThisWrite = 0;
+        if (!WriteFile(mPixelFile.getHandle(),
+                       data + bytesWritten,
+                       bytesToWrite,
+                       &bytesThisWrite,
+                       &overlapped))
+        {
+            throw sys::SystemException(Ctxt("Error writing to file"));
+        }
+        bytesWritten += bytesThisWrite;
+    }
+}
+#else
+void SICDWriteControl::writeAt(nitf::Off offset,
+                               const std::byte* data,
+                               size_t size)
+{
+    size_t bytesWritten = 0;
+    while (bytesWritten < size)
+    {
+        const ssize_t bytesThisWrite =
+                ::pwrite(mPixelFile.getHandle(),
+                         data + bytesWritten,
+                         size - bytesWritten,
+                         static_cast<off_t>(offset + bytesWritten));
+        if (bytesThisWrite < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+            {
+                continue;
+            }
+            throw sys::SystemException(Ctxt("Error writing to file"));
+        }
+        bytesWritten += static_cast<size_t>(bytesThisWrite);
+    }
+}
+#endif
+
+void SICDWriteControl::markWritten(const types::RowCol<size_t>& offset,
+                                   const types::RowCol<size_t>& dims)
+{
+    const size_t globalNumCols = getContainer()->getData(0)->getNumCols();
+
+    std::lock_guard<std::mutex> lock(mCoverageMutex);
+    for (size_t row = offset.row; row < offset.row + dims.row; ++row)
+    {
+        auto& columns = mColumnsWritten[row];
+        if (getFirstMissingColumn(columns, globalNumCols) < globalNumCols)
+        {
+            addInterval(columns, offset.col, offset.col + dims.col);
+            if (getFirstMissingColumn(columns, globalNumCols) ==
+                globalNumCols)
+            {
+                ++mNumRowsComplete;
+            }
+        }
     }
+}
 
+void SICDWriteControl::writePixels(const std::byte* pixels,
+                                   const types::RowCol<size_t>& offset,
+                                   const types::RowCol<size_t>& dims)
+{
+    const six::Data* const data = getContainer()->getData(0);
+    const size_t numBytesPerPixel = data->getNumBytesPerPixel();
     const size_t globalNumCols = data->getNumCols();
 
     for (size_t seg = 0; seg < mImageSegmentInfo.size(); ++seg)
@@ -133,13 +289,12 @@ void SICDWriteControl::save(void* imageData,
                                        startGlobalRowToWrite,
                                        numRowsToWrite))
         {
-            // Figure out what offset of 'imageData' we're writing from
+            // Figure out what offset of 'pixels' we're writing from
             const size_t startLocalRowToWrite =
                     startGlobalRowToWrite - offset.row;
-            const size_t numBytesPerRow = dims.col * numBytesPerPixel * NUM_BANDS;
+            const size_t numBytesPerRow = dims.col * numBytesPerPixel;
             const std::byte* imageDataPtr =
-                    static_cast<std::byte*>(imageData) +
-                    startLocalRowToWrite * numBytesPerRow;
+                    pixels + startLocalRowToWrite * numBytesPerRow;
 
             // Now figure out our offset into the segment
             const auto segStartRow = imageSegmentInfo.getFirstRow();
@@ -148,36 +303,61 @@ void SICDWriteControl::save(void* imageData,
             const size_t pixelOffset =
                     startRowInSegToWrite * globalNumCols + offset.col;
             size_t byteOffset = mImageDataStart[seg] +
-                    pixelOffset * numBytesPerPixel * NUM_BANDS;
+                    pixelOffset * numBytesPerPixel;
 
             // TODO: For SIDD we'll have to handle blocking too
 
             if (dims.col == globalNumCols)
             {
                 // Life is easy - one write
-                mIO->seek(static_cast<nitf::Off>(byteOffset), NITF_SEEK_SET);
-                mIO->write(imageDataPtr,
-                           numRowsToWrite * dims.col * NUM_BANDS *
-                               numBytesPerPixel);
+                writeAt(static_cast<nitf::Off>(byteOffset), imageDataPtr,
+                        numRowsToWrite * numBytesPerRow);
             }
             else
             {
                 // Need to write out partial rows
-                const size_t rowSeekStride =
-                        globalNumCols * numBytesPerPixel * NUM_BANDS;
+                const size_t rowSeekStride = globalNumCols * numBytesPerPixel;
 
                 for (size_t row = 0;
                      row < numRowsToWrite;
                      ++row, byteOffset += rowSeekStride,
                          imageDataPtr += numBytesPerRow)
                 {
-                    mIO->seek(static_cast<nitf::Off>(byteOffset), NITF_SEEK_SET);
-                    mIO->write(imageDataPtr, numBytesPerRow);
+                    writeAt(static_cast<nitf::Off>(byteOffset), imageDataPtr,
+                            numBytesPerRow);
                 }
             }
         }
     }
 
+    markWritten(offset, dims);
+}
+
+void SICDWriteControl::save(void* imageData,
+                            const types::RowCol<size_t>& offset,
+                            const types::RowCol<size_t>& dims,
+                            bool restoreData)
+{
+    writeHeadersOnce();
+
+    const six::Data* const data = getContainer()->getData(0);
+    checkAOI(offset, dims, getExtent(*data));
+
+    constexpr size_t NUM_BANDS = 2;
+    const size_t numBytesPerPixel = data->getNumBytesPerPixel() / NUM_BANDS;
+    const size_t numPixelsTotal = dims.area() * NUM_BANDS;
+    const bool doByteSwap = shouldByteSwap();
+
+    // Byte swap if needed
+    if (doByteSwap)
+    {
+        sys::byteSwap(imageData,
+                      static_cast<unsigned short>(numBytesPerPixel),
+                      numPixelsTotal);
+    }
+
+    writePixels(static_cast<const std::byte*>(imageData), offset, dims);
+
     // Byte swap back if needed
     if (doByteSwap && restoreData)
     {
@@ -187,9 +367,102 @@ void SICDWriteControl::save(void* imageData,
     }
 }
 
+void SICDWriteControl::save(std::span<const std::complex<float>> pixels,
+                            const types::RowCol<size_t>& offset,
+                            const types::RowCol<size_t>& dims)
+{
+    writeHeadersOnce();
+
+    const six::Data* const data = getContainer()->getData(0);
+    checkAOI(offset, dims, getExtent(*data));
+    if (pixels.size() != dims.area())
+    {
+        throw except::Exception(Ctxt(
+                "Expected " + std::to_string(dims.area()) + " pixels but got " +
+                std::to_string(pixels.size())));
+    }
+    if (pixels.empty())
+    {
+        return;
+    }
+    const auto pixelType = data->getPixelType();
+    if (pixelType == PixelType::AMP8I_PHS8I)
+    {
+        static const Parameter defaultCutoff(
+                WriteControl::AMP8I_PHS8I_DEFAULT_CUTOFF);
+        const ptrdiff_t cutoff = getOptions().getParameter(
+                WriteControl::AMP8I_PHS8I_CUTOFF, defaultCutoff);
+
+        std::vector<AMP8I_PHS8I_t> converted(dims.area());
+        const auto& complexData = static_cast<const ComplexData&>(*data);
+        complexData.imageData->to_AMP8I_PHS8I(
+                pixels, std::span<AMP8I_PHS8I_t>(converted.data(),
+                                                  converted.size()),
+                cutoff);
+        writePixels(reinterpret_cast<const std::byte*>(converted.data()),
+                    offset, dims);
+    }
+    else if (pixelType == PixelType::RE32F_IM32F)
+    {
+        if (shouldByteSwap())
+        {
+            std::vector<std::complex<float>> swapped(pixels.begin(),
+                                                     pixels.end());
+            sys::byteSwap(swapped.data(),
+                          static_cast<unsigned short>(sizeof(float)),
+                          swapped.size() * 2);
+            writePixels(reinterpret_cast<const std::byte*>(swapped.data()),
+                        offset, dims);
+        }
+        else
+        {
+            writePixels(reinterpret_cast<const std::byte*>(pixels.data()),
+                        offset, dims);
+        }
+    }
+    else
+    {
+        throw except::Exception(Ctxt(
+                "Complex float pixels cannot be saved as " +
+                pixelType.toString()));
+    }
+}
+
+bool SICDWriteControl::isComplete() const
+{
+    std::lock_guard<std::mutex> lock(mCoverageMutex);
+    return !mColumnsWritten.empty() &&
+            mNumRowsComplete == mColumnsWritten.size();
+}
+
 void SICDWriteControl::close()
 {
     mIO->close();
+    if (mPixelFile.isOpen())
+    {
+        mPixelFile.close();
+    }
+
+    if (mHaveWrittenHeaders && !isComplete())
+    {
+        const size_t numCols = getContainer()->getData(0)->getNumCols();
+
+        std::lock_guard<std::mutex> lock(mCoverageMutex);
+        for (size_t row = 0; row < mColumnsWritten.size(); ++row)
+        {
+            const size_t col =
+                    getFirstMissingColumn(mColumnsWritten[row], numCols);
+            if (col < numCols)
+            {
+                throw except::Exception(Ctxt(
+                        "Pixel " + std::to_string(row) + ", " +
+                        std::to_string(col) + " was never saved (" +
+                        std::to_string(mColumnsWritten.size() -
+                                       mNumRowsComplete) +
+                        " rows are incomplete)"));
+            }
+        }
+    }
 }
 }
 }
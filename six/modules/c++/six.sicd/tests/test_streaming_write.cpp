@@ -24,8 +24,11 @@
 // Demonstrates that streaming writes result in equivalent SICDs to the normal
 // writes via NITFWriteControl
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "TestUtilities.h"
 
@@ -105,11 +108,12 @@ struct GetPixelType<int16_t>
 // Create dummy SICD data
 template <typename DataTypeT>
 std::unique_ptr<six::Data>
-createData(const types::RowCol<size_t>& dims)
+createData(const types::RowCol<size_t>& dims,
+           six::PixelType pixelType = GetPixelType<DataTypeT>::getPixelType())
 {
     six::sicd::ComplexData* data(new six::sicd::ComplexData());
     std::unique_ptr<six::Data> scopedData(data);
-    data->setPixelType(GetPixelType<DataTypeT>::getPixelType());
+    data->setPixelType(pixelType);
     setExtent(*data, dims);
     data->setName("corename");
     data->setSource("sensorname");
@@ -257,6 +261,15 @@ struct Tester final
     // Writes where some rows are written out with only some of the cols
     void testMultipleWritesOfPartialRows();
 
+    // Reads a region spanning several segments back, segments in parallel
+    void testConcurrentSegmentRead();
+
+    // Tiles saved out of order by several threads at once
+    void testConcurrentTileWrites();
+
+    // close() complains about pixels that were never saved
+    void testIncompleteWrite();
+
 private:
     void normalWrite();
 
@@ -446,6 +459,216 @@ void Tester<DataTypeT>::testMultipleWritesOfPartialRows()
     compare("Multiple writes of partial rows");
 }
 
+template <typename DataTypeT>
+void Tester<DataTypeT>::testConcurrentTileWrites()
+{
+    const EnsureFileCleanup ensureFileCleanup(mTestPathname);
+
+    six::Options options;
+    setMaxProductSize(options);
+    six::sicd::SICDWriteControl sicdWriter(mTestPathname, mSchemaPaths);
+    sicdWriter.initialize(options, mContainer);
+
+    // Tiles that don't line up with rows, columns or segments, in an
+    // order unrelated to where they go
+    const types::RowCol<size_t> tileDims(17, 100);
+    std::vector<types::RowCol<size_t> > offsets;
+    for (size_t row = 0; row < mDims.row; row += tileDims.row)
+    {
+        for (size_t col = 0; col < mDims.col; col += tileDims.col)
+        {
+            offsets.push_back(types::RowCol<size_t>(row, col));
+        }
+    }
+    for (size_t ii = 0; ii < offsets.size(); ++ii)
+    {
+        std::swap(offsets[ii], offsets[(ii * 7919) % offsets.size()]);
+    }
+
+    std::atomic<size_t> nextTile(0);
+    std::vector<std::string> errors(4);
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < errors.size(); ++thread)
+    {
+        threads.emplace_back([&, thread]()
+        {
+            try
+            {
+                std::vector<std::complex<DataTypeT> > tile;
+                for (size_t ii = nextTile++; ii < offsets.size();
+                     ii = nextTile++)
+                {
+                    const auto& offset = offsets[ii];
+                    const types::RowCol<size_t> dims(
+                            std::min(tileDims.row, mDims.row - offset.row),
+                            std::min(tileDims.col, mDims.col - offset.col));
+                    subsetData(mImagePtr, mDims.col, offset, dims, tile);
+                    sicdWriter.save(tile.data(), offset, dims);
+                }
+            }
+            catch (const except::Exception& ex)
+            {
+                errors[thread] = ex.getMessage();
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (const auto& error : errors)
+    {
+        if (!error.empty())
+        {
+            std::cerr << "Concurrent tile write failed: " << error << std::endl;
+            mSuccess = false;
+        }
+    }
+
+    if (!sicdWriter.isComplete())
+    {
+        std::cerr << "Concurrent tile write is incomplete" << std::endl;
+        mSuccess = false;
+    }
+    sicdWriter.close();
+
+    compare("Concurrent tile writes");
+}
+
+template <typename DataTypeT>
+void Tester<DataTypeT>::testIncompleteWrite()
+{
+    const EnsureFileCleanup ensureFileCleanup(mTestPathname);
+
+    six::Options options;
+    setMaxProductSize(options);
+    six::sicd::SICDWriteControl sicdWriter(mTestPathname, mSchemaPaths);
+    sicdWriter.initialize(options, mContainer);
+
+    // Everything but the last column of row 50
+    std::vector<std::complex<DataTypeT> > subset;
+    types::RowCol<size_t> offset(0, 0);
+    types::RowCol<size_t> subsetDims(50, mDims.col);
+    subsetData(mImagePtr, mDims.col, offset, subsetDims, subset);
+    sicdWriter.save(subset.data(), offset, subsetDims);
+
+    offset.row = 51;
+    subsetDims.row = mDims.row - offset.row;
+    subsetData(mImagePtr, mDims.col, offset, subsetDims, subset);
+    sicdWriter.save(subset.data(), offset, subsetDims);
+
+    offset.row = 50;
+    subsetDims = types::RowCol<size_t>(1, mDims.col - 1);
+    subsetData(mImagePtr, mDims.col, offset, subsetDims, subset);
+    sicdWriter.save(subset.data(), offset, subsetDims);
+
+    try
+    {
+        sicdWriter.close();
+        std::cerr << "Incomplete write was not detected" << std::endl;
+        mSuccess = false;
+    }
+    catch (const except::Exception&)
+    {
+    }
+}
+
+template <typename DataTypeT>
+void Tester<DataTypeT>::testConcurrentSegmentRead()
+{
+    six::NITFReadControl reader;
+    reader.setNumSegmentThreads(4);
+    reader.load(mNormalPathname, mSchemaPaths);
+
+    const types::RowCol<size_t> offset(mDims.row / 4, 10);
+    const types::RowCol<size_t> dims(mDims.row / 2, mDims.col - 20);
+    six::Region region;
+    region.setStartRow(offset.row);
+    region.setStartCol(offset.col);
+    region.setNumRows(dims.row);
+    region.setNumCols(dims.col);
+    std::unique_ptr<std::complex<DataTypeT>[]> buffer;
+    reader.interleaved(region, 0, buffer);
+
+    std::vector<std::complex<DataTypeT> > expected;
+    subsetData(mImagePtr, mDims.col, offset, dims, expected);
+
+    std::string prefix = "Concurrent segment read";
+    if (mSetMaxProductSize)
+    {
+        prefix += " (max product size " + std::to_string(mMaxProductSize) + ")";
+    }
+    if (std::equal(expected.begin(), expected.end(), buffer.get()))
+    {
+        std::cout << prefix << " matches" << std::endl;
+    }
+    else
+    {
+        std::cerr << prefix << " DOES NOT MATCH" << std::endl;
+        mSuccess = false;
+    }
+}
+
+// Streams complex<float> tiles through the span overload of save(), which
+// has to produce the same bytes NITFWriteControl writes for 'pixelType'
+bool testComplexFloatSaves(const std::vector<std::string>& schemaPaths,
+                           six::PixelType pixelType)
+{
+    const std::string normalPathname("normal_write.nitf");
+    const std::string testPathname("streaming_write.nitf");
+    const EnsureFileCleanup normalFileCleanup(normalPathname);
+    const EnsureFileCleanup testFileCleanup(testPathname);
+
+    const types::RowCol<size_t> dims(123, 456);
+    std::vector<std::complex<float> > image(dims.area());
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = std::complex<float>(static_cast<float>(ii % 251),
+                                        static_cast<float>(ii % 83) - 41);
+    }
+
+    mem::SharedPtr<six::Container> container(
+            new six::Container(six::DataType::COMPLEX));
+    container->addData(createData<float>(dims, pixelType).release());
+
+    const six::Options options;
+    {
+        six::NITFWriteControl writer(options, container);
+        std::vector<std::filesystem::path> paths;
+        std::transform(schemaPaths.begin(), schemaPaths.end(), std::back_inserter(paths), [](const std::string& s) { return s; });
+        save(writer, image, normalPathname, paths);
+    }
+    const CompareFiles compareFiles(normalPathname);
+
+    six::sicd::SICDWriteControl sicdWriter(testPathname, schemaPaths);
+    sicdWriter.initialize(options, container);
+
+    // Last tile first, so the headers go out on a save() that isn't at
+    // the origin
+    const types::RowCol<size_t> tileDims(50, 200);
+    std::vector<std::complex<float> > tile;
+    for (size_t row = dims.row; row > 0;)
+    {
+        row = (row - 1) / tileDims.row * tileDims.row;
+        for (size_t col = dims.col; col > 0;)
+        {
+            col = (col - 1) / tileDims.col * tileDims.col;
+            const types::RowCol<size_t> offset(row, col);
+            const types::RowCol<size_t> subDims(
+                    std::min(tileDims.row, dims.row - row),
+                    std::min(tileDims.col, dims.col - col));
+            subsetData(image.data(), dims.col, offset, subDims, tile);
+            sicdWriter.save(std::span<const std::complex<float> >(
+                                    tile.data(), tile.size()),
+                            offset, subDims);
+        }
+    }
+    sicdWriter.close();
+
+    return compareFiles("Complex float saves as " + pixelType.toString(),
+                        testPathname);
+}
+
 template <typename DataTypeT>
 bool doTests(const std::vector<std::string>& schemaPaths,
              bool setMaxProductSize,
@@ -465,6 +688,9 @@ bool doTests(const std::vector<std::string>& schemaPaths,
     tester.testSingleWrite();
     tester.testMultipleWritesOfFullRows();
     tester.testMultipleWritesOfPartialRows();
+    tester.testConcurrentTileWrites();
+    tester.testIncompleteWrite();
+    tester.testConcurrentSegmentRead();
 
     return tester.success();
 }
@@ -505,6 +731,14 @@ int main(int /*argc*/, char** /*argv*/)
             success = false;
         }
 
+        if (!testComplexFloatSaves(schemaPaths,
+                                   six::PixelType::RE32F_IM32F) ||
+            !testComplexFloatSaves(schemaPaths,
+                                   six::PixelType::AMP8I_PHS8I))
+        {
+            success = false;
+        }
+
         // Run tests forcing various numbers of segments
         std::vector<size_t> numRows;
         numRows.push_back(80);
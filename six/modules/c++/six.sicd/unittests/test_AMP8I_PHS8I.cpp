@@ -797,6 +797,95 @@ TEST_CASE(test_ComplexToAMP8IPHS8I)
     test_ComplexToAMP8IPHS8I(testName, item, inputs.begin(), inputs.end(), candidates);
 }
 
+static void test_nearest_neighbors_(const std::string& testName, const six::AmplitudeTable* pAmplitudeTable)
+{
+    std::unique_ptr<six::sicd::details::ComplexToAMP8IPHS8I> pTree; // not-cached, non-NULL amplitudeTable
+    const auto& item = *(six::sicd::details::ComplexToAMP8IPHS8I::make(pAmplitudeTable, pTree));
+
+    std::vector<std::complex<float>> inputs;
+    const auto add_neighbors = [&](const std::complex<long double>& v_)
+    {
+        const std::complex<float> v(gsl::narrow_cast<float>(v_.real()), gsl::narrow_cast<float>(v_.imag()));
+        for (const auto re : { std::nextafter(v.real(), -HUGE_VALF), v.real(), std::nextafter(v.real(), HUGE_VALF) })
+        {
+            for (const auto im : { std::nextafter(v.imag(), -HUGE_VALF), v.imag(), std::nextafter(v.imag(), HUGE_VALF) })
+            {
+                inputs.emplace_back(re, im);
+            }
+        }
+    };
+
+    // Every possible value, and values right on the boundaries between them:
+    // half way between phases, and half way between magnitudes.
+    for (int i = 0; i < 256; i++)
+    {
+        for (int j = 0; j < 256; j++)
+        {
+            const auto v = six::sicd::Utilities::from_AMP8I_PHS8I(i, j, pAmplitudeTable);
+            add_neighbors(v);
+            add_neighbors(v * std::polar(1.0L, M_PI / 256.0L));
+            if (i < 255)
+            {
+                add_neighbors((v + six::sicd::Utilities::from_AMP8I_PHS8I(i + 1, j, pAmplitudeTable)) / 2.0L);
+            }
+        }
+    }
+
+    // Random values over a wide range of scales
+    std::default_random_engine eng(123456);  // ... fixed seed means deterministic tests...
+    std::uniform_real_distribution<float> uniform(-300.0f, 300.0f);
+    std::uniform_real_distribution<float> exponent(-130.0f, 130.0f);
+    for (size_t k = 0; k < 100000; k++)
+    {
+        inputs.emplace_back(uniform(eng), uniform(eng));
+        inputs.emplace_back(uniform(eng) * std::exp2(exponent(eng)), uniform(eng) * std::exp2(exponent(eng)));
+    }
+
+    // Special values
+    constexpr auto inf = std::numeric_limits<float>::infinity();
+    const auto denorm = std::numeric_limits<float>::denorm_min();
+    for (const auto re : { 0.0f, -0.0f, denorm, -denorm, 1.0f, -inf, inf, std::numeric_limits<float>::max() })
+    {
+        for (const auto im : { 0.0f, -0.0f, denorm, -denorm, -1.0f, inf, -std::numeric_limits<float>::max() })
+        {
+            inputs.emplace_back(re, im);
+        }
+    }
+    inputs.emplace_back(1.0f, 0.0f); // odd number of values to exercise the tail
+
+    std::vector<AMP8I_PHS8I_t> results(inputs.size());
+    item.nearest_neighbors(std::span<const std::complex<float>>(inputs.data(), inputs.size()),
+        std::span<AMP8I_PHS8I_t>(results.data(), results.size()));
+    std::vector<AMP8I_PHS8I_t> scalar(inputs.size()); // AVX2 would otherwise leave only the tail to encodeScalar()
+    item.nearest_neighbors(std::span<const std::complex<float>>(inputs.data(), inputs.size()),
+        std::span<AMP8I_PHS8I_t>(scalar.data(), scalar.size()), false /*vectorize*/);
+    std::vector<AMP8I_PHS8I_t> threaded(inputs.size());
+    six::sicd::ImageData::to_AMP8I_PHS8I(pAmplitudeTable, std::span<const std::complex<float>>(inputs.data(), inputs.size()),
+        std::span<AMP8I_PHS8I_t>(threaded.data(), threaded.size()), 10000 /*cutoff*/);
+
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        const auto expected = item.nearest_neighbor(inputs[i]);
+        TEST_ASSERT_EQ(expected.first, results[i].first);
+        TEST_ASSERT_EQ(expected.second, results[i].second);
+        TEST_ASSERT_EQ(expected.first, scalar[i].first);
+        TEST_ASSERT_EQ(expected.second, scalar[i].second);
+        TEST_ASSERT_EQ(expected.first, threaded[i].first);
+        TEST_ASSERT_EQ(expected.second, threaded[i].second);
+    }
+}
+TEST_CASE(test_nearest_neighbors)
+{
+    test_nearest_neighbors_(testName, nullptr);
+
+    six::AmplitudeTable amplitudeTable;
+    for (size_t i = 0; i < 256; i++)
+    {
+        amplitudeTable.index(i) = std::pow(1.04, static_cast<double>(i)) - 1.0;
+    }
+    test_nearest_neighbors_(testName, &amplitudeTable);
+}
+
 TEST_MAIN(
     TEST_CHECK(test_8bit_ampphs);
     TEST_CHECK(read_8bit_ampphs_with_table);
@@ -807,5 +896,6 @@ TEST_MAIN(
     TEST_CHECK(test_nearest_neighbor);
     TEST_CHECK(test_verify_phase_uint8_ordering);
     TEST_CHECK(test_ComplexToAMP8IPHS8I);
+    TEST_CHECK(test_nearest_neighbors);
     )
 
@@ -0,0 +1,146 @@
+/* =========================================================================
+* This file is part of six.sicd-c++
+* =========================================================================
+*
+* (C) Copyright 2004 - 2017, MDA Information Systems LLC
+*
+* six.sicd-c++ is free software; you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this program; If not,
+* see <http://www.gnu.org/licenses/>.
+*
+*/
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <string>
+#include <vector>
+
+#include <std/span>
+#include <io/TempFile.h>
+#include <str/Manip.h>
+#include <import/nitf.hpp>
+#include <six/NITFReadControl.h>
+#include <six/Pyramid.h>
+#include <six/XMLControlFactory.h>
+#include <six/sicd/ComplexXMLControl.h>
+#include <six/sicd/Utilities.h>
+
+#include "TestCase.h"
+
+namespace
+{
+// Mean of each 2x2 block, as PyramidBuilder defines a level
+std::vector<double> reduce(const std::vector<double>& input,
+                           const types::RowCol<size_t>& inputDims)
+{
+    const types::RowCol<size_t> dims((inputDims.row + 1) / 2,
+                                     (inputDims.col + 1) / 2);
+    std::vector<double> output(dims.area());
+    for (size_t row = 0; row < dims.row; ++row)
+    {
+        for (size_t col = 0; col < dims.col; ++col)
+        {
+            double sum = 0;
+            size_t count = 0;
+            for (size_t ii = 2 * row;
+                 ii < std::min(2 * row + 2, inputDims.row); ++ii)
+            {
+                for (size_t jj = 2 * col;
+                     jj < std::min(2 * col + 2, inputDims.col); ++jj)
+                {
+                    sum += input[ii * inputDims.col + jj];
+                    ++count;
+                }
+            }
+            output[row * dims.col + col] = sum / count;
+        }
+    }
+    return output;
+}
+}
+
+TEST_CASE(testWritePyramidRoundTrip)
+{
+    const types::RowCol<size_t> dims(37, 21);
+    const size_t numLevels = 2;
+    auto complexData = six::sicd::Utilities::createFakeComplexData(
+            "1.2.1", six::PixelType::RE32F_IM32F, false, &dims);
+
+    std::vector<std::complex<float> > image(dims.area());
+    std::vector<double> expected(dims.area());
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = std::complex<float>(static_cast<float>(ii % 13),
+                                        static_cast<float>(ii % 7) - 3);
+        expected[ii] = std::abs(image[ii]);
+    }
+
+    io::TempFile sicdFile;
+    io::TempFile pyramidFile;
+    six::XMLControlFactory::getInstance().addCreator<
+            six::sicd::ComplexXMLControl>();
+    six::sicd::writeAsNITF(sicdFile.pathname(), std::vector<std::string>(),
+            *complexData,
+            std::span<const std::complex<float> >(image.data(), image.size()));
+
+    six::NITFReadControl sicdReader;
+    sicdReader.load(sicdFile.pathname());
+    // Small reads, so levels are built across several of them
+    six::writePyramid(sicdReader, pyramidFile.pathname(), numLevels, 0, 5, 2);
+
+    nitf::IOHandle handle(pyramidFile.pathname(), NITF_ACCESS_READONLY,
+                          NITF_OPEN_EXISTING);
+    nitf::Reader reader;
+    nitf::Record record = reader.read(handle);
+    TEST_ASSERT_EQ(static_cast<size_t>(record.getNumImages()), numLevels);
+
+    types::RowCol<size_t> levelDims = dims;
+    for (size_t level = 1; level <= numLevels; ++level)
+    {
+        expected = reduce(expected, levelDims);
+        levelDims = six::PyramidBuilder::getLevelDims(dims, level);
+
+        nitf::ImageSubheader subheader = nitf::ImageSegment(
+                record.getImages()[level - 1]).getSubheader();
+        TEST_ASSERT_EQ(static_cast<size_t>(subheader.numRows()),
+                       levelDims.row);
+        TEST_ASSERT_EQ(static_cast<size_t>(subheader.numCols()),
+                       levelDims.col);
+        TEST_ASSERT_EQ(str::trim(
+                               subheader.getImageMagnification().toString()),
+                       "/" + std::to_string(1 << level));
+        TEST_ASSERT_EQ(subheader.getPixelValueType().toString(),
+                       std::string("R  "));
+
+        std::vector<float> pixels(levelDims.area());
+        uint32_t band = 0;
+        nitf::SubWindow subWindow(static_cast<uint32_t>(levelDims.row),
+                                  static_cast<uint32_t>(levelDims.col),
+                                  &band, 1);
+        auto* buffer = reinterpret_cast<uint8_t*>(pixels.data());
+        int padded = 0;
+        reader.newImageReader(static_cast<int>(level - 1))
+                .read(subWindow, &buffer, &padded);
+
+        // First, last and an interior pixel
+        for (const size_t ii : {static_cast<size_t>(0), levelDims.area() - 1,
+                                levelDims.col + 1})
+        {
+            TEST_ASSERT_ALMOST_EQ_EPS(pixels[ii], expected[ii], 1e-4);
+        }
+    }
+}
+
+TEST_MAIN(
+    TEST_CHECK(testWritePyramidRoundTrip);
+    )
@@ -0,0 +1,69 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_BYTE_SWAP_KERNELS_H__
+#define __SIX_BYTE_SWAP_KERNELS_H__
+#pragma once
+
+#include <stddef.h>
+#include <complex>
+
+#include <std/cstddef>
+
+namespace six
+{
+/*
+ * Single threaded kernels behind the CPHD and CRSD byte swapping and
+ * sample conversion functions, which split the work over threads.
+ *
+ * AVX2 and SSE4.1 variants are compiled with target attributes and picked
+ * once, at runtime, from the CPU's capabilities; other platforms get the
+ * scalar code.
+ */
+
+/*!
+ *  Converts one run of complex samples to complex<float>, byte swapping
+ *  and/or applying 'scaleFactor' along the way.  The multiply is done in
+ *  double so every implementation gives bit-identical results.
+ */
+typedef void (*ConvertKernel)(const std::byte* input,
+                              size_t numElements,
+                              double scaleFactor,
+                              std::complex<float>* output);
+
+/*!
+ *  Get the fastest kernel this CPU supports
+ *
+ *  \param elementSize Bytes per complex sample (2, 4 or 8)
+ *  \param swap Whether the input is in the other byte order
+ *  \param scale Whether to multiply by the kernel's scaleFactor
+ *
+ *  \throw except::Exception If 'elementSize' is not 2, 4 or 8
+ */
+ConvertKernel getConvertKernel(size_t elementSize, bool swap, bool scale);
+
+/*!
+ *  Byte swap 'numElements' elements of 'elemSize' bytes in place
+ */
+void byteSwapElements(void* buffer, size_t elemSize, size_t numElements);
+}
+
+#endif
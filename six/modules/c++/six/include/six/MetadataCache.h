@@ -0,0 +1,220 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_METADATA_CACHE_H__
+#define __SIX_METADATA_CACHE_H__
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace six
+{
+/*!
+ * \struct MetadataCacheKey
+ * \brief Identifies one version of a file's XML block, as parsed against
+ * one set of schemas
+ *
+ * A file that is rewritten in place changes size, modification time or
+ * XML content, and so gets a new key. Metadata parsed without validation,
+ * or against other schemas, is never returned for a reader that asks for
+ * validation against 'schemaPaths'.
+ */
+struct MetadataCacheKey final
+{
+    std::string pathname;
+    int64_t fileSize = 0;
+    int64_t modifiedTime = 0;
+    uint64_t xmlHash = 0;
+    //! Sorted; empty if the XML wasn't validated
+    std::vector<std::string> schemaPaths;
+
+    bool operator<(const MetadataCacheKey& other) const;
+
+    /*!
+     *  Build the key for a file whose XML block is 'xmlBlock'
+     *
+     *  \param pathname File path, as given to the reader
+     *  \param xmlBlock Bytes of the file's XML block
+     *  \param size Number of bytes in 'xmlBlock'
+     *  \param schemaPaths Schemas the XML is validated against, if any
+     *
+     *  \throw except::Exception If the file cannot be stat'd
+     */
+    static MetadataCacheKey make(const std::string& pathname,
+                                 const void* xmlBlock,
+                                 size_t size,
+                                 const std::vector<std::string>& schemaPaths);
+};
+
+/*!
+ * \class MetadataCache
+ * \brief Process-wide LRU cache of parsed metadata, keyed by file
+ *
+ * Parsing and validating the XML block dominates the cost of opening a
+ * CPHD or CRSD file. When the cache has a nonzero capacity, the reader
+ * looks the file up here before parsing and stores what it parsed
+ * afterwards, so reopening an unchanged file only reads and hashes the
+ * XML block.
+ *
+ * The cache is disabled (capacity 0) until setCapacity() is called.
+ * The least recently used entry is evicted once it is full. All member
+ * functions are safe to call from multiple threads.
+ */
+template <typename MetadataT>
+class MetadataCache final
+{
+public:
+    using Key = MetadataCacheKey;
+
+    /*!
+     *  Create an empty cache
+     *
+     *  \param capacity Maximum number of entries; 0 disables the cache
+     */
+    explicit MetadataCache(size_t capacity = 0) :
+        mCapacity(capacity)
+    {
+    }
+
+    //! Cache shared by all readers of MetadataT in the process
+    static MetadataCache& getInstance()
+    {
+        static MetadataCache cache;
+        return cache;
+    }
+
+    //! See MetadataCacheKey::make()
+    static Key makeKey(const std::string& pathname,
+                       const void* xmlBlock,
+                       size_t size,
+                       const std::vector<std::string>& schemaPaths =
+                               std::vector<std::string>())
+    {
+        return Key::make(pathname, xmlBlock, size, schemaPaths);
+    }
+
+    /*!
+     *  Look up the metadata for 'key' and mark it recently used
+     *
+     *  \param key Key from makeKey()
+     *
+     *  \return The metadata, or nullptr on a miss
+     */
+    std::shared_ptr<const MetadataT> find(const Key& key)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto iter = mIndex.find(key);
+        if (iter == mIndex.end())
+        {
+            return nullptr;
+        }
+        mEntries.splice(mEntries.begin(), mEntries, iter->second);
+        return iter->second->second;
+    }
+
+    /*!
+     *  Add or replace the metadata for 'key'. Does nothing if the cache
+     *  is disabled.
+     *
+     *  \param key Key from makeKey()
+     *  \param metadata Metadata parsed from the file's XML block
+     */
+    void insert(const Key& key, std::shared_ptr<const MetadataT> metadata)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mCapacity == 0)
+        {
+            return;
+        }
+
+        const auto iter = mIndex.find(key);
+        if (iter != mIndex.end())
+        {
+            iter->second->second = metadata;
+            mEntries.splice(mEntries.begin(), mEntries, iter->second);
+            return;
+        }
+
+        mEntries.emplace_front(key, metadata);
+        mIndex[key] = mEntries.begin();
+        evict();
+    }
+
+    //! Change the maximum number of entries, evicting any excess
+    void setCapacity(size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCapacity = capacity;
+        evict();
+    }
+    size_t getCapacity() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mCapacity;
+    }
+
+    //! Number of entries currently cached
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEntries.size();
+    }
+
+    //! Drop every entry
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEntries.clear();
+        mIndex.clear();
+    }
+
+    MetadataCache(const MetadataCache&) = delete;
+    MetadataCache& operator=(const MetadataCache&) = delete;
+
+private:
+    using Entry = std::pair<Key, std::shared_ptr<const MetadataT> >;
+
+    // Must be called with mMutex held
+    void evict()
+    {
+        while (mEntries.size() > mCapacity)
+        {
+            mIndex.erase(mEntries.back().first);
+            mEntries.pop_back();
+        }
+    }
+
+    mutable std::mutex mMutex;
+    size_t mCapacity = 0;
+    //! Most recently used first
+    std::list<Entry> mEntries;
+    std::map<Key, typename std::list<Entry>::iterator> mIndex;
+};
+}
+
+#endif
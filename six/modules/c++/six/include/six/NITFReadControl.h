@@ -181,6 +181,29 @@ struct NITFReadControl : public ReadControl
      */
     virtual UByte* interleaved(Region& region, size_t imageNumber) override;
 
+    /*!
+     * Set how many image segments interleaved() may read at once.
+     *
+     * Large images are split across several segments, each its own range of
+     * bytes in the file, so they can be read concurrently into their own
+     * slices of the output buffer.  Each thread opens its own handle to the
+     * file, so this only applies to images loaded from a pathname; images
+     * loaded from a stream or IOInterface are always read one segment at a
+     * time.
+     *
+     * \param numThreads Most segments to read at once.  The default of 1
+     * reads them one after another on the calling thread; 0 uses one thread
+     * per CPU.
+     */
+    void setNumSegmentThreads(size_t numThreads)
+    {
+        mNumSegmentThreads = numThreads;
+    }
+    size_t getNumSegmentThreads() const
+    {
+        return mNumSegmentThreads;
+    }
+
     std::string getFileType() const override
     {
         return "NITF";
@@ -198,6 +221,13 @@ struct NITFReadControl : public ReadControl
         return mReader;
     }
 
+    //! Index into getRecord().getImages() of the first image segment of
+    //! 'imageNumber'
+    size_t getImageSegmentIndex(size_t imageNumber) const
+    {
+        return mInfos.at(imageNumber)->getStartIndex();
+    }
+
 protected:
     //! We keep a ref to the reader
     mutable nitf::Reader mReader;
@@ -283,6 +313,10 @@ private:
     // The issue occurs from the explicit destructor of
     // IOControl
     std::shared_ptr<nitf::IOInterface> mInterface;
+
+    //! The file we were loaded from, if any; see setNumSegmentThreads()
+    std::string mPathname;
+    size_t mNumSegmentThreads = 1;
 };
 
 
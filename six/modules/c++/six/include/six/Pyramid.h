@@ -0,0 +1,163 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_PYRAMID_H__
+#define __SIX_PYRAMID_H__
+#pragma once
+
+#include <stddef.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <types/RowCol.h>
+#include <six/NITFReadControl.h>
+
+namespace six
+{
+/*!
+ * \class PyramidBuilder
+ * \brief Builds all of the 2x reduced-resolution levels of an image in a
+ * single pass over it
+ *
+ * Full resolution rows are added top to bottom, any number at a time.  Each
+ * pixel of level n is the mean of a 2x2 block of level n - 1 (just the
+ * pixels that exist along the last row and column of an odd-sized level),
+ * so level n is ceil(dims / 2^n).  As soon as rows of a level are finished
+ * they are handed to the sink and fed to the next level, so memory use is
+ * bounded by the size of one addRows() call plus one row per level.
+ *
+ * Samples are floats, interleaved by pixel when there is more than one band.
+ */
+class PyramidBuilder final
+{
+public:
+    /*!
+     * Receives finished rows of one level, top to bottom
+     *
+     * \param level Level the rows belong to; 1 is half resolution
+     * \param startRow First row of 'rows' within the level
+     * \param numRows Number of rows
+     * \param rows Pixels of those rows; only valid during the call
+     */
+    using RowSink = std::function<void(size_t level,
+                                       size_t startRow,
+                                       size_t numRows,
+                                       const float* rows)>;
+
+    /*!
+     * \param dims Full resolution image size
+     * \param numBands Number of samples per pixel
+     * \param numLevels Number of reduced-resolution levels to build
+     * \param sink Called with the rows of each level as they are finished.
+     * Calls are made from the thread calling addRows(), one at a time.
+     * \param numThreads Number of threads to reduce rows on; 0 uses one
+     * per CPU
+     */
+    PyramidBuilder(const types::RowCol<size_t>& dims,
+                   size_t numBands,
+                   size_t numLevels,
+                   RowSink sink,
+                   size_t numThreads = 1);
+
+    PyramidBuilder(const PyramidBuilder&) = delete;
+    PyramidBuilder& operator=(const PyramidBuilder&) = delete;
+
+    //! Size of 'level' (0 is full resolution) of an image of size 'dims'
+    static types::RowCol<size_t>
+    getLevelDims(const types::RowCol<size_t>& dims, size_t level);
+
+    /*!
+     * Number of levels needed before both dimensions of the smallest one
+     * are no more than 'maxDim'.  This is 0 if 'dims' already fit.
+     */
+    static size_t getNumLevels(const types::RowCol<size_t>& dims,
+                               size_t maxDim);
+
+    /*!
+     * Add the next full resolution rows
+     *
+     * \param rows numRows * dims.col * numBands samples
+     * \param numRows Number of rows
+     *
+     * \throw except::Exception If this would add more rows than the image has
+     */
+    void addRows(const float* rows, size_t numRows);
+
+    //! True once every full resolution row has been added
+    bool isComplete() const
+    {
+        return mNumRowsAdded == mDims.row;
+    }
+
+private:
+    struct Level
+    {
+        types::RowCol<size_t> inputDims;
+        types::RowCol<size_t> dims;
+        size_t numInputRowsSeen = 0;
+        size_t numRowsDone = 0;
+        //! Odd input row waiting for the row below it
+        std::vector<float> carry;
+        bool haveCarry = false;
+        std::vector<float> rows;
+    };
+
+    void reduce(size_t level, const float* rows, size_t numRows);
+
+    const types::RowCol<size_t> mDims;
+    const size_t mNumBands;
+    const RowSink mSink;
+    const size_t mNumThreads;
+    std::vector<Level> mLevels;
+    size_t mNumRowsAdded = 0;
+};
+
+/*!
+ * Streams an image of a SICD or SIDD once, a block of rows at a time, and
+ * writes its reduced-resolution levels to a separate NITF.  Image segment n
+ * of the output holds level n + 1 (so the first is half resolution) and has
+ * its IMAG field set to the reduction factor, e.g. "/2".  The file header
+ * and image subheaders carry the classification of the input.
+ *
+ * SICD pixels are detected (|z|) and written as 32-bit floats.  SIDD pixels
+ * keep their sample type (lookup tables are applied first) and are rounded;
+ * RGB products keep their three bands.
+ *
+ * \param reader Reader that load() has been called on
+ * \param outPathname Output NITF pathname
+ * \param numLevels Number of levels to write; 0 writes enough for the
+ * smallest to fit in 256 x 256 (and at least one)
+ * \param imageNumber Image to reduce; for SIDD, the product number
+ * \param numRowsPerRead Number of full resolution rows to read at a time;
+ * reading the next block overlaps reducing the previous one
+ * \param numThreads Number of threads to reduce rows on; 0 uses one per CPU
+ */
+void writePyramid(NITFReadControl& reader,
+                  const std::string& outPathname,
+                  size_t numLevels = 0,
+                  size_t imageNumber = 0,
+                  size_t numRowsPerRead = 512,
+                  size_t numThreads = 0);
+}
+
+#endif
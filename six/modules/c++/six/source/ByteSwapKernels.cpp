@@ -0,0 +1,490 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/ByteSwapKernels.h>
+
+#include <string.h>
+#include <string>
+
+#include <sys/Conf.h>
+#include <except/Exception.h>
+#include <nitf/coda-oss.hpp>
+
+// Vectorized kernels are compiled for specific instruction sets with
+// function attributes and picked at runtime based on what the CPU supports,
+// so the library itself doesn't need to be built with -mavx2.
+#if (defined(__GNUC__) || defined(__clang__)) && \
+        (defined(__x86_64__) || defined(__i386__))
+#define SIX_X86_SIMD 1
+#define SIX_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SIX_X86_SIMD 1
+#define SIX_TARGET(isa)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#define SIX_X86_SIMD 0
+#endif
+
+namespace
+{
+// TODO: Maybe this should go in sys/Conf.h
+//       It's more flexible in that it properly handles float's - you can't
+//       just call sys::byteSwap(floatVal) because the compiler may change the
+//       byte-swapped float value into a valid IEEE value beforehand.
+template <typename T>
+inline
+void byteSwap(const void* in, T& out)
+{
+    const std::byte* const inPtr = static_cast<const std::byte*>(in);
+    std::byte* const outPtr = reinterpret_cast<std::byte*>(&out);
+
+    for (size_t ii = 0, jj = sizeof(T) - 1; ii < jj; ++ii, --jj)
+    {
+        outPtr[ii] = inPtr[jj];
+        outPtr[jj] = inPtr[ii];
+    }
+}
+
+template <typename T, bool Swap>
+inline T load(const std::byte* in)
+{
+    T value;
+    if (Swap)
+    {
+        byteSwap(in, value);
+    }
+    else
+    {
+        memcpy(&value, in, sizeof(T));
+    }
+    return value;
+}
+
+// Byte swaps 'numElements' elements of one size in place
+typedef void (*SwapKernel)(std::byte* buffer, size_t numElements);
+
+template <typename InT, bool Swap, bool Scale>
+void convertScalar(const std::byte* input,
+                   size_t numElements,
+                   double scaleFactor,
+                   std::complex<float>* output)
+{
+    for (size_t ii = 0; ii < numElements;
+         ++ii, input += sizeof(std::complex<InT>))
+    {
+        const InT real = load<InT, Swap>(input);
+        const InT imag = load<InT, Swap>(input + sizeof(InT));
+        if (Scale)
+        {
+            output[ii] = std::complex<float>(
+                    static_cast<float>(real * scaleFactor),
+                    static_cast<float>(imag * scaleFactor));
+        }
+        else
+        {
+            output[ii] = std::complex<float>(real, imag);
+        }
+    }
+}
+
+template <size_t ElemSize>
+void swapScalar(std::byte* buffer, size_t numElements)
+{
+    sys::byteSwap(buffer, static_cast<unsigned short>(ElemSize), numElements);
+}
+
+enum class SimdLevel
+{
+    SCALAR,
+    SSE41,
+    AVX2
+};
+
+#if SIX_X86_SIMD
+SimdLevel detectSimdLevel()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx &&
+        (_xgetbv(0) & 0x6) == 0x6)  // OS saves XMM and YMM state
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool sse41 = __builtin_cpu_supports("sse4.1") != 0;
+    const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+    if (avx2)
+    {
+        return SimdLevel::AVX2;
+    }
+    if (sse41)
+    {
+        return SimdLevel::SSE41;
+    }
+    return SimdLevel::SCALAR;
+}
+
+// Shuffle control that reverses the bytes of each ElemSize-byte element
+// in a 16 byte lane
+template <size_t ElemSize>
+SIX_TARGET("sse4.1")
+inline __m128i swapMask128()
+{
+    alignas(16) int8_t mask[16];
+    for (size_t ii = 0; ii < 16; ++ii)
+    {
+        mask[ii] = static_cast<int8_t>(
+                ii - ii % ElemSize + ElemSize - 1 - ii % ElemSize);
+    }
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+//------------------------------------------------------------------------
+// SSE4.1: two complex samples (four components) per step
+//------------------------------------------------------------------------
+SIX_TARGET("sse4.1")
+inline __m128i loadSSE41(const int8_t*, const std::byte* in, __m128i)
+{
+    int32_t raw;
+    memcpy(&raw, in, sizeof(raw));
+    return _mm_cvtepi8_epi32(_mm_cvtsi32_si128(raw));
+}
+
+SIX_TARGET("sse4.1")
+inline __m128i loadSSE41(const int16_t*, const std::byte* in, __m128i mask)
+{
+    __m128i raw = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in));
+    raw = _mm_shuffle_epi8(raw, mask);
+    return _mm_cvtepi16_epi32(raw);
+}
+
+SIX_TARGET("sse4.1")
+inline __m128 loadSSE41(const float*, const std::byte* in, __m128i mask)
+{
+    const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    return _mm_castsi128_ps(_mm_shuffle_epi8(raw, mask));
+}
+
+SIX_TARGET("sse4.1")
+inline __m128 toFloatSSE41(__m128i lanes)
+{
+    return _mm_cvtepi32_ps(lanes);
+}
+SIX_TARGET("sse4.1")
+inline __m128 toFloatSSE41(__m128 lanes)
+{
+    return lanes;
+}
+
+SIX_TARGET("sse4.1")
+inline __m128 scaleSSE41(__m128i lanes, __m128d scale)
+{
+    const __m128d lo = _mm_mul_pd(_mm_cvtepi32_pd(lanes), scale);
+    const __m128d hi = _mm_mul_pd(
+            _mm_cvtepi32_pd(_mm_unpackhi_epi64(lanes, lanes)), scale);
+    return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+SIX_TARGET("sse4.1")
+inline __m128 scaleSSE41(__m128 lanes, __m128d scale)
+{
+    const __m128d lo = _mm_mul_pd(_mm_cvtps_pd(lanes), scale);
+    const __m128d hi = _mm_mul_pd(
+            _mm_cvtps_pd(_mm_movehl_ps(lanes, lanes)), scale);
+    return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
+template <typename InT, bool Swap, bool Scale>
+SIX_TARGET("sse4.1")
+void convertSSE41(const std::byte* input,
+                  size_t numElements,
+                  double scaleFactor,
+                  std::complex<float>* output)
+{
+    // The identity shuffle leaves bytes in file order
+    const __m128i mask = Swap ? swapMask128<sizeof(InT)>() :
+            swapMask128<1>();
+    const __m128d scale = _mm_set1_pd(scaleFactor);
+    const size_t numVectorized = numElements - numElements % 2;
+
+    for (size_t ii = 0; ii < numVectorized;
+         ii += 2, input += 2 * sizeof(std::complex<InT>))
+    {
+        const auto lanes = loadSSE41(static_cast<const InT*>(nullptr),
+                                     input,
+                                     mask);
+        const __m128 result = Scale ? scaleSSE41(lanes, scale) :
+                toFloatSSE41(lanes);
+        _mm_storeu_ps(reinterpret_cast<float*>(output + ii), result);
+    }
+    convertScalar<InT, Swap, Scale>(input,
+                                    numElements - numVectorized,
+                                    scaleFactor,
+                                    output + numVectorized);
+}
+
+template <size_t ElemSize>
+SIX_TARGET("sse4.1")
+void swapSSE41(std::byte* buffer, size_t numElements)
+{
+    const __m128i mask = swapMask128<ElemSize>();
+    const size_t numBytes = numElements * ElemSize;
+    const size_t numVectorized = numBytes - numBytes % 16;
+    for (size_t ii = 0; ii < numVectorized; ii += 16)
+    {
+        __m128i* const ptr = reinterpret_cast<__m128i*>(buffer + ii);
+        _mm_storeu_si128(ptr, _mm_shuffle_epi8(_mm_loadu_si128(ptr), mask));
+    }
+    swapScalar<ElemSize>(buffer + numVectorized,
+                         (numBytes - numVectorized) / ElemSize);
+}
+
+//------------------------------------------------------------------------
+// AVX2: four complex samples (eight components) per step
+//------------------------------------------------------------------------
+template <size_t ElemSize>
+SIX_TARGET("avx2")
+inline __m256i swapMask256()
+{
+    const __m128i mask = swapMask128<ElemSize>();
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(mask), mask, 1);
+}
+
+SIX_TARGET("avx2")
+inline __m256i loadAVX2(const int8_t*, const std::byte* in, __m256i)
+{
+    return _mm256_cvtepi8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)));
+}
+
+SIX_TARGET("avx2")
+inline __m256i loadAVX2(const int16_t*, const std::byte* in, __m256i mask)
+{
+    __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    raw = _mm_shuffle_epi8(raw, _mm256_castsi256_si128(mask));
+    return _mm256_cvtepi16_epi32(raw);
+}
+
+SIX_TARGET("avx2")
+inline __m256 loadAVX2(const float*, const std::byte* in, __m256i mask)
+{
+    const __m256i raw =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    return _mm256_castsi256_ps(_mm256_shuffle_epi8(raw, mask));
+}
+
+SIX_TARGET("avx2")
+inline __m256 toFloatAVX2(__m256i lanes)
+{
+    return _mm256_cvtepi32_ps(lanes);
+}
+SIX_TARGET("avx2")
+inline __m256 toFloatAVX2(__m256 lanes)
+{
+    return lanes;
+}
+
+SIX_TARGET("avx2")
+inline __m256 combineAVX2(__m256d lo, __m256d hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)),
+                                _mm256_cvtpd_ps(hi),
+                                1);
+}
+
+SIX_TARGET("avx2")
+inline __m256 scaleAVX2(__m256i lanes, __m256d scale)
+{
+    const __m256d lo = _mm256_mul_pd(
+            _mm256_cvtepi32_pd(_mm256_castsi256_si128(lanes)), scale);
+    const __m256d hi = _mm256_mul_pd(
+            _mm256_cvtepi32_pd(_mm256_extracti128_si256(lanes, 1)), scale);
+    return combineAVX2(lo, hi);
+}
+SIX_TARGET("avx2")
+inline __m256 scaleAVX2(__m256 lanes, __m256d scale)
+{
+    const __m256d lo = _mm256_mul_pd(
+            _mm256_cvtps_pd(_mm256_castps256_ps128(lanes)), scale);
+    const __m256d hi = _mm256_mul_pd(
+            _mm256_cvtps_pd(_mm256_extractf128_ps(lanes, 1)), scale);
+    return combineAVX2(lo, hi);
+}
+
+template <typename InT, bool Swap, bool Scale>
+SIX_TARGET("avx2")
+void convertAVX2(const std::byte* input,
+                 size_t numElements,
+                 double scaleFactor,
+                 std::complex<float>* output)
+{
+    const __m256i mask = Swap ? swapMask256<sizeof(InT)>() :
+            swapMask256<1>();
+    const __m256d scale = _mm256_set1_pd(scaleFactor);
+    const size_t numVectorized = numElements - numElements % 4;
+
+    for (size_t ii = 0; ii < numVectorized;
+         ii += 4, input += 4 * sizeof(std::complex<InT>))
+    {
+        const auto lanes = loadAVX2(static_cast<const InT*>(nullptr),
+                                    input,
+                                    mask);
+        const __m256 result = Scale ? scaleAVX2(lanes, scale) :
+                toFloatAVX2(lanes);
+        _mm256_storeu_ps(reinterpret_cast<float*>(output + ii), result);
+    }
+    convertScalar<InT, Swap, Scale>(input,
+                                    numElements - numVectorized,
+                                    scaleFactor,
+                                    output + numVectorized);
+}
+
+template <size_t ElemSize>
+SIX_TARGET("avx2")
+void swapAVX2(std::byte* buffer, size_t numElements)
+{
+    const __m256i mask = swapMask256<ElemSize>();
+    const size_t numBytes = numElements * ElemSize;
+    const size_t numVectorized = numBytes - numBytes % 32;
+    for (size_t ii = 0; ii < numVectorized; ii += 32)
+    {
+        __m256i* const ptr = reinterpret_cast<__m256i*>(buffer + ii);
+        _mm256_storeu_si256(ptr,
+                            _mm256_shuffle_epi8(_mm256_loadu_si256(ptr),
+                                                mask));
+    }
+    swapScalar<ElemSize>(buffer + numVectorized,
+                         (numBytes - numVectorized) / ElemSize);
+}
+#else
+SimdLevel detectSimdLevel()
+{
+    return SimdLevel::SCALAR;
+}
+#endif
+
+SimdLevel getSimdLevel()
+{
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+template <typename InT, bool Swap, bool Scale>
+six::ConvertKernel pickConvertKernel()
+{
+#if SIX_X86_SIMD
+    switch (getSimdLevel())
+    {
+    case SimdLevel::AVX2:
+        return &convertAVX2<InT, Swap, Scale>;
+    case SimdLevel::SSE41:
+        return &convertSSE41<InT, Swap, Scale>;
+    default:
+        break;
+    }
+#endif
+    return &convertScalar<InT, Swap, Scale>;
+}
+
+template <typename InT>
+six::ConvertKernel pickConvertKernel(bool swap, bool scale)
+{
+    // Single byte components never need swapping
+    swap = swap && sizeof(InT) > 1;
+    if (swap)
+    {
+        return scale ? pickConvertKernel<InT, true, true>() :
+                pickConvertKernel<InT, true, false>();
+    }
+    return scale ? pickConvertKernel<InT, false, true>() :
+            pickConvertKernel<InT, false, false>();
+}
+
+template <size_t ElemSize>
+SwapKernel getSwapKernel()
+{
+#if SIX_X86_SIMD
+    switch (getSimdLevel())
+    {
+    case SimdLevel::AVX2:
+        return &swapAVX2<ElemSize>;
+    case SimdLevel::SSE41:
+        return &swapSSE41<ElemSize>;
+    default:
+        break;
+    }
+#endif
+    return &swapScalar<ElemSize>;
+}
+}
+
+namespace six
+{
+ConvertKernel getConvertKernel(size_t elementSize, bool swap, bool scale)
+{
+    switch (elementSize)
+    {
+    case 2:
+        return pickConvertKernel<int8_t>(swap, scale);
+    case 4:
+        return pickConvertKernel<int16_t>(swap, scale);
+    case 8:
+        return pickConvertKernel<float>(swap, scale);
+    default:
+        throw except::Exception(Ctxt(
+                "Unexpected element size " + std::to_string(elementSize)));
+    }
+}
+
+void byteSwapElements(void* buffer, size_t elemSize, size_t numElements)
+{
+    std::byte* const bufferPtr = static_cast<std::byte*>(buffer);
+    switch (elemSize)
+    {
+    case 2:
+        getSwapKernel<2>()(bufferPtr, numElements);
+        break;
+    case 4:
+        getSwapKernel<4>()(bufferPtr, numElements);
+        break;
+    case 8:
+        getSwapKernel<8>()(bufferPtr, numElements);
+        break;
+    default:
+        sys::byteSwap(buffer,
+                      static_cast<unsigned short>(elemSize),
+                      numElements);
+    }
+}
+}
@@ -0,0 +1,70 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/MetadataCache.h>
+
+#include <algorithm>
+#include <tuple>
+
+#include <sys/OS.h>
+
+namespace
+{
+// 64-bit FNV-1a; only has to tell versions of the same file apart
+uint64_t hashBytes(const void* data, size_t size)
+{
+    const auto bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t ii = 0; ii < size; ++ii)
+    {
+        hash ^= bytes[ii];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+}
+
+namespace six
+{
+bool MetadataCacheKey::operator<(const MetadataCacheKey& other) const
+{
+    return std::tie(pathname, fileSize, modifiedTime, xmlHash, schemaPaths) <
+           std::tie(other.pathname, other.fileSize, other.modifiedTime,
+                    other.xmlHash, other.schemaPaths);
+}
+
+MetadataCacheKey MetadataCacheKey::make(
+        const std::string& pathname,
+        const void* xmlBlock,
+        size_t size,
+        const std::vector<std::string>& schemaPaths)
+{
+    const sys::OS os;
+    MetadataCacheKey key;
+    key.pathname = pathname;
+    key.fileSize = os.getSize(pathname);
+    key.modifiedTime = os.getLastModifiedTime(pathname);
+    key.xmlHash = hashBytes(xmlBlock, size);
+    key.schemaPaths = schemaPaths;
+    std::sort(key.schemaPaths.begin(), key.schemaPaths.end());
+    return key;
+}
+}
@@ -22,12 +22,14 @@
 
 #include <assert.h>
 
+#include <future>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <std/memory>
 
 #include <gsl/gsl.h>
+#include <sys/OS.h>
 
 #include <six/NITFReadControl.h>
 #include <six/XMLControlFactory.h>
@@ -91,6 +93,32 @@ six::PixelType getPixelType(const nitf::ImageSubheader& subheader)
     }
     throw except::Exception(Ctxt("Unexpected image representation '" + to_string(iRep) + "'"));
 }
+
+// The rows of one image segment that interleaved() needs
+struct SegmentRead final
+{
+    int imageSegment;
+    uint32_t startRow;
+    uint32_t numRows;
+    six::UByte* buffer;
+};
+
+void readSegment(nitf::ImageReader& imageReader, const SegmentRead& read,
+                 uint32_t startCol, uint32_t numCols)
+{
+    uint32_t bandList(0);
+    nitf::SubWindow sw;
+    sw.setStartRow(read.startRow);
+    sw.setNumRows(read.numRows);
+    sw.setStartCol(startCol);
+    sw.setNumCols(numCols);
+    sw.setNumBands(1);
+    sw.setBandList(&bandList);
+
+    auto bufferPtr = read.buffer;
+    int padded;
+    imageReader.read(sw, &bufferPtr, &padded);
+}
 }
 
 namespace six
@@ -254,11 +282,13 @@ void NITFReadControl::load(const std::string& fromFile, const std::vector<std::s
 {
     auto handle(std::make_shared<nitf::IOHandle>(fromFile));
     load(handle, pSchemaPaths);
+    mPathname = fromFile;
 }
 void NITFReadControl::load(const std::filesystem::path& fromFile, const std::vector<std::filesystem::path>* pSchemaPaths)
 {
     std::shared_ptr<nitf::IOInterface> handle(std::make_shared<nitf::IOHandle>(fromFile.string()));
     load(handle, pSchemaPaths);
+    mPathname = fromFile.string();
 }
 
 void NITFReadControl::load(std::shared_ptr<nitf::IOInterface> ioInterface)
@@ -644,9 +674,6 @@ UByte* NITFReadControl::interleaved(Region& region, size_t imageNumber)
     if (extentCols > numColsTotal || startCol > numColsTotal)
         throw except::Exception(Ctxt(FmtX("Too many cols requested [%d]", numColsReq)));
 
-    // Allocate one band
-    uint32_t bandList(0);
-
     const auto subWindowSize = regionExtent.area() * thisImage.getData()->getNumBytesPerPixel();
 
     auto buffer = region.getBuffer();
@@ -656,12 +683,6 @@ UByte* NITFReadControl::interleaved(Region& region, size_t imageNumber)
     }
 
     // Do segmenting here
-    nitf::SubWindow sw;
-    sw.setStartCol(static_cast<uint32_t>(startCol));
-    sw.setNumCols(static_cast<uint32_t>(numColsReq));
-    sw.setNumBands(1);
-    sw.setBandList(&bandList);
-
     std::vector < NITFSegmentInfo > imageSegments = thisImage.getImageSegments();
     const size_t numIS = imageSegments.size();
     size_t startOff = 0;
@@ -685,36 +706,80 @@ UByte* NITFReadControl::interleaved(Region& region, size_t imageNumber)
     --i; // Need to get rid of the last one
     size_t totalRead = 0;
     auto numRowsLeft = numRowsReq;
-    sw.setStartRow(static_cast<uint32_t>(startRow - startOff));
+    auto segStartRow = static_cast<uint32_t>(startRow - startOff);
 #if DEBUG_OFFSETS
     std::cout << "startRow: " << startRow
     << " startOff: " << startOff
-    << " sw.startRow: " << sw.getStartRow()
+    << " sw.startRow: " << segStartRow
     << " i: " << i << std::endl;
 #endif
 
+    // Each segment lands in its own slice of the buffer
     const auto nbpp = thisImage.getData()->getNumBytesPerPixel();
     const auto startIndex = thisImage.getStartIndex();
-    createCompressionOptions(mCompressionOptions);
+    std::vector<SegmentRead> reads;
     for (; i < numIS && totalRead < subWindowSize; i++)
     {
         const auto numRowsReqSeg =
-                std::min(gsl::narrow<size_t>(numRowsLeft), imageSegments[i].getNumRows() - sw.getStartRow());
-
-        sw.setNumRows(static_cast<uint32_t>(numRowsReqSeg));
-        nitf::ImageReader imageReader = mReader.newImageReader(
-                static_cast<int>(startIndex + i),
-                mCompressionOptions);
-
-        auto bufferPtr = buffer + totalRead;
+                std::min(gsl::narrow<size_t>(numRowsLeft), imageSegments[i].getNumRows() - segStartRow);
 
-        int padded;
-        imageReader.read(sw, &bufferPtr, &padded);
+        reads.push_back({ static_cast<int>(startIndex + i), segStartRow,
+                static_cast<uint32_t>(numRowsReqSeg), buffer + totalRead });
         totalRead += numColsReq * nbpp * numRowsReqSeg;
-        sw.setStartRow(0);
+        segStartRow = 0;
         numRowsLeft -= numRowsReqSeg;
     }
 
+    createCompressionOptions(mCompressionOptions);
+    const auto numThreads = std::min(reads.size(),
+            mNumSegmentThreads == 0 ? sys::OS().getNumCPUs() : mNumSegmentThreads);
+    if (numThreads <= 1 || mPathname.empty())
+    {
+        for (const auto& read : reads)
+        {
+            nitf::ImageReader imageReader = mReader.newImageReader(read.imageSegment, mCompressionOptions);
+            readSegment(imageReader, read, static_cast<uint32_t>(startCol), static_cast<uint32_t>(numColsReq));
+        }
+        return buffer;
+    }
+
+    // mReader has a single file position, so every thread gets its own
+    // handle to the file.  The segment readers come from mReader, whose
+    // record already has each segment's offset, and only the pixel reads
+    // themselves run concurrently.
+    std::vector<nitf::IOHandle> handles;
+    std::vector<nitf::ImageReader> imageReaders;
+    handles.reserve(numThreads);
+    imageReaders.reserve(reads.size());
+    for (size_t thread = 0; thread < numThreads; ++thread)
+    {
+        handles.emplace_back(mPathname);
+    }
+    for (size_t read = 0; read < reads.size(); ++read)
+    {
+        imageReaders.push_back(mReader.newImageReader(reads[read].imageSegment, mCompressionOptions));
+        imageReaders.back().setInput(handles[read % numThreads]);
+    }
+
+    const auto readSegments = [&](size_t thread)
+    {
+        for (size_t read = thread; read < reads.size(); read += numThreads)
+        {
+            readSegment(imageReaders[read], reads[read],
+                        static_cast<uint32_t>(startCol), static_cast<uint32_t>(numColsReq));
+        }
+    };
+    std::vector<std::future<void>> futures;
+    for (size_t thread = 1; thread < numThreads; ++thread)
+    {
+        futures.push_back(std::async(std::launch::async, readSegments, thread));
+    }
+    readSegments(0);
+    for (auto& future : futures)
+    {
+        future.get();
+    }
+
     return buffer;
 }
 
@@ -789,6 +854,7 @@ void NITFReadControl::reset()
     }
     mInfos.clear();
     mInterface.reset();
+    mPathname.clear();
 }
 
 
@@ -0,0 +1,731 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/Pyramid.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <future>
+#include <iomanip>
+#include <sstream>
+#include <std/cstddef>
+#include <utility>
+
+#include <except/Exception.h>
+#include <gsl/gsl.h>
+#include <nitf/BufferedWriter.hpp>
+#include <nitf/Writer.hpp>
+#include <sys/Conf.h>
+#include <sys/OS.h>
+
+#include <six/Data.h>
+#include <six/NITFHeaderCreator.h>
+#include <six/Region.h>
+
+#undef min
+#undef max
+
+namespace
+{
+// Calls func(begin, end) on up to numThreads contiguous pieces of
+// [0, count), each at least minPerThread long, and waits for all of them
+template <typename TFunc>
+void forEachRange(size_t count, size_t numThreads, size_t minPerThread,
+                  const TFunc& func)
+{
+    const auto numPieces = std::max<size_t>(1,
+            std::min(numThreads, count / std::max<size_t>(minPerThread, 1)));
+    if (numPieces <= 1)
+    {
+        func(0, count);
+        return;
+    }
+
+    const auto perPiece = (count + numPieces - 1) / numPieces;
+    std::vector<std::future<void>> futures;
+    for (size_t begin = perPiece; begin < count; begin += perPiece)
+    {
+        futures.push_back(std::async(std::launch::async, func, begin,
+                                     std::min(count, begin + perPiece)));
+    }
+    func(0, perPiece);
+    for (auto& future : futures)
+    {
+        future.get();
+    }
+}
+
+// Rows below this many input samples are not worth a thread of their own
+constexpr size_t MIN_SAMPLES_PER_THREAD = 1 << 16;
+
+// Averages 2x2 blocks of rows 'top' and 'bottom', or 2x1 blocks of 'top'
+// alone when 'bottom' is nullptr.  The last column of an odd-width row
+// is averaged by itself.
+void reduceRow(const float* top, const float* bottom, size_t inputCols,
+               size_t numBands, float* out)
+{
+    const auto numPairs = inputCols / 2;
+    if (bottom != nullptr)
+    {
+        for (size_t col = 0; col < numPairs; ++col)
+        {
+            const auto* const t = top + 2 * col * numBands;
+            const auto* const b = bottom + 2 * col * numBands;
+            for (size_t band = 0; band < numBands; ++band)
+            {
+                out[col * numBands + band] = 0.25f *
+                        ((t[band] + t[band + numBands]) +
+                         (b[band] + b[band + numBands]));
+            }
+        }
+        if (inputCols % 2)
+        {
+            const auto offset = (inputCols - 1) * numBands;
+            for (size_t band = 0; band < numBands; ++band)
+            {
+                out[numPairs * numBands + band] = 0.5f *
+                        (top[offset + band] + bottom[offset + band]);
+            }
+        }
+    }
+    else
+    {
+        for (size_t col = 0; col < numPairs; ++col)
+        {
+            const auto* const t = top + 2 * col * numBands;
+            for (size_t band = 0; band < numBands; ++band)
+            {
+                out[col * numBands + band] =
+                        0.5f * (t[band] + t[band + numBands]);
+            }
+        }
+        if (inputCols % 2)
+        {
+            const auto offset = (inputCols - 1) * numBands;
+            std::copy(top + offset, top + offset + numBands,
+                      out + numPairs * numBands);
+        }
+    }
+}
+
+//! How the pixels of one input are detected and written out
+struct PyramidFormat final
+{
+    size_t numBands = 1;
+    size_t bytesPerSample = 1;
+    nitf::PixelValueType pixelValueType = nitf::PixelValueType::Integer;
+    nitf::ImageRepresentation imageRepresentation =
+            nitf::ImageRepresentation::MONO;
+
+    //! Turns 'numPixels' raw pixels into numPixels * numBands samples
+    std::function<void(const std::byte*, size_t, float*)> toSamples;
+};
+
+template <typename T>
+std::function<void(const std::byte*, size_t, float*)> integerSamples(
+        size_t numBands)
+{
+    return [numBands](const std::byte* in, size_t numPixels, float* out)
+    {
+        for (size_t ii = 0; ii < numPixels * numBands; ++ii)
+        {
+            T value;
+            memcpy(&value, in + ii * sizeof(T), sizeof(T));
+            out[ii] = static_cast<float>(value);
+        }
+    };
+}
+
+PyramidFormat getFormat(const six::Data& data)
+{
+    PyramidFormat format;
+
+    const auto pixelType = data.getPixelType();
+    switch (pixelType)
+    {
+    case six::PixelType::RE32F_IM32F:
+        format.toSamples = [](const std::byte* in, size_t numPixels, float* out)
+        {
+            for (size_t ii = 0; ii < numPixels; ++ii)
+            {
+                std::array<float, 2> value;
+                memcpy(value.data(), in + ii * sizeof(value), sizeof(value));
+                out[ii] = std::abs(std::complex<float>(value[0], value[1]));
+            }
+        };
+        break;
+    case six::PixelType::RE16I_IM16I:
+        format.toSamples = [](const std::byte* in, size_t numPixels, float* out)
+        {
+            for (size_t ii = 0; ii < numPixels; ++ii)
+            {
+                std::array<int16_t, 2> value;
+                memcpy(value.data(), in + ii * sizeof(value), sizeof(value));
+                out[ii] = std::abs(std::complex<float>(value[0], value[1]));
+            }
+        };
+        break;
+    case six::PixelType::AMP8I_PHS8I:
+    {
+        // The magnitude only depends on the amplitude byte
+        std::array<float, 256> amplitudes;
+        const auto* const table = data.getAmplitudeTable();
+        for (size_t ii = 0; ii < amplitudes.size(); ++ii)
+        {
+            amplitudes[ii] = static_cast<float>(
+                    table == nullptr ? ii : table->index(ii));
+        }
+        format.toSamples = [amplitudes](const std::byte* in, size_t numPixels,
+                                        float* out)
+        {
+            for (size_t ii = 0; ii < numPixels; ++ii)
+            {
+                out[ii] = amplitudes[static_cast<uint8_t>(in[2 * ii])];
+            }
+        };
+        break;
+    }
+    case six::PixelType::MONO8I:
+        format.toSamples = integerSamples<uint8_t>(1);
+        break;
+    case six::PixelType::MONO16I:
+        format.bytesPerSample = 2;
+        format.toSamples = integerSamples<uint16_t>(1);
+        break;
+    case six::PixelType::RGB24I:
+        format.numBands = 3;
+        format.imageRepresentation = nitf::ImageRepresentation::RGB;
+        format.toSamples = integerSamples<uint8_t>(3);
+        break;
+    case six::PixelType::MONO8LU:
+    case six::PixelType::RGB8LU:
+    {
+        const auto& lut = data.getDisplayLUT();
+        if (lut.get() == nullptr)
+        {
+            if (pixelType == six::PixelType::MONO8LU)
+            {
+                format.toSamples = integerSamples<uint8_t>(1);
+                break;
+            }
+            throw except::Exception(Ctxt("RGB8LU image has no lookup table"));
+        }
+
+        // Averaging lookup table indices is meaningless, so apply the
+        // table first
+        const auto elementSize = lut->elementSize;
+        std::vector<float> table(lut->numEntries * elementSize);
+        if (pixelType == six::PixelType::RGB8LU)
+        {
+            if (elementSize != 3)
+            {
+                throw except::Exception(Ctxt(
+                        "Unexpected RGB8LU lookup table element size: " +
+                        std::to_string(elementSize)));
+            }
+            format.numBands = 3;
+            format.imageRepresentation = nitf::ImageRepresentation::RGB;
+            for (size_t ii = 0; ii < table.size(); ++ii)
+            {
+                table[ii] = lut->table[ii];
+            }
+        }
+        else if (elementSize == 2)
+        {
+            format.bytesPerSample = 2;
+            table.resize(lut->numEntries);
+            for (size_t ii = 0; ii < lut->numEntries; ++ii)
+            {
+                uint16_t value;
+                memcpy(&value, (*lut)[ii], sizeof(value));
+                table[ii] = value;
+            }
+        }
+        else if (elementSize == 1)
+        {
+            for (size_t ii = 0; ii < table.size(); ++ii)
+            {
+                table[ii] = lut->table[ii];
+            }
+        }
+        else
+        {
+            throw except::Exception(Ctxt(
+                    "Unexpected MONO8LU lookup table element size: " +
+                    std::to_string(elementSize)));
+        }
+
+        const auto numBands = format.numBands;
+        const auto numEntries = lut->numEntries;
+        format.toSamples = [table, numBands, numEntries](
+                const std::byte* in, size_t numPixels, float* out)
+        {
+            for (size_t ii = 0; ii < numPixels; ++ii)
+            {
+                const auto index = std::min<size_t>(
+                        static_cast<uint8_t>(in[ii]), numEntries - 1);
+                std::copy(&table[index * numBands],
+                          &table[index * numBands] + numBands,
+                          out + ii * numBands);
+            }
+        };
+        break;
+    }
+    default:
+        throw except::Exception(Ctxt("Cannot build a pyramid of pixel type " +
+                                     pixelType.toString()));
+    }
+
+    if (data.getDataType() == six::DataType::COMPLEX)
+    {
+        format.bytesPerSample = sizeof(float);
+        format.pixelValueType = nitf::PixelValueType::Floating;
+    }
+    return format;
+}
+
+// Rounds and converts samples to the output type, big endian
+void fromSamples(const float* in, size_t count, const PyramidFormat& format,
+                 std::byte* out)
+{
+    if (format.pixelValueType == nitf::PixelValueType::Floating)
+    {
+        memcpy(out, in, count * sizeof(float));
+    }
+    else if (format.bytesPerSample == 2)
+    {
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            const auto value = static_cast<uint16_t>(in[ii] + 0.5f);
+            memcpy(out + ii * sizeof(value), &value, sizeof(value));
+        }
+    }
+    else
+    {
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            out[ii] = static_cast<std::byte>(static_cast<uint8_t>(in[ii] + 0.5f));
+        }
+    }
+
+    if (format.bytesPerSample > 1 && !sys::isBigEndianSystem())
+    {
+        sys::byteSwap(out, static_cast<unsigned short>(format.bytesPerSample),
+                      count);
+    }
+}
+
+// The IMAG field only has room for "/2" through "/512"
+constexpr size_t MAX_NUM_LEVELS = 9;
+
+void setupRecord(const nitf::Record& input,
+                 size_t imageSegmentIndex,
+                 const types::RowCol<size_t>& dims,
+                 size_t numLevels,
+                 const PyramidFormat& format,
+                 nitf::Record& record)
+{
+    const nitf::FileHeader inputHeader = input.getHeader();
+    nitf::FileHeader header = record.getHeader();
+    header.getFileHeader().set("NITF");
+    header.getComplianceLevel().set("09");
+    header.getSystemType().set("BF01");
+    header.getOriginStationID().set(inputHeader.getOriginStationID().toString());
+    header.getFileTitle().set(inputHeader.getFileTitle().toString());
+    header.getClassification().set(inputHeader.getClassification().toString());
+    header.setSecurityGroup(inputHeader.getSecurityGroup().clone());
+
+    // Date, time and security come from the image being reduced, which
+    // isn't the first in a file of several SIDD products
+    nitf::ImageSubheader inputSubheader = nitf::ImageSegment(
+            input.getImages()[imageSegmentIndex]).getSubheader();
+
+    for (size_t level = 1; level <= numLevels; ++level)
+    {
+        const auto levelDims = six::PyramidBuilder::getLevelDims(dims, level);
+
+        nitf::ImageSegment segment = record.newImageSegment();
+        nitf::ImageSubheader subheader = segment.getSubheader();
+
+        std::ostringstream imageId;
+        imageId << "LEVEL" << std::setw(2) << std::setfill('0') << level;
+        subheader.getImageId().set(imageId.str());
+        subheader.getImageDateAndTime().set(
+                inputSubheader.getImageDateAndTime().toString());
+        subheader.getImageSecurityClass().set(
+                inputSubheader.getImageSecurityClass().toString());
+        subheader.setSecurityGroup(inputSubheader.getSecurityGroup().clone());
+        subheader.getImageSource().set(
+                inputSubheader.getImageSource().toString());
+
+        std::vector<nitf::BandInfo> bands(format.numBands);
+        const nitf::Representation rgb[] = { nitf::Representation::R,
+                                             nitf::Representation::G,
+                                             nitf::Representation::B };
+        for (size_t band = 0; band < bands.size(); ++band)
+        {
+            bands[band].init(format.numBands == 3 ? rgb[band]
+                                                  : nitf::Representation::M,
+                             nitf::Subcategory::None, "N", "   ");
+        }
+        const auto numBits = gsl::narrow<uint32_t>(format.bytesPerSample * 8);
+        subheader.setPixelInformation(format.pixelValueType, numBits, numBits,
+                                      "R", format.imageRepresentation, "SAR",
+                                      bands);
+
+        // One block; NITRO writes 0 for blocks wider or taller than 8192
+        subheader.setBlocking(gsl::narrow<uint32_t>(levelDims.row),
+                              gsl::narrow<uint32_t>(levelDims.col),
+                              gsl::narrow<uint32_t>(levelDims.row),
+                              gsl::narrow<uint32_t>(levelDims.col),
+                              format.numBands == 1 ? nitf::BlockingMode::Block
+                                                   : nitf::BlockingMode::Pixel);
+
+        subheader.getImageDisplayLevel().set(gsl::narrow<uint32_t>(level));
+        subheader.getImageAttachmentLevel().set(static_cast<uint32_t>(0));
+        subheader.getImageLocation().set("0000000000");
+        subheader.getImageMagnification().set("/" + std::to_string(1 << level));
+    }
+}
+
+/*
+ * Writes the file header and every image subheader, leaving room for the
+ * image data after each, and returns the file offset of each image's data.
+ * This is the same layout nitf::ByteProvider works out, but the levels all
+ * have different sizes.
+ */
+std::vector<nitf::Off> writeHeaders(nitf::Record& record,
+                                    const std::vector<uint64_t>& dataLengths,
+                                    nitf::IOInterface& io)
+{
+    nitf::Writer writer;
+    writer.prepareIO(io, record);
+
+    record.setComplexityLevelIfUnset();
+    nitf::Off fileLengthOffset;
+    uint32_t headerLength;
+    io.seek(0, NITF_SEEK_SET);
+    writer.writeHeader(fileLengthOffset, headerLength);
+
+    std::vector<uint64_t> subheaderLengths(dataLengths.size());
+    std::vector<nitf::Off> dataOffsets(dataLengths.size());
+    for (size_t ii = 0; ii < dataLengths.size(); ++ii)
+    {
+        const auto subheaderOffset = io.tell();
+        nitf::Off comratOffset;
+        writer.writeImageSubheader(
+                nitf::ImageSegment(record.getImages()[ii]).getSubheader(),
+                record.getVersion(), comratOffset);
+        dataOffsets[ii] = io.tell();
+        subheaderLengths[ii] = dataOffsets[ii] - subheaderOffset;
+        io.seek(dataOffsets[ii] + gsl::narrow<nitf::Off>(dataLengths[ii]),
+                NITF_SEEK_SET);
+    }
+    const auto fileLength = io.tell();
+
+    // Now that the lengths are known, fill them in
+    io.seek(fileLengthOffset, NITF_SEEK_SET);
+    writer.writeInt64Field(fileLength, NITF_FL_SZ, '0', NITF_WRITER_FILL_LEFT);
+    writer.writeInt64Field(headerLength, NITF_HL_SZ, '0', NITF_WRITER_FILL_LEFT);
+    io.seek(fileLengthOffset + NITF_FL_SZ + NITF_HL_SZ + NITF_NUMI_SZ,
+            NITF_SEEK_SET);
+    for (size_t ii = 0; ii < dataLengths.size(); ++ii)
+    {
+        writer.writeInt64Field(subheaderLengths[ii], NITF_LISH_SZ, '0',
+                               NITF_WRITER_FILL_LEFT);
+        writer.writeInt64Field(dataLengths[ii], NITF_LI_SZ, '0',
+                               NITF_WRITER_FILL_LEFT);
+    }
+    return dataOffsets;
+}
+}
+
+namespace six
+{
+PyramidBuilder::PyramidBuilder(const types::RowCol<size_t>& dims,
+                               size_t numBands,
+                               size_t numLevels,
+                               RowSink sink,
+                               size_t numThreads) :
+    mDims(dims),
+    mNumBands(numBands),
+    mSink(std::move(sink)),
+    mNumThreads(numThreads == 0 ? sys::OS().getNumCPUs() : numThreads),
+    mLevels(numLevels)
+{
+    if (dims.row == 0 || dims.col == 0 || numBands == 0)
+    {
+        throw except::Exception(Ctxt("Image must be non-empty"));
+    }
+    if (!mSink)
+    {
+        throw except::Exception(Ctxt("A row sink is required"));
+    }
+
+    for (size_t level = 0; level < numLevels; ++level)
+    {
+        mLevels[level].inputDims = getLevelDims(dims, level);
+        mLevels[level].dims = getLevelDims(dims, level + 1);
+        mLevels[level].carry.resize(mLevels[level].inputDims.col * numBands);
+    }
+}
+
+types::RowCol<size_t>
+PyramidBuilder::getLevelDims(const types::RowCol<size_t>& dims, size_t level)
+{
+    types::RowCol<size_t> levelDims(dims);
+    for (size_t ii = 0; ii < level; ++ii)
+    {
+        levelDims.row = (levelDims.row + 1) / 2;
+        levelDims.col = (levelDims.col + 1) / 2;
+    }
+    return levelDims;
+}
+
+size_t PyramidBuilder::getNumLevels(const types::RowCol<size_t>& dims,
+                                    size_t maxDim)
+{
+    if (maxDim == 0)
+    {
+        throw except::Exception(Ctxt("Levels can't be smaller than 1 x 1"));
+    }
+
+    size_t numLevels = 0;
+    for (auto levelDims = dims;
+         levelDims.row > maxDim || levelDims.col > maxDim;
+         levelDims = getLevelDims(levelDims, 1))
+    {
+        ++numLevels;
+    }
+    return numLevels;
+}
+
+void PyramidBuilder::addRows(const float* rows, size_t numRows)
+{
+    if (numRows > mDims.row - mNumRowsAdded)
+    {
+        throw except::Exception(Ctxt(
+                "Adding " + std::to_string(numRows) + " rows after " +
+                std::to_string(mNumRowsAdded) + " would exceed the " +
+                std::to_string(mDims.row) + " rows in the image"));
+    }
+    mNumRowsAdded += numRows;
+
+    if (numRows > 0 && !mLevels.empty())
+    {
+        reduce(0, rows, numRows);
+    }
+}
+
+void PyramidBuilder::reduce(size_t levelIndex, const float* rows, size_t numRows)
+{
+    Level& level = mLevels[levelIndex];
+    const auto inputStride = level.inputDims.col * mNumBands;
+    const auto stride = level.dims.col * mNumBands;
+
+    level.numInputRowsSeen += numRows;
+    const bool isLastInput = level.numInputRowsSeen == level.inputDims.row;
+    const auto numInputRows = numRows + (level.haveCarry ? 1 : 0);
+    const auto numOutputRows = numInputRows / 2 +
+            (isLastInput ? numInputRows % 2 : 0);
+    if (level.rows.size() < numOutputRows * stride)
+    {
+        level.rows.resize(numOutputRows * stride);
+    }
+    float* const out = level.rows.data();
+
+    // Finish the row left over from last time
+    size_t row = 0;
+    if (level.haveCarry)
+    {
+        reduceRow(level.carry.data(), rows, level.inputDims.col, mNumBands, out);
+        level.haveCarry = false;
+        rows += inputStride;
+        --numRows;
+        ++row;
+    }
+
+    const auto numPairs = numRows / 2;
+    const auto minPairsPerThread = MIN_SAMPLES_PER_THREAD / (2 * inputStride) + 1;
+    float* const pairsOut = out + row * stride;
+    forEachRange(numPairs, mNumThreads, minPairsPerThread,
+                 [&](size_t begin, size_t end)
+    {
+        for (size_t pair = begin; pair < end; ++pair)
+        {
+            reduceRow(rows + 2 * pair * inputStride,
+                      rows + (2 * pair + 1) * inputStride,
+                      level.inputDims.col, mNumBands, pairsOut + pair * stride);
+        }
+    });
+    row += numPairs;
+
+    if (numRows % 2)
+    {
+        const float* const last = rows + (numRows - 1) * inputStride;
+        if (isLastInput)
+        {
+            reduceRow(last, nullptr, level.inputDims.col, mNumBands,
+                      out + row * stride);
+            ++row;
+        }
+        else
+        {
+            std::copy(last, last + inputStride, level.carry.begin());
+            level.haveCarry = true;
+        }
+    }
+
+    if (row == 0)
+    {
+        return;
+    }
+
+    const auto startRow = level.numRowsDone;
+    level.numRowsDone += row;
+    mSink(levelIndex + 1, startRow, row, out);
+    if (levelIndex + 1 < mLevels.size())
+    {
+        reduce(levelIndex + 1, out, row);
+    }
+}
+
+void writePyramid(NITFReadControl& reader,
+                  const std::string& outPathname,
+                  size_t numLevels,
+                  size_t imageNumber,
+                  size_t numRowsPerRead,
+                  size_t numThreads)
+{
+    const auto container = reader.getContainer();
+    if (container.get() == nullptr)
+    {
+        throw except::Exception(Ctxt(
+                "load() must be called prior to calling writePyramid()"));
+    }
+    const Data& data = *container->getData(imageNumber);
+    const auto dims = getExtent(data);
+    const auto format = getFormat(data);
+
+    if (numLevels == 0)
+    {
+        numLevels = std::max<size_t>(1, std::min(MAX_NUM_LEVELS,
+                PyramidBuilder::getNumLevels(dims, 256)));
+    }
+    if (numLevels > MAX_NUM_LEVELS)
+    {
+        throw except::Exception(Ctxt(
+                "At most " + std::to_string(MAX_NUM_LEVELS) +
+                " levels are supported"));
+    }
+    numThreads = numThreads == 0 ? sys::OS().getNumCPUs() : numThreads;
+    numRowsPerRead = std::max<size_t>(1, std::min(numRowsPerRead, dims.row));
+
+    // Lay out the output
+    nitf::Record record(NITF_VER_21);
+    setupRecord(reader.getRecord(), reader.getImageSegmentIndex(imageNumber),
+                dims, numLevels, format, record);
+    std::vector<uint64_t> dataLengths(numLevels);
+    for (size_t level = 1; level <= numLevels; ++level)
+    {
+        dataLengths[level - 1] =
+                PyramidBuilder::getLevelDims(dims, level).area() *
+                format.numBands * format.bytesPerSample;
+        if (dataLengths[level - 1] > 9999999999ULL)
+        {
+            throw except::Exception(Ctxt(
+                    "Level " + std::to_string(level) +
+                    " is too large for a single image segment"));
+        }
+    }
+    nitf::BufferedWriter io(outPathname, NITFHeaderCreator::DEFAULT_BUFFER_SIZE);
+    const auto dataOffsets = writeHeaders(record, dataLengths, io);
+
+    // Every level is written as its rows are finished
+    std::vector<std::byte> staging;
+    const auto writeRows = [&](size_t level, size_t startRow, size_t numRows,
+                               const float* rows)
+    {
+        const auto numSamplesPerRow =
+                PyramidBuilder::getLevelDims(dims, level).col * format.numBands;
+        const auto numSamples = numRows * numSamplesPerRow;
+        staging.resize(numSamples * format.bytesPerSample);
+        fromSamples(rows, numSamples, format, staging.data());
+
+        io.seek(dataOffsets[level - 1] + gsl::narrow<nitf::Off>(
+                        startRow * numSamplesPerRow * format.bytesPerSample),
+                NITF_SEEK_SET);
+        io.write(staging.data(), staging.size());
+    };
+    PyramidBuilder builder(dims, format.numBands, numLevels, writeRows,
+                           numThreads);
+
+    // Read the next block of rows while this one is reduced
+    const auto numBytesPerRow = dims.col * data.getNumBytesPerPixel();
+    std::array<std::vector<std::byte>, 2> buffers;
+    buffers[0].resize(numRowsPerRead * numBytesPerRow);
+    buffers[1].resize(numRowsPerRead * numBytesPerRow);
+    const auto readRows = [&](size_t startRow, std::byte* buffer)
+    {
+        Region region;
+        region.setStartRow(gsl::narrow<ptrdiff_t>(startRow));
+        region.setNumRows(gsl::narrow<ptrdiff_t>(
+                std::min(numRowsPerRead, dims.row - startRow)));
+        region.setStartCol(0);
+        region.setNumCols(gsl::narrow<ptrdiff_t>(dims.col));
+        region.setBuffer(buffer);
+        reader.interleaved(region, imageNumber);
+    };
+
+    std::vector<float> samples(numRowsPerRead * dims.col * format.numBands);
+    auto pending = std::async(std::launch::async, readRows, 0,
+                              buffers[0].data());
+    for (size_t startRow = 0, current = 0; startRow < dims.row;
+         startRow += numRowsPerRead, current ^= 1)
+    {
+        pending.get();
+        const auto nextRow = startRow + numRowsPerRead;
+        if (nextRow < dims.row)
+        {
+            pending = std::async(std::launch::async, readRows, nextRow,
+                                 buffers[current ^ 1].data());
+        }
+
+        const auto numRows = std::min(numRowsPerRead, dims.row - startRow);
+        const auto* const raw = buffers[current].data();
+        forEachRange(numRows, numThreads,
+                     MIN_SAMPLES_PER_THREAD / (dims.col * format.numBands) + 1,
+                     [&](size_t begin, size_t end)
+        {
+            format.toSamples(raw + begin * numBytesPerRow,
+                             (end - begin) * dims.col,
+                             samples.data() + begin * dims.col * format.numBands);
+        });
+
+        builder.addRows(samples.data(), numRows);
+    }
+
+    io.close();
+}
+}
@@ -0,0 +1,194 @@
+/* =========================================================================
+* This file is part of six-c++
+* =========================================================================
+*
+* (C) Copyright 2004 - 2018, MDA Information Systems LLC
+*
+* six-c++ is free software; you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this program; If not,
+* see <http://www.gnu.org/licenses/>.
+*
+*/
+#include <algorithm>
+#include <vector>
+
+#include "TestCase.h"
+#include <except/Exception.h>
+#include <six/Pyramid.h>
+
+namespace
+{
+// Reduces a whole level at once, the obvious way
+std::vector<float> reduceLevel(const std::vector<float>& input,
+                               const types::RowCol<size_t>& inputDims,
+                               size_t numBands)
+{
+    const types::RowCol<size_t> dims((inputDims.row + 1) / 2,
+                                     (inputDims.col + 1) / 2);
+    std::vector<float> output(dims.area() * numBands);
+    for (size_t row = 0; row < dims.row; ++row)
+    {
+        for (size_t col = 0; col < dims.col; ++col)
+        {
+            for (size_t band = 0; band < numBands; ++band)
+            {
+                float sum = 0;
+                size_t count = 0;
+                for (size_t ii = 2 * row;
+                     ii < std::min(2 * row + 2, inputDims.row); ++ii)
+                {
+                    for (size_t jj = 2 * col;
+                         jj < std::min(2 * col + 2, inputDims.col); ++jj)
+                    {
+                        sum += input[(ii * inputDims.col + jj) * numBands +
+                                     band];
+                        ++count;
+                    }
+                }
+                output[(row * dims.col + col) * numBands + band] = sum / count;
+            }
+        }
+    }
+    return output;
+}
+
+bool buildsReference(const types::RowCol<size_t>& dims, size_t numBands,
+                     size_t numLevels, size_t rowsPerCall, size_t numThreads)
+{
+    std::vector<float> image(dims.area() * numBands);
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<float>((ii * 37) % 101);
+    }
+
+    std::vector<std::vector<float> > levels(numLevels + 1);
+    std::vector<size_t> nextRow(numLevels + 1, 0);
+    six::PyramidBuilder builder(dims, numBands, numLevels,
+            [&](size_t level, size_t startRow, size_t numRows,
+                const float* rows)
+            {
+                const auto levelDims =
+                        six::PyramidBuilder::getLevelDims(dims, level);
+                if (level < 1 || level > numLevels ||
+                    startRow != nextRow[level])
+                {
+                    throw except::Exception(Ctxt("Rows out of order"));
+                }
+                nextRow[level] += numRows;
+                levels[level].insert(levels[level].end(), rows,
+                        rows + numRows * levelDims.col * numBands);
+            },
+            numThreads);
+
+    for (size_t row = 0; row < dims.row; row += rowsPerCall)
+    {
+        if (builder.isComplete())
+        {
+            return false;
+        }
+        builder.addRows(&image[row * dims.col * numBands],
+                        std::min(rowsPerCall, dims.row - row));
+    }
+    if (!builder.isComplete())
+    {
+        return false;
+    }
+
+    std::vector<float> expected = image;
+    for (size_t level = 1; level <= numLevels; ++level)
+    {
+        const auto inputDims =
+                six::PyramidBuilder::getLevelDims(dims, level - 1);
+        expected = reduceLevel(expected, inputDims, numBands);
+        if (nextRow[level] != six::PyramidBuilder::getLevelDims(
+                                      dims, level).row ||
+            levels[level].size() != expected.size())
+        {
+            return false;
+        }
+        for (size_t ii = 0; ii < expected.size(); ++ii)
+        {
+            if (std::abs(levels[level][ii] - expected[ii]) > 1e-4f)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+}
+
+TEST_CASE(LevelDims)
+{
+    const types::RowCol<size_t> dims(1000, 37);
+    TEST_ASSERT_EQ(six::PyramidBuilder::getLevelDims(dims, 0).row,
+                   static_cast<size_t>(1000));
+    TEST_ASSERT_EQ(six::PyramidBuilder::getLevelDims(dims, 1).col,
+                   static_cast<size_t>(19));
+    TEST_ASSERT_EQ(six::PyramidBuilder::getLevelDims(dims, 3).row,
+                   static_cast<size_t>(125));
+    TEST_ASSERT_EQ(six::PyramidBuilder::getLevelDims(dims, 3).col,
+                   static_cast<size_t>(5));
+    TEST_ASSERT_EQ(six::PyramidBuilder::getLevelDims(dims, 20).col,
+                   static_cast<size_t>(1));
+
+    TEST_ASSERT_EQ(six::PyramidBuilder::getNumLevels(dims, 1000),
+                   static_cast<size_t>(0));
+    TEST_ASSERT_EQ(six::PyramidBuilder::getNumLevels(dims, 256),
+                   static_cast<size_t>(2));
+    TEST_ASSERT_EQ(six::PyramidBuilder::getNumLevels(dims, 1),
+                   static_cast<size_t>(10));
+}
+
+TEST_CASE(OddSizes)
+{
+    const types::RowCol<size_t> dims(45, 23);
+    for (size_t rowsPerCall : {1, 2, 3, 7, 45})
+    {
+        TEST_ASSERT_TRUE(buildsReference(dims, 1, 4, rowsPerCall, 1));
+    }
+    TEST_ASSERT_TRUE(buildsReference(types::RowCol<size_t>(1, 1), 1, 2, 1, 1));
+}
+
+TEST_CASE(MultipleBands)
+{
+    TEST_ASSERT_TRUE(buildsReference(types::RowCol<size_t>(32, 17), 3, 3,
+                                     5, 1));
+}
+
+TEST_CASE(MultipleThreads)
+{
+    // Wide enough rows that the reduction is spread over threads
+    TEST_ASSERT_TRUE(buildsReference(types::RowCol<size_t>(19, 70001), 1, 2,
+                                     4, 4));
+}
+
+TEST_CASE(TooManyRows)
+{
+    const types::RowCol<size_t> dims(3, 4);
+    const std::vector<float> rows(4 * 4);
+    six::PyramidBuilder builder(dims, 1, 1,
+            [](size_t, size_t, size_t, const float*) {});
+    TEST_EXCEPTION(builder.addRows(rows.data(), 4));
+    builder.addRows(rows.data(), 3);
+    TEST_ASSERT_TRUE(builder.isComplete());
+    TEST_EXCEPTION(builder.addRows(rows.data(), 1));
+}
+
+TEST_MAIN(
+    TEST_CHECK(LevelDims);
+    TEST_CHECK(OddSizes);
+    TEST_CHECK(MultipleBands);
+    TEST_CHECK(MultipleThreads);
+    TEST_CHECK(TooManyRows);
+    )
@@ -0,0 +1,594 @@
+/*
+ * =========================================================================
+ * This file is part of crsd-python
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * crsd-python is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ */
+
+%module(package="pysix") crsd
+
+%feature("autodoc", "1");
+%feature("flatnested");
+
+%include <std_string.i>
+%include <std_vector.i>
+
+%import "except.i"
+%import "sys.i"
+%import "types.i"
+%import "mem.i"
+%import "six_sicd.i"
+%import "six.i"
+%import "math_poly.i"
+%import "math_linear.i"
+%import "scene.i"
+
+%{
+#include "import/types.h"
+#include "import/crsd.h"
+#include "import/six.h"
+#include "import/six/sicd.h"
+#include "import/sys.h"
+#include <numpyutils/numpyutils.h>
+
+using six::Vector2;
+using six::Vector3;
+
+namespace
+{
+static_assert(sizeof(Vector3) == 3 * sizeof(double),
+              "PVP vectors must be packed to be viewed as arrays");
+static_assert(sizeof(Vector2) == 2 * sizeof(double),
+              "PVP vectors must be packed to be viewed as arrays");
+
+// Structured dtype from a list of (name, format) pairs
+PyArray_Descr* makeDescr(const char* name0, const char* format0,
+                         const char* name1, const char* format1)
+{
+    PyObject* spec = Py_BuildValue("[(ss)(ss)]",
+                                   name0, format0, name1, format1);
+    if (spec == nullptr)
+    {
+        throw except::Exception(Ctxt("Unable to build NumPy dtype"));
+    }
+    PyArray_Descr* descr = nullptr;
+    const int converted = PyArray_DescrConverter(spec, &descr);
+    Py_DECREF(spec);
+    if (!converted)
+    {
+        throw except::Exception(Ctxt("Unable to build NumPy dtype"));
+    }
+    return descr;
+}
+
+// Integer and fractional seconds, as in RcvStart and RefPhi0
+PyArray_Descr* getTimeDescr()
+{
+    return makeDescr("int", "=i8", "frac", "=f8");
+}
+
+// dtype of one signal sample of 'elementSize' bytes; CI2 and CI4 have no
+// NumPy complex type so they get a (real, imag) record. Samples read into
+// memory are in native order, 'bigEndian' describes them as in the file.
+PyArray_Descr* getSampleDescr(size_t elementSize, bool bigEndian = false)
+{
+    switch (elementSize)
+    {
+    case 2:
+        return makeDescr("real", "|i1", "imag", "|i1");
+    case 4:
+        return bigEndian ? makeDescr("real", ">i2", "imag", ">i2") :
+                           makeDescr("real", "=i2", "imag", "=i2");
+    case 8:
+    {
+        PyArray_Descr* descr = PyArray_DescrFromType(NPY_COMPLEX64);
+        if (bigEndian)
+        {
+            PyArray_Descr* swapped = PyArray_DescrNewByteorder(descr, NPY_BIG);
+            Py_DECREF(descr);
+            if (swapped == nullptr)
+            {
+                throw except::Exception(Ctxt("Unable to build NumPy dtype"));
+            }
+            descr = swapped;
+        }
+        return descr;
+    }
+    default:
+        throw except::Exception(Ctxt(
+                "Unsupported signal element size " +
+                std::to_string(elementSize)));
+    }
+}
+
+/*
+ * Read-only array over memory that belongs to 'owner'. The array holds a
+ * reference to 'owner', so the memory outlives every view of it.
+ * Steals the reference to 'descr'.
+ */
+PyObject* makeView(PyObject* owner,
+                   PyArray_Descr* descr,
+                   int numDims,
+                   npy_intp* dims,
+                   const void* data)
+{
+    if (data == nullptr)
+    {
+        // Empty (e.g. an optional PVP that isn't present)
+        PyObject* array = PyArray_Zeros(numDims, dims, descr, 0);
+        numpyutils::verifyNewPyObject(array);
+        return array;
+    }
+
+    PyObject* array = PyArray_NewFromDescr(
+            &PyArray_Type, descr, numDims, dims, nullptr,
+            const_cast<void*>(data),
+            NPY_ARRAY_C_CONTIGUOUS | NPY_ARRAY_ALIGNED,
+            nullptr);
+    numpyutils::verifyNewPyObject(array);
+    // Mapped file bytes needn't be aligned for the dtype
+    PyArray_UpdateFlags(reinterpret_cast<PyArrayObject*>(array),
+                        NPY_ARRAY_ALIGNED);
+
+    Py_INCREF(owner);
+    if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(array),
+                              owner) < 0)
+    {
+        Py_DECREF(array);
+        throw except::Exception(Ctxt("Unable to set NumPy array base"));
+    }
+    return array;
+}
+
+template <typename T>
+PyObject* makeColumnView(PyObject* owner,
+                         std::span<const T> column,
+                         PyArray_Descr* descr,
+                         npy_intp components = 1)
+{
+    npy_intp dims[2] = {static_cast<npy_intp>(column.size()), components};
+    return makeView(owner, descr, components > 1 ? 2 : 1, dims,
+                    column.data());
+}
+
+// C-contiguous array of whole samples of 'elementSize' bytes
+PyArrayObject* verifySignalArray(PyObject* array, size_t elementSize)
+{
+    numpyutils::verifyArray(array);
+    auto pyArray = reinterpret_cast<PyArrayObject*>(array);
+    if (!PyArray_IS_C_CONTIGUOUS(pyArray))
+    {
+        throw except::Exception(Ctxt("Array must be C contiguous"));
+    }
+    if (static_cast<size_t>(PyArray_ITEMSIZE(pyArray)) != elementSize)
+    {
+        throw except::Exception(Ctxt(
+                "Array elements must be " + std::to_string(elementSize) +
+                " bytes to match the signal array format"));
+    }
+    return pyArray;
+}
+}
+%}
+
+%init
+%{
+    import_array();
+%}
+
+%ignore crsd::CRSDXMLControl::toXML(const Metadata& metadata);
+%ignore crsd::CRSDXMLControl::toXML(
+    const Metadata& metadata,
+    const std::vector<std::string>& schemaPaths);
+
+// Raw buffer and span based I/O is replaced by the NumPy versions below
+%ignore crsd::DataWriter;
+%ignore crsd::DataWriterLittleEndian;
+%ignore crsd::DataWriterBigEndian;
+%ignore crsd::Wideband::read;
+%ignore crsd::Wideband::readChannels;
+%ignore crsd::CRSDWriter::write;
+%ignore crsd::CRSDWriter::writeCRSDData;
+%ignore crsd::CRSDWriter::writeSupportData;
+%ignore crsd::PVPBlock::getPVPdata;
+%ignore crsd::PVPBlock::getRcvStart(size_t) const;
+%ignore crsd::PVPBlock::getRcvPos(size_t) const;
+%ignore crsd::PVPBlock::getRcvVel(size_t) const;
+%ignore crsd::PVPBlock::getFRCV1(size_t) const;
+%ignore crsd::PVPBlock::getFRCV2(size_t) const;
+%ignore crsd::PVPBlock::getRefPhi0(size_t) const;
+%ignore crsd::PVPBlock::getRefFreq(size_t) const;
+%ignore crsd::PVPBlock::getDFIC0(size_t) const;
+%ignore crsd::PVPBlock::getFICRate(size_t) const;
+%ignore crsd::PVPBlock::getRcvACX(size_t) const;
+%ignore crsd::PVPBlock::getRcvACY(size_t) const;
+%ignore crsd::PVPBlock::getRcvEB(size_t) const;
+%ignore crsd::PVPBlock::getSignal(size_t) const;
+%ignore crsd::PVPBlock::getAmpSF(size_t) const;
+%ignore crsd::PVPBlock::getDGRGC(size_t) const;
+%ignore crsd::PVPBlock::getTxPulseIndex(size_t) const;
+%ignore crsd::PPPBlock::getPPPdata;
+
+%include "crsd/MetadataBase.h"
+%include "crsd/Metadata.h"
+%include "crsd/BaseFileHeader.h"
+%include "crsd/FileHeader.h"
+%include "crsd/PVP.h"
+%include "crsd/PVPBlock.h"
+%include "crsd/PPP.h"
+%include "crsd/PPPBlock.h"
+%include "crsd/CRSDXMLControl.h"
+%include "crsd/Wideband.h"
+%include "crsd/CRSDReader.h"
+%include "crsd/CRSDWriter.h"
+
+%extend crsd::FileHeader
+{
+    std::string __str__()
+    {
+        std::ostringstream out;
+        out << *$self;
+        return out.str();
+    }
+}
+
+%extend crsd::Metadata
+{
+    std::string __str__()
+    {
+        std::ostringstream out;
+        out << *$self;
+        return out.str();
+    }
+}
+
+%extend crsd::PVPBlock
+{
+    std::string __str__()
+    {
+        std::ostringstream out;
+        out << *$self;
+        return out.str();
+    }
+
+    // Zero-copy view of one PVP for every vector of a channel. 'owner' is
+    // kept alive by the array; see PVPBlock.getColumn() below.
+    PyObject* getColumnImpl(const std::string& name,
+                            size_t channel,
+                            PyObject* owner)
+    {
+        if (name == "RcvStart")
+        {
+            return makeColumnView(owner, $self->getRcvStart(channel),
+                                  getTimeDescr());
+        }
+        if (name == "RcvPos")
+        {
+            return makeColumnView(owner, $self->getRcvPos(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE), 3);
+        }
+        if (name == "RcvVel")
+        {
+            return makeColumnView(owner, $self->getRcvVel(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE), 3);
+        }
+        if (name == "FRCV1")
+        {
+            return makeColumnView(owner, $self->getFRCV1(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE));
+        }
+        if (name == "FRCV2")
+        {
+            return makeColumnView(owner, $self->getFRCV2(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE));
+        }
+        if (name == "RefPhi0")
+        {
+            return makeColumnView(owner, $self->getRefPhi0(channel),
+                                  getTimeDescr());
+        }
+        if (name == "RefFreq")
+        {
+            return makeColumnView(owner, $self->getRefFreq(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE));
+        }
+        if (name == "DFIC0")
+        {
+            return makeColumnView(owner, $self->getDFIC0(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE));
+        }
+        if (name == "FICRate")
+        {
+            return makeColumnView(owner, $self->getFICRate(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE));
+        }
+        if (name == "RcvACX")
+        {
+            return makeColumnView(owner, $self->getRcvACX(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE), 3);
+        }
+        if (name == "RcvACY")
+        {
+            return makeColumnView(owner, $self->getRcvACY(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE), 3);
+        }
+        if (name == "RcvEB")
+        {
+            return makeColumnView(owner, $self->getRcvEB(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE), 2);
+        }
+        if (name == "Signal")
+        {
+            return makeColumnView(owner, $self->getSignal(channel),
+                                  PyArray_DescrFromType(NPY_INT64));
+        }
+        if (name == "AmpSF")
+        {
+            return makeColumnView(owner, $self->getAmpSF(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE));
+        }
+        if (name == "DGRGC")
+        {
+            return makeColumnView(owner, $self->getDGRGC(channel),
+                                  PyArray_DescrFromType(NPY_DOUBLE));
+        }
+        if (name == "TxPulseIndex")
+        {
+            return makeColumnView(owner, $self->getTxPulseIndex(channel),
+                                  PyArray_DescrFromType(NPY_INT64));
+        }
+        throw except::Exception(Ctxt("Unknown PVP column " + name));
+    }
+}
+
+%extend crsd::Wideband
+{
+    // Reads straight into a preallocated, C-contiguous NumPy array
+    void readImpl(size_t channel,
+                  size_t firstVector,
+                  size_t lastVector,
+                  size_t firstSample,
+                  size_t lastSample,
+                  size_t numThreads,
+                  PyObject* array)
+    {
+        PyArrayObject* pyArray =
+                verifySignalArray(array, $self->getElementSize());
+        if (!PyArray_ISWRITEABLE(pyArray))
+        {
+            throw except::Exception(Ctxt("Array must be writeable"));
+        }
+        const types::RowCol<size_t> dims = $self->getBufferDims(
+                channel, firstVector, lastVector, firstSample, lastSample);
+        if (numpyutils::getDimensionsRC(array) != dims)
+        {
+            throw except::Exception(Ctxt(
+                    "Array shape doesn't match the requested vectors "
+                    "and samples"));
+        }
+        $self->read(channel,
+                    firstVector,
+                    lastVector,
+                    firstSample,
+                    lastSample,
+                    numThreads,
+                    dims,
+                    numpyutils::getBuffer<void>(array));
+    }
+
+    // Zero-copy view of memory-mapped vectors; see getMappedSignal()
+    PyObject* getMappedSignalImpl(size_t channel,
+                                  size_t firstVector,
+                                  size_t lastVector,
+                                  PyObject* owner)
+    {
+        // The view is over the file's bytes, so NumPy does any byte
+        // swapping through the big-endian dtype
+        const std::byte* data = nullptr;
+        switch ($self->getElementSize())
+        {
+        case 2:
+            data = $self->getMappedSignalView<int8_t>(
+                    channel, firstVector, lastVector).data();
+            break;
+        case 4:
+            data = $self->getMappedSignalView<int16_t>(
+                    channel, firstVector, lastVector).data();
+            break;
+        case 8:
+            data = $self->getMappedSignalView<float>(
+                    channel, firstVector, lastVector).data();
+            break;
+        }
+        const types::RowCol<size_t> dims = $self->getBufferDims(
+                channel, firstVector, lastVector, 0, crsd::Wideband::ALL);
+        npy_intp shape[2] = {static_cast<npy_intp>(dims.row),
+                             static_cast<npy_intp>(dims.col)};
+        return makeView(owner, getSampleDescr($self->getElementSize(), true),
+                        2, shape, data);
+    }
+}
+
+%extend crsd::CRSDWriter
+{
+    // Writes whole vectors straight from a C-contiguous NumPy array
+    void writeVectorsImpl(size_t channel, size_t firstVector, PyObject* array)
+    {
+        numpyutils::verifyArray(array);
+        const size_t elementSize =
+                static_cast<size_t>(PyArray_ITEMSIZE(
+                        reinterpret_cast<PyArrayObject*>(array)));
+        verifySignalArray(array, elementSize);
+        const size_t numElements = numpyutils::getNumElements(array);
+        if (numElements == 0)
+        {
+            return;
+        }
+        const void* data = numpyutils::getBuffer<void>(array);
+        switch (elementSize)
+        {
+        case 2:
+            $self->writeVectors(channel, firstVector,
+                    std::span<const std::complex<int8_t>>(
+                            static_cast<const std::complex<int8_t>*>(data),
+                            numElements));
+            break;
+        case 4:
+            $self->writeVectors(channel, firstVector,
+                    std::span<const std::complex<int16_t>>(
+                            static_cast<const std::complex<int16_t>*>(data),
+                            numElements));
+            break;
+        case 8:
+            numpyutils::verifyType(array, NPY_COMPLEX64);
+            $self->writeVectors(channel, firstVector,
+                    std::span<const std::complex<float>>(
+                            static_cast<const std::complex<float>*>(data),
+                            numElements));
+            break;
+        default:
+            throw except::Exception(Ctxt(
+                    "Unsupported signal element size " +
+                    std::to_string(elementSize)));
+        }
+    }
+
+%pythoncode
+%{
+    def __del__(self):
+        self.close()
+%}
+}
+
+%pythoncode
+%{
+import numpy
+import multiprocessing
+
+PVP_COLUMNS = ('RcvStart', 'RcvPos', 'RcvVel', 'FRCV1', 'FRCV2', 'RefPhi0',
+               'RefFreq', 'DFIC0', 'FICRate', 'RcvACX', 'RcvACY', 'RcvEB',
+               'Signal', 'AmpSF', 'DGRGC', 'TxPulseIndex')
+
+
+def signalDtype(elementSize):
+    """NumPy dtype of one signal sample: complex64 for CF8, and a
+    (real, imag) record of int8 (CI2) or int16 (CI4) otherwise"""
+    if elementSize == 8:
+        return numpy.dtype('complex64')
+    if elementSize == 4:
+        return numpy.dtype([('real', 'i2'), ('imag', 'i2')])
+    if elementSize == 2:
+        return numpy.dtype([('real', 'i1'), ('imag', 'i1')])
+    raise Exception('Unknown element type')
+
+
+def getColumn(self, name, channel=0):
+    """Read-only NumPy view of PVP 'name' for every vector of 'channel'.
+
+    No data is copied. Vectors become (numVectors, 3) arrays, and RcvStart
+    and RefPhi0 become records of ('int', 'frac') seconds. The view keeps
+    this block alive, but is invalidated if the block is reloaded.
+    Optional PVPs that aren't present come back empty."""
+    return self.getColumnImpl(name, channel, self)
+
+
+def getColumns(self, channel=0):
+    """Dict of every PVP present in 'channel', as from getColumn()"""
+    columns = {}
+    for name in PVP_COLUMNS:
+        column = self.getColumn(name, channel)
+        if column.size > 0:
+            columns[name] = column
+    return columns
+
+PVPBlock.getColumn = getColumn
+PVPBlock.getColumns = getColumns
+
+
+def readInto(self,
+             array,
+             channel=0,
+             firstVector=0,
+             lastVector=Wideband.ALL,
+             firstSample=0,
+             lastSample=Wideband.ALL,
+             numThreads=multiprocessing.cpu_count()):
+    """Read into a preallocated NumPy array, with no intermediate copy"""
+    self.readImpl(channel, firstVector, lastVector, firstSample, lastSample,
+                  numThreads, array)
+    return array
+
+
+def read(self,
+         channel=0,
+         firstVector=0,
+         lastVector=Wideband.ALL,
+         firstSample=0,
+         lastSample=Wideband.ALL,
+         numThreads=multiprocessing.cpu_count()):
+    """Read into a new NumPy array of signalDtype() samples"""
+    dims = self.getBufferDims(channel, firstVector, lastVector,
+                              firstSample, lastSample)
+    array = numpy.empty(shape=(dims.row, dims.col),
+                        dtype=signalDtype(self.getElementSize()))
+    return self.readInto(array, channel, firstVector, lastVector,
+                         firstSample, lastSample, numThreads)
+
+
+def getMappedSignal(self, channel=0, firstVector=0, lastVector=Wideband.ALL):
+    """Read-only NumPy view straight into the memory-mapped signal block.
+
+    Only available for uncompressed files. The samples aren't copied or
+    swapped, so CI4 and CF8 views have big-endian dtypes and NumPy swaps
+    them on access. The view keeps the reader alive."""
+    return self.getMappedSignalImpl(channel, firstVector, lastVector, self)
+
+Wideband.readInto = readInto
+Wideband.read = read
+Wideband.getMappedSignal = getMappedSignal
+
+# Blocks and the wideband belong to the reader, so views of them must keep
+# the reader alive as well
+_getPVPBlock = CRSDReader.getPVPBlock
+_getWideband = CRSDReader.getWideband
+
+
+def _readerGetPVPBlock(self):
+    block = _getPVPBlock(self)
+    block._reader = self
+    return block
+
+
+def _readerGetWideband(self):
+    wideband = _getWideband(self)
+    wideband._reader = self
+    return wideband
+
+CRSDReader.getPVPBlock = _readerGetPVPBlock
+CRSDReader.getWideband = _readerGetWideband
+
+
+def writeVectors(self, channel, firstVector, array):
+    """Write whole vectors from a C-contiguous NumPy array of
+    signalDtype() samples, with no intermediate copy"""
+    self.writeVectorsImpl(channel, firstVector, array)
+
+CRSDWriter.writeVectors = writeVectors
+%}
+
+%template(VectorString) std::vector<std::string>;
@@ -0,0 +1,90 @@
+#!/usr/bin/env python
+
+#
+# =========================================================================
+# This file is part of crsd-python
+# =========================================================================
+#
+# (C) Copyright 2004 - 2020, MDA Information Systems LLC
+#
+# crsd-python is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program; If not,
+# see <http://www.gnu.org/licenses/>.
+#
+
+# Checks that the NumPy views and reads agree with the per-element getters
+
+import sys
+import multiprocessing
+
+import numpy
+
+from pysix.crsd import CRSDReader, PVP_COLUMNS
+
+
+def check_pvp_columns(reader):
+    pvp_block = reader.getPVPBlock()
+    for channel in range(reader.getNumChannels()):
+        columns = pvp_block.getColumns(channel)
+        assert 'RcvPos' in columns and 'Signal' in columns
+        for name, column in columns.items():
+            assert name in PVP_COLUMNS
+            assert not column.flags.writeable
+            assert len(column) == reader.getNumVectors(channel)
+
+        rcv_pos = columns['RcvPos']
+        for vector in range(len(rcv_pos)):
+            expected = pvp_block.getRcvPos(channel, vector)
+            assert tuple(rcv_pos[vector]) == \
+                (expected[0], expected[1], expected[2])
+            assert columns['Signal'][vector] == \
+                pvp_block.getSignal(channel, vector)
+
+    # The views keep the reader alive
+    rcv_pos = reader.getPVPBlock().getColumn('RcvPos')
+    return rcv_pos
+
+
+def check_wideband(reader):
+    wideband = reader.getWideband()
+    num_threads = multiprocessing.cpu_count()
+    for channel in range(reader.getNumChannels()):
+        data = wideband.read(channel, numThreads=num_threads)
+        assert data.shape == (reader.getNumVectors(channel),
+                              reader.getNumSamples(channel))
+
+        # Reusing a buffer for a sub-window
+        window = numpy.empty_like(data[1:3, 2:5])
+        wideband.readInto(window, channel, 1, 2, 2, 4)
+        assert numpy.array_equal(window, data[1:3, 2:5])
+
+        try:
+            mapped = wideband.getMappedSignal(channel)
+        except RuntimeError:
+            # Compressed
+            continue
+        assert not mapped.flags.writeable
+        assert numpy.array_equal(mapped.astype(data.dtype), data)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        print('Usage: ' + sys.argv[0] + ' <Input CRSD>')
+        sys.exit(0)
+
+    reader = CRSDReader(sys.argv[1], multiprocessing.cpu_count())
+    rcv_pos = check_pvp_columns(reader)
+    check_wideband(reader)
+    del reader
+    assert rcv_pos.shape[1] == 3 and numpy.isfinite(rcv_pos).all()
+    print('Test passed')
@@ -425,9 +425,11 @@ def readFromNITF(pathname, schemaPaths=VectorString()):
         // TODO: If we get noncontiguous memory, maybe we want to
         //       instead do multiple calls to save() ourselves to
         //       avoid the memory allocation
-        $self->save(numpyutils::getBuffer<std::complex<float> >(data),
-                    offset,
-                    numpyutils::getDimensionsRC(data));
+        const types::RowCol<size_t> dims = numpyutils::getDimensionsRC(data);
+        const std::span<const std::complex<float> > pixels(
+                numpyutils::getBuffer<std::complex<float> >(data),
+                dims.area());
+        $self->save(pixels, offset, dims);
     }
 
     void initXMLControlRegistry(six::XMLControlRegistry& xmlRegistry)